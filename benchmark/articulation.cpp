@@ -0,0 +1,57 @@
+#include "common.h"
+#include <benchmark/benchmark.h>
+
+using namespace sapien;
+using namespace sapien::bench;
+
+static void BM_ArticulationGetQpos(benchmark::State &state) {
+  auto s = CreateScene(0, 1, state.range(0));
+  auto a = s.articulations.at(0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a->getQpos());
+  }
+}
+BENCHMARK(BM_ArticulationGetQpos)->Arg(7)->Arg(30);
+
+static void BM_ArticulationSetQpos(benchmark::State &state) {
+  auto s = CreateScene(0, 1, state.range(0));
+  auto a = s.articulations.at(0);
+  Eigen::VectorXf q = Eigen::VectorXf::Constant(a->getDof(), 0.1f);
+  for (auto _ : state) {
+    a->setQpos(q);
+  }
+}
+BENCHMARK(BM_ArticulationSetQpos)->Arg(7)->Arg(30);
+
+static void BM_ArticulationGetQvel(benchmark::State &state) {
+  auto s = CreateScene(0, 1, state.range(0));
+  auto a = s.articulations.at(0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a->getQvel());
+  }
+}
+BENCHMARK(BM_ArticulationGetQvel)->Arg(7)->Arg(30);
+
+static void BM_ArticulationSetQvel(benchmark::State &state) {
+  auto s = CreateScene(0, 1, state.range(0));
+  auto a = s.articulations.at(0);
+  Eigen::VectorXf q = Eigen::VectorXf::Constant(a->getDof(), 0.1f);
+  for (auto _ : state) {
+    a->setQvel(q);
+  }
+}
+BENCHMARK(BM_ArticulationSetQvel)->Arg(7)->Arg(30);
+
+// set qpos on every articulation then step, the pattern of a reset in RL environments
+static void BM_ArticulationResetAndStep(benchmark::State &state) {
+  auto s = CreateScene(0, state.range(0));
+  Eigen::VectorXf q = Eigen::VectorXf::Zero(7);
+  for (auto _ : state) {
+    for (auto &a : s.articulations) {
+      a->setQpos(q);
+      a->setQvel(q);
+    }
+    s.system->step();
+  }
+}
+BENCHMARK(BM_ArticulationResetAndStep)->Arg(1)->Arg(100)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,272 @@
+#include "common.h"
+#include "sapien/actor_builder.h"
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <numbers>
+
+namespace sapien::physx {
+// defined in src/physx/mesh.cpp
+std::vector<std::vector<int>> splitMesh(aiMesh *mesh);
+} // namespace sapien::physx
+
+using namespace sapien;
+using namespace sapien::bench;
+
+static std::string AssetPath(std::string const &name) {
+  auto root = std::filesystem::path(__FILE__).parent_path().parent_path();
+  for (auto dir : {root / "unittest" / "assets", root / "test" / "assets"}) {
+    if (std::filesystem::exists(dir / name)) {
+      return (dir / name).string();
+    }
+  }
+  throw std::runtime_error("failed to find benchmark asset " + name);
+}
+
+static std::vector<std::string> const &MeshAssets() {
+  static std::vector<std::string> assets = {"cube.obj", "doublecube.obj", "cone.stl",
+                                            "torus.stl"};
+  return assets;
+}
+
+// UV sphere with given number of segments, used to control mesh size deterministically
+static std::tuple<Vertices, Triangles> CreateSphere(uint32_t segments) {
+  uint32_t rings = segments / 2;
+  Vertices vertices((rings + 1) * segments, 3);
+  for (uint32_t r = 0; r <= rings; ++r) {
+    float theta = std::numbers::pi_v<float> * r / rings;
+    for (uint32_t s = 0; s < segments; ++s) {
+      float phi = 2.f * std::numbers::pi_v<float> * s / segments;
+      vertices.row(r * segments + s) << std::sin(theta) * std::cos(phi),
+          std::sin(theta) * std::sin(phi), std::cos(theta);
+    }
+  }
+  Triangles triangles(rings * segments * 2, 3);
+  uint32_t t = 0;
+  for (uint32_t r = 0; r < rings; ++r) {
+    for (uint32_t s = 0; s < segments; ++s) {
+      uint32_t a = r * segments + s;
+      uint32_t b = r * segments + (s + 1) % segments;
+      uint32_t c = a + segments;
+      uint32_t d = b + segments;
+      triangles.row(t++) << a, c, b;
+      triangles.row(t++) << b, c, d;
+    }
+  }
+  return {vertices, triangles};
+}
+
+//////////////////// import ////////////////////
+
+static void BM_AssimpImport(benchmark::State &state) {
+  auto filename = AssetPath(MeshAssets().at(state.range(0)));
+  for (auto _ : state) {
+    Assimp::Importer importer;
+    importer.SetPropertyBool(AI_CONFIG_IMPORT_COLLADA_IGNORE_UP_DIRECTION, true);
+    benchmark::DoNotOptimize(
+        importer.ReadFile(filename, aiProcess_Triangulate | aiProcess_PreTransformVertices));
+  }
+  state.SetLabel(MeshAssets().at(state.range(0)));
+}
+BENCHMARK(BM_AssimpImport)->DenseRange(0, 3);
+
+static void BM_SplitMesh(benchmark::State &state) {
+  auto filename = AssetPath(MeshAssets().at(state.range(0)));
+  Assimp::Importer importer;
+  auto scene =
+      importer.ReadFile(filename, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices);
+  if (!scene || !scene->mNumMeshes) {
+    state.SkipWithError("failed to load mesh");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(splitMesh(scene->mMeshes[0]));
+  }
+  state.SetLabel(MeshAssets().at(state.range(0)));
+}
+BENCHMARK(BM_SplitMesh)->DenseRange(0, 3);
+
+//////////////////// cooking ////////////////////
+
+static void BM_CookConvexMesh(benchmark::State &state) {
+  auto [vertices, triangles] = CreateSphere(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::make_shared<PhysxConvexMesh>(vertices));
+  }
+  state.counters["vertices"] = vertices.rows();
+}
+BENCHMARK(BM_CookConvexMesh)->Arg(8)->Arg(32)->Arg(128)->Unit(benchmark::kMicrosecond);
+
+static void BM_CookTriangleMesh(benchmark::State &state) {
+  auto [vertices, triangles] = CreateSphere(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::make_shared<PhysxTriangleMesh>(vertices, triangles, false));
+  }
+  state.counters["triangles"] = triangles.rows();
+}
+BENCHMARK(BM_CookTriangleMesh)->Arg(8)->Arg(32)->Arg(128)->Unit(benchmark::kMicrosecond);
+
+// args: sphere segments, SDF spacing in units of 1e-3
+static void BM_CookSDF(benchmark::State &state) {
+  auto [vertices, triangles] = CreateSphere(state.range(0));
+  auto config = PhysxDefault::getSDFShapeConfig();
+  auto sdfConfig = config;
+  sdfConfig.spacing = state.range(1) * 1e-3f;
+  PhysxDefault::setSDFShapeConfig(sdfConfig);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::make_shared<PhysxTriangleMesh>(vertices, triangles, true));
+  }
+  PhysxDefault::setSDFShapeConfig(config);
+}
+BENCHMARK(BM_CookSDF)
+    ->ArgNames({"segments", "spacing_mm"})
+    ->Args({32, 100})
+    ->Args({32, 50})
+    ->Args({32, 20})
+    ->Unit(benchmark::kMillisecond);
+
+//////////////////// mesh manager ////////////////////
+
+// args: asset index, warm (1 keeps the MeshManager cache between iterations)
+static void BM_MeshManagerLoadConvexMesh(benchmark::State &state) {
+  auto filename = AssetPath(MeshAssets().at(state.range(0)));
+  bool warm = state.range(1);
+  MeshManager::Clear();
+  MeshManager::Get()->loadConvexMesh(filename);
+  for (auto _ : state) {
+    if (!warm) {
+      state.PauseTiming();
+      MeshManager::Clear();
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(MeshManager::Get()->loadConvexMesh(filename));
+  }
+  state.SetLabel(MeshAssets().at(state.range(0)) + (warm ? " warm" : " cold"));
+}
+BENCHMARK(BM_MeshManagerLoadConvexMesh)
+    ->ArgNames({"asset", "warm"})
+    ->ArgsProduct({{0, 2, 3}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_MeshManagerLoadTriangleMesh(benchmark::State &state) {
+  auto filename = AssetPath(MeshAssets().at(state.range(0)));
+  bool warm = state.range(1);
+  MeshManager::Clear();
+  MeshManager::Get()->loadTriangleMesh(filename);
+  for (auto _ : state) {
+    if (!warm) {
+      state.PauseTiming();
+      MeshManager::Clear();
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(MeshManager::Get()->loadTriangleMesh(filename));
+  }
+  state.SetLabel(MeshAssets().at(state.range(0)) + (warm ? " warm" : " cold"));
+}
+BENCHMARK(BM_MeshManagerLoadTriangleMesh)
+    ->ArgNames({"asset", "warm"})
+    ->ArgsProduct({{0, 2, 3}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+//////////////////// shapes ////////////////////
+
+static void BM_CollisionShapeCreateBox(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        std::make_shared<PhysxCollisionShapeBox>(Vec3(0.1f, 0.2f, 0.3f), GetMaterial()));
+  }
+}
+BENCHMARK(BM_CollisionShapeCreateBox);
+
+static void BM_CollisionShapeCreateConvexMesh(benchmark::State &state) {
+  auto filename = AssetPath("torus.stl");
+  MeshManager::Get()->loadConvexMesh(filename);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        std::make_shared<PhysxCollisionShapeConvexMesh>(filename, Vec3(1.f), GetMaterial()));
+  }
+}
+BENCHMARK(BM_CollisionShapeCreateConvexMesh);
+
+static void BM_CollisionShapeClone(benchmark::State &state) {
+  std::shared_ptr<PhysxCollisionShape> shape;
+  if (state.range(0) == 0) {
+    shape = std::make_shared<PhysxCollisionShapeBox>(Vec3(0.1f, 0.2f, 0.3f), GetMaterial());
+  } else {
+    shape = std::make_shared<PhysxCollisionShapeConvexMesh>(AssetPath("torus.stl"), Vec3(1.f),
+                                                            GetMaterial());
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(shape->clone());
+  }
+  state.SetLabel(state.range(0) == 0 ? "box" : "convex mesh");
+}
+BENCHMARK(BM_CollisionShapeClone)->Arg(0)->Arg(1);
+
+//////////////////// articulation ////////////////////
+
+static void BM_CloneArticulation(benchmark::State &state) {
+  auto entities = CreateChain({0.f, 0.f, 0.f}, state.range(0));
+  auto root = entities.front()->getComponent<PhysxArticulationLinkComponent>();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(PhysxArticulationLinkComponent::cloneArticulation(root));
+  }
+}
+BENCHMARK(BM_CloneArticulation)->Arg(7)->Arg(30)->Unit(benchmark::kMicrosecond);
+
+//////////////////// actor builder ////////////////////
+
+static ActorBuilder CreateClutterBuilder() {
+  ActorBuilder builder;
+  CollisionShapeRecord box;
+  box.type = CollisionShapeRecord::Type::eBox;
+  box.scale = Vec3(0.05f);
+  box.material = GetMaterial();
+  builder.addCollision(box);
+
+  CollisionShapeRecord mesh;
+  mesh.type = CollisionShapeRecord::Type::eConvexMesh;
+  mesh.filename = AssetPath("cone.stl");
+  mesh.scale = Vec3(0.05f);
+  mesh.material = GetMaterial();
+  builder.addCollision(mesh);
+  return builder;
+}
+
+// arg 0 builds entities one at a time, arg 1 builds them with a single buildMany call
+static void BM_ActorBuilderBuild(benchmark::State &state) {
+  auto builder = CreateClutterBuilder();
+  uint32_t count = state.range(1);
+  std::vector<Pose> poses;
+  for (uint32_t i = 0; i < count; ++i) {
+    poses.push_back({{0.1f * (i % 100), 0.1f * (i / 100), 0.1f}, {1.f, 0.f, 0.f, 0.f}});
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto scene = std::make_shared<Scene>(
+        std::vector<std::shared_ptr<System>>{std::make_shared<PhysxSystemCpu>()});
+    builder.setScene(scene);
+    state.ResumeTiming();
+
+    if (state.range(0) == 0) {
+      for (auto &pose : poses) {
+        builder.setInitialPose(pose);
+        benchmark::DoNotOptimize(builder.build());
+      }
+    } else {
+      benchmark::DoNotOptimize(builder.buildMany(poses));
+    }
+
+    state.PauseTiming();
+    builder.setScene(nullptr);
+    scene.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetLabel(state.range(0) == 0 ? "build" : "buildMany");
+}
+BENCHMARK(BM_ActorBuilderBuild)
+    ->ArgsProduct({{0, 1}, {100, 1000}})
+    ->Unit(benchmark::kMillisecond);
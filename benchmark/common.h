@@ -0,0 +1,111 @@
+#pragma once
+#include "sapien/entity.h"
+#include "sapien/physx/physx.h"
+#include "sapien/scene.h"
+#include <cmath>
+
+namespace sapien {
+namespace bench {
+
+using namespace sapien::physx;
+
+inline std::shared_ptr<PhysxMaterial> GetMaterial() {
+  static auto mat = std::make_shared<PhysxMaterial>(0.3, 0.3, 0.1);
+  return mat;
+}
+
+inline std::shared_ptr<Entity> AddGround(Scene &scene) {
+  auto component = std::make_shared<PhysxRigidStaticComponent>();
+  auto shape = std::make_shared<PhysxCollisionShapePlane>(GetMaterial());
+  shape->setLocalPose({{0.f, 0.f, 0.f}, {0.7071068, 0, -0.7071068, 0}});
+  component->attachCollision(shape);
+
+  auto entity = std::make_shared<Entity>();
+  entity->setName("ground");
+  entity->addComponent(component);
+  scene.addEntity(entity);
+  return entity;
+}
+
+inline std::shared_ptr<Entity> CreateBox(Vec3 position, float halfSize) {
+  auto component = std::make_shared<PhysxRigidDynamicComponent>();
+  component->attachCollision(
+      std::make_shared<PhysxCollisionShapeBox>(Vec3(halfSize), GetMaterial()));
+
+  auto entity = std::make_shared<Entity>();
+  entity->addComponent(component);
+  entity->setPose({position, {1.f, 0.f, 0.f, 0.f}});
+  return entity;
+}
+
+/** fixed-base chain of box links connected by revolute joints */
+inline std::vector<std::shared_ptr<Entity>> CreateChain(Vec3 position, uint32_t dof) {
+  std::vector<std::shared_ptr<Entity>> entities;
+  std::shared_ptr<PhysxArticulationLinkComponent> parent;
+  for (uint32_t i = 0; i <= dof; ++i) {
+    auto link = PhysxArticulationLinkComponent::Create(parent);
+    link->attachCollision(std::make_shared<PhysxCollisionShapeBox>(Vec3(0.05f), GetMaterial()));
+    if (parent) {
+      link->getJoint()->setType(::physx::PxArticulationJointType::eREVOLUTE);
+      link->getJoint()->setAnchorPoseInParent({{0.f, 0.f, 0.1f}, {1.f, 0.f, 0.f, 0.f}});
+      link->getJoint()->setAnchorPoseInChild({{0.f, 0.f, 0.f}, {1.f, 0.f, 0.f, 0.f}});
+      link->getJoint()->setDriveProperties(100.f, 10.f, 1000.f,
+                                           ::physx::PxArticulationDriveType::eFORCE);
+    } else {
+      link->getJoint()->setType(::physx::PxArticulationJointType::eFIX);
+    }
+
+    auto entity = std::make_shared<Entity>();
+    entity->addComponent(link);
+    entity->setPose({position + Vec3(0.f, 0.f, 0.1f * i), {1.f, 0.f, 0.f, 0.f}});
+    entities.push_back(entity);
+    parent = link;
+  }
+  return entities;
+}
+
+struct BenchScene {
+  std::shared_ptr<Scene> scene;
+  std::shared_ptr<PhysxSystemCpu> system;
+  std::vector<std::shared_ptr<Entity>> bodies;
+  std::vector<std::shared_ptr<PhysxArticulation>> articulations;
+};
+
+/** Deterministic scene with boxes on a grid resting on the ground and fixed-base chains.
+ *  spacing is the distance between box centers in box sizes, values <= 1 make boxes touch
+ *  their neighbors which gives a contact-dense scene */
+inline BenchScene CreateScene(uint32_t bodyCount, uint32_t articulationCount = 0,
+                              uint32_t dof = 7, float spacing = 2.f) {
+  BenchScene s;
+  s.system = std::make_shared<PhysxSystemCpu>();
+  s.scene = std::make_shared<Scene>(std::vector<std::shared_ptr<System>>{s.system});
+  AddGround(*s.scene);
+
+  float halfSize = 0.05f;
+  uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(bodyCount))));
+  for (uint32_t i = 0; i < bodyCount; ++i) {
+    float x = (i % side) * 2.f * halfSize * spacing;
+    float y = (i / side) * 2.f * halfSize * spacing;
+    auto entity = CreateBox({x, y, halfSize}, halfSize);
+    s.scene->addEntity(entity);
+    s.bodies.push_back(entity);
+  }
+
+  for (uint32_t i = 0; i < articulationCount; ++i) {
+    auto entities = CreateChain({-1.f - static_cast<float>(i), 0.f, 0.f}, dof);
+    for (auto &e : entities) {
+      s.scene->addEntity(e);
+    }
+    s.articulations.push_back(
+        entities.front()->getComponent<PhysxArticulationLinkComponent>()->getArticulation());
+  }
+
+  // settle the scene so measurements do not include the initial contact generation
+  for (int i = 0; i < 10; ++i) {
+    s.system->step();
+  }
+  return s;
+}
+
+} // namespace bench
+} // namespace sapien
@@ -0,0 +1,55 @@
+#include "sapien/math/batch.h"
+#include "sapien/math/bounding_box.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace sapien;
+
+static Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> RandomPoints(int64_t count) {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dis(-1.f, 1.f);
+  Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> points(count, 3);
+  for (int64_t i = 0; i < count * 3; ++i) {
+    points.data()[i] = dis(gen);
+  }
+  return points;
+}
+
+// point cloud sized inputs, e.g. one 640x480 camera
+static void BM_TransformPoints(benchmark::State &state) {
+  auto points = RandomPoints(state.range(0));
+  decltype(points) result(points.rows(), 3);
+  Pose pose({0.1f, 0.2f, 0.3f}, Quat(0.5f, 0.5f, 0.5f, 0.5f));
+  for (auto _ : state) {
+    transformPoints(pose, points.data(), result.data(), points.rows());
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetLabel(getBatchMathBackend());
+}
+BENCHMARK(BM_TransformPoints)->Arg(1 << 10)->Arg(640 * 480)->Unit(benchmark::kMicrosecond);
+
+static void BM_ComputeAABB(benchmark::State &state) {
+  auto points = RandomPoints(state.range(0));
+  Pose pose({0.1f, 0.2f, 0.3f}, Quat(0.5f, 0.5f, 0.5f, 0.5f));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(computeAABB(points, Vec3(2.f), pose));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ComputeAABB)->Arg(64)->Arg(1 << 14)->Unit(benchmark::kMicrosecond);
+
+static void BM_ComposePoses(benchmark::State &state) {
+  int64_t count = state.range(0);
+  float pose[7] = {0.1f, 0.2f, 0.3f, 0.5f, 0.5f, 0.5f, 0.5f};
+  std::vector<float> a(count * 7), out(count * 7);
+  for (int64_t i = 0; i < count * 7; ++i) {
+    a[i] = pose[i % 7];
+  }
+  for (auto _ : state) {
+    composePoses(a.data(), count, a.data(), count, out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ComposePoses)->Arg(1 << 12);
@@ -0,0 +1,142 @@
+#include "common.h"
+#include <benchmark/benchmark.h>
+
+using namespace sapien;
+using namespace sapien::bench;
+
+// args: bodies, articulations, spacing (percent of box size)
+static void BM_PhysxSystemCpuStep(benchmark::State &state) {
+  auto s = CreateScene(state.range(0), state.range(1), 7, state.range(2) / 100.f);
+  for (auto _ : state) {
+    s.system->step();
+  }
+  auto stats = s.system->getStepStatistics();
+  state.counters["contact_pairs"] = stats.contactPairs;
+  state.counters["contact_points"] = stats.contactPoints;
+  state.counters["steps_per_second"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_PhysxSystemCpuStep)
+    ->ArgNames({"bodies", "articulations", "spacing"})
+    ->Args({10, 0, 200})
+    ->Args({100, 0, 200})
+    ->Args({1000, 0, 200})
+    ->Args({1000, 0, 100})
+    ->Args({0, 1, 200})
+    ->Args({0, 10, 200})
+    ->Args({0, 100, 200})
+    ->Args({100, 10, 100})
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_PhysxSyncPoseToEntity(benchmark::State &state) {
+  auto s = CreateScene(state.range(0), state.range(1));
+  auto bodies = s.system->getRigidDynamicComponents();
+  auto links = s.system->getArticulationLinkComponents();
+  for (auto _ : state) {
+    for (auto &b : bodies) {
+      b->syncPoseToEntity();
+    }
+    for (auto &l : links) {
+      l->syncPoseToEntity();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (bodies.size() + links.size()));
+}
+BENCHMARK(BM_PhysxSyncPoseToEntity)
+    ->ArgNames({"bodies", "articulations"})
+    ->Args({100, 0})
+    ->Args({1000, 0})
+    ->Args({0, 100});
+
+static void BM_PhysxPackState(benchmark::State &state) {
+  auto s = CreateScene(state.range(0), state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s.system->packState());
+  }
+  state.SetBytesProcessed(state.iterations() * s.system->packState().size());
+}
+BENCHMARK(BM_PhysxPackState)
+    ->ArgNames({"bodies", "articulations"})
+    ->Args({100, 0})
+    ->Args({1000, 0})
+    ->Args({0, 100});
+
+static void BM_PhysxUnpackState(benchmark::State &state) {
+  auto s = CreateScene(state.range(0), state.range(1));
+  auto data = s.system->packState();
+  for (auto _ : state) {
+    s.system->unpackState(data);
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_PhysxUnpackState)
+    ->ArgNames({"bodies", "articulations"})
+    ->Args({100, 0})
+    ->Args({1000, 0})
+    ->Args({0, 100});
+
+static void BM_ScenePackEntityPoses(benchmark::State &state) {
+  auto s = CreateScene(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s.scene->packEntityPoses());
+  }
+}
+BENCHMARK(BM_ScenePackEntityPoses)->Arg(100)->Arg(1000);
+
+// args: bodies, spacing (percent of box size)
+static void BM_PhysxGetContacts(benchmark::State &state) {
+  auto s = CreateScene(state.range(0), 0, 7, state.range(1) / 100.f);
+  s.system->step();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s.system->getContacts());
+  }
+  state.counters["contact_pairs"] = s.system->getContacts().size();
+}
+BENCHMARK(BM_PhysxGetContacts)
+    ->ArgNames({"bodies", "spacing"})
+    ->Args({100, 200})
+    ->Args({1000, 200})
+    ->Args({1000, 100});
+
+static void BM_PhysxRaycast(benchmark::State &state) {
+  auto s = CreateScene(state.range(0));
+  uint32_t i = 0;
+  for (auto _ : state) {
+    // sweep rays over the grid so hits and misses are both covered
+    float x = static_cast<float>(i++ % 64) * 0.05f;
+    benchmark::DoNotOptimize(s.system->raycast({x, x, 1.f}, {0.f, 0.f, -1.f}, 10.f));
+  }
+}
+BENCHMARK(BM_PhysxRaycast)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_SceneAddRemoveEntity(benchmark::State &state) {
+  auto s = CreateScene(state.range(0));
+  std::vector<std::shared_ptr<Entity>> entities;
+  for (uint32_t i = 0; i < 100; ++i) {
+    entities.push_back(CreateBox({static_cast<float>(i), -5.f, 1.f}, 0.05f));
+  }
+  for (auto _ : state) {
+    for (auto &e : entities) {
+      s.scene->addEntity(e);
+    }
+    for (auto &e : entities) {
+      s.scene->removeEntity(e);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * entities.size());
+}
+BENCHMARK(BM_SceneAddRemoveEntity)->Arg(100)->Arg(1000);
+
+static void BM_SceneAddRemoveArticulation(benchmark::State &state) {
+  auto s = CreateScene(0);
+  auto entities = CreateChain({0.f, 5.f, 0.f}, state.range(0));
+  for (auto _ : state) {
+    for (auto &e : entities) {
+      s.scene->addEntity(e);
+    }
+    for (auto &e : entities) {
+      s.scene->removeEntity(e);
+    }
+  }
+}
+BENCHMARK(BM_SceneAddRemoveArticulation)->Arg(7)->Arg(30);
@@ -0,0 +1,100 @@
+"""
+End-to-end URDF loading benchmark.
+
+cold: first load in a fresh process (includes mesh import and cooking)
+warm: repeated loads in the same process (mesh caches populated)
+
+Usage: python benchmark/urdf_load.py [--repeat N] [--out result.json] [urdf ...]
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+ASSET_DIR = os.path.join(os.path.dirname(__file__), "..", "unittest", "assets")
+DEFAULT_URDFS = [
+    os.path.join(ASSET_DIR, "movo_simple.urdf"),
+    os.path.join(ASSET_DIR, "urdf_test_case", "test.urdf"),
+]
+
+
+def load_once(scene, urdf):
+    loader = scene.create_urdf_loader()
+    loader.fix_root_link = True
+    start = time.perf_counter()
+    articulations, actors = loader.load_multiple(urdf)
+    elapsed = time.perf_counter() - start
+    for e in [l.entity for a in articulations for l in a.links] + list(actors):
+        scene.remove_entity(e)
+    return elapsed
+
+
+def run_single(urdf):
+    """time the first load in this process"""
+    import sapien
+
+    scene = sapien.Scene()
+    print(json.dumps({"seconds": load_once(scene, urdf)}))
+
+
+def run(urdfs, repeat):
+    import sapien
+
+    results = []
+    for urdf in urdfs:
+        # cold: a new interpreter so no mesh or Python module caches are populated
+        output = subprocess.check_output(
+            [sys.executable, __file__, "--single", urdf], text=True
+        )
+        cold = json.loads(output.strip().splitlines()[-1])["seconds"]
+
+        scene = sapien.Scene()
+        load_once(scene, urdf)
+        warm = sorted(load_once(scene, urdf) for _ in range(repeat))
+
+        results.append(
+            {
+                "name": os.path.basename(urdf),
+                "cold_ms": cold * 1e3,
+                "warm_ms_median": warm[len(warm) // 2] * 1e3,
+                "warm_ms_min": warm[0] * 1e3,
+                "repeat": repeat,
+            }
+        )
+        print(
+            f"{results[-1]['name']:30s} cold {results[-1]['cold_ms']:10.2f} ms  "
+            f"warm {results[-1]['warm_ms_median']:10.2f} ms",
+            file=sys.stderr,
+        )
+
+    return {
+        "context": {"sapien_version": sapien.__version__, "python": sys.version},
+        "benchmarks": results,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("urdf", nargs="*", default=DEFAULT_URDFS)
+    parser.add_argument("--repeat", type=int, default=10)
+    parser.add_argument("--out", type=str, default=None)
+    parser.add_argument("--single", type=str, default=None, help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.single:
+        run_single(args.single)
+        return
+
+    result = json.dumps(run(args.urdf, args.repeat), indent=2)
+    if args.out:
+        with open(args.out, "w") as f:
+            f.write(result)
+    else:
+        print(result)
+
+
+if __name__ == "__main__":
+    main()
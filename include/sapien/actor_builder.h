@@ -0,0 +1,140 @@
+#pragma once
+#include "math/pose.h"
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sapien {
+class Entity;
+class Scene;
+
+namespace physx {
+class PhysxCollisionShape;
+class PhysxMaterial;
+} // namespace physx
+
+namespace sapien_renderer {
+class SapienRenderBodyComponent;
+class SapienRenderMaterial;
+} // namespace sapien_renderer
+
+struct CollisionShapeRecord {
+  enum class Type {
+    eConvexMesh,
+    eMultipleConvexMeshes,
+    eNonconvexMesh,
+    ePlane,
+    eBox,
+    eCapsule,
+    eSphere,
+    eCylinder
+  };
+  Type type{Type::eBox};
+
+  /** mesh types */
+  std::string filename;
+
+  /** scale for mesh types, half size for box */
+  Vec3 scale{1.f, 1.f, 1.f};
+
+  /** sphere, capsule and cylinder */
+  float radius{1.f};
+  /** half length for capsule and cylinder */
+  float length{1.f};
+
+  /** nullptr uses the default material */
+  std::shared_ptr<physx::PhysxMaterial> material;
+  Pose pose;
+
+  float density{1000.f};
+  float patchRadius{0.f};
+  float minPatchRadius{0.f};
+  bool isTrigger{false};
+};
+
+struct VisualShapeRecord {
+  enum class Type { eFile, ePlane, eBox, eCapsule, eSphere, eCylinder };
+  Type type{Type::eBox};
+
+  std::string filename;
+  /** scale for file and plane, half size for box */
+  Vec3 scale{1.f, 1.f, 1.f};
+
+  float radius{1.f};
+  /** half length for capsule and cylinder */
+  float length{1.f};
+
+  /** nullptr uses the material in the file or a default material */
+  std::shared_ptr<sapien_renderer::SapienRenderMaterial> material;
+
+  Pose pose;
+  std::string name;
+};
+
+/** Native counterpart of the Python ActorBuilder. Shapes are created once per build call and
+ *  cloned for every instance, so cooked meshes, physical materials and render meshes are shared
+ *  by all entities built from the same records. */
+class ActorBuilder {
+public:
+  enum class BodyType { eDynamic, eKinematic, eStatic };
+
+  ActorBuilder() = default;
+
+  ActorBuilder &addCollision(CollisionShapeRecord const &record) {
+    mCollisionRecords.push_back(record);
+    return *this;
+  }
+  ActorBuilder &addVisual(VisualShapeRecord const &record) {
+    mVisualRecords.push_back(record);
+    return *this;
+  }
+  std::vector<CollisionShapeRecord> &getCollisionRecords() { return mCollisionRecords; }
+  std::vector<VisualShapeRecord> &getVisualRecords() { return mVisualRecords; }
+
+  void setScene(std::shared_ptr<Scene> scene) { mScene = scene; }
+  std::shared_ptr<Scene> getScene() const { return mScene; }
+
+  void setName(std::string const &name) { mName = name; }
+  std::string getName() const { return mName; }
+
+  void setBodyType(BodyType type) { mBodyType = type; }
+  BodyType getBodyType() const { return mBodyType; }
+
+  void setInitialPose(Pose const &pose) { mInitialPose = pose; }
+  Pose getInitialPose() const { return mInitialPose; }
+
+  void setCollisionGroups(std::array<uint32_t, 4> const &groups) { mCollisionGroups = groups; }
+  std::array<uint32_t, 4> getCollisionGroups() const { return mCollisionGroups; }
+
+  /** disables automatic mass computation from shape densities */
+  void setMassAndInertia(float mass, Pose const &cmassLocalPose, Vec3 const &inertia);
+
+  /** build one entity at the initial pose and add it to the scene */
+  std::shared_ptr<Entity> build();
+
+  /** Build one entity per pose. scenes must contain either one scene shared by all entities or
+   *  one scene per pose. An empty list uses the builder's scene. */
+  std::vector<std::shared_ptr<Entity>> buildMany(std::vector<Pose> const &poses,
+                                                 std::vector<std::shared_ptr<Scene>> scenes = {});
+
+private:
+  std::vector<std::shared_ptr<physx::PhysxCollisionShape>> buildCollisionShapes() const;
+  std::shared_ptr<sapien_renderer::SapienRenderBodyComponent> buildRenderComponent() const;
+
+  std::vector<CollisionShapeRecord> mCollisionRecords;
+  std::vector<VisualShapeRecord> mVisualRecords;
+
+  std::shared_ptr<Scene> mScene;
+  std::string mName;
+  BodyType mBodyType{BodyType::eDynamic};
+  Pose mInitialPose;
+  std::array<uint32_t, 4> mCollisionGroups{1, 1, 0, 0};
+
+  bool mAutoInertial{true};
+  float mMass{0.f};
+  Pose mCMassLocalPose;
+  Vec3 mInertia{0.f, 0.f, 0.f};
+};
+
+} // namespace sapien
@@ -1,4 +1,7 @@
 #pragma once
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <vulkan/vulkan.hpp>
@@ -125,13 +128,70 @@ struct CpuArrayHandle {
   std::vector<int> strides;
   std::string type;
   void *ptr{};
+
+  /** keeps the memory at ptr alive, empty if the handle only borrows the memory */
+  std::shared_ptr<void> owner;
+
+  bool isContiguous() const;
+  int bytes() const;
+
+  /** The returned tensor shares ownership of the memory. Tensors of borrowed handles are only
+   *  valid as long as the memory they borrow. */
+  DLManagedTensor *toDLPack() const;
+};
+
+/** Pool of 64-byte aligned host memory. Sizes are rounded up to powers of two and released
+ *  blocks are kept for reuse until the pool holds more than getMaxPooledBytes. */
+class CpuArrayPool : public std::enable_shared_from_this<CpuArrayPool> {
+public:
+  static std::shared_ptr<CpuArrayPool> Get();
+
+  /** the block is returned to the pool when the last reference is released */
+  std::shared_ptr<void> allocate(size_t bytes);
+
+  void setMaxPooledBytes(size_t bytes);
+  size_t getMaxPooledBytes() const { return mMaxPooledBytes; }
+  size_t getPooledBytes() const { return mPooledBytes; }
+
+  /** free all pooled blocks, blocks in use are unaffected */
+  void clear();
+
+  CpuArrayPool() {}
+  CpuArrayPool(CpuArrayPool const &) = delete;
+  CpuArrayPool &operator=(CpuArrayPool const &) = delete;
+  ~CpuArrayPool();
+
+private:
+  void release(void *ptr, size_t bytes);
+  void trim(size_t maxBytes);
+
+  std::mutex mMutex;
+  std::map<size_t, std::vector<void *>> mFreeBlocks;
+  size_t mPooledBytes{0};
+  size_t mMaxPooledBytes{size_t(256) << 20};
 };
 
 struct CpuArray {
+  /** Create uninitialized empty CpuArray */
+  CpuArray() {}
+
+  /** Create CpuArray with uninitialized memory from CpuArrayPool
+   * @param shape shape of the array
+   * @param typestr in numpy typestr format
+   */
+  CpuArray(std::vector<int> shape_, std::string type_);
+
+  /** @return handle sharing ownership of the memory */
+  CpuArrayHandle handle() const;
+
+  /** @return byte size of the array in bytes */
+  int bytes() const;
+
+  void *ptr() const { return data.get(); }
+
   std::vector<int> shape;
   std::string type;
-
-  std::vector<char> data;
+  std::shared_ptr<void> data;
 };
 
 } // namespace sapien
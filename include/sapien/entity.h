@@ -36,6 +36,9 @@ public:
   Pose getPose() const;
   void setPose(Pose const &);
 
+  /** incremented whenever the pose changes, used by systems to skip unchanged entities */
+  uint64_t getPoseVersion() const { return mPoseVersion; }
+
   /** called when added to scene */
   void onAddToScene(Scene &);
 
@@ -59,6 +62,7 @@ public:
 
   // called internally to set the pose of this entity.
   // this function does not propagate to components
+  // the pose version only changes if the pose is different
   void internalSyncPose(Pose const &);
 
   // called internally to swap in python components to replace placeholder components
@@ -77,6 +81,7 @@ protected:
   std::string mName{};
   Scene *mScene{};
   Pose mPose;
+  uint64_t mPoseVersion{0};
   std::vector<std::shared_ptr<Component>> mComponents;
 };
 
@@ -0,0 +1,150 @@
+#pragma once
+#include "bounding_box.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+namespace sapien {
+
+inline bool containsAABB(AABB const &outer, AABB const &inner) {
+  return outer.lower.x <= inner.lower.x && outer.lower.y <= inner.lower.y &&
+         outer.lower.z <= inner.lower.z && inner.upper.x <= outer.upper.x &&
+         inner.upper.y <= outer.upper.y && inner.upper.z <= outer.upper.z;
+}
+
+inline bool overlapsAABB(AABB const &a, AABB const &b) {
+  return a.lower.x <= b.upper.x && b.lower.x <= a.upper.x && a.lower.y <= b.upper.y &&
+         b.lower.y <= a.upper.y && a.lower.z <= b.upper.z && b.lower.z <= a.upper.z;
+}
+
+/** squared distance from a point to the box, 0 inside */
+inline float distance2ToAABB(AABB const &box, Vec3 const &p) {
+  float dx = std::max({box.lower.x - p.x, 0.f, p.x - box.upper.x});
+  float dy = std::max({box.lower.y - p.y, 0.f, p.y - box.upper.y});
+  float dz = std::max({box.lower.z - p.z, 0.f, p.z - box.upper.z});
+  return dx * dx + dy * dy + dz * dz;
+}
+
+/** planes are (a, b, c, d) with a x + b y + c z + d >= 0 on the inner side */
+inline bool isAABBOutsidePlanes(AABB const &box,
+                                std::vector<std::array<float, 4>> const &planes) {
+  for (auto const &n : planes) {
+    float x = n[0] >= 0.f ? box.upper.x : box.lower.x;
+    float y = n[1] >= 0.f ? box.upper.y : box.lower.y;
+    float z = n[2] >= 0.f ? box.upper.z : box.lower.z;
+    if (n[0] * x + n[1] * y + n[2] * z + n[3] < 0.f) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/** Dynamic bounding volume hierarchy over AABBs. Leaves are inserted next to the sibling with
+ *  the lowest surface area cost and the tree is rebalanced with rotations, so insert, remove
+ *  and move are O(log n). Callers usually store enlarged ("fat") boxes and only move a leaf
+ *  when its object leaves the stored box. */
+class AABBTree {
+public:
+  static constexpr int32_t Null = -1;
+
+  /** returns the leaf id, data is returned by queries */
+  int32_t insert(AABB const &box, uint32_t data);
+  void remove(int32_t leaf);
+  void move(int32_t leaf, AABB const &box);
+  void clear();
+
+  AABB const &getAABB(int32_t leaf) const { return mNodes[leaf].box; }
+  uint32_t getData(int32_t leaf) const { return mNodes[leaf].data; }
+  void setData(int32_t leaf, uint32_t data) { mNodes[leaf].data = data; }
+
+  uint32_t getLeafCount() const { return mLeafCount; }
+  int32_t getHeight() const { return mRoot == Null ? 0 : mNodes[mRoot].height; }
+
+  /** visit data of all leaves whose boxes pass test, test is also used to prune internal nodes */
+  template <typename Test, typename Callback> void query(Test &&test, Callback &&callback) const {
+    if (mRoot == Null) {
+      return;
+    }
+    std::vector<int32_t> stack{mRoot};
+    while (!stack.empty()) {
+      auto const &node = mNodes[stack.back()];
+      stack.pop_back();
+      if (!test(node.box)) {
+        continue;
+      }
+      if (node.isLeaf()) {
+        callback(node.data);
+      } else {
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+      }
+    }
+  }
+
+  /** Data of the k leaves closest to point, sorted by distance. distance2(data) returns the
+   *  squared distance of a leaf object and must not be less than the distance to its box. */
+  template <typename Distance>
+  std::vector<std::pair<uint32_t, float>> nearest(Vec3 const &point, uint32_t k,
+                                                  Distance &&distance2) const {
+    std::vector<std::pair<uint32_t, float>> result;
+    if (mRoot == Null || k == 0) {
+      return result;
+    }
+
+    using Item = std::pair<float, int32_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+    auto farther = [](auto const &a, auto const &b) { return a.second < b.second; };
+    open.push({distance2ToAABB(mNodes[mRoot].box, point), mRoot});
+    while (!open.empty()) {
+      auto [d, index] = open.top();
+      open.pop();
+      if (result.size() == k && d >= result.front().second) {
+        break;
+      }
+      auto const &node = mNodes[index];
+      if (node.isLeaf()) {
+        float dl = distance2(node.data);
+        if (result.size() < k) {
+          result.push_back({node.data, dl});
+          std::push_heap(result.begin(), result.end(), farther);
+        } else if (dl < result.front().second) {
+          std::pop_heap(result.begin(), result.end(), farther);
+          result.back() = {node.data, dl};
+          std::push_heap(result.begin(), result.end(), farther);
+        }
+      } else {
+        open.push({distance2ToAABB(mNodes[node.child1].box, point), node.child1});
+        open.push({distance2ToAABB(mNodes[node.child2].box, point), node.child2});
+      }
+    }
+    std::sort_heap(result.begin(), result.end(), farther);
+    return result;
+  }
+
+private:
+  struct Node {
+    AABB box;
+    int32_t parent{Null}; // next free node when not in use
+    int32_t child1{Null};
+    int32_t child2{Null};
+    int32_t height{0}; // leaf is 0, free node is -1
+    uint32_t data{0};
+    bool isLeaf() const { return child1 == Null; }
+  };
+
+  int32_t allocateNode();
+  void freeNode(int32_t index);
+  void insertLeaf(int32_t leaf);
+  void removeLeaf(int32_t leaf);
+  int32_t balance(int32_t index);
+  void refitAncestors(int32_t index);
+
+  std::vector<Node> mNodes;
+  int32_t mRoot{Null};
+  int32_t mFreeList{Null};
+  uint32_t mLeafCount{0};
+};
+
+} // namespace sapien
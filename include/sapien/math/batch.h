@@ -0,0 +1,37 @@
+#pragma once
+#include "./pose.h"
+#include <cstddef>
+
+namespace sapien {
+
+/** Batch kernels over contiguous float arrays. Points are [N, 3], quaternions are [N, 4] in
+ *  (w, x, y, z) order, poses are [N, 7] laid out as (x, y, z, qw, qx, qy, qz), and matrices
+ *  are row-major [N, 4, 4]. Point kernels use AVX2/FMA (selected at runtime) or NEON when
+ *  available and fall back to scalar code otherwise. Input and output may be the same array. */
+
+/** out[i] = pose * (scale * in[i]) */
+void transformPoints(Pose const &pose, Vec3 const &scale, float const *in, float *out,
+                     size_t count);
+void transformPoints(Pose const &pose, float const *in, float *out, size_t count);
+
+/** bounds of pose * (scale * points[i]) without storing the transformed points */
+void computeTransformedBounds(Pose const &pose, Vec3 const &scale, float const *points,
+                              size_t count, Vec3 &lower, Vec3 &upper);
+
+/** out[i] = a[i] * b[i], either a or b may hold a single pose applied to all poses of the other */
+void composePoses(float const *a, size_t countA, float const *b, size_t countB, float *out);
+void invertPoses(float const *poses, float *out, size_t count);
+
+void posesToMatrices(float const *poses, float *matrices, size_t count);
+/** rotations of matrices must be orthonormal, returned quaternions are normalized */
+void matricesToPoses(float const *matrices, float *poses, size_t count);
+
+/** same rotations as QuatToRPY and RPYToQuat, roll and yaw in [-pi, pi], pitch in
+ *  [-pi/2, pi/2] */
+void quatsToRPY(float const *quats, float *rpy, size_t count);
+void rpyToQuats(float const *rpy, float *quats, size_t count);
+
+/** "avx2", "neon" or "scalar" */
+char const *getBatchMathBackend();
+
+} // namespace sapien
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "batch.h"
 #include "pose.h"
 #include <Eigen/Dense>
 
@@ -15,7 +16,7 @@ struct AABB {
   inline OBB getOBB() const;
   inline Vec3 getCenter() const { return (lower + upper) * 0.5f; }
 
-  AABB operator+(AABB const &other) {
+  AABB operator+(AABB const &other) const {
     return {{std::min(other.lower.x, lower.x), std::min(other.lower.y, lower.y),
              std::min(other.lower.z, lower.z)},
             {std::max(other.upper.x, upper.x), std::max(other.upper.y, upper.y),
@@ -31,16 +32,13 @@ struct OBB {
   inline Vec3 getCenter() const { return pose.p; }
 };
 
+/** bounds of vertices scaled in their local frame and then transformed by pose */
 inline AABB computeAABB(Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> const &vertices,
                         Vec3 const &scale, Pose const &pose) {
-  auto R =
-      Eigen::Quaternionf(pose.q.w, pose.q.x, pose.q.y, pose.q.z).normalized().toRotationMatrix();
-  auto points = vertices * R.transpose();
-
-  auto lower = points.colwise().minCoeff();
-  auto upper = points.colwise().maxCoeff();
-  return {.lower = Vec3(lower(0), lower(1), lower(2)) * scale + pose.p,
-          .upper = Vec3(upper(0), upper(1), upper(2)) * scale + pose.p};
+  AABB aabb;
+  computeTransformedBounds(pose, scale, vertices.data(), vertices.rows(), aabb.lower,
+                           aabb.upper);
+  return aabb;
 }
 
 inline AABB computeAABB(Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> const &vertices,
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace sapien {
+
+/** Quadric error simplification (Garland and Heckbert) of a triangle mesh by half-edge
+ *  collapses. Vertices are never moved or created, so the returned triangles index into the
+ *  input vertices and all other vertex attributes stay valid. Boundary edges, including seams
+ *  where vertices are split for uv or normals, are kept in place by boundary quadrics, and
+ *  collapses that flip a triangle or make the mesh non-manifold are rejected.
+ *
+ *  vertices are [vertexCount, 3], triangles are [triangleCount, 3]. Simplification stops when
+ *  at most targetTriangleCount triangles remain or when every remaining collapse would cost
+ *  more than maxError (squared distance to the original surface). */
+std::vector<uint32_t> simplifyMesh(float const *vertices, uint32_t vertexCount,
+                                   uint32_t const *triangles, uint32_t triangleCount,
+                                   uint32_t targetTriangleCount,
+                                   float maxError = std::numeric_limits<float>::infinity());
+
+} // namespace sapien
@@ -4,6 +4,7 @@
 #include <PxPhysicsAPI.h>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -13,6 +14,8 @@ namespace physx {
 
 class PhysxEngine;
 
+/** Caches cooked meshes by canonical path. Loading is thread-safe: meshes are cooked outside
+ *  the lock, so different files can be cooked concurrently */
 class MeshManager {
 public:
   static std::shared_ptr<MeshManager> Get();
@@ -26,6 +29,7 @@ public:
   std::vector<std::shared_ptr<PhysxConvexMesh>> loadConvexMeshGroup(const std::string &filename);
 
 private:
+  std::mutex mMutex;
   std::map<std::string, std::shared_ptr<PhysxTriangleMesh>> mTriangleMeshRegistry;
   std::map<std::string, std::shared_ptr<PhysxConvexMesh>> mConvexMeshRegistry;
   std::map<std::string, std::vector<std::shared_ptr<PhysxConvexMesh>>> mConvexMeshGroupRegistry;
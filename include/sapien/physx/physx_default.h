@@ -22,6 +22,8 @@ struct PhysxSceneConfig {
   bool enableFrictionEveryIteration =
       true;                // better friction calculation, recommended for robotics
   uint32_t cpuWorkers = 0; // CPU workers, 0 for using main thread
+  uint32_t scratchBlockSize = 0; // scratch memory for simulate in bytes, multiple of 16K
+  bool enableScratchAutoGrow = false; // grow scratch memory to fit peak constraint memory
 };
 
 struct PhysxBodyConfig {
@@ -41,6 +43,11 @@ struct PhysxSDFShapeConfig {
   uint32_t numThreadsForConstruction = 4;
 };
 
+struct PhysxAllocatorConfig {
+  bool enableTracking = false; // track PhysX memory per allocation name and per PhysX system
+  bool enablePool = false;     // serve small allocations from pools, implies tracking
+};
+
 class PhysxDefault {
 public:
   static std::shared_ptr<PhysxMaterial> GetDefaultMaterial();
@@ -73,10 +80,21 @@ public:
   static void setSDFShapeConfig(PhysxSDFShapeConfig const &);
   static PhysxSDFShapeConfig getSDFShapeConfig();
 
+  // allocator used by PhysX, must be set before any other code involving PhysX
+  static void setAllocatorConfig(bool enableTracking, bool enablePool);
+  static void setAllocatorConfig(PhysxAllocatorConfig const &);
+  static PhysxAllocatorConfig const &getAllocatorConfig();
+
   // enable GPU simulation, may not be disabled
   static void EnableGPU();
   static bool GetGPUEnabled();
 
+  // forward PhysX internal profile zones (broadphase, narrowphase, solver, ...) to the SAPIEN
+  // profiler, may be toggled at any time for CPU zones; GPU zones are only forwarded if enabled
+  // before the first GPU scene is created
+  static void SetProfilerEnabled(bool enabled);
+  static bool GetProfilerEnabled();
+
   static std::string getPhysxVersion();
 };
 
@@ -2,9 +2,22 @@
 #include <PxPhysicsAPI.h>
 #include <map>
 #include <memory>
+#include <string>
 
 namespace sapien {
 namespace physx {
+
+struct PhysxMemoryStats {
+  bool tracking{}; // false if the allocator was created without tracking, all values are 0
+  uint64_t currentBytes{};
+  uint64_t peakBytes{};
+  uint64_t liveAllocations{};
+  uint64_t totalAllocations{};
+  std::map<std::string, uint64_t> bytesByName; // live bytes per PhysX allocation name
+  uint64_t poolReservedBytes{};                // memory held by small-allocation pools
+  uint64_t poolUsedBytes{};
+};
+
 class PhysxEngine {
 public:
   static std::shared_ptr<PhysxEngine> Get(float toleranceLength = 0.1f,
@@ -12,14 +25,23 @@ public:
 
   static std::shared_ptr<PhysxEngine> GetIfExists();
 
+  // callback forwarding PhysX profile zones to the SAPIEN profiler
+  static ::physx::PxProfilerCallback *GetProfilerCallback();
+
   PhysxEngine(float toleranceLength, float toleranceSpeed);
   ::physx::PxPhysics *getPxPhysics() const { return mPxPhysics; }
 
   ::physx::PxCudaContextManager *getCudaContextManager(int cudaId);
 
+  /** memory allocated by PhysX, see PhysxDefault::setAllocatorConfig */
+  PhysxMemoryStats getMemoryStats() const;
+  /** live bytes attributed to the PhysX system with given memory tag */
+  uint64_t getSystemAllocatedBytes(uint32_t tag) const;
+
   ~PhysxEngine();
 
 private:
+  bool mTrackingAllocator{false};
   ::physx::PxPhysics *mPxPhysics;
   ::physx::PxFoundation *mPxFoundation;
 
@@ -10,6 +10,7 @@
 #include "scene_query.h"
 #include "simulation_callback.hpp"
 #include <PxPhysicsAPI.h>
+#include <deque>
 #include <memory>
 #include <set>
 
@@ -26,6 +27,47 @@ class PhysxRigidDynamicComponent;
 class PhysxRigidStaticComponent;
 class PhysxArticulationLinkComponent;
 
+/** statistics of a single simulation step, counts come from PxSimulationStatistics unless noted
+ */
+struct PhysxStepStatistics {
+  uint64_t step{}; // index of the step these statistics belong to
+
+  uint32_t activeDynamicBodies{};
+  uint32_t activeKinematicBodies{};
+  uint32_t staticBodies{};
+  uint32_t dynamicBodies{};
+  uint32_t kinematicBodies{};
+  uint32_t articulations{};
+  int awakeArticulations{-1}; // -1 when not available (GPU)
+  uint32_t activeConstraints{};
+  uint32_t axisSolverConstraints{};
+
+  uint32_t broadPhaseAdds{};
+  uint32_t broadPhaseRemoves{};
+  uint32_t discreteContactPairs{}; // overlapping shape pairs processed by narrow phase
+  uint32_t discreteContactPairsWithCacheHits{};
+  uint32_t discreteContactPairsWithContacts{};
+  uint32_t newPairs{};
+  uint32_t lostPairs{};
+  uint32_t newTouches{};
+  uint32_t lostTouches{};
+  uint32_t partitions{};
+
+  uint32_t peakConstraintMemory{};
+  uint32_t requiredContactConstraintMemory{};
+  uint32_t compressedContactSize{};
+  uint32_t scratchBlockSize{}; // scratch memory passed to simulate
+  uint32_t scratchGrowCount{}; // times the scratch memory has been grown
+
+  int contactPairs{-1};  // pairs reported to SAPIEN, -1 when not available
+  int contactPoints{-1}; // points reported to SAPIEN, -1 when not available
+
+  // wall time in milliseconds
+  double simulateTime{};
+  double fetchResultsTime{};
+  double syncPoseTime{};
+};
+
 class PhysxSystem : public System {
 
 public:
@@ -65,11 +107,51 @@ public:
   void setSceneCollisionId(int id) { mSceneCollisionId = id; }
   int getSceneCollisionId() const { return mSceneCollisionId; }
 
+  /** live PhysX bytes allocated while creating and stepping this system on the calling thread,
+   * requires a tracking allocator (PhysxDefault::setAllocatorConfig) */
+  uint64_t getAllocatedBytes() const;
+
+  /** size of scratch memory passed to simulate, see PhysxSceneConfig::scratchBlockSize */
+  uint32_t getScratchBlockSize() const { return mScratchBlockSize; }
+  /** reallocate scratch memory between steps, size is rounded up to a multiple of 16K and
+   * clamped below 4G, throws while a GPU step started by stepStart is not finished */
+  void setScratchBlockSize(uint32_t size);
+  /** scratch memory for simulate, nullptr when scratch block size is 0 */
+  void *getScratchBlock() const { return mScratchBlock.get(); }
+
+  /** number of times this system has been simulated, including the initial GPU step */
+  uint64_t getStepCount() const { return mTotalSteps; }
+
+  /** statistics of the last step, only valid until the scene is modified */
+  PhysxStepStatistics getStepStatistics() const;
+
+  /** keep statistics of the last size steps, 0 disables history (default) */
+  void setStepStatisticsHistorySize(uint32_t size);
+  uint32_t getStepStatisticsHistorySize() const { return mStepStatisticsHistorySize; }
+  std::vector<PhysxStepStatistics> getStepStatisticsHistory() const {
+    return {mStepStatisticsHistory.begin(), mStepStatisticsHistory.end()};
+  }
+
   ~PhysxSystem();
 
 protected:
   PhysxSystem();
 
+  /** grow scratch memory after a step if auto grow is enabled */
+  void updateScratchBlock();
+
+  /** fill SAPIEN side counters (contacts, awake articulations) */
+  virtual void fillStepStatistics(PhysxStepStatistics &stats) const {}
+  /** called at the end of each step */
+  void recordStepStatistics();
+
+  uint64_t mTotalSteps{};
+  double mSimulateTime{};
+  double mFetchResultsTime{};
+  double mSyncPoseTime{};
+  uint32_t mStepStatisticsHistorySize{0};
+  std::deque<PhysxStepStatistics> mStepStatisticsHistory;
+
   PhysxSceneConfig mSceneConfig;
   std::shared_ptr<PhysxEngine> mEngine;
 
@@ -79,6 +161,16 @@ protected:
   ::physx::PxDefaultCpuDispatcher *mPxCPUDispatcher;
 
   int mSceneCollisionId{0};
+
+  uint32_t mMemoryTag; // attributes PhysX allocations to this system
+
+  struct ScratchDeleter {
+    void operator()(void *p) const;
+  };
+  std::unique_ptr<void, ScratchDeleter> mScratchBlock;
+  uint32_t mScratchBlockSize{0};
+  bool mSimulating{false}; // PhysX may use the scratch block until fetchResults
+  uint32_t mScratchGrowCount{0};
 };
 
 class PhysxSystemCpu : public PhysxSystem {
@@ -110,6 +202,9 @@ public:
 
   ~PhysxSystemCpu();
 
+protected:
+  void fillStepStatistics(PhysxStepStatistics &stats) const override;
+
 private:
   DefaultEventCallback mSimulationCallback;
 
@@ -246,6 +341,9 @@ public:
 
   ~PhysxSystemGpu();
 
+protected:
+  void fillStepStatistics(PhysxStepStatistics &stats) const override;
+
 private:
   std::shared_ptr<Device> mDevice;
   void ensureCudaDevice();
@@ -256,8 +354,6 @@ private:
   std::set<std::shared_ptr<PhysxRigidStaticComponent>, comp_cmp> mRigidStaticComponents;
   std::set<std::shared_ptr<PhysxArticulationLinkComponent>, comp_cmp> mArticulationLinkComponents;
 
-  uint64_t mTotalSteps{};
-
   bool mGpuInitialized{false};
 
   // cache values updated in gpuInit
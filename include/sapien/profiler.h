@@ -1,4 +1,7 @@
 #pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
 
 namespace sapien {
 
@@ -12,6 +15,50 @@ public:
   ~ProfilerBlock() { ProfilerBlockEnd(); }
 };
 
+/** Built-in CPU profiler
+ *
+ * Blocks are always forwarded to NVTX. While the CPU profiler is running, each thread
+ * additionally appends its blocks to its own event buffer and per-block statistics without
+ * taking locks, which can be exported as a Chrome trace (chrome://tracing or
+ * https://ui.perfetto.dev) or summarized. Block names must outlive the profiler, use
+ * ProfilerInternName for dynamic names.
+ */
+struct ProfilerBlockStats {
+  std::string name;
+  uint64_t count;
+  // all durations are in milliseconds
+  double total;
+  double mean;
+  double min;
+  double max;
+  double p50;
+  double p90;
+  double p99;
+};
+
+void ProfilerStart(uint64_t maxTraceEvents = 1 << 22);
+void ProfilerStop();
+bool ProfilerIsRunning();
+
+/** discard all recorded events and statistics, each thread clears its own buffers the next
+ * time it records */
+void ProfilerReset();
+
+void ProfilerDumpChromeTrace(std::string const &filename);
+
+/** statistics of all recorded blocks, sorted by total time */
+std::vector<ProfilerBlockStats> ProfilerGetSummary();
+std::string ProfilerGetSummaryTable();
+
+/** get a pointer to a copy of name that lives until the program exits */
+char const *ProfilerInternName(std::string const &name);
+
+/** Record a block measured outside of ProfilerBlockBegin/End (e.g. zones started and ended on
+ * different threads). Timestamps come from ProfilerNow, the block is attributed to the calling
+ * thread and ignored when the profiler is not running. */
+int64_t ProfilerNow();
+void ProfilerRecordBlock(char const *name, int64_t begin, int64_t end);
+
 }; // namespace sapien
 
 #define SAPIEN_PROFILE_CONCAT_(prefix, suffix) prefix##suffix
@@ -1,8 +1,10 @@
 #pragma once
 #include "../component.h"
+#include "camera_point_cloud.h"
 #include "image.h"
 #include "sapien/math/mat.h"
 #include "sapien/math/pose.h"
+#include <array>
 #include <map>
 #include <svulkan2/renderer/renderer_base.h>
 #include <svulkan2/scene/camera.h>
@@ -67,11 +69,39 @@ public:
 
   inline CameraMode getMode() const { return mMode; }
 
+  /** world space planes (a, b, c, d) of the view frustum, inside where a x + b y + c z + d >= 0 */
+  std::vector<std::array<float, 4>> getFrustumPlanes() const;
+  /** Hide render objects outside the view frustum while taking pictures, only supported by the
+   *  rasterizer. Culled objects do not cast shadows into the picture. */
+  void setFrustumCulling(bool enable) { mFrustumCulling = enable; }
+  bool getFrustumCulling() const { return mFrustumCulling; }
+  /** number of objects hidden by culling in the last picture */
+  uint32_t getCulledObjectCount() const { return mCulledObjectCount; }
+  /** number of render shapes drawn with a LOD model in the last picture, LOD models are
+   *  selected by SapienRendererSystem::updateLods for perspective cameras on the rasterizer */
+  uint32_t getLodObjectCount() const { return mLodObjectCount; }
+
   void takePicture();
   std::vector<std::string> getImageNames() const;
   SapienRenderImageCpu getImage(std::string const &name);
   SapienRenderImageCuda getImageCuda(std::string const &name);
 
+  /** Point cloud of the rendered pixels from the Position target of the last picture, with the
+   *  Color and Segmentation targets when requested. Points are filtered and transformed on
+   *  options.threadCount threads into a buffer reused across calls. */
+  PointCloud getPointCloud(PointCloudOptions const &options = {});
+
+  /** Targets copied to host memory by every takePicture without blocking. Pictures alternate
+   *  between two staging buffers, so the previous picture can be read while the next one
+   *  renders. An empty list disables async readback. */
+  void setAsyncReadbackTargets(std::vector<std::string> const &names);
+  std::vector<std::string> getAsyncReadbackTargets() const { return mAsyncReadbackTargets; }
+  /** index of the newest picture whose readback has completed, 0 if there is none. With wait,
+   *  blocks until the readback of the last picture taken completes */
+  uint64_t getAsyncFrame(bool wait = false);
+  /** image of a picture returned by getAsyncFrame, only the last two pictures are kept */
+  SapienRenderImageCpu getImageAsync(std::string const &name, uint64_t frame);
+
   // TODO: make the following serializable
   void setProperty(std::string const &name, int property);
   void setProperty(std::string const &name, float property);
@@ -120,6 +150,7 @@ private:
   std::string mShaderDir;
 
   std::map<std::string, std::variant<int, float>> mProperties;
+  std::vector<std::string> mAsyncReadbackTargets;
 
   std::unique_ptr<SapienRenderCameraInternal> mCamera;
   Pose mLocalPose;
@@ -131,6 +162,12 @@ private:
   // this is set to true when GPU resources is available
   bool mGpuInitialized{false};
   int mGpuPoseIndex{-1};
+
+  bool mFrustumCulling{false};
+  uint32_t mCulledObjectCount{0};
+  uint32_t mLodObjectCount{0};
+
+  CpuArray mPointCloudBuffer;
 };
 
 } // namespace sapien_renderer
@@ -0,0 +1,59 @@
+#pragma once
+#include "sapien/array.h"
+#include "sapien/math/pose.h"
+
+namespace sapien {
+namespace sapien_renderer {
+
+enum class PointCloudFrame {
+  eWorld,
+  /** camera frame of the Position target, x right, y up, z back (OpenGL convention) */
+  eCamera
+};
+
+struct PointCloudOptions {
+  PointCloudFrame frame{PointCloudFrame::eWorld};
+  /** also output the Color target of each point */
+  bool color{false};
+  /** also output the Segmentation target of each point */
+  bool segmentation{false};
+
+  /** keep points whose distance along the view direction is within [minDepth, maxDepth],
+   *  maxDepth 0 keeps all rendered points */
+  float minDepth{0.f};
+  float maxDepth{0.f};
+
+  /** keep points whose segmentation channel segmentationLevel (0 for render shapes, 1 for
+   *  entities) is one of the ids, empty keeps all points */
+  std::vector<uint32_t> segmentationIds;
+  uint32_t segmentationLevel{1};
+
+  /** 0 uses all cores */
+  uint32_t threadCount{0};
+};
+
+/** Views into one contiguous buffer. Unrequested outputs have an empty shape. */
+struct PointCloud {
+  /** [N, 3] f4 */
+  CpuArrayHandle points;
+  /** [N, 4] f4 in [0, 1] */
+  CpuArrayHandle colors;
+  /** [N, 4] u4, same channels as the Segmentation target */
+  CpuArrayHandle segmentation;
+};
+
+/** Build a point cloud from camera pictures in one pass.
+ *  @param position [H, W, 4] f4 Position target, xyz in camera frame and w < 1 for rendered
+ *                  pixels
+ *  @param color [H, W, 4] f4 or u1 Color target, required when options.color is set
+ *  @param segmentation [H, W, 4] u4 Segmentation target, required when options.segmentation is
+ *                      set or segmentation ids are given
+ *  @param cameraPose pose of the camera frame in world, used for world frame points
+ *  @param buffer storage of the output, reused when large enough and not referenced elsewhere
+ */
+PointCloud computePointCloud(CpuArrayHandle const &position, CpuArrayHandle const *color,
+                             CpuArrayHandle const *segmentation, Pose const &cameraPose,
+                             PointCloudOptions const &options, CpuArray &buffer);
+
+} // namespace sapien_renderer
+} // namespace sapien
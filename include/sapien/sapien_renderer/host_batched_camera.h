@@ -0,0 +1,47 @@
+#pragma once
+
+#include "./sapien_renderer_system.h"
+
+namespace sapien {
+namespace sapien_renderer {
+
+/** Renders a list of cameras, possibly from different scenes, and copies the chosen render
+ *  targets into one host visible [N, H, W, C] buffer per target. Unlike BatchedCamera it only
+ *  needs Vulkan, so it also works on devices without CUDA such as software rasterizers. */
+class HostBatchedCamera {
+public:
+  HostBatchedCamera(std::vector<std::shared_ptr<SapienRenderCameraComponent>> cameras,
+                    std::vector<std::string> renderTargets);
+  std::vector<std::shared_ptr<SapienRenderCameraComponent>> const &getCameras() const {
+    return mCameras;
+  }
+
+  /** submits all cameras and a single copy, returns without waiting for the GPU */
+  void takePicture();
+  /** waits for the last picture and returns the [N, H, W, C] images of a render target */
+  CpuArrayHandle getPicture(std::string const &name);
+
+  ~HostBatchedCamera();
+
+private:
+  void waitForPicture();
+
+  std::vector<std::shared_ptr<SapienRenderCameraComponent>> mCameras;
+
+  struct Target {
+    std::shared_ptr<svulkan2::core::Buffer> buffer;
+    std::vector<int> shape;
+    std::string type;
+    CpuArray array;
+  };
+  std::map<std::string, Target> mTargets;
+
+  std::unique_ptr<svulkan2::core::CommandPool> mCommandPool;
+  vk::UniqueCommandBuffer mCommandBuffer;
+
+  vk::UniqueSemaphore mSemaphore;
+  uint64_t mFrameCounter{0};
+};
+
+} // namespace sapien_renderer
+} // namespace sapien
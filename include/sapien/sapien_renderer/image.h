@@ -12,7 +12,8 @@ std::string getFormatTypestr(vk::Format format);
 struct SapienRenderImageCpu : public CpuArrayHandle {
   vk::Format format;
 
-  SapienRenderImageCpu(int width, int height, vk::Format format, void *ptr);
+  SapienRenderImageCpu(int width, int height, vk::Format format, void *ptr,
+                       std::shared_ptr<void> owner = nullptr);
 };
 
 struct SapienRenderImageCuda : public CudaArrayHandle {
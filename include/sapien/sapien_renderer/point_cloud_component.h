@@ -28,7 +28,8 @@ public:
   void onAddToScene(Scene &scene) override;
   void onRemoveFromScene(Scene &scene) override;
 
-  void internalUpdate();
+  // called by system to sync pose, returns true if the object is updated
+  bool internalUpdate();
 
   CudaArrayHandle getCudaArray() const;
 
@@ -48,6 +49,9 @@ private:
   std::shared_ptr<svulkan2::resource::SVPointSet> mPointSet;
   svulkan2::scene::PointObject *mObject{};
   Vec3 mScale{1.f};
+
+  // entity pose version written to the object
+  uint64_t mPoseVersion{~0ull};
 };
 
 } // namespace sapien_renderer
@@ -27,9 +27,10 @@ public:
 
   void onAddToScene(Scene &scene) override;
   void onRemoveFromScene(Scene &scene) override;
+  void onSetPose(Pose const &pose) override;
 
-  // called by system to sync pose
-  void internalUpdate();
+  // called by system to sync pose, returns true if the node is updated
+  bool internalUpdate();
 
   svulkan2::scene::Node *internalGetNode() const { return mNode; }
 
@@ -56,6 +57,12 @@ public:
   void enableRenderId();
   bool getRenderIdDisabled() const { return mRenderIdDisabled; }
 
+  /** Static bodies are not checked for pose changes on every render update. Their nodes are
+   *  only updated when added to a scene and when the entity pose is set with setPose, so they
+   *  must not be moved by physics or by unpacking scene poses. */
+  void setStatic(bool isStatic);
+  bool getStatic() const { return mStatic; }
+
   std::shared_ptr<SapienRenderBodyComponent> clone() const;
 
 private:
@@ -66,6 +73,10 @@ private:
   int mShadingMode{0};
 
   bool mRenderIdDisabled{false};
+  bool mStatic{false};
+
+  // entity pose version written to the node
+  uint64_t mPoseVersion{~0ull};
 };
 
 } // namespace sapien_renderer
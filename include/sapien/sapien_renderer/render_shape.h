@@ -44,6 +44,27 @@ public:
 
   inline std::shared_ptr<svulkan2::resource::SVModel> const &getModel() const { return mModel; }
 
+  /** simplified models, level i keeps about lodRatio^(i + 1) of the triangles of the model */
+  std::vector<std::shared_ptr<svulkan2::resource::SVModel>> const &getLodModels() const {
+    return mLodModels;
+  }
+  float getLodRatio() const { return mLodRatio; }
+  void internalSetLodObjects(std::vector<svulkan2::scene::Object *> objects) {
+    mLodObjects = objects;
+    mLodLevel = 0;
+  }
+  std::vector<svulkan2::scene::Object *> const &internalGetLodObjects() const {
+    return mLodObjects;
+  }
+  /** draw LOD object level - 1 instead of the current object, 0 draws the render object. The
+   *  newly drawn object takes over the transparency of the previous one. */
+  void internalSetLodLevel(uint32_t level);
+  uint32_t internalGetLodLevel() const { return mLodLevel; }
+  /** the render object or the LOD object currently drawn for this shape */
+  svulkan2::scene::Object *internalGetDisplayedObject() const {
+    return mLodLevel ? mLodObjects[mLodLevel - 1] : mObject;
+  }
+
   virtual AABB getLocalAABB() = 0;
   virtual AABB getGlobalAABBFast();
   virtual AABB computeGlobalAABBTight();
@@ -57,6 +78,7 @@ public:
   std::shared_ptr<SapienRenderBodyComponent> getParent() const;
 
   void internalSetRenderObject(svulkan2::scene::Object *object) { mObject = object; }
+  svulkan2::scene::Object *internalGetRenderObject() const { return mObject; }
 
   virtual std::shared_ptr<SapienRenderMaterial> getMaterial() const = 0;
   virtual ~RenderShape();
@@ -106,6 +128,11 @@ protected:
   SapienRenderBodyComponent *mParent{nullptr};
   svulkan2::scene::Object *mObject{nullptr};
 
+  std::vector<std::shared_ptr<svulkan2::resource::SVModel>> mLodModels;
+  float mLodRatio{1.f};
+  std::vector<svulkan2::scene::Object *> mLodObjects;
+  uint32_t mLodLevel{0};
+
   int mBatchedPoseIndex{-1};
 };
 
@@ -214,6 +241,13 @@ public:
   Vec3 getScale() const;
   void setScale(Vec3 const &scale);
 
+  /** Generate up to levels levels of detail by quadric simplification, each keeping about
+   *  ratio of the triangles of the previous level. Cameras draw a level based on the projected
+   *  size of the shape. For meshes loaded from files the result is cached in
+   *  SapienRendererDefault::getMeshLodCacheDirectory. Only allowed when not attached to
+   *  component. */
+  void generateLods(uint32_t levels, float ratio = 0.25f);
+
   std::vector<std::shared_ptr<RenderShapeTriangleMeshPart>> getParts() override;
 
   std::shared_ptr<SapienRenderMaterial> getMaterial() const override;
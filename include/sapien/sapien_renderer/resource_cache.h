@@ -0,0 +1,125 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <svulkan2/resource/model.h>
+#include <svulkan2/resource/texture.h>
+
+namespace sapien {
+namespace sapien_renderer {
+
+struct RenderResourceCacheStats {
+  uint32_t modelCount;
+  uint32_t textureCount;
+  uint32_t meshCount;
+  /** entries not referenced outside the cache, these are evicted first */
+  uint32_t unusedCount;
+  /** estimated device memory of all cached resources */
+  uint64_t bytes;
+  uint64_t unusedBytes;
+  uint64_t budget;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+};
+
+/** Deduplicates render meshes and textures by content. Files with identical contents (and
+ *  identical load parameters) share one resource no matter their paths, and meshes with
+ *  identical data from scene files share one mesh. Models share a resource only when the
+ *  materials and buffers they reference are identical as well; this is checked for OBJ and glTF
+ *  files, models in other formats referencing external files are only shared by path. Hash
+ *  matches are confirmed by comparing contents. Entries not referenced outside the cache are
+ *  evicted in least recently used order whenever the cached resources exceed the memory
+ *  budget. */
+class RenderResourceCache {
+public:
+  std::shared_ptr<svulkan2::resource::SVModel> getModel(std::string const &filename);
+  std::shared_ptr<svulkan2::resource::SVTexture>
+  getTexture(std::string const &filename, uint32_t mipLevels, vk::Filter filter,
+             vk::SamplerAddressMode addressMode, bool srgb);
+  /** Decode textures on threadCount worker threads (0 uses all cores), then upload them one by
+   *  one from the calling thread. getTexture with the same files and parameters returns them
+   *  without waiting. KTX2 files holding data in a Vulkan format, such as BCn, skip decoding.
+   *  Prefetched textures are not evicted for the memory budget until they are requested by
+   *  getTexture or dropped by clearUnused. */
+  void prefetchTextures(std::vector<std::string> const &filenames, uint32_t mipLevels,
+                        vk::Filter filter, vk::SamplerAddressMode addressMode, bool srgb,
+                        uint32_t threadCount = 0);
+  /** a cached mesh with the same vertex and index data, or mesh itself after caching it */
+  std::shared_ptr<svulkan2::resource::SVMesh>
+  deduplicateMesh(std::shared_ptr<svulkan2::resource::SVMesh> mesh);
+
+  /** evict unused entries until the estimated memory is within bytes, 0 means unlimited */
+  void setMemoryBudget(uint64_t bytes);
+  uint64_t getMemoryBudget() const { return mBudget; }
+
+  /** evict unused entries until the cache is within its memory budget */
+  void trim();
+  /** wait for pending loads and evict all unused entries, including prefetched textures */
+  void clearUnused();
+
+  RenderResourceCacheStats getStats();
+
+private:
+  enum class Type { eModel, eTexture, eMesh };
+  /** a file a resource is loaded from, reference is its name in the file referencing it */
+  struct Source {
+    std::string reference;
+    std::string path;
+  };
+  struct Entry {
+    Type type;
+    std::shared_ptr<svulkan2::resource::SVModel> model;
+    std::shared_ptr<svulkan2::resource::SVTexture> texture;
+    std::shared_ptr<svulkan2::resource::SVMesh> mesh;
+    std::shared_future<void> loaded;
+    uint64_t bytes{0};
+    // prefetched and not requested yet
+    bool pinned{false};
+    std::list<std::string>::iterator lru;
+
+    std::vector<Source> sources;
+    // files confirmed to hold the same contents as sources
+    std::set<std::string> verified;
+  };
+  struct FileHash {
+    uint64_t size;
+    std::filesystem::file_time_type time;
+    uint64_t hash;
+  };
+
+  uint64_t hashFile(std::string const &filename);
+  /** the model file followed by the external files it references, complete is false for
+   *  formats whose references are not parsed */
+  static std::vector<Source> getModelSources(std::string const &filename, bool &complete);
+  uint64_t hashSources(std::vector<Source> const &sources);
+  /** whether sources hold the contents entry was loaded from, false on a hash collision */
+  bool matches(Entry &entry, std::vector<Source> const &sources);
+  std::pair<std::shared_ptr<svulkan2::resource::SVTexture>, std::shared_future<void>>
+  loadTexture(std::string const &filename, uint32_t mipLevels, vk::Filter filter,
+              vk::SamplerAddressMode addressMode, bool srgb, bool pin);
+  Entry *find(std::string const &key);
+  void insert(std::string const &key, Entry entry);
+  void updateBytes(Entry &entry);
+  bool isUsed(Entry const &entry) const;
+  void evict(uint64_t budget);
+
+  std::mutex mMutex;
+  std::unordered_map<std::string, Entry> mEntries;
+  // most recently used first
+  std::list<std::string> mLru;
+  std::unordered_map<std::string, FileHash> mFileHashes;
+
+  uint64_t mBudget{0};
+  uint64_t mHits{0};
+  uint64_t mMisses{0};
+  uint64_t mEvictions{0};
+};
+
+} // namespace sapien_renderer
+} // namespace sapien
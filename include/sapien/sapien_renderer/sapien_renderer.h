@@ -1,6 +1,7 @@
 #pragma once
 
 #include "camera_component.h"
+#include "camera_point_cloud.h"
 #include "cubemap.h"
 #include "deformable_mesh_component.h"
 #include "image.h"
@@ -10,9 +11,11 @@
 #include "point_cloud_component.h"
 #include "render_body_component.h"
 #include "render_shape.h"
+#include "resource_cache.h"
 #include "sapien_renderer_default.h"
 #include "sapien_renderer_system.h"
 #include "window.h"
 #include "vr.h"
 
 #include "batched_render_system.h"
+#include "host_batched_camera.h"
@@ -37,6 +37,10 @@ public:
   static void setRayTracingDoFAperture(float radius);
   static void setRayTracingDoFPlane(float depth);
   static void setMSAA(int msaa);
+  /** levels of detail generated for every mesh loaded from file, 0 disables */
+  static void setMeshLodLevels(uint32_t levels);
+  /** directory caching simplified indices of meshes loaded from file, empty disables caching */
+  static void setMeshLodCacheDirectory(std::string const &dir);
 
   static std::string getViewerShaderDirectory();
   static std::string getCameraShaderDirectory();
@@ -46,6 +50,8 @@ public:
   static float getRayTracingDoFAperture();
   static float getRayTracingDoFPlane();
   static int getMSAA();
+  static uint32_t getMeshLodLevels();
+  static std::string getMeshLodCacheDirectory();
 
   // TODO: set render target format
   static void setRenderTargetFormat(std::string const &name, vk::Format format);
@@ -67,6 +73,8 @@ public:
   svulkan2::renderer::RTRenderer::DenoiserType rayTracingDenoiserType{
       svulkan2::renderer::RTRenderer::DenoiserType::eNONE};
   int msaa{1};
+  uint32_t meshLodLevels{0};
+  std::string meshLodCacheDirectory{};
 
   float rayTracingDoFAperture = 0.f;
   float rayTracingDoFPlane = 1.f;
@@ -5,6 +5,7 @@
 #include "../system.h"
 #include "cubemap.h"
 #include "sapien/array.h"
+#include "sapien/math/bounding_box.h"
 #include "sapien/math/vec3.h"
 #include <set>
 #include <svulkan2/core/context.h>
@@ -21,6 +22,8 @@ class SapienRenderLightComponent;
 class PointCloudComponent;
 class CudaDeformableMeshComponent;
 class SapienRenderCubemap;
+class RenderShape;
+class RenderResourceCache;
 
 class SapienRenderEngine {
 public:
@@ -32,6 +35,8 @@ public:
   std::shared_ptr<svulkan2::resource::SVResourceManager> getResourceManager() const {
     return mResourceManager;
   }
+  /** meshes and textures loaded from files, deduplicated by content */
+  std::shared_ptr<RenderResourceCache> getResourceCache() const { return mResourceCache; }
 
   std::shared_ptr<svulkan2::resource::SVMesh> getSphereMesh();
   std::shared_ptr<svulkan2::resource::SVMesh> getPlaneMesh();
@@ -47,6 +52,7 @@ private:
   std::shared_ptr<Device> mDevice;
   std::shared_ptr<svulkan2::core::Context> mContext;
   std::shared_ptr<svulkan2::resource::SVResourceManager> mResourceManager;
+  std::shared_ptr<RenderResourceCache> mResourceCache;
 
   std::shared_ptr<svulkan2::resource::SVMesh> mSphereMesh;
   std::shared_ptr<svulkan2::resource::SVMesh> mPlaneMesh;
@@ -94,11 +100,37 @@ public:
                                                                     mRenderLightComponents.end()};
   }
 
+  /** sync render nodes with entity poses, only entities whose poses changed since the last
+   *  step are written to the render scene */
   void step() override;
   std::string getName() const override { return "render"; }
 
+  /** number of render bodies and point clouds whose nodes were updated by the last step */
+  uint32_t getUpdatedNodeCount() const { return mUpdatedNodeCount; }
+
   CudaArrayHandle getTransformCudaArray();
 
+  /** Render objects whose world AABBs are outside any of the planes, see isAABBOutsidePlanes.
+   *  The AABBs are computed at most once per step and shared by all cameras. */
+  std::vector<svulkan2::scene::Object *>
+  cullObjects(std::vector<std::array<float, 4>> const &planes);
+  /** threads used to cull large scenes, 0 uses all cores */
+  void setCullingThreadCount(uint32_t count) { mCullingThreadCount = count; }
+  uint32_t getCullingThreadCount() const { return mCullingThreadCount; }
+
+  /** Draw render shapes with the LOD model matching their size seen from cameraPosition with a
+   *  focal length of focalPixels. A shape keeps full detail while its bounding sphere projects
+   *  larger than LodFullDetailPixels and drops one level each time its projected area shrinks
+   *  by the LOD ratio. Levels persist until changed, so only shapes whose level changes modify
+   *  the scene and force command buffers to be recorded again; the viewer shows the levels of
+   *  the last picture. Returns the number of visible shapes drawn with a LOD model. */
+  uint32_t updateLods(Vec3 const &cameraPosition, float focalPixels);
+  /** draw all render shapes at full detail */
+  void resetLods();
+  /** levels added to the selected LOD level, positive values select coarser models */
+  void setLodBias(float bias) { mLodBias = bias; }
+  float getLodBias() const { return mLodBias; }
+
   ~SapienRendererSystem();
 
   uint64_t nextRenderId() { return mNextRenderId++; };
@@ -110,12 +142,26 @@ private:
   std::shared_ptr<svulkan2::scene::Scene> mScene;
 
   std::set<std::shared_ptr<SapienRenderBodyComponent>, comp_cmp> mRenderBodyComponents;
+  // render bodies checked for pose changes on every step
+  std::set<std::shared_ptr<SapienRenderBodyComponent>, comp_cmp> mMovableRenderBodyComponents;
   std::set<std::shared_ptr<SapienRenderCameraComponent>, comp_cmp> mRenderCameraComponents;
   std::set<std::shared_ptr<SapienRenderLightComponent>, comp_cmp> mRenderLightComponents;
   std::set<std::shared_ptr<PointCloudComponent>, comp_cmp> mPointCloudComponents;
   std::set<std::shared_ptr<CudaDeformableMeshComponent>, comp_cmp> mCudaDeformableMeshComponents;
 
   std::shared_ptr<SapienRenderCubemap> mCubemap;
+
+  uint32_t mUpdatedNodeCount{0};
+
+  void updateCullingItems();
+  struct CullingItem {
+    RenderShape *shape;
+    AABB box;
+  };
+  std::vector<CullingItem> mCullingItems;
+  bool mCullingItemsDirty{true};
+  uint32_t mCullingThreadCount{1};
+  float mLodBias{0.f};
 };
 
 } // namespace sapien_renderer
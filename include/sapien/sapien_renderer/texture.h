@@ -58,6 +58,13 @@ public:
                         AddressMode addressMode, bool srgb);
   explicit SapienRenderTexture2D(std::shared_ptr<svulkan2::resource::SVTexture> tex);
 
+  /** Decode texture files on worker threads and upload them ahead of time, so creating
+   *  textures from these files with the same parameters does not block. threadCount 0 uses all
+   *  cores. KTX2 files storing BCn or other Vulkan formats are uploaded without decoding. */
+  static void Prefetch(std::vector<std::string> const &filenames, uint32_t mipLevels,
+                       FilterMode filterMode, AddressMode addressMode, bool srgb,
+                       uint32_t threadCount = 0);
+
   std::string getFilename() const;
 };
 
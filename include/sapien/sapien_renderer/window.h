@@ -160,7 +160,7 @@ private:
 
   std::unique_ptr<svulkan2::renderer::GuiWindow> mWindow;
 
-  std::unordered_map<std::string, std::vector<char>> mImageBuffers;
+  std::unordered_map<std::string, CpuArray> mImageBuffers;
 
   vk::UniqueSemaphore mSceneRenderSemaphore;
   vk::UniqueFence mSceneRenderFence;
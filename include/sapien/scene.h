@@ -25,6 +25,7 @@ public:
 
   void addSystem(std::shared_ptr<System> system);
   std::shared_ptr<System> getSystem(std::string const &name) const;
+  bool hasSystem(std::string const &name) const { return mSystems.contains(name); }
 
   template <class T> std::shared_ptr<T> getSystemWithType(std::string const &name) const {
     if (auto s = std::dynamic_pointer_cast<T>(getSystem(name))) {
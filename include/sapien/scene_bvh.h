@@ -0,0 +1,70 @@
+#pragma once
+#include "math/aabb_tree.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace sapien {
+class Component;
+class Entity;
+class Scene;
+
+/** Bounding volume hierarchy over the global AABBs of physx rigid bodies or render bodies in a
+ *  scene. The hierarchy is refit before the first query after each physx step: entities whose
+ *  poses changed get new boxes and leaves only move in the tree when a box leaves its enlarged
+ *  copy in the tree. Call update after changing poses, shapes or entities between steps.
+ *
+ *  Query results are indices into getComponents(), valid until the next refit. */
+class SceneBVH {
+public:
+  enum class Source { ePhysx, eRender };
+
+  /** margin enlarges the boxes stored in the tree so small motions do not change the tree */
+  SceneBVH(std::shared_ptr<Scene> scene, Source source = Source::ePhysx, float margin = 0.05f);
+
+  /** add and remove components and recompute all boxes */
+  void update();
+
+  std::vector<std::shared_ptr<Component>> const &getComponents();
+  AABB getAABB(uint32_t index);
+
+  std::vector<uint32_t> queryBox(AABB const &box);
+  std::vector<uint32_t> querySphere(Vec3 const &center, float radius);
+
+  /** planes are (a, b, c, d) with a x + b y + c z + d >= 0 inside the frustum */
+  std::vector<uint32_t> queryFrustum(std::vector<std::array<float, 4>> const &planes);
+
+  /** k components with the closest boxes to point, sorted by distance */
+  std::vector<uint32_t> queryNearest(Vec3 const &point, uint32_t k);
+
+  uint32_t getTreeHeight() const { return mTree.getHeight(); }
+  Source getSource() const { return mSource; }
+  float getMargin() const { return mMargin; }
+
+private:
+  struct Item {
+    Pose pose;
+    AABB box;
+    int32_t leaf;
+  };
+
+  /** synchronize with the scene, force recomputes boxes of entities that did not move */
+  void refit(bool force);
+  void refitIfStepped();
+  AABB computeAABB(Component &component) const;
+  std::shared_ptr<Component> findComponent(Entity &entity) const;
+  AABB fatten(AABB const &box) const;
+  uint64_t getStepCount() const;
+
+  std::shared_ptr<Scene> mScene;
+  Source mSource;
+  float mMargin;
+
+  AABBTree mTree;
+  std::vector<Item> mItems;
+  std::vector<std::shared_ptr<Component>> mComponents;
+  std::unordered_map<Component *, uint32_t> mIndex;
+  uint64_t mStepCount{~0ull};
+};
+
+} // namespace sapien
@@ -0,0 +1,120 @@
+#pragma once
+#include "sapien/math/pose.h"
+#include <Eigen/Dense>
+#include <array>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sapien {
+namespace urdf {
+
+/** Plain description of a URDF file. Poses and sizes are stored unscaled as written in the file,
+ *  file names are resolved to absolute paths when possible */
+
+struct URDFGeometry {
+  enum class Type { eBox, eSphere, eCylinder, eCapsule, eMesh };
+  Type type{Type::eBox};
+
+  /** full size for box, scale for mesh */
+  Vec3 size{1.f, 1.f, 1.f};
+  float radius{0.f};
+  float length{0.f};
+  std::string filename;
+};
+
+struct URDFMaterial {
+  std::string name;
+  std::optional<std::array<float, 4>> color;
+  std::string texture;
+};
+
+struct URDFVisual {
+  std::string name;
+  Pose origin;
+  URDFGeometry geometry;
+  std::optional<URDFMaterial> material;
+};
+
+struct URDFCollision {
+  std::string name;
+  Pose origin;
+  URDFGeometry geometry;
+};
+
+struct URDFInertial {
+  Pose origin;
+  float mass{0.f};
+  Eigen::Matrix3f inertia{Eigen::Matrix3f::Zero()};
+};
+
+struct URDFLink {
+  std::string name;
+  std::optional<URDFInertial> inertial;
+  std::vector<URDFVisual> visuals;
+  std::vector<URDFCollision> collisions;
+};
+
+struct URDFMimic {
+  std::string joint;
+  float multiplier{1.f};
+  float offset{0.f};
+};
+
+struct URDFJoint {
+  std::string name;
+  std::string type;
+  std::string parent;
+  std::string child;
+  Pose origin;
+  Vec3 axis{1.f, 0.f, 0.f};
+  float lower{0.f};
+  float upper{0.f};
+  float friction{0.f};
+  float damping{0.f};
+  std::optional<URDFMimic> mimic;
+};
+
+struct URDFCamera {
+  std::string parent;
+  Pose pose;
+  uint32_t width{0};
+  uint32_t height{0};
+  float near{0.01f};
+  float far{100.f};
+  std::optional<float> fovx;
+  std::optional<float> fovy;
+};
+
+struct URDFRobot {
+  std::string name;
+  std::vector<URDFLink> links;
+  std::vector<URDFJoint> joints;
+  std::vector<URDFCamera> cameras;
+
+  /** link with no parent joint */
+  std::string baseLink;
+
+  URDFLink const &getLink(std::string const &name) const;
+
+  /** nullptr for the base link */
+  URDFJoint const *getParentJoint(std::string const &link) const;
+
+  std::vector<URDFJoint const *> getChildJoints(std::string const &link) const;
+};
+
+/** Parse a URDF string. Relative and package:// paths are resolved against urdfDir and
+ *  packageDir the same way as the Python loader */
+URDFRobot ParseURDF(std::string const &xml, std::string const &urdfDir,
+                    std::string const &packageDir = "");
+
+/** returns pairs of links in <disable_collisions reason="Default"> entries */
+std::vector<std::array<std::string, 2>> ParseSRDF(std::string const &xml);
+
+/** Resolve an asset path in a URDF file. package:// paths are searched in packageDir and then
+ *  in every parent directory of urdfDir. Returns filename unchanged if it cannot be found. */
+std::string FindURDFAsset(std::string const &filename, std::string const &urdfDir,
+                          std::string const &packageDir = "");
+
+} // namespace urdf
+} // namespace sapien
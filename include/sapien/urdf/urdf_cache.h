@@ -0,0 +1,64 @@
+#pragma once
+#include "./urdf.h"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace sapien {
+namespace urdf {
+
+/** Fully resolved URDF file: robot description with absolute asset paths and the collision
+ *  pairs disabled by its SRDF */
+struct URDFDescription {
+  URDFRobot robot;
+  std::vector<std::array<std::string, 2>> ignorePairs;
+};
+
+/** Caches parsed URDF files by (URDF, SRDF, package directory). An entry is reused while the
+ *  modification time and size of both files are unchanged. Otherwise the files are reread and
+ *  the entry is only reparsed if their content hash changed. */
+class URDFCache {
+public:
+  static std::shared_ptr<URDFCache> Get();
+  static void Clear();
+
+  /** srdfFile defaults to the .srdf file next to urdfFile */
+  std::shared_ptr<URDFDescription const> load(std::string const &urdfFile,
+                                              std::string const &srdfFile = "",
+                                              std::string const &packageDir = "");
+
+  /** parse the files without touching the cache */
+  static std::shared_ptr<URDFDescription const> Read(std::string const &urdfFile,
+                                                     std::string const &srdfFile = "",
+                                                     std::string const &packageDir = "");
+
+  uint64_t getHitCount() const { return mHitCount; }
+  uint64_t getMissCount() const { return mMissCount; }
+
+private:
+  struct FileStamp {
+    bool exists{false};
+    int64_t mtime{0};
+    uint64_t size{0};
+    bool operator==(FileStamp const &other) const = default;
+  };
+  static FileStamp Stamp(std::string const &filename);
+
+  struct Entry {
+    FileStamp urdfStamp;
+    FileStamp srdfStamp;
+    uint64_t hash{0};
+    std::shared_ptr<URDFDescription const> description;
+  };
+
+  std::mutex mMutex;
+  std::map<std::tuple<std::string, std::string, std::string>, Entry> mEntries;
+  std::atomic<uint64_t> mHitCount{0};
+  std::atomic<uint64_t> mMissCount{0};
+};
+
+} // namespace urdf
+} // namespace sapien
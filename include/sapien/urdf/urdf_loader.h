@@ -0,0 +1,121 @@
+#pragma once
+#include "./urdf.h"
+#include <map>
+#include <memory>
+#include <tuple>
+
+namespace sapien {
+class Entity;
+class Scene;
+
+namespace physx {
+class PhysxArticulation;
+class PhysxMaterial;
+class PhysxRigidBodyComponent;
+} // namespace physx
+
+namespace sapien_renderer {
+class SapienRenderBodyComponent;
+} // namespace sapien_renderer
+
+namespace urdf {
+struct URDFDescription;
+
+/** Native URDF loader producing the same entities as the Python URDFLoader.
+ *  Collision meshes are cooked and render meshes are loaded in parallel before entities are
+ *  built. Convex decomposition and USD meshes are only supported by the Python loader. */
+class URDFLoader {
+public:
+  URDFLoader() = default;
+
+  void setScene(std::shared_ptr<Scene> scene) { mScene = scene; }
+  std::shared_ptr<Scene> getScene() const { return mScene; }
+
+  void setFixRootLink(bool fix) { mFixRootLink = fix; }
+  bool getFixRootLink() const { return mFixRootLink; }
+
+  void setLoadMultipleCollisionsFromFile(bool enable) { mLoadMultipleCollisions = enable; }
+  bool getLoadMultipleCollisionsFromFile() const { return mLoadMultipleCollisions; }
+
+  void setCollisionIsVisual(bool enable) { mCollisionIsVisual = enable; }
+  bool getCollisionIsVisual() const { return mCollisionIsVisual; }
+
+  void setScale(float scale) { mScale = scale; }
+  float getScale() const { return mScale; }
+
+  /** reuse parsed URDF files from URDFCache across loads */
+  void setUseCache(bool enable) { mUseCache = enable; }
+  bool getUseCache() const { return mUseCache; }
+
+  /** number of threads used to load meshes, 0 uses hardware concurrency */
+  void setMeshLoadThreads(uint32_t count) { mMeshLoadThreads = count; }
+  uint32_t getMeshLoadThreads() const { return mMeshLoadThreads; }
+
+  void setMaterial(float staticFriction, float dynamicFriction, float restitution);
+  void setDensity(float density) { mDensity = density; }
+  void setPatchRadius(float radius) { mPatchRadius = radius; }
+  void setMinPatchRadius(float radius) { mMinPatchRadius = radius; }
+
+  void setLinkMaterial(std::string const &link, float staticFriction, float dynamicFriction,
+                       float restitution);
+  void setLinkDensity(std::string const &link, float density) { mLinkDensity[link] = density; }
+  void setLinkPatchRadius(std::string const &link, float radius) {
+    mLinkPatchRadius[link] = radius;
+  }
+  void setLinkMinPatchRadius(std::string const &link, float radius) {
+    mLinkMinPatchRadius[link] = radius;
+  }
+
+  /** Load all articulations and single-link actors in the URDF file and add them to the scene.
+   *  srdfFile defaults to the .srdf file next to urdfFile. */
+  std::tuple<std::vector<std::shared_ptr<physx::PhysxArticulation>>,
+             std::vector<std::shared_ptr<Entity>>>
+  loadMultiple(std::string const &urdfFile, std::string const &srdfFile = "",
+               std::string const &packageDir = "");
+
+  /** Load a URDF file containing exactly one articulation */
+  std::shared_ptr<physx::PhysxArticulation> load(std::string const &urdfFile,
+                                                 std::string const &srdfFile = "",
+                                                 std::string const &packageDir = "");
+
+  /** Same as loadMultiple with an already parsed robot */
+  std::tuple<std::vector<std::shared_ptr<physx::PhysxArticulation>>,
+             std::vector<std::shared_ptr<Entity>>>
+  loadRobot(URDFRobot const &robot, std::vector<std::array<std::string, 2>> const &ignorePairs);
+
+private:
+  std::shared_ptr<physx::PhysxMaterial> getMaterial(std::string const &link) const;
+  float getDensity(std::string const &link) const;
+  float getPatchRadius(std::string const &link) const;
+  float getMinPatchRadius(std::string const &link) const;
+
+  std::shared_ptr<URDFDescription const> readDescription(std::string const &urdfFile,
+                                                         std::string const &srdfFile,
+                                                         std::string const &packageDir) const;
+  void preloadMeshes(URDFRobot const &robot) const;
+  void buildCollisions(URDFLink const &link, physx::PhysxRigidBodyComponent &body,
+                       std::array<uint32_t, 4> const &collisionGroups) const;
+  std::shared_ptr<sapien_renderer::SapienRenderBodyComponent>
+  buildVisuals(URDFLink const &link) const;
+
+  std::shared_ptr<Scene> mScene;
+
+  bool mFixRootLink{true};
+  bool mLoadMultipleCollisions{false};
+  bool mCollisionIsVisual{false};
+  float mScale{1.f};
+  bool mUseCache{true};
+  uint32_t mMeshLoadThreads{0};
+
+  std::shared_ptr<physx::PhysxMaterial> mMaterial;
+  float mDensity{1000.f};
+  float mPatchRadius{0.f};
+  float mMinPatchRadius{0.f};
+  std::map<std::string, std::shared_ptr<physx::PhysxMaterial>> mLinkMaterial;
+  std::map<std::string, float> mLinkDensity;
+  std::map<std::string, float> mLinkPatchRadius;
+  std::map<std::string, float> mLinkMinPatchRadius;
+};
+
+} // namespace urdf
+} // namespace sapien
@@ -0,0 +1,88 @@
+#pragma once
+#include "sapien/array.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <thread>
+
+namespace sapien {
+
+/** Writes image sequences to disk on background threads.
+ *
+ *  Images are copied when added, so cameras may reuse their buffers immediately. Encoding runs
+ *  on a pool of worker threads; when maxQueuedFrames images are waiting, addImage blocks until
+ *  a worker takes one. Errors raised by workers are rethrown by the next addImage or flush.
+ *
+ *  Each stream name gets its own sequence: directory/name/<frame>.png|exr|npy, or a single
+ *  directory/name.bin container for eBIN. */
+class FrameRecorder {
+public:
+  /** ePNG: u1 and u2 images with 1, 2, 3 or 4 channels, f4 images in [0, 1] are stored as 8 bit
+   *  eEXR: uncompressed f4, u4 and i4 images (i4 is stored as unsigned)
+   *  eNPY: any image, one .npy file per frame
+   *  eBIN: any image, records appended to one file per stream in the order addImage was called
+   *        for that stream. Every record is a uint64 frame index, a uint32 typestr length and
+   *        the typestr, a uint32 dimension count, uint32 dimensions and the contiguous image
+   *        data. */
+  enum class Format { ePNG, eEXR, eNPY, eBIN };
+
+  /** threadCount 0 uses all cores */
+  FrameRecorder(std::string directory, Format format, uint32_t threadCount = 0,
+                uint32_t maxQueuedFrames = 16);
+
+  /** Queue image [H, W] or [H, W, C] as frame of stream name. Image batches [N, H, W, C] are
+   *  written to streams name_0 to name_(N-1). */
+  void addImage(std::string const &name, uint64_t frame, CpuArrayHandle const &image);
+
+  /** block until all queued images are written */
+  void flush();
+
+  uint32_t getQueuedFrameCount();
+  uint64_t getWrittenFrameCount();
+
+  FrameRecorder(FrameRecorder const &) = delete;
+  FrameRecorder &operator=(FrameRecorder const &) = delete;
+  ~FrameRecorder();
+
+private:
+  struct Job {
+    std::string name;
+    uint64_t frame;
+    CpuArray image;
+    uint64_t sequence; // position in the eBIN stream
+  };
+
+  void work();
+  void write(Job const &job);
+  void rethrow();
+
+  std::string mDirectory;
+  Format mFormat;
+  uint32_t mMaxQueuedFrames;
+
+  std::mutex mMutex;
+  std::condition_variable mJobAdded;
+  std::condition_variable mJobTaken;
+  std::condition_variable mJobDone;
+  std::deque<Job> mJobs;
+  uint32_t mActiveJobs{0};
+  uint64_t mWrittenFrames{0};
+  bool mStopping{false};
+  std::exception_ptr mError;
+
+  // eBIN containers, workers append records in sequence order
+  struct Container {
+    uint64_t queued{0}; // guarded by mMutex
+    std::mutex mutex;
+    std::condition_variable written;
+    uint64_t next{0};
+    std::ofstream file;
+  };
+  std::map<std::string, std::unique_ptr<Container>> mContainers;
+
+  std::vector<std::thread> mThreads;
+};
+
+} // namespace sapien
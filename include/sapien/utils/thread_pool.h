@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sapien {
+
+/** Worker threads shared by short data parallel loops (culling, point clouds, asset loading).
+ *
+ *  Workers are started on first use and live until the program exits, so loops do not pay for
+ *  creating and joining threads. The calling thread always works on its own loop, which keeps
+ *  nested loops and loops started from workers from waiting on busy workers. */
+class ThreadPool {
+public:
+  static ThreadPool &Get();
+
+  explicit ThreadPool(uint32_t workerCount);
+  uint32_t getWorkerCount() const { return mThreads.size(); }
+
+  /** Call f(task) for every task in [0, taskCount) on at most maxThreads threads including the
+   *  calling thread, 0 uses all workers. Returns when all tasks are done and rethrows the first
+   *  exception thrown by a task. */
+  void parallelFor(uint32_t taskCount, uint32_t maxThreads,
+                   std::function<void(uint32_t)> const &f);
+
+  ThreadPool(ThreadPool const &) = delete;
+  ThreadPool &operator=(ThreadPool const &) = delete;
+  ~ThreadPool();
+
+private:
+  struct Job {
+    std::function<void(uint32_t)> const *f;
+    uint32_t taskCount;
+    uint32_t helperLimit;
+    uint32_t helpers{0}; // guarded by mMutex
+    std::atomic<uint32_t> nextTask{0};
+    std::atomic<uint32_t> doneTasks{0};
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+  };
+
+  void work();
+  static void run(Job &job);
+
+  std::mutex mMutex;
+  std::condition_variable mJobAdded;
+  std::deque<std::shared_ptr<Job>> mJobs;
+  bool mStopping{false};
+
+  std::vector<std::thread> mThreads;
+};
+
+} // namespace sapien
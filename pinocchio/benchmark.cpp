@@ -0,0 +1,105 @@
+#include "pinocchio_model.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <sstream>
+
+// count every heap allocation made by the process
+static std::atomic<uint64_t> gAllocationCount{0};
+
+void *operator new(std::size_t size) {
+  ++gAllocationCount;
+  if (void *p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+using namespace sapien;
+
+static std::string chainURDF(int dof) {
+  std::ostringstream ss;
+  ss << "<robot name=\"chain\">";
+  for (int i = 0; i <= dof; ++i) {
+    ss << "<link name=\"link_" << i << "\"><inertial><mass value=\"1\"/>"
+       << "<inertia ixx=\"0.01\" ixy=\"0\" ixz=\"0\" iyy=\"0.01\" iyz=\"0\" izz=\"0.01\"/>"
+       << "</inertial></link>";
+  }
+  for (int i = 0; i < dof; ++i) {
+    ss << "<joint name=\"joint_" << i + 1 << "\" type=\"revolute\">"
+       << "<parent link=\"link_" << i << "\"/><child link=\"link_" << i + 1 << "\"/>"
+       << "<origin xyz=\"0 0 0.1\" rpy=\"0 0 0\"/><axis xyz=\"" << (i % 2) << " " << (1 - i % 2)
+       << " 0\"/><limit lower=\"-3\" upper=\"3\" effort=\"1\" velocity=\"1\"/></joint>";
+  }
+  ss << "</robot>";
+  return ss.str();
+}
+
+static bool run(char const *name, int iterations, std::function<void()> const &f) {
+  f(); // warm up
+  uint64_t allocations = gAllocationCount;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    f();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  allocations = gAllocationCount - allocations;
+  double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+  double perCall = static_cast<double>(allocations) / iterations;
+  std::printf("%-40s %10.1f ns/call %8.2f allocations/call\n", name, ns, perCall);
+  return allocations == 0;
+}
+
+int main(int argc, char **argv) {
+  int dof = argc > 1 ? std::atoi(argv[1]) : 7;
+  int iterations = argc > 2 ? std::atoi(argv[2]) : 10000;
+
+  auto model = PinocchioModel::fromURDFXML(chainURDF(dof), {0, 0, -9.81});
+  std::vector<std::string> joints, links;
+  for (int i = dof; i >= 1; --i) {
+    joints.push_back("joint_" + std::to_string(i));
+  }
+  for (int i = 0; i <= dof; ++i) {
+    links.push_back("link_" + std::to_string(i));
+  }
+  model->setJointOrder(joints);
+  model->setLinkOrder(links);
+
+  Eigen::VectorXd qpos = Eigen::VectorXd::Random(dof);
+  Eigen::VectorXd qvel = Eigen::VectorXd::Random(dof);
+  Eigen::VectorXd qacc = Eigen::VectorXd::Random(dof);
+  Eigen::VectorXd vec(dof);
+  Eigen::MatrixXd mat(dof, dof);
+  Eigen::Matrix<double, 6, Eigen::Dynamic> J(6, dof);
+
+  bool ok = true;
+  ok &= run("computeForwardKinematics", iterations,
+            [&]() { model->computeForwardKinematics(qpos); });
+  ok &= run("getLinkPose", iterations, [&]() { model->getLinkPose(dof); });
+  ok &= run("computeFullJacobian", iterations, [&]() { model->computeFullJacobian(qpos); });
+  ok &= run("getLinkJacobian(out)", iterations, [&]() { model->getLinkJacobian(dof, J, true); });
+  ok &= run("computeSingleLinkLocalJacobian(out)", iterations,
+            [&]() { model->computeSingleLinkLocalJacobian(qpos, dof, J); });
+  ok &= run("computeGeneralizedMassMatrix(out)", iterations,
+            [&]() { model->computeGeneralizedMassMatrix(qpos, mat); });
+  ok &= run("computeCoriolisMatrix(out)", iterations,
+            [&]() { model->computeCoriolisMatrix(qpos, qvel, mat); });
+  ok &= run("computeInverseDynamics(out)", iterations,
+            [&]() { model->computeInverseDynamics(qpos, qvel, qacc, vec); });
+  ok &= run("computeForwardDynamics(out)", iterations,
+            [&]() { model->computeForwardDynamics(qpos, qvel, qacc, vec); });
+
+  if (!ok) {
+    std::printf("FAILED: heap allocations detected in allocation-free calls\n");
+    return 1;
+  }
+  return 0;
+}
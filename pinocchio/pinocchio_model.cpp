@@ -3,9 +3,23 @@
 #include <pinocchio/algorithm/crba.hpp>
 #include <pinocchio/algorithm/joint-configuration.hpp>
 #include <pinocchio/algorithm/rnea.hpp>
+#include <pinocchio/serialization/eigen.hpp>
+#include <pinocchio/serialization/model.hpp>
 
+#include <boost/archive/archive_exception.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <fstream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <tuple>
 
+#ifndef SAPIEN_PINOCCHIO_NO_PYTHON
 #define PYBIND11_USE_SMART_HOLDER_AS_DEFAULT 1
 #include <pybind11/eigen.h>
 #include <pybind11/functional.h>
@@ -13,6 +27,7 @@
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#endif
 
 #define ASSERT(exp, info)                                                                         \
   if (!(exp)) {                                                                                   \
@@ -20,18 +35,137 @@
   }
 
 namespace sapien {
+
+static constexpr char const *gBinaryMagic = "SAPIEN_PINOCCHIO";
+static constexpr uint32_t gBinaryVersion = 1;
+
+using ModelCacheKey = std::tuple<std::string, double, double, double>;
+static std::map<ModelCacheKey, std::weak_ptr<pinocchio::Model const>> gModelCache;
+static std::mutex gModelCacheLock;
+
 std::unique_ptr<PinocchioModel> PinocchioModel::fromURDFXML(std::string const &urdf,
                                                             Eigen::Vector3d gravity) {
-  auto m = std::unique_ptr<PinocchioModel>(new PinocchioModel);
-  pinocchio::urdf::buildModelFromXML(urdf, m->model);
-  m->model.gravity = {gravity, Eigen::Vector3d{0, 0, 0}};
-  m->data = pinocchio::Data(m->model);
-  m->indexS2P.setIdentity(m->model.nv);
-  return m;
+  ModelCacheKey key{urdf, gravity.x(), gravity.y(), gravity.z()};
+
+  std::shared_ptr<pinocchio::Model const> model;
+  {
+    std::lock_guard lock(gModelCacheLock);
+    auto it = gModelCache.find(key);
+    if (it != gModelCache.end()) {
+      model = it->second.lock();
+    }
+    if (!model) {
+      auto m = std::make_shared<pinocchio::Model>();
+      pinocchio::urdf::buildModelFromXML(urdf, *m);
+      m->gravity = {gravity, Eigen::Vector3d{0, 0, 0}};
+      model = m;
+      // entries hold the URDF text, so expired ones are dropped before the cache grows
+      std::erase_if(gModelCache, [](auto const &item) { return item.second.expired(); });
+      gModelCache[key] = model;
+    }
+  }
+
+  auto result = std::unique_ptr<PinocchioModel>(new PinocchioModel(model));
+  return result;
+}
+
+size_t PinocchioModel::PruneModelCache() {
+  std::lock_guard lock(gModelCacheLock);
+  std::erase_if(gModelCache, [](auto const &item) { return item.second.expired(); });
+  return gModelCache.size();
+}
+
+std::string PinocchioModel::saveBinary() const {
+  std::ostringstream ss(std::ios::binary);
+  {
+    boost::archive::binary_oarchive oa(ss);
+    std::string magic = gBinaryMagic;
+    uint32_t version = gBinaryVersion;
+    oa << magic << version << model << indexS2P << QIDX << NQ << NV << linkIdx2FrameIdx;
+  }
+  return ss.str();
+}
+
+std::unique_ptr<PinocchioModel> PinocchioModel::fromBinary(std::string const &buffer) {
+  auto model = std::make_shared<pinocchio::Model>();
+  Eigen::VectorXi s2p, qidx, nq, nv;
+  std::vector<int> linkIdx2FrameIdx;
+  try {
+    std::istringstream ss(buffer, std::ios::binary);
+    boost::archive::binary_iarchive ia(ss);
+
+    std::string magic;
+    uint32_t version;
+    ia >> magic >> version;
+    if (magic != gBinaryMagic || version != gBinaryVersion) {
+      throw std::runtime_error("failed to load pinocchio model: invalid or incompatible data");
+    }
+    ia >> *model >> s2p >> qidx >> nq >> nv >> linkIdx2FrameIdx;
+  } catch (boost::archive::archive_exception const &e) {
+    throw std::runtime_error(std::string("failed to load pinocchio model: ") + e.what());
+  }
+
+  // the tables index into the model without bound checks, so they must agree with it
+  ASSERT(s2p.size() == model->nv, "failed to load pinocchio model: corrupted joint order");
+  std::vector<bool> seen(model->nv, false);
+  for (Eigen::Index i = 0; i < s2p.size(); ++i) {
+    ASSERT(s2p[i] >= 0 && s2p[i] < model->nv && !seen[s2p[i]],
+           "failed to load pinocchio model: corrupted joint order");
+    seen[s2p[i]] = true;
+  }
+
+  ASSERT(nq.size() == qidx.size() && nv.size() == qidx.size(),
+         "failed to load pinocchio model: corrupted joint tables");
+  int dofs = 0;
+  for (Eigen::Index N = 0; N < qidx.size(); ++N) {
+    ASSERT(qidx[N] >= 0 && nq[N] >= 0 && nv[N] >= 0 && qidx[N] + nq[N] <= model->nq,
+           "failed to load pinocchio model: corrupted joint tables");
+    dofs += nv[N];
+  }
+  ASSERT(qidx.size() == 0 || dofs == model->nv,
+         "failed to load pinocchio model: corrupted joint tables");
+
+  for (int frame : linkIdx2FrameIdx) {
+    ASSERT(frame >= 0 && frame < model->nframes,
+           "failed to load pinocchio model: corrupted link order");
+  }
+
+  auto result = std::unique_ptr<PinocchioModel>(new PinocchioModel(model));
+  result->indexS2P = s2p;
+  result->QIDX = qidx;
+  result->NQ = nq;
+  result->NV = nv;
+  result->linkIdx2FrameIdx = linkIdx2FrameIdx;
+  return result;
 }
 
-Eigen::VectorXd PinocchioModel::posS2P(const Eigen::VectorXd &qext) {
-  Eigen::VectorXd qint(model.nq);
+void PinocchioModel::saveBinaryFile(std::string const &filename) const {
+  std::ofstream f(filename, std::ios::binary);
+  if (!f) {
+    throw std::runtime_error("failed to open file for writing: " + filename);
+  }
+  auto buffer = saveBinary();
+  f.write(buffer.data(), buffer.size());
+}
+
+std::unique_ptr<PinocchioModel> PinocchioModel::fromBinaryFile(std::string const &filename) {
+  std::ifstream f(filename, std::ios::binary);
+  if (!f) {
+    throw std::runtime_error("failed to open file for reading: " + filename);
+  }
+  std::ostringstream ss;
+  ss << f.rdbuf();
+  return fromBinary(ss.str());
+}
+
+PinocchioModel::PinocchioModel(std::shared_ptr<pinocchio::Model const> m)
+    : modelHolder(std::move(m)), model(*modelHolder), data(model),
+      indexS2P(Eigen::VectorXi::LinSpaced(model.nv, 0, model.nv - 1)), mQpos(model.nq),
+      mQvel(model.nv), mQacc(model.nv), mJacobian(6, model.nv), mJacobianLocal(6, model.nv) {}
+
+void PinocchioModel::posS2P(Eigen::Ref<const Eigen::VectorXd> qext,
+                            Eigen::Ref<Eigen::VectorXd> qint) const {
+  ASSERT(qint.size() == model.nq, "posS2P failed: invalid output size");
   uint32_t count = 0;
   for (Eigen::Index N = 0; N < QIDX.size(); ++N) {
     auto start_idx = QIDX[N];
@@ -52,12 +186,11 @@ Eigen::VectorXd PinocchioModel::posS2P(const Eigen::VectorXd &qext) {
     count += NV[N];
   }
   ASSERT(count == qext.size(), "posS2P failed");
-  return qint;
 }
 
-Eigen::VectorXd PinocchioModel::posP2S(const Eigen::VectorXd &qint) {
-  Eigen::VectorXd qext(model.nv);
-
+void PinocchioModel::posP2S(Eigen::Ref<const Eigen::VectorXd> qint,
+                            Eigen::Ref<Eigen::VectorXd> qext) const {
+  ASSERT(qext.size() == model.nv, "posP2S failed: invalid output size");
   int count = 0;
   for (Eigen::Index N = 0; N < QIDX.size(); ++N) {
     auto start_idx = QIDX[N];
@@ -77,7 +210,22 @@ Eigen::VectorXd PinocchioModel::posP2S(const Eigen::VectorXd &qint) {
     count += NV[N];
   }
   ASSERT(count == model.nv, "posP2S failed");
-  return qext;
+}
+
+void PinocchioModel::velS2P(Eigen::Ref<const Eigen::VectorXd> vext,
+                            Eigen::Ref<Eigen::VectorXd> vint) const {
+  ASSERT(vext.size() == indexS2P.size(), "velS2P failed: invalid input size");
+  for (Eigen::Index i = 0; i < indexS2P.size(); ++i) {
+    vint[indexS2P[i]] = vext[i];
+  }
+}
+
+void PinocchioModel::velP2S(Eigen::Ref<const Eigen::VectorXd> vint,
+                            Eigen::Ref<Eigen::VectorXd> vext) const {
+  ASSERT(vext.size() == indexS2P.size(), "velP2S failed: invalid output size");
+  for (Eigen::Index i = 0; i < indexS2P.size(); ++i) {
+    vext[i] = vint[indexS2P[i]];
+  }
 }
 
 void PinocchioModel::setJointOrder(std::vector<std::string> names) {
@@ -95,7 +243,7 @@ void PinocchioModel::setJointOrder(std::vector<std::string> names) {
     }
   }
   ASSERT(count == model.nv, "setJointOrder failed");
-  indexS2P = Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic>(v);
+  indexS2P = v;
 
   QIDX = Eigen::VectorXi(names.size());
   NQ = Eigen::VectorXi(names.size());
@@ -124,11 +272,14 @@ void PinocchioModel::setLinkOrder(std::vector<std::string> names) {
 }
 
 Eigen::MatrixXd PinocchioModel::getRandomConfiguration() {
-  return posP2S(pinocchio::randomConfiguration(model));
+  Eigen::VectorXd result(model.nv);
+  posP2S(pinocchio::randomConfiguration(model), result);
+  return result;
 }
 
-void PinocchioModel::computeForwardKinematics(const Eigen::VectorXd &qpos) {
-  pinocchio::forwardKinematics(model, data, posS2P(qpos));
+void PinocchioModel::computeForwardKinematics(Eigen::Ref<const Eigen::VectorXd> qpos) {
+  posS2P(qpos, mQpos);
+  pinocchio::forwardKinematics(model, data, mQpos);
 }
 
 Pose PinocchioModel::getLinkPose(uint32_t index) {
@@ -144,69 +295,138 @@ Pose PinocchioModel::getLinkPose(uint32_t index) {
   return {Vec3(P.x(), P.y(), P.z()), Quat(Q.w(), Q.x(), Q.y(), Q.z())};
 }
 
-void PinocchioModel::computeFullJacobian(const Eigen::VectorXd &qpos) {
-  pinocchio::computeJointJacobians(model, data, posS2P(qpos));
+void PinocchioModel::computeFullJacobian(Eigen::Ref<const Eigen::VectorXd> qpos) {
+  posS2P(qpos, mQpos);
+  pinocchio::computeJointJacobians(model, data, mQpos);
 }
 
 Eigen::Matrix<double, 6, Eigen::Dynamic> PinocchioModel::getLinkJacobian(uint32_t index,
                                                                          bool local) {
+  Eigen::Matrix<double, 6, Eigen::Dynamic> J(6, model.nv);
+  getLinkJacobian(index, J, local);
+  return J;
+}
+
+void PinocchioModel::getLinkJacobian(uint32_t index,
+                                     Eigen::Ref<Eigen::Matrix<double, 6, Eigen::Dynamic>> out,
+                                     bool local) {
   ASSERT(index < linkIdx2FrameIdx.size(), "link index out of bound");
+  ASSERT(out.cols() == model.nv, "getLinkJacobian failed: invalid output size");
   auto frameIdx = linkIdx2FrameIdx[index];
   auto jointIdx = model.frames[frameIdx].parent;
 
-  auto link2joint = model.frames[frameIdx].placement;
-  auto joint2world = data.oMi[jointIdx];
-  auto link2world = joint2world * link2joint;
-
-  Eigen::Matrix<double, 6, Eigen::Dynamic> J(6, model.nv);
-  J.fill(0);
+  mJacobian.setZero();
+  pinocchio::getJointJacobian(model, data, jointIdx, pinocchio::ReferenceFrame::WORLD, mJacobian);
 
-  pinocchio::getJointJacobian(model, data, jointIdx, pinocchio::ReferenceFrame::WORLD, J);
+  auto *J = &mJacobian;
   if (local) {
-    J = link2world.toActionMatrixInverse() * J;
+    auto link2world = data.oMi[jointIdx] * model.frames[frameIdx].placement;
+    mJacobianLocal.noalias() = link2world.toActionMatrixInverse() * mJacobian;
+    J = &mJacobianLocal;
+  }
+
+  // gather columns to SAPIEN order
+  for (Eigen::Index i = 0; i < indexS2P.size(); ++i) {
+    out.col(i) = J->col(indexS2P[i]);
   }
-  // permute Jacobin to SAPIEN format
-  return J * indexS2P;
 }
 
 Eigen::Matrix<double, 6, Eigen::Dynamic>
-PinocchioModel::computeSingleLinkLocalJacobian(Eigen::VectorXd const &qpos, uint32_t index) {
+PinocchioModel::computeSingleLinkLocalJacobian(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                               uint32_t index) {
+  Eigen::Matrix<double, 6, Eigen::Dynamic> J(6, model.nv);
+  computeSingleLinkLocalJacobian(qpos, index, J);
+  return J;
+}
+
+void PinocchioModel::computeSingleLinkLocalJacobian(
+    Eigen::Ref<const Eigen::VectorXd> qpos, uint32_t index,
+    Eigen::Ref<Eigen::Matrix<double, 6, Eigen::Dynamic>> out) {
   ASSERT(index < linkIdx2FrameIdx.size(), "link index out of bound");
+  ASSERT(out.cols() == model.nv, "computeSingleLinkLocalJacobian failed: invalid output size");
   auto frameIdx = linkIdx2FrameIdx[index];
   auto jointIdx = model.frames[frameIdx].parent;
   auto link2joint = model.frames[frameIdx].placement;
 
-  Eigen::Matrix<double, 6, Eigen::Dynamic> J(6, model.nv);
-  J.fill(0);
-  pinocchio::computeJointJacobian(model, data, posS2P(qpos), jointIdx, J);
-  return link2joint.toActionMatrixInverse() * J * indexS2P;
+  posS2P(qpos, mQpos);
+  mJacobian.setZero();
+  pinocchio::computeJointJacobian(model, data, mQpos, jointIdx, mJacobian);
+  mJacobianLocal.noalias() = link2joint.toActionMatrixInverse() * mJacobian;
+
+  for (Eigen::Index i = 0; i < indexS2P.size(); ++i) {
+    out.col(i) = mJacobianLocal.col(indexS2P[i]);
+  }
+}
+
+Eigen::MatrixXd
+PinocchioModel::computeGeneralizedMassMatrix(Eigen::Ref<const Eigen::VectorXd> qpos) {
+  Eigen::MatrixXd M(model.nv, model.nv);
+  computeGeneralizedMassMatrix(qpos, M);
+  return M;
 }
 
-Eigen::MatrixXd PinocchioModel::computeGeneralizedMassMatrix(const Eigen::VectorXd &qpos) {
-  pinocchio::crba(model, data, posS2P(qpos));
+void PinocchioModel::computeGeneralizedMassMatrix(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                                  Eigen::Ref<Eigen::MatrixXd> out) {
+  ASSERT(out.rows() == model.nv && out.cols() == model.nv,
+         "computeGeneralizedMassMatrix failed: invalid output size");
+  posS2P(qpos, mQpos);
+  pinocchio::crba(model, data, mQpos);
   data.M.triangularView<Eigen::StrictlyLower>() =
       data.M.transpose().triangularView<Eigen::StrictlyLower>();
-  return indexS2P.transpose() * data.M * indexS2P;
+  out = data.M(indexS2P, indexS2P);
+}
+
+Eigen::MatrixXd PinocchioModel::computeCoriolisMatrix(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                                      Eigen::Ref<const Eigen::VectorXd> qvel) {
+  Eigen::MatrixXd C(model.nv, model.nv);
+  computeCoriolisMatrix(qpos, qvel, C);
+  return C;
+}
+
+void PinocchioModel::computeCoriolisMatrix(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                           Eigen::Ref<const Eigen::VectorXd> qvel,
+                                           Eigen::Ref<Eigen::MatrixXd> out) {
+  ASSERT(out.rows() == model.nv && out.cols() == model.nv,
+         "computeCoriolisMatrix failed: invalid output size");
+  posS2P(qpos, mQpos);
+  velS2P(qvel, mQvel);
+  out = pinocchio::computeCoriolisMatrix(model, data, mQpos, mQvel)(indexS2P, indexS2P);
+}
+
+Eigen::VectorXd PinocchioModel::computeInverseDynamics(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                                       Eigen::Ref<const Eigen::VectorXd> qvel,
+                                                       Eigen::Ref<const Eigen::VectorXd> qacc) {
+  Eigen::VectorXd result(model.nv);
+  computeInverseDynamics(qpos, qvel, qacc, result);
+  return result;
 }
 
-Eigen::MatrixXd PinocchioModel::computeCoriolisMatrix(const Eigen::VectorXd &qpos,
-                                                      const Eigen::VectorXd &qvel) {
-  return indexS2P.transpose() *
-         pinocchio::computeCoriolisMatrix(model, data, posS2P(qpos), indexS2P * qvel) * indexS2P;
+void PinocchioModel::computeInverseDynamics(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                            Eigen::Ref<const Eigen::VectorXd> qvel,
+                                            Eigen::Ref<const Eigen::VectorXd> qacc,
+                                            Eigen::Ref<Eigen::VectorXd> out) {
+  posS2P(qpos, mQpos);
+  velS2P(qvel, mQvel);
+  velS2P(qacc, mQacc);
+  velP2S(pinocchio::rnea(model, data, mQpos, mQvel, mQacc), out);
 }
 
-Eigen::VectorXd PinocchioModel::computeInverseDynamics(const Eigen::VectorXd &qpos,
-                                                       const Eigen::VectorXd &qvel,
-                                                       const Eigen::VectorXd &qacc) {
-  return indexS2P.transpose() *
-         pinocchio::rnea(model, data, posS2P(qpos), indexS2P * qvel, indexS2P * qacc);
+Eigen::VectorXd PinocchioModel::computeForwardDynamics(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                                       Eigen::Ref<const Eigen::VectorXd> qvel,
+                                                       Eigen::Ref<const Eigen::VectorXd> qf) {
+  Eigen::VectorXd result(model.nv);
+  computeForwardDynamics(qpos, qvel, qf, result);
+  return result;
 }
 
-Eigen::VectorXd PinocchioModel::computeForwardDynamics(const Eigen::VectorXd &qpos,
-                                                       const Eigen::VectorXd &qvel,
-                                                       const Eigen::VectorXd &qf) {
-  return indexS2P.transpose() *
-         pinocchio::aba(model, data, posS2P(qpos), indexS2P * qvel, indexS2P * qf);
+void PinocchioModel::computeForwardDynamics(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                            Eigen::Ref<const Eigen::VectorXd> qvel,
+                                            Eigen::Ref<const Eigen::VectorXd> qf,
+                                            Eigen::Ref<Eigen::VectorXd> out) {
+  posS2P(qpos, mQpos);
+  velS2P(qvel, mQvel);
+  velS2P(qf, mQacc);
+  velP2S(pinocchio::aba(model, data, mQpos, mQvel, mQacc), out);
 }
 
 std::tuple<Eigen::VectorXd, bool, Eigen::Matrix<double, 6, 1>>
@@ -219,12 +439,14 @@ PinocchioModel::computeInverseKinematics(uint32_t linkIdx, Pose const &pose,
   if (initialQpos.size() == 0) {
     q = pinocchio::neutral(model);
   } else {
-    q = posS2P(initialQpos);
+    q.resize(model.nq);
+    posS2P(initialQpos, q);
   }
 
   Eigen::VectorXd mask;
   if (activeQMask.size() > 0) {
-    mask = indexS2P * activeQMask.cast<double>();
+    mask.resize(model.nv);
+    velS2P(activeQMask.cast<double>(), mask);
   } else {
     mask = Eigen::VectorXd(model.nv);
     for (int i = 0; i < model.nv; ++i) {
@@ -280,20 +502,46 @@ PinocchioModel::computeInverseKinematics(uint32_t linkIdx, Pose const &pose,
     v.noalias() = -J.transpose() * JJt.ldlt().solve(err);
     q = pinocchio::integrate(model, q, v * dt);
   }
-  return {posP2S(bestQ), success, bestErr};
+  Eigen::VectorXd result(model.nv);
+  posP2S(bestQ, result);
+  return {result, success, bestErr};
 }
 
 } // namespace sapien
 
+#ifndef SAPIEN_PINOCCHIO_NO_PYTHON
 using namespace sapien;
 namespace py = pybind11;
+
+// overloads taking "out" write into a preallocated float64 array and do not allocate, matrices
+// must be Fortran-ordered (np.zeros(shape, order="F"))
+using RefCVec = Eigen::Ref<const Eigen::VectorXd>;
+using RefVec = Eigen::Ref<Eigen::VectorXd>;
+using RefMat = Eigen::Ref<Eigen::MatrixXd>;
+using RefJacobian = Eigen::Ref<Eigen::Matrix<double, 6, Eigen::Dynamic>>;
+
 PYBIND11_MODULE(pysapien_pinocchio, m) {
+  m.def("prune_model_cache", &PinocchioModel::PruneModelCache,
+        "Remove expired entries from the URDF model cache and return the number of live models");
+
   auto PyPinocchioModel =
       py::class_<PinocchioModel>(m, "PinocchioModel");
   PyPinocchioModel
       .def(py::init([](std::string urdf, Eigen::Vector3d gravity) {
         return PinocchioModel::fromURDFXML(urdf, gravity);
       }))
+      .def_static(
+          "from_binary",
+          [](py::bytes data) { return PinocchioModel::fromBinary(std::string(data)); },
+          "Load a model from bytes produced by save_binary", py::arg("data"))
+      .def_static("from_binary_file", &PinocchioModel::fromBinaryFile,
+                  "Load a model from a file produced by save_binary_file", py::arg("filename"))
+      .def(
+          "save_binary", [](PinocchioModel const &m) { return py::bytes(m.saveBinary()); },
+          "Serialize the model together with its joint and link orders")
+      .def("save_binary_file", &PinocchioModel::saveBinaryFile, py::arg("filename"))
+      .def(py::pickle([](PinocchioModel const &m) { return py::bytes(m.saveBinary()); },
+                      [](py::bytes data) { return PinocchioModel::fromBinary(std::string(data)); }))
       .def("set_link_order", &PinocchioModel::setLinkOrder)
       .def("set_joint_order", &PinocchioModel::setJointOrder)
       .def("compute_forward_kinematics", &PinocchioModel::computeForwardKinematics,
@@ -324,18 +572,37 @@ Returns:
            py::arg("link_index"), py::arg("pose"), py::arg("initial_qpos") = Eigen::VectorXd{},
            py::arg("active_qmask") = Eigen::VectorXi{}, py::arg("eps") = 1e-4,
            py::arg("max_iterations") = 1000, py::arg("dt") = 0.1, py::arg("damp") = 1e-6)
-      .def("compute_forward_dynamics", &PinocchioModel::computeForwardDynamics, py::arg("qpos"),
-           py::arg("qvel"), py::arg("qf"))
-      .def("compute_inverse_dynamics", &PinocchioModel::computeInverseDynamics, py::arg("qpos"),
-           py::arg("qvel"), py::arg("qacc"))
-      .def("compute_generalized_mass_matrix", &PinocchioModel::computeGeneralizedMassMatrix,
+      .def("compute_forward_dynamics",
+           py::overload_cast<RefCVec, RefCVec, RefCVec>(&PinocchioModel::computeForwardDynamics),
+           py::arg("qpos"), py::arg("qvel"), py::arg("qf"))
+      .def("compute_forward_dynamics",
+           py::overload_cast<RefCVec, RefCVec, RefCVec, RefVec>(
+               &PinocchioModel::computeForwardDynamics),
+           py::arg("qpos"), py::arg("qvel"), py::arg("qf"), py::arg("out"))
+      .def("compute_inverse_dynamics",
+           py::overload_cast<RefCVec, RefCVec, RefCVec>(&PinocchioModel::computeInverseDynamics),
+           py::arg("qpos"), py::arg("qvel"), py::arg("qacc"))
+      .def("compute_inverse_dynamics",
+           py::overload_cast<RefCVec, RefCVec, RefCVec, RefVec>(
+               &PinocchioModel::computeInverseDynamics),
+           py::arg("qpos"), py::arg("qvel"), py::arg("qacc"), py::arg("out"))
+      .def("compute_generalized_mass_matrix",
+           py::overload_cast<RefCVec>(&PinocchioModel::computeGeneralizedMassMatrix),
            py::arg("qpos"))
-      .def("compute_coriolis_matrix", &PinocchioModel::computeCoriolisMatrix, py::arg("qpos"),
-           py::arg("qvel"))
+      .def("compute_generalized_mass_matrix",
+           py::overload_cast<RefCVec, RefMat>(&PinocchioModel::computeGeneralizedMassMatrix),
+           py::arg("qpos"), py::arg("out"))
+      .def("compute_coriolis_matrix",
+           py::overload_cast<RefCVec, RefCVec>(&PinocchioModel::computeCoriolisMatrix),
+           py::arg("qpos"), py::arg("qvel"))
+      .def("compute_coriolis_matrix",
+           py::overload_cast<RefCVec, RefCVec, RefMat>(&PinocchioModel::computeCoriolisMatrix),
+           py::arg("qpos"), py::arg("qvel"), py::arg("out"))
 
       .def("compute_full_jacobian", &PinocchioModel::computeFullJacobian,
            "Compute and cache Jacobian for all links", py::arg("qpos"))
-      .def("get_link_jacobian", &PinocchioModel::getLinkJacobian,
+      .def("get_link_jacobian",
+           py::overload_cast<uint32_t, bool>(&PinocchioModel::getLinkJacobian),
            R"doc(
 Given link index, get the Jacobian. Must be called after compute_full_jacobian.
 
@@ -344,8 +611,17 @@ Args:
   local: True for world(spatial) frame; False for link(body) frame
 )doc",
            py::arg("link_index"), py::arg("local") = false)
-      .def("compute_single_link_local_jacobian", &PinocchioModel::computeSingleLinkLocalJacobian,
+      .def("get_link_jacobian",
+           py::overload_cast<uint32_t, RefJacobian, bool>(&PinocchioModel::getLinkJacobian),
+           py::arg("link_index"), py::arg("out"), py::arg("local") = false)
+      .def("compute_single_link_local_jacobian",
+           py::overload_cast<RefCVec, uint32_t>(&PinocchioModel::computeSingleLinkLocalJacobian),
            "Compute the link(body) Jacobian for a single link. It is faster than "
            "compute_full_jacobian followed by get_link_jacobian",
-           py::arg("qpos"), py::arg("link_index"));
+           py::arg("qpos"), py::arg("link_index"))
+      .def("compute_single_link_local_jacobian",
+           py::overload_cast<RefCVec, uint32_t, RefJacobian>(
+               &PinocchioModel::computeSingleLinkLocalJacobian),
+           py::arg("qpos"), py::arg("link_index"), py::arg("out"));
 }
+#endif
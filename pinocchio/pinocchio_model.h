@@ -9,40 +9,70 @@
 namespace sapien {
 
 class PinocchioModel {
-  pinocchio::Model model{};
-  pinocchio::Data data{};
-
-  /** pinocchio_qpos = indexS2P * sapien_qpos
-   * Left multiplication permutes rows of SAPIEN order to Pinocchio order
-   * Right multiplication permutes columns of Pinocchio order to SAPIEN order
+  /** model is immutable after construction and shared by all PinocchioModels built from
+   * the same URDF and gravity, each PinocchioModel owns its own data */
+  std::shared_ptr<pinocchio::Model const> modelHolder;
+  pinocchio::Model const &model;
+  pinocchio::Data data;
+
+  /** pinocchio_qvel[indexS2P[i]] = sapien_qvel[i]
+   * SAPIEN order is obtained by gathering Pinocchio order with indexS2P
    */
-  Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic> indexS2P;
+  Eigen::VectorXi indexS2P;
 
   Eigen::VectorXi QIDX;
   Eigen::VectorXi NQ;
   Eigen::VectorXi NV;
 
-  Eigen::VectorXd posS2P(const Eigen::VectorXd &qpos);
-  Eigen::VectorXd posP2S(const Eigen::VectorXd &qpos);
+  /** preallocated buffers in Pinocchio order, sized once on construction */
+  Eigen::VectorXd mQpos;
+  Eigen::VectorXd mQvel;
+  Eigen::VectorXd mQacc;
+  pinocchio::Data::Matrix6x mJacobian;
+  pinocchio::Data::Matrix6x mJacobianLocal;
+
+  void posS2P(Eigen::Ref<const Eigen::VectorXd> qext, Eigen::Ref<Eigen::VectorXd> qint) const;
+  void posP2S(Eigen::Ref<const Eigen::VectorXd> qint, Eigen::Ref<Eigen::VectorXd> qext) const;
+  void velS2P(Eigen::Ref<const Eigen::VectorXd> vext, Eigen::Ref<Eigen::VectorXd> vint) const;
+  void velP2S(Eigen::Ref<const Eigen::VectorXd> vint, Eigen::Ref<Eigen::VectorXd> vext) const;
 
   std::vector<int> linkIdx2FrameIdx;
 
 public:
+  /** build a model from URDF, the underlying pinocchio::Model is cached and shared among all
+   * models created with the same URDF content and gravity */
   static std::unique_ptr<PinocchioModel> fromURDFXML(std::string const &urdf,
                                                      Eigen::Vector3d gravity);
 
+  /** load a model previously saved with saveBinary, including joint and link orders
+   *
+   *  throws std::runtime_error if the data is truncated, from another version, or its joint
+   *  and link tables do not match the model */
+  static std::unique_ptr<PinocchioModel> fromBinary(std::string const &buffer);
+  static std::unique_ptr<PinocchioModel> fromBinaryFile(std::string const &filename);
+
+  /** serialize the prepared model, including joint and link orders */
+  std::string saveBinary() const;
+  void saveBinaryFile(std::string const &filename) const;
+
+  /** number of live entries in the URDF model cache, expired entries are also dropped when a
+   * new model is added */
+  static size_t PruneModelCache();
+
   PinocchioModel(PinocchioModel const &other) = delete;
   PinocchioModel &operator=(PinocchioModel const &other) = delete;
   ~PinocchioModel() = default;
 
-  inline pinocchio::Model &getInternalModel() { return model; }
+  /** the model is shared with other PinocchioModels built from the same URDF and gravity, so
+   * it is only exposed as const, copy it to build a modified model */
+  inline pinocchio::Model const &getInternalModel() { return model; }
   inline pinocchio::Data &getInternalData() { return data; }
 
 private:
-  inline PinocchioModel(){};
+  PinocchioModel(std::shared_ptr<pinocchio::Model const> m);
 
 public:
-  /** initialize internal permutation matrices by providing joint name*/
+  /** initialize internal joint reordering by providing joint name*/
   void setJointOrder(std::vector<std::string> names);
   void setLinkOrder(std::vector<std::string> names);
 
@@ -50,7 +80,7 @@ public:
   Eigen::MatrixXd getRandomConfiguration();
 
   /** compute and cache the forward kinematics */
-  void computeForwardKinematics(const Eigen::VectorXd &qpos);
+  void computeForwardKinematics(Eigen::Ref<const Eigen::VectorXd> qpos);
 
   /** get link pose
    *
@@ -58,32 +88,41 @@ public:
    */
   Pose getLinkPose(uint32_t index);
 
-  void computeFullJacobian(const Eigen::VectorXd &qpos);
+  void computeFullJacobian(Eigen::Ref<const Eigen::VectorXd> qpos);
 
   /** get Jacobian for a link
    *
    *  must be called after computeFullJacobian
    */
   Eigen::Matrix<double, 6, Eigen::Dynamic> getLinkJacobian(uint32_t index, bool local = false);
+  void getLinkJacobian(uint32_t index, Eigen::Ref<Eigen::Matrix<double, 6, Eigen::Dynamic>> out,
+                       bool local = false);
 
   /** compute the local Jacobian for a single link
    *
    */
   Eigen::Matrix<double, 6, Eigen::Dynamic>
-  computeSingleLinkLocalJacobian(Eigen::VectorXd const &qpos, uint32_t index);
+  computeSingleLinkLocalJacobian(Eigen::Ref<const Eigen::VectorXd> qpos, uint32_t index);
+  void computeSingleLinkLocalJacobian(Eigen::Ref<const Eigen::VectorXd> qpos, uint32_t index,
+                                      Eigen::Ref<Eigen::Matrix<double, 6, Eigen::Dynamic>> out);
 
   /** M in Ma + Cv + g = t
    *
    * Composite rigid body algorithm
-   * Note: only upper triangular part is computed
    */
-  Eigen::MatrixXd computeGeneralizedMassMatrix(const Eigen::VectorXd &qpos);
+  Eigen::MatrixXd computeGeneralizedMassMatrix(Eigen::Ref<const Eigen::VectorXd> qpos);
+  void computeGeneralizedMassMatrix(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                    Eigen::Ref<Eigen::MatrixXd> out);
 
   /** C in Ma + Cv + g = t
    *
    * Recursive Newton-Euler algorithm
    */
-  Eigen::MatrixXd computeCoriolisMatrix(const Eigen::VectorXd &qpos, const Eigen::VectorXd &qvel);
+  Eigen::MatrixXd computeCoriolisMatrix(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                        Eigen::Ref<const Eigen::VectorXd> qvel);
+  void computeCoriolisMatrix(Eigen::Ref<const Eigen::VectorXd> qpos,
+                             Eigen::Ref<const Eigen::VectorXd> qvel,
+                             Eigen::Ref<Eigen::MatrixXd> out);
 
   /** Ma + Cv + g = t
    *
@@ -91,15 +130,25 @@ public:
    * Note: to compute g, call computeInverseDynamics(qpos, 0, 0)
    *       to compute all passive forces, call computeInverseDynamics(qpos, qvel, 0)
    */
-  Eigen::VectorXd computeInverseDynamics(const Eigen::VectorXd &qpos, const Eigen::VectorXd &qvel,
-                                         const Eigen::VectorXd &qacc);
+  Eigen::VectorXd computeInverseDynamics(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                         Eigen::Ref<const Eigen::VectorXd> qvel,
+                                         Eigen::Ref<const Eigen::VectorXd> qacc);
+  void computeInverseDynamics(Eigen::Ref<const Eigen::VectorXd> qpos,
+                              Eigen::Ref<const Eigen::VectorXd> qvel,
+                              Eigen::Ref<const Eigen::VectorXd> qacc,
+                              Eigen::Ref<Eigen::VectorXd> out);
 
   /** Ma + Cv + g = t
    *
    * Articulated-body algorithm
    */
-  Eigen::VectorXd computeForwardDynamics(const Eigen::VectorXd &qpos, const Eigen::VectorXd &qvel,
-                                         const Eigen::VectorXd &qf);
+  Eigen::VectorXd computeForwardDynamics(Eigen::Ref<const Eigen::VectorXd> qpos,
+                                         Eigen::Ref<const Eigen::VectorXd> qvel,
+                                         Eigen::Ref<const Eigen::VectorXd> qf);
+  void computeForwardDynamics(Eigen::Ref<const Eigen::VectorXd> qpos,
+                              Eigen::Ref<const Eigen::VectorXd> qvel,
+                              Eigen::Ref<const Eigen::VectorXd> qf,
+                              Eigen::Ref<Eigen::VectorXd> out);
 
   /** Numerical IK clik algorithm
    *  computes the numerical IK for a given link
@@ -0,0 +1,80 @@
+#include "pinocchio_model.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace sapien;
+
+static std::string chainURDF(int dof) {
+  std::ostringstream ss;
+  ss << "<robot name=\"chain\">";
+  for (int i = 0; i <= dof; ++i) {
+    ss << "<link name=\"link_" << i << "\"><inertial><mass value=\"1\"/>"
+       << "<inertia ixx=\"0.01\" ixy=\"0\" ixz=\"0\" iyy=\"0.01\" iyz=\"0\" izz=\"0.01\"/>"
+       << "</inertial></link>";
+  }
+  for (int i = 0; i < dof; ++i) {
+    ss << "<joint name=\"joint_" << i + 1 << "\" type=\"revolute\">"
+       << "<parent link=\"link_" << i << "\"/><child link=\"link_" << i + 1 << "\"/>"
+       << "<origin xyz=\"0 0 0.1\" rpy=\"0 0 0\"/><axis xyz=\"" << (i % 2) << " " << (1 - i % 2)
+       << " 0\"/><limit lower=\"-3\" upper=\"3\" effort=\"1\" velocity=\"1\"/></joint>";
+  }
+  ss << "</robot>";
+  return ss.str();
+}
+
+TEST(PinocchioModel, SharedModel) {
+  auto urdf = chainURDF(3);
+  auto a = PinocchioModel::fromURDFXML(urdf, {0, 0, -9.81});
+  auto b = PinocchioModel::fromURDFXML(urdf, {0, 0, -9.81});
+  auto c = PinocchioModel::fromURDFXML(urdf, {0, 0, -1});
+  EXPECT_EQ(&a->getInternalModel(), &b->getInternalModel());
+  EXPECT_NE(&a->getInternalModel(), &c->getInternalModel());
+  EXPECT_NE(&a->getInternalData(), &b->getInternalData());
+  EXPECT_EQ(PinocchioModel::PruneModelCache(), 2);
+
+  // expired entries are dropped when the next model is added
+  a.reset();
+  b.reset();
+  c.reset();
+  auto d = PinocchioModel::fromURDFXML(chainURDF(2), {0, 0, -9.81});
+  EXPECT_EQ(PinocchioModel::PruneModelCache(), 1);
+}
+
+TEST(PinocchioModel, Binary) {
+  int dof = 4;
+  auto model = PinocchioModel::fromURDFXML(chainURDF(dof), {0, 0, -9.81});
+  std::vector<std::string> joints, links;
+  for (int i = dof; i >= 1; --i) {
+    joints.push_back("joint_" + std::to_string(i));
+  }
+  for (int i = dof; i >= 0; --i) {
+    links.push_back("link_" + std::to_string(i));
+  }
+  model->setJointOrder(joints);
+  model->setLinkOrder(links);
+
+  auto buffer = model->saveBinary();
+  auto loaded = PinocchioModel::fromBinary(buffer);
+
+  Eigen::VectorXd qpos(dof);
+  qpos << 0.1, -0.2, 0.3, -0.4;
+  model->computeForwardKinematics(qpos);
+  loaded->computeForwardKinematics(qpos);
+  for (int i = 0; i <= dof; ++i) {
+    Pose p0 = model->getLinkPose(i);
+    Pose p1 = loaded->getLinkPose(i);
+    EXPECT_FLOAT_EQ(p0.p.x, p1.p.x);
+    EXPECT_FLOAT_EQ(p0.p.y, p1.p.y);
+    EXPECT_FLOAT_EQ(p0.p.z, p1.p.z);
+  }
+  // link 0 is the tip in this order, not the base at the origin
+  EXPECT_GT(loaded->getLinkPose(0).p.z, 0.1f);
+  EXPECT_TRUE(model->computeGeneralizedMassMatrix(qpos).isApprox(
+      loaded->computeGeneralizedMassMatrix(qpos)));
+
+  EXPECT_THROW(PinocchioModel::fromBinary(buffer.substr(0, buffer.size() / 2)),
+               std::runtime_error);
+  EXPECT_THROW(PinocchioModel::fromBinary(buffer.substr(0, buffer.size() - 4)),
+               std::runtime_error);
+  EXPECT_THROW(PinocchioModel::fromBinary("not a model"), std::runtime_error);
+}
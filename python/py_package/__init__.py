@@ -11,7 +11,7 @@ from . import _oidn_tricks
 from . import pysapien
 
 from .pysapien import Entity, Component, System, CudaArray, Pose, Device
-from .pysapien import profile
+from .pysapien import profile, profiler
 from .pysapien import set_log_level
 from .pysapien import math, simsense
 
@@ -31,6 +31,7 @@ import pkg_resources
 
 try:
     render.set_imgui_ini_filename(str(Path.home() / ".sapien" / "imgui.ini"))
+    render.set_mesh_lod_cache_dir(str(Path.home() / ".sapien" / "lod_cache"))
     pysapien.render._internal_set_shader_search_path(
         pkg_resources.resource_filename("sapien", "vulkan_shader")
     )
@@ -284,6 +284,87 @@ class ActorBuilder:
         self.scene.add_entity(entity)
         return entity
 
+    def to_native(self):
+        """
+        Convert this builder to a native sapien.pysapien.ActorBuilder. Mesh files are
+        preprocessed and decomposed here, the native builder only instantiates shapes.
+        """
+        if self.physx_body_type not in ["dynamic", "static", "kinematic"]:
+            raise Exception(
+                f"native builder does not support body type [{self.physx_body_type}]"
+            )
+
+        builder = sapien.ActorBuilder()
+        for r in self.collision_records:
+            filename = r.filename
+            if filename:
+                filename = preprocess_mesh_file(filename)
+            if r.type == "multiple_convex_meshes" and r.decomposition == "coacd":
+                params = r.decomposition_params
+                filename = do_coacd(filename, **(params if params is not None else {}))
+
+            builder.add_collision(
+                sapien.CollisionShapeRecord(
+                    type=r.type,
+                    filename=filename,
+                    scale=r.scale,
+                    radius=r.radius,
+                    length=r.length,
+                    material=r.material,
+                    pose=r.pose,
+                    density=r.density,
+                    patch_radius=r.patch_radius,
+                    min_patch_radius=r.min_patch_radius,
+                    is_trigger=r.is_trigger,
+                )
+            )
+
+        for r in self.visual_records:
+            filename = preprocess_mesh_file(r.filename) if r.type == "file" else ""
+            builder.add_visual(
+                sapien.VisualShapeRecord(
+                    type=r.type,
+                    filename=filename,
+                    scale=r.scale,
+                    radius=r.radius,
+                    length=r.length,
+                    material=r.material,
+                    pose=r.pose,
+                    name=r.name,
+                )
+            )
+
+        builder.name = self.name
+        builder.physx_body_type = self.physx_body_type
+        builder.initial_pose = self.initial_pose
+        builder.collision_groups = self.collision_groups
+        if self.scene is not None:
+            builder.set_scene(self.scene)
+        if not self._auto_inertial:
+            builder.set_mass_and_inertia(
+                self._mass, self._cmass_local_pose, self._inertia
+            )
+        return builder
+
+    def build_many(self, poses, scenes=None):
+        """
+        Build one entity per pose in a single native call. Cooked meshes, physical
+        materials and render meshes are shared by all entities.
+        Args:
+            poses: initial pose of each entity
+            scenes: None to use the scene of this builder, a list with one scene shared
+                by all entities, or a list with one scene per pose
+        Returns:
+            list of built entities
+        """
+        if scenes is None:
+            if self.scene is None:
+                raise Exception(
+                    "you need to set the scene of the actor builder by calling the set_scene method"
+                )
+            scenes = [self.scene]
+        return self.to_native().build_many(poses, scenes)
+
     def build_kinematic(self, name=""):
         self.set_physx_body_type("kinematic")
         return self.build(name=name)
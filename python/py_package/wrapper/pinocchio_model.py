@@ -1,5 +1,7 @@
 import numpy as np
+import pickle
 import warnings
+import weakref
 from ..pysapien import Pose
 from ..pysapien.physx import PhysxArticulation
 import platform
@@ -8,12 +10,79 @@ from .urdf_exporter import export_kinematic_chain_urdf
 try:
     import pinocchio
 
+    class _ModelHolder:
+        def __init__(self, model):
+            self.model = model
+
     class PinocchioModel:
+        # models built from identical URDF and gravity share one pinocchio.Model
+        _model_cache = weakref.WeakValueDictionary()
+
         def __init__(self, urdf_string, gravity):
-            self.model: pinocchio.Model = pinocchio.buildModelFromXML(urdf_string)
-            self.model.gravity.vector[:] = [*gravity, 0, 0, 0]
+            key = (urdf_string, *[float(g) for g in gravity])
+            holder = PinocchioModel._model_cache.get(key)
+            if holder is None:
+                model = pinocchio.buildModelFromXML(urdf_string)
+                model.gravity.vector[:] = [*gravity, 0, 0, 0]
+                holder = _ModelHolder(model)
+                PinocchioModel._model_cache[key] = holder
+
+            self._model_holder = holder
+            self.model: pinocchio.Model = holder.model
             self.data = pinocchio.Data(self.model)
 
+        def save_binary(self):
+            """
+            Serialize the model together with its joint and link orders
+            """
+            return pickle.dumps(
+                (
+                    self.model,
+                    self.index_s2p,
+                    self.QIDX,
+                    self.NQ,
+                    self.NV,
+                    self.link_id_to_frame_index,
+                )
+            )
+
+        def save_binary_file(self, filename):
+            with open(filename, "wb") as f:
+                f.write(self.save_binary())
+
+        @staticmethod
+        def from_binary(data):
+            """
+            Load a model from bytes produced by save_binary
+            """
+            model, index_s2p, QIDX, NQ, NV, link_id_to_frame_index = pickle.loads(data)
+            if sorted(index_s2p) != list(range(model.nv)):
+                raise RuntimeError("failed to load pinocchio model: corrupted joint order")
+            if not len(QIDX) == len(NQ) == len(NV) or any(
+                q < 0 or n < 0 or q + n > model.nq for q, n in zip(QIDX, NQ)
+            ):
+                raise RuntimeError("failed to load pinocchio model: corrupted joint tables")
+            if any(f < 0 or f >= model.nframes for f in link_id_to_frame_index):
+                raise RuntimeError("failed to load pinocchio model: corrupted link order")
+            self = PinocchioModel.__new__(PinocchioModel)
+            self._model_holder = _ModelHolder(model)
+            self.model = model
+            self.data = pinocchio.Data(model)
+            self.index_s2p = index_s2p
+            self.index_p2s = np.zeros_like(index_s2p)
+            for s, p in enumerate(index_s2p):
+                self.index_p2s[p] = s
+            self.QIDX = QIDX
+            self.NQ = NQ
+            self.NV = NV
+            self.link_id_to_frame_index = link_id_to_frame_index
+            return self
+
+        @staticmethod
+        def from_binary_file(filename):
+            with open(filename, "rb") as f:
+                return PinocchioModel.from_binary(f.read())
+
         def set_joint_order(self, names):
             v = np.zeros(self.model.nv, dtype=np.int64)
             count = 0
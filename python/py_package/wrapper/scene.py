@@ -51,10 +51,18 @@ class Scene(_Scene):
 
         return ArticulationBuilder().set_scene(self)
 
-    def create_urdf_loader(self):
-        from .urdf_loader import URDFLoader
+    def create_urdf_loader(self, native: bool = False):
+        """
+        Args:
+            native: use the C++ loader, which is much faster but does not support
+                convex decomposition or USD meshes
+        """
+        if native:
+            loader = sapien.URDFLoader()
+        else:
+            from .urdf_loader import URDFLoader
 
-        loader = URDFLoader()
+            loader = URDFLoader()
         loader.set_scene(self)
         return loader
 
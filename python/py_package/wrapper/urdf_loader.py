@@ -1,3 +1,4 @@
+import hashlib
 import math
 import os
 from lxml import etree
@@ -41,6 +42,103 @@ def _try_very_hard_to_find_file(filename, urdf_dir, package_dir=None):
     return str(fpath)
 
 
+def _parse_srdf(srdf_string):
+    ignore_pairs = []
+    root = ET.fromstring(srdf_string.encode("utf-8"))
+    for elem in root.findall("disable_collisions"):
+        if elem.attrib["reason"].lower() == "default":
+            ignore_pairs.append(set((elem.attrib["link1"], elem.attrib["link2"])))
+    return ignore_pairs
+
+
+def _file_stamp(filename):
+    try:
+        st = os.stat(filename)
+    except OSError:
+        return None
+    return (st.st_mtime_ns, st.st_size)
+
+
+class _ParsedURDF:
+    """URDF parsed by urchin with its SRDF collision pairs and resolved asset paths"""
+
+    def __init__(self, robot, ignore_pairs, stamp, digest):
+        self.robot = robot
+        self.ignore_pairs = ignore_pairs
+        self.stamp = stamp
+        self.digest = digest
+        self.resolved_files = dict()
+
+
+class URDFCache:
+    """
+    Parsed URDF files shared by all loaders, keyed by URDF, SRDF and package directory.
+    An entry is reused while the modification time and size of both files are unchanged.
+    Otherwise the files are reread and only reparsed if their content changed.
+    """
+
+    def __init__(self):
+        self._entries = dict()
+        self.hits = 0
+        self.misses = 0
+
+    def clear(self):
+        self._entries.clear()
+
+    @staticmethod
+    def _read(urdf_file, srdf_file):
+        with open(urdf_file, "rb") as f:
+            urdf_bytes = f.read()
+        srdf_bytes = None
+        if os.path.isfile(srdf_file):
+            with open(srdf_file, "rb") as f:
+                srdf_bytes = f.read()
+        digest = hashlib.sha1(urdf_bytes)
+        if srdf_bytes is not None:
+            digest.update(b"\0")
+            digest.update(srdf_bytes)
+        return urdf_bytes, srdf_bytes, digest.hexdigest()
+
+    @staticmethod
+    def parse(urdf_file, srdf_file, stamp=None):
+        urdf_bytes, srdf_bytes, digest = URDFCache._read(urdf_file, srdf_file)
+        return URDFCache._parse(urdf_file, urdf_bytes, srdf_bytes, stamp, digest)
+
+    @staticmethod
+    def _parse(urdf_file, urdf_bytes, srdf_bytes, stamp, digest):
+        xml = ET.fromstring(urdf_bytes)
+        robot = URDF._from_xml(xml, os.path.dirname(urdf_file), lazy_load_meshes=True)
+        ignore_pairs = _parse_srdf(srdf_bytes.decode("utf-8")) if srdf_bytes else []
+        return _ParsedURDF(robot, ignore_pairs, stamp, digest)
+
+    def get(self, urdf_file, srdf_file, package_dir=None):
+        key = (
+            os.path.abspath(urdf_file),
+            os.path.abspath(srdf_file),
+            None if package_dir is None else os.path.abspath(package_dir),
+        )
+        stamp = (_file_stamp(urdf_file), _file_stamp(srdf_file))
+
+        entry = self._entries.get(key)
+        if entry is not None and entry.stamp == stamp:
+            self.hits += 1
+            return entry
+
+        urdf_bytes, srdf_bytes, digest = self._read(urdf_file, srdf_file)
+        if entry is not None and entry.digest == digest:
+            entry.stamp = stamp
+            self.hits += 1
+            return entry
+
+        self.misses += 1
+        entry = self._parse(urdf_file, urdf_bytes, srdf_bytes, stamp, digest)
+        self._entries[key] = entry
+        return entry
+
+
+urdf_cache = URDFCache()
+
+
 class URDFLoader:
     def __init__(self):
         self.fix_root_link = True
@@ -52,6 +150,8 @@ class URDFLoader:
         self.collision_is_visual = False
         self.revolute_unwrapped = False
         self.scale = 1.0
+        self.use_cache = True
+        self._resolved_files = dict()
 
         self._material = None
         self._patch_radius = 0
@@ -119,15 +219,19 @@ class URDFLoader:
         return self
 
     def parse_srdf(self, srdf_string):
-        ignore_pairs = []
-        root = ET.fromstring(srdf_string.encode("utf-8"))
-        for elem in root.findall("disable_collisions"):
-            if elem.attrib["reason"].lower() == "default":
-                ignore_pairs.append(set((elem.attrib["link1"], elem.attrib["link2"])))
-        return ignore_pairs
+        return _parse_srdf(srdf_string)
+
+    def _find_file(self, filename):
+        if filename not in self._resolved_files:
+            self._resolved_files[filename] = _try_very_hard_to_find_file(
+                filename, self.urdf_dir, self.package_dir
+            )
+        return self._resolved_files[filename]
 
     @staticmethod
     def _pose_from_origin(origin, scale):
+        # origin belongs to the cached URDF and must not be modified
+        origin = np.array(origin)
         origin[:3, 3] = origin[:3, 3] * scale
         return Pose(origin)
 
@@ -281,11 +385,7 @@ class URDFLoader:
                     material.base_color = visual.material.color
                 elif visual.material.texture is not None:
                     material.diffuse_texture = RenderTexture2D(
-                        _try_very_hard_to_find_file(
-                            visual.material.texture.filename,
-                            self.urdf_dir,
-                            self.package_dir,
-                        )
+                        self._find_file(visual.material.texture.filename)
                     )
 
             t_visual2link = self._pose_from_origin(visual.origin, self.scale)
@@ -327,11 +427,7 @@ class URDFLoader:
                     scale = np.ones(3)
 
                 link_builder.add_visual_from_file(
-                    _try_very_hard_to_find_file(
-                        visual.geometry.mesh.filename,
-                        self.urdf_dir,
-                        self.package_dir,
-                    ),
+                    self._find_file(visual.geometry.mesh.filename),
                     t_visual2link,
                     scale * self.scale,
                     material=material,
@@ -414,11 +510,7 @@ class URDFLoader:
                 else:
                     scale = np.ones(3)
 
-                filename = _try_very_hard_to_find_file(
-                    collision.geometry.mesh.filename,
-                    self.urdf_dir,
-                    self.package_dir,
-                )
+                filename = self._find_file(collision.geometry.mesh.filename)
 
                 if self.load_multiple_collisions_from_file:
                     link_builder.add_multiple_convex_collisions_from_file(
@@ -614,6 +706,10 @@ class URDFLoader:
         xml = ET.fromstring(urdf_string.encode("utf-8"))
 
         robot = URDF._from_xml(xml, self.urdf_dir, lazy_load_meshes=True)
+        self._resolved_files = dict()
+        return self._parse_robot(robot)
+
+    def _parse_robot(self, robot):
         links = robot.links
         joints = robot.joints
 
@@ -664,18 +760,17 @@ class URDFLoader:
         self.package_dir = package_dir
         self.urdf_dir = os.path.dirname(urdf_file)
 
-        with open(urdf_file, "r") as f:
-            urdf_string = f.read()
-
         if srdf_file is None:
             srdf_file = urdf_file[:-4] + "srdf"
-        if os.path.isfile(srdf_file):
-            with open(srdf_file, "r") as f:
-                self.ignore_pairs = self.parse_srdf(f.read())
+
+        if self.use_cache:
+            parsed = urdf_cache.get(urdf_file, srdf_file, package_dir)
         else:
-            self.ignore_pairs = []
+            parsed = URDFCache.parse(urdf_file, srdf_file)
 
-        return self._parse_urdf(urdf_string)
+        self.ignore_pairs = parsed.ignore_pairs
+        self._resolved_files = parsed.resolved_files
+        return self._parse_robot(parsed.robot)
 
     def load_multiple(self, urdf_file: str, srdf_file=None, package_dir=None):
         """
@@ -21,6 +21,12 @@ inline py::capsule DLPackToCapsule(DLManagedTensor *tensor) {
   });
 }
 
+// capsule keeping owner alive, used as base of numpy arrays sharing its memory
+inline py::capsule OwnerToCapsule(std::shared_ptr<void> const &owner) {
+  return py::capsule(new std::shared_ptr<void>(owner),
+                     [](void *ptr) { delete static_cast<std::shared_ptr<void> *>(ptr); });
+}
+
 } // namespace sapien
 
 namespace pybind11::detail {
@@ -42,13 +48,13 @@ template <> struct type_caster<CpuArrayHandle> {
       strides.push_back(s);
     }
 
-    // this makes a copy
+    // owned memory is shared with numpy, borrowed memory is copied
+    if (src.owner) {
+      auto array =
+          py::array(py::dtype(src.type), shape, strides, src.ptr, OwnerToCapsule(src.owner));
+      return array.release();
+    }
     auto array = py::array(py::dtype(src.type), shape, strides, src.ptr);
-
-    // this makes array in-place
-    // assert(static_cast<const void *>(array.request().ptr) == static_cast<const void
-    // *>(src.ptr));
-
     return array.release();
   }
 };
@@ -65,7 +71,7 @@ template <> struct type_caster<CpuArray> {
       shape.push_back(s);
     }
 
-    auto array = py::array(py::dtype(src.type), shape, src.data.data());
+    auto array = py::array(py::dtype(src.type), shape, src.ptr(), OwnerToCapsule(src.data));
     return array.release();
   }
 };
@@ -1,3 +1,4 @@
+#include "sapien/math/batch.h"
 #include "sapien/math/math.h"
 #include "sapien/scene.h"
 #include "sapien_type_caster.h"
@@ -11,6 +12,39 @@ namespace py = pybind11;
 
 using namespace sapien;
 
+using FloatArray = py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+// number of items in an array of shape [..., d0, d1, ...] with trailing dims given by shape
+static size_t BatchCount(FloatArray const &array, std::vector<py::ssize_t> const &shape,
+                         char const *name) {
+  auto ndim = static_cast<py::ssize_t>(shape.size());
+  bool valid = array.ndim() >= ndim;
+  for (py::ssize_t i = 0; valid && i < ndim; ++i) {
+    valid = array.shape(array.ndim() - ndim + i) == shape[i];
+  }
+  if (!valid) {
+    std::string expected;
+    for (auto d : shape) {
+      expected += ", " + std::to_string(d);
+    }
+    throw std::runtime_error(std::string("invalid ") + name + ", expected shape [..." +
+                             expected + "]");
+  }
+  size_t count = 1;
+  for (py::ssize_t i = 0; i < array.ndim() - ndim; ++i) {
+    count *= array.shape(i);
+  }
+  return count;
+}
+
+// output array replacing the trailing dims of array
+static FloatArray BatchOutput(FloatArray const &array, py::ssize_t inDims,
+                              std::vector<py::ssize_t> const &shape) {
+  std::vector<py::ssize_t> outShape(array.shape(), array.shape() + array.ndim() - inDims);
+  outShape.insert(outShape.end(), shape.begin(), shape.end());
+  return FloatArray(outShape);
+}
+
 void init_math(py::module &sapien) {
   auto m = sapien.def_submodule("math");
 
@@ -49,5 +83,95 @@ void init_math(py::module &sapien) {
 
   m.def("shortest_rotation", &ShortestRotation, py::arg("source"), py::arg("target"));
   m.attr("pose_gl_to_ros") = POSE_GL_TO_ROS;
+
+  // batch kernels, poses are [..., 7] arrays of (x, y, z, qw, qx, qy, qz)
+  m.def(
+       "transform_points",
+       [](Pose const &pose, FloatArray points, Vec3 const &scale) {
+         size_t count = BatchCount(points, {3}, "points");
+         auto result = BatchOutput(points, 1, {3});
+         {
+           py::gil_scoped_release release;
+           transformPoints(pose, scale, points.data(), result.mutable_data(), count);
+         }
+         return result;
+       },
+       py::arg("pose"), py::arg("points"), py::arg("scale") = Vec3(1.f),
+       "apply pose to points of shape [..., 3], scale is applied in the local frame first")
+      .def(
+          "compose_poses",
+          [](FloatArray a, FloatArray b) {
+            size_t countA = BatchCount(a, {7}, "poses");
+            size_t countB = BatchCount(b, {7}, "poses");
+            auto result = BatchOutput(countA >= countB ? a : b, 1, {7});
+            {
+              py::gil_scoped_release release;
+              composePoses(a.data(), countA, b.data(), countB, result.mutable_data());
+            }
+            return result;
+          },
+          py::arg("a"), py::arg("b"),
+          "a * b for pose arrays of shape [..., 7], either side may hold a single pose")
+      .def(
+          "invert_poses",
+          [](FloatArray poses) {
+            size_t count = BatchCount(poses, {7}, "poses");
+            auto result = BatchOutput(poses, 1, {7});
+            {
+              py::gil_scoped_release release;
+              invertPoses(poses.data(), result.mutable_data(), count);
+            }
+            return result;
+          },
+          py::arg("poses"))
+      .def(
+          "poses_to_matrices",
+          [](FloatArray poses) {
+            size_t count = BatchCount(poses, {7}, "poses");
+            auto result = BatchOutput(poses, 1, {4, 4});
+            {
+              py::gil_scoped_release release;
+              posesToMatrices(poses.data(), result.mutable_data(), count);
+            }
+            return result;
+          },
+          py::arg("poses"))
+      .def(
+          "matrices_to_poses",
+          [](FloatArray matrices) {
+            size_t count = BatchCount(matrices, {4, 4}, "matrices");
+            auto result = BatchOutput(matrices, 2, {7});
+            {
+              py::gil_scoped_release release;
+              matricesToPoses(matrices.data(), result.mutable_data(), count);
+            }
+            return result;
+          },
+          py::arg("matrices"))
+      .def(
+          "quats_to_rpy",
+          [](FloatArray quats) {
+            size_t count = BatchCount(quats, {4}, "quaternions");
+            auto result = BatchOutput(quats, 1, {3});
+            {
+              py::gil_scoped_release release;
+              quatsToRPY(quats.data(), result.mutable_data(), count);
+            }
+            return result;
+          },
+          py::arg("quats"))
+      .def(
+          "rpy_to_quats",
+          [](FloatArray rpy) {
+            size_t count = BatchCount(rpy, {3}, "rpy");
+            auto result = BatchOutput(rpy, 1, {4});
+            {
+              py::gil_scoped_release release;
+              rpyToQuats(rpy.data(), result.mutable_data(), count);
+            }
+            return result;
+          },
+          py::arg("rpy"));
+  m.attr("batch_backend") = getBatchMathBackend();
   m.attr("pose_ros_to_gl") = POSE_ROS_TO_GL;
 }
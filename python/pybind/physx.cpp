@@ -187,16 +187,19 @@ Generator<int> init_physx(py::module &sapien) {
       .def_readwrite("enable_enhanced_determinism", &PhysxSceneConfig::enableEnhancedDeterminism)
       .def_readwrite("enable_friction_every_iteration",
                      &PhysxSceneConfig::enableFrictionEveryIteration)
+      .def_readwrite("scratch_block_size", &PhysxSceneConfig::scratchBlockSize)
+      .def_readwrite("enable_scratch_auto_grow", &PhysxSceneConfig::enableScratchAutoGrow)
       .def("__repr__", [](PhysxSceneConfig &) { return "PhysxSceneConfig()"; })
       .def(py::pickle(
           [](PhysxSceneConfig &config) {
             return py::make_tuple(config.gravity, config.bounceThreshold, config.enablePCM,
                                   config.enableTGS, config.enableCCD,
                                   config.enableEnhancedDeterminism,
-                                  config.enableFrictionEveryIteration);
+                                  config.enableFrictionEveryIteration, config.scratchBlockSize,
+                                  config.enableScratchAutoGrow);
           },
           [](py::tuple t) {
-            if (t.size() != 7) {
+            if (t.size() != 7 && t.size() != 9) {
               throw std::runtime_error("Invalid state!");
             }
             PhysxSceneConfig config;
@@ -209,6 +212,10 @@ Generator<int> init_physx(py::module &sapien) {
                 t[5].cast<decltype(config.enableEnhancedDeterminism)>();
             config.enableFrictionEveryIteration =
                 t[6].cast<decltype(config.enableFrictionEveryIteration)>();
+            if (t.size() == 9) {
+              config.scratchBlockSize = t[7].cast<decltype(config.scratchBlockSize)>();
+              config.enableScratchAutoGrow = t[8].cast<decltype(config.enableScratchAutoGrow)>();
+            }
             return config;
           }));
 
@@ -279,6 +286,66 @@ Generator<int> init_physx(py::module &sapien) {
             return config;
           }));
 
+  auto PyPhysxAllocatorConfig = py::class_<PhysxAllocatorConfig>(m, "PhysxAllocatorConfig");
+  PyPhysxAllocatorConfig.def(py::init<>())
+      .def_readwrite("enable_tracking", &PhysxAllocatorConfig::enableTracking)
+      .def_readwrite("enable_pool", &PhysxAllocatorConfig::enablePool)
+      .def("__repr__", [](PhysxAllocatorConfig &) { return "PhysxAllocatorConfig()"; });
+
+  auto PyPhysxMemoryStats = py::class_<PhysxMemoryStats>(m, "PhysxMemoryStats");
+  PyPhysxMemoryStats.def_readonly("tracking", &PhysxMemoryStats::tracking)
+      .def_readonly("current_bytes", &PhysxMemoryStats::currentBytes)
+      .def_readonly("peak_bytes", &PhysxMemoryStats::peakBytes)
+      .def_readonly("live_allocations", &PhysxMemoryStats::liveAllocations)
+      .def_readonly("total_allocations", &PhysxMemoryStats::totalAllocations)
+      .def_readonly("bytes_by_name", &PhysxMemoryStats::bytesByName)
+      .def_readonly("pool_reserved_bytes", &PhysxMemoryStats::poolReservedBytes)
+      .def_readonly("pool_used_bytes", &PhysxMemoryStats::poolUsedBytes)
+      .def("__repr__", [](PhysxMemoryStats const &s) {
+        return "PhysxMemoryStats(current_bytes=" + std::to_string(s.currentBytes) +
+               ", peak_bytes=" + std::to_string(s.peakBytes) + ")";
+      });
+
+  auto PyPhysxStepStatistics = py::class_<PhysxStepStatistics>(m, "PhysxStepStatistics");
+  PyPhysxStepStatistics.def_readonly("step", &PhysxStepStatistics::step)
+      .def_readonly("active_dynamic_bodies", &PhysxStepStatistics::activeDynamicBodies)
+      .def_readonly("active_kinematic_bodies", &PhysxStepStatistics::activeKinematicBodies)
+      .def_readonly("static_bodies", &PhysxStepStatistics::staticBodies)
+      .def_readonly("dynamic_bodies", &PhysxStepStatistics::dynamicBodies)
+      .def_readonly("kinematic_bodies", &PhysxStepStatistics::kinematicBodies)
+      .def_readonly("articulations", &PhysxStepStatistics::articulations)
+      .def_readonly("awake_articulations", &PhysxStepStatistics::awakeArticulations)
+      .def_readonly("active_constraints", &PhysxStepStatistics::activeConstraints)
+      .def_readonly("axis_solver_constraints", &PhysxStepStatistics::axisSolverConstraints)
+      .def_readonly("broad_phase_adds", &PhysxStepStatistics::broadPhaseAdds)
+      .def_readonly("broad_phase_removes", &PhysxStepStatistics::broadPhaseRemoves)
+      .def_readonly("discrete_contact_pairs", &PhysxStepStatistics::discreteContactPairs)
+      .def_readonly("discrete_contact_pairs_with_cache_hits",
+                    &PhysxStepStatistics::discreteContactPairsWithCacheHits)
+      .def_readonly("discrete_contact_pairs_with_contacts",
+                    &PhysxStepStatistics::discreteContactPairsWithContacts)
+      .def_readonly("new_pairs", &PhysxStepStatistics::newPairs)
+      .def_readonly("lost_pairs", &PhysxStepStatistics::lostPairs)
+      .def_readonly("new_touches", &PhysxStepStatistics::newTouches)
+      .def_readonly("lost_touches", &PhysxStepStatistics::lostTouches)
+      .def_readonly("partitions", &PhysxStepStatistics::partitions)
+      .def_readonly("peak_constraint_memory", &PhysxStepStatistics::peakConstraintMemory)
+      .def_readonly("required_contact_constraint_memory",
+                    &PhysxStepStatistics::requiredContactConstraintMemory)
+      .def_readonly("compressed_contact_size", &PhysxStepStatistics::compressedContactSize)
+      .def_readonly("scratch_block_size", &PhysxStepStatistics::scratchBlockSize)
+      .def_readonly("scratch_grow_count", &PhysxStepStatistics::scratchGrowCount)
+      .def_readonly("contact_pairs", &PhysxStepStatistics::contactPairs)
+      .def_readonly("contact_points", &PhysxStepStatistics::contactPoints)
+      .def_readonly("simulate_time", &PhysxStepStatistics::simulateTime)
+      .def_readonly("fetch_results_time", &PhysxStepStatistics::fetchResultsTime)
+      .def_readonly("sync_pose_time", &PhysxStepStatistics::syncPoseTime)
+      .def("__repr__", [](PhysxStepStatistics const &s) {
+        return "PhysxStepStatistics(step=" + std::to_string(s.step) +
+               ", contact_pairs=" + std::to_string(s.contactPairs) +
+               ", simulate_time=" + std::to_string(s.simulateTime) + ")";
+      });
+
   auto PyPhysxEngine = py::class_<PhysxEngine>(m, "PhysxEngine");
   auto PyPhysxContactPoint = py::class_<ContactPoint>(m, "PhysxContactPoint");
   auto PyPhysxContact = py::class_<Contact>(m, "PhysxContact");
@@ -345,8 +412,9 @@ Generator<int> init_physx(py::module &sapien) {
 
   co_yield 0;
 
-  PyPhysxEngine.def(py::init(&PhysxEngine::Get), py::arg("tolerance_length"),
-                    py::arg("tolerance_speed"));
+  PyPhysxEngine
+      .def(py::init(&PhysxEngine::Get), py::arg("tolerance_length"), py::arg("tolerance_speed"))
+      .def("get_memory_stats", &PhysxEngine::getMemoryStats);
 
   PyPhysxContactPoint.def_readonly("position", &ContactPoint::position)
       .def_readonly("normal", &ContactPoint::normal)
@@ -398,7 +466,27 @@ Generator<int> init_physx(py::module &sapien) {
       .def("get_rigid_static_components", &PhysxSystem::getRigidStaticComponents)
       .def_property_readonly("articulation_link_components",
                              &PhysxSystem::getArticulationLinkComponents)
-      .def("get_articulation_link_components", &PhysxSystem::getArticulationLinkComponents);
+      .def("get_articulation_link_components", &PhysxSystem::getArticulationLinkComponents)
+
+      .def("get_allocated_bytes", &PhysxSystem::getAllocatedBytes,
+           "live PhysX bytes allocated while creating and stepping this system, requires "
+           "sapien.physx.set_allocator_config(enable_tracking=True)")
+      .def_property("scratch_block_size", &PhysxSystem::getScratchBlockSize,
+                    &PhysxSystem::setScratchBlockSize)
+      .def("set_scratch_block_size", &PhysxSystem::setScratchBlockSize, py::arg("size"),
+           "reallocate scratch memory passed to simulate between steps, size is rounded up to "
+           "a multiple of 16K and 0 lets PhysX allocate on its own. Raises between step_start "
+           "and step_finish of a GPU system")
+      .def("get_scratch_block_size", &PhysxSystem::getScratchBlockSize)
+      .def("get_step_statistics", &PhysxSystem::getStepStatistics,
+           "statistics of the last step, only valid until the scene is modified")
+      .def_property("step_statistics_history_size", &PhysxSystem::getStepStatisticsHistorySize,
+                    &PhysxSystem::setStepStatisticsHistorySize)
+      .def("set_step_statistics_history_size", &PhysxSystem::setStepStatisticsHistorySize,
+           py::arg("size"),
+           "keep statistics of the last size steps for get_step_statistics_history, 0 disables")
+      .def("get_step_statistics_history_size", &PhysxSystem::getStepStatisticsHistorySize)
+      .def("get_step_statistics_history", &PhysxSystem::getStepStatisticsHistory);
 
   PyPhysxSystemCpu.def(py::init<>())
       .def("get_contacts", &PhysxSystemCpu::getContacts, py::return_value_policy::reference)
@@ -1179,6 +1267,19 @@ Example:
       .def("get_default_material", &PhysxDefault::GetDefaultMaterial)
       .def("_enable_gpu", &PhysxDefault::EnableGPU)
       .def("is_gpu_enabled", &PhysxDefault::GetGPUEnabled)
+      .def("set_allocator_config",
+           py::overload_cast<bool, bool>(&PhysxDefault::setAllocatorConfig),
+           py::arg("enable_tracking") = false, py::arg("enable_pool") = false,
+           "Must be called before any other code involving PhysX")
+      .def("set_allocator_config",
+           py::overload_cast<PhysxAllocatorConfig const &>(&PhysxDefault::setAllocatorConfig),
+           py::arg("config"))
+      .def("get_allocator_config", &PhysxDefault::getAllocatorConfig)
+      .def("get_memory_stats", []() { return PhysxEngine::Get()->getMemoryStats(); })
+      .def("set_profiler_enabled", &PhysxDefault::SetProfilerEnabled, py::arg("enabled"),
+           "Forward PhysX internal profile zones to sapien.profiler. Zones are only emitted by "
+           "checked/profile builds of PhysX.")
+      .def("is_profiler_enabled", &PhysxDefault::GetProfilerEnabled)
       .def("set_gpu_memory_config", &PhysxDefault::setGpuMemoryConfig,
            py::arg("temp_buffer_capacity") = 16 * 1024 * 1024,
            py::arg("max_rigid_contact_count") = 1024 * 512,
@@ -1,16 +1,21 @@
 #include "./array.hpp"
 #include "./python_component.hpp"
 #include "generator.hpp"
+#include "sapien/actor_builder.h"
 #include "sapien/component.h"
 #include "sapien/device.h"
 #include "sapien/entity.h"
 #include "sapien/logger.h"
 #include "sapien/math/math.h"
+#include "sapien/physx/material.h"
 #include "sapien/physx/physx_system.h"
 #include "sapien/profiler.h"
 #include "sapien/sapien_renderer/sapien_renderer.h"
 #include "sapien/scene.h"
+#include "sapien/scene_bvh.h"
 #include "sapien/system.h"
+#include "sapien/urdf/urdf_cache.h"
+#include "sapien/urdf/urdf_loader.h"
 #include "sapien_type_caster.h"
 #include <pybind11/eigen.h>
 #include <pybind11/numpy.h>
@@ -22,6 +27,156 @@ namespace py = pybind11;
 using namespace pybind11::literals;
 using namespace sapien;
 
+namespace pybind11::detail {
+
+template <> struct type_caster<CollisionShapeRecord::Type> {
+  PYBIND11_TYPE_CASTER(CollisionShapeRecord::Type,
+                       _("typing.Literal['convex_mesh', 'multiple_convex_meshes', "
+                         "'nonconvex_mesh', 'plane', 'box', 'capsule', 'sphere', 'cylinder']"));
+
+  static inline std::vector<std::pair<std::string, CollisionShapeRecord::Type>> const Names = {
+      {"convex_mesh", CollisionShapeRecord::Type::eConvexMesh},
+      {"multiple_convex_meshes", CollisionShapeRecord::Type::eMultipleConvexMeshes},
+      {"nonconvex_mesh", CollisionShapeRecord::Type::eNonconvexMesh},
+      {"plane", CollisionShapeRecord::Type::ePlane},
+      {"box", CollisionShapeRecord::Type::eBox},
+      {"capsule", CollisionShapeRecord::Type::eCapsule},
+      {"sphere", CollisionShapeRecord::Type::eSphere},
+      {"cylinder", CollisionShapeRecord::Type::eCylinder}};
+
+  bool load(py::handle src, bool convert) {
+    std::string name = py::cast<std::string>(src);
+    for (auto &[n, t] : Names) {
+      if (n == name) {
+        value = t;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static py::handle cast(CollisionShapeRecord::Type const &src, py::return_value_policy policy,
+                         py::handle parent) {
+    for (auto &[n, t] : Names) {
+      if (t == src) {
+        return py::str(n).release();
+      }
+    }
+    throw std::runtime_error("invalid collision shape type");
+  }
+};
+
+template <> struct type_caster<VisualShapeRecord::Type> {
+  PYBIND11_TYPE_CASTER(
+      VisualShapeRecord::Type,
+      _("typing.Literal['file', 'plane', 'box', 'capsule', 'sphere', 'cylinder']"));
+
+  static inline std::vector<std::pair<std::string, VisualShapeRecord::Type>> const Names = {
+      {"file", VisualShapeRecord::Type::eFile},
+      {"plane", VisualShapeRecord::Type::ePlane},
+      {"box", VisualShapeRecord::Type::eBox},
+      {"capsule", VisualShapeRecord::Type::eCapsule},
+      {"sphere", VisualShapeRecord::Type::eSphere},
+      {"cylinder", VisualShapeRecord::Type::eCylinder}};
+
+  bool load(py::handle src, bool convert) {
+    std::string name = py::cast<std::string>(src);
+    for (auto &[n, t] : Names) {
+      if (n == name) {
+        value = t;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static py::handle cast(VisualShapeRecord::Type const &src, py::return_value_policy policy,
+                         py::handle parent) {
+    for (auto &[n, t] : Names) {
+      if (t == src) {
+        return py::str(n).release();
+      }
+    }
+    throw std::runtime_error("invalid visual shape type");
+  }
+};
+
+template <> struct type_caster<ActorBuilder::BodyType> {
+  PYBIND11_TYPE_CASTER(ActorBuilder::BodyType,
+                       _("typing.Literal['dynamic', 'kinematic', 'static']"));
+
+  bool load(py::handle src, bool convert) {
+    std::string name = py::cast<std::string>(src);
+    if (name == "dynamic") {
+      value = ActorBuilder::BodyType::eDynamic;
+      return true;
+    } else if (name == "kinematic") {
+      value = ActorBuilder::BodyType::eKinematic;
+      return true;
+    } else if (name == "static") {
+      value = ActorBuilder::BodyType::eStatic;
+      return true;
+    }
+    return false;
+  }
+
+  static py::handle cast(ActorBuilder::BodyType const &src, py::return_value_policy policy,
+                         py::handle parent) {
+    switch (src) {
+    case ActorBuilder::BodyType::eDynamic:
+      return py::str("dynamic").release();
+    case ActorBuilder::BodyType::eKinematic:
+      return py::str("kinematic").release();
+    case ActorBuilder::BodyType::eStatic:
+      return py::str("static").release();
+    }
+    throw std::runtime_error("invalid body type");
+  }
+};
+
+template <> struct type_caster<SceneBVH::Source> {
+  PYBIND11_TYPE_CASTER(SceneBVH::Source, _("typing.Literal['physx', 'render']"));
+
+  bool load(py::handle src, bool convert) {
+    std::string name = py::cast<std::string>(src);
+    if (name == "physx") {
+      value = SceneBVH::Source::ePhysx;
+      return true;
+    } else if (name == "render") {
+      value = SceneBVH::Source::eRender;
+      return true;
+    }
+    return false;
+  }
+
+  static py::handle cast(SceneBVH::Source const &src, py::return_value_policy policy,
+                         py::handle parent) {
+    switch (src) {
+    case SceneBVH::Source::ePhysx:
+      return py::str("physx").release();
+    case SceneBVH::Source::eRender:
+      return py::str("render").release();
+    }
+    throw std::runtime_error("invalid BVH source");
+  }
+};
+
+} // namespace pybind11::detail
+
+// query results are index arrays unless components are requested
+static py::object BVHResult(SceneBVH &bvh, std::vector<uint32_t> const &indices,
+                            bool returnComponents) {
+  if (!returnComponents) {
+    return py::array_t<uint32_t>(indices.size(), indices.data());
+  }
+  auto const &components = bvh.getComponents();
+  py::list result;
+  for (auto i : indices) {
+    result.append(components[i]);
+  }
+  return result;
+}
+
 class PythonSystem : public System, public py::trampoline_self_life_support {
 public:
   using System::System;
@@ -34,9 +189,9 @@ public:
 
 class PythonProfiler {
 public:
-  PythonProfiler(std::string const &name) { mName = name; }
+  PythonProfiler(std::string const &name) { mName = ProfilerInternName(name); }
 
-  void enter() { ProfilerBlockBegin(mName.c_str()); }
+  void enter() { ProfilerBlockBegin(mName); }
   void exit(const std::optional<pybind11::type> &exc_type,
             const std::optional<pybind11::object> &exc_value,
             const std::optional<pybind11::object> &traceback) {
@@ -45,7 +200,7 @@ public:
 
   py::cpp_function decorate(py::function func) {
     return [func = func, name = mName](py::args args, py::kwargs const &kwargs) {
-      ProfilerBlockBegin(name.c_str());
+      ProfilerBlockBegin(name);
       auto obj = func(*args, **kwargs);
       ProfilerBlockEnd();
       return obj;
@@ -53,7 +208,7 @@ public:
   }
 
 private:
-  std::string mName;
+  char const *mName;
 };
 
 Generator<int> init_sapien(py::module &m) {
@@ -76,6 +231,35 @@ Generator<int> init_sapien(py::module &m) {
           },
           py::arg("func"));
 
+  auto profiler = m.def_submodule("profiler");
+  profiler
+      .def("start", &ProfilerStart, py::arg("max_trace_events") = 1 << 22,
+           R"doc(
+Start recording profiled blocks on all threads with the built-in CPU profiler.
+
+Args:
+    max_trace_events: events beyond this count are dropped from the trace but still counted
+        in the summary
+)doc")
+      .def("stop", &ProfilerStop)
+      .def("is_running", &ProfilerIsRunning)
+      .def("reset", &ProfilerReset, "Discard all recorded events and statistics")
+      .def("dump_chrome_trace", &ProfilerDumpChromeTrace, py::arg("filename"),
+           "Write recorded events as Chrome trace JSON, viewable in chrome://tracing or Perfetto")
+      .def(
+          "get_summary",
+          []() {
+            py::list result;
+            for (auto &s : ProfilerGetSummary()) {
+              result.append(py::dict("name"_a = s.name, "count"_a = s.count, "total"_a = s.total,
+                                     "mean"_a = s.mean, "min"_a = s.min, "max"_a = s.max,
+                                     "p50"_a = s.p50, "p90"_a = s.p90, "p99"_a = s.p99));
+            }
+            return result;
+          },
+          "Per-block statistics sorted by total time, all durations are in milliseconds")
+      .def("get_summary_table", &ProfilerGetSummaryTable);
+
   auto PyPose = py::class_<Pose>(m, "Pose");
   auto PyScene = py::class_<Scene>(m, "Scene");
   auto PyEntity = py::class_<Entity>(m, "Entity");
@@ -84,7 +268,13 @@ Generator<int> init_sapien(py::module &m) {
 
   auto PySystem = py::class_<System, PythonSystem>(m, "System");
   auto PyCudaArray = py::class_<CudaArrayHandle>(m, "CudaArray");
+  auto PyCpuArrayPool = py::class_<CpuArrayPool>(m, "CpuArrayPool");
   auto PyDevice = py::class_<Device>(m, "Device");
+  auto PyURDFLoader = py::class_<urdf::URDFLoader>(m, "URDFLoader");
+  auto PyCollisionShapeRecord = py::class_<CollisionShapeRecord>(m, "CollisionShapeRecord");
+  auto PyVisualShapeRecord = py::class_<VisualShapeRecord>(m, "VisualShapeRecord");
+  auto PyActorBuilder = py::class_<ActorBuilder>(m, "ActorBuilder");
+  auto PySceneBVH = py::class_<SceneBVH>(m, "SceneBVH");
 
   co_yield 0;
 
@@ -174,6 +364,7 @@ Generator<int> init_sapien(py::module &m) {
       .def_property("pose", &Entity::getPose, &Entity::setPose)
       .def("get_pose", &Entity::getPose)
       .def("set_pose", &Entity::setPose, py::arg("pose"))
+      .def_property_readonly("pose_version", &Entity::getPoseVersion)
 
       .def(
           "find_component_by_type",
@@ -252,6 +443,206 @@ Generator<int> init_sapien(py::module &m) {
       .def_readonly("name", &Device::name)
       .def_property_readonly("pci_string", &Device::getPciString);
 
+  PyURDFLoader
+      .def(py::init<>(), "Native URDF loader with the same interface as the Python URDFLoader, "
+                         "convex decomposition and USD meshes are not supported")
+      .def(
+          "set_scene",
+          [](urdf::URDFLoader &loader, std::shared_ptr<Scene> scene) -> urdf::URDFLoader & {
+            loader.setScene(scene);
+            return loader;
+          },
+          py::arg("scene"), py::return_value_policy::reference_internal)
+      .def_property("fix_root_link", &urdf::URDFLoader::getFixRootLink,
+                    &urdf::URDFLoader::setFixRootLink)
+      .def_property("load_multiple_collisions_from_file",
+                    &urdf::URDFLoader::getLoadMultipleCollisionsFromFile,
+                    &urdf::URDFLoader::setLoadMultipleCollisionsFromFile)
+      .def_property("collision_is_visual", &urdf::URDFLoader::getCollisionIsVisual,
+                    &urdf::URDFLoader::setCollisionIsVisual)
+      .def_property("scale", &urdf::URDFLoader::getScale, &urdf::URDFLoader::setScale)
+      .def_property("mesh_load_threads", &urdf::URDFLoader::getMeshLoadThreads,
+                    &urdf::URDFLoader::setMeshLoadThreads,
+                    "number of threads used to cook collision meshes, 0 uses all cores")
+      .def_property("use_cache", &urdf::URDFLoader::getUseCache,
+                    &urdf::URDFLoader::setUseCache,
+                    "reuse parsed URDF files across loads until they are modified")
+      .def_static("clear_cache", &urdf::URDFCache::Clear)
+      .def_static("get_cache_stats",
+                  []() {
+                    auto cache = urdf::URDFCache::Get();
+                    return py::dict("hits"_a = cache->getHitCount(),
+                                    "misses"_a = cache->getMissCount());
+                  })
+      .def("set_material", &urdf::URDFLoader::setMaterial, py::arg("static_friction"),
+           py::arg("dynamic_friction"), py::arg("restitution"))
+      .def("set_density", &urdf::URDFLoader::setDensity, py::arg("density"))
+      .def("set_patch_radius", &urdf::URDFLoader::setPatchRadius, py::arg("patch_radius"))
+      .def("set_min_patch_radius", &urdf::URDFLoader::setMinPatchRadius,
+           py::arg("min_patch_radius"))
+      .def("set_link_material", &urdf::URDFLoader::setLinkMaterial, py::arg("link_name"),
+           py::arg("static_friction"), py::arg("dynamic_friction"), py::arg("restitution"))
+      .def("set_link_density", &urdf::URDFLoader::setLinkDensity, py::arg("link_name"),
+           py::arg("density"))
+      .def("set_link_patch_radius", &urdf::URDFLoader::setLinkPatchRadius, py::arg("link_name"),
+           py::arg("patch_radius"))
+      .def("set_link_min_patch_radius", &urdf::URDFLoader::setLinkMinPatchRadius,
+           py::arg("link_name"), py::arg("min_patch_radius"))
+      .def(
+          "load_multiple",
+          [](urdf::URDFLoader &loader, std::string const &urdfFile,
+             std::optional<std::string> const &srdfFile,
+             std::optional<std::string> const &packageDir) {
+            return loader.loadMultiple(urdfFile, srdfFile.value_or(""), packageDir.value_or(""));
+          },
+          py::arg("urdf_file"), py::arg("srdf_file") = py::none(),
+          py::arg("package_dir") = py::none(),
+          "returns Tuple[List[PhysxArticulation], List[Entity]] for multi-body articulations "
+          "and single-body entities in the URDF file")
+      .def(
+          "load",
+          [](urdf::URDFLoader &loader, std::string const &urdfFile,
+             std::optional<std::string> const &srdfFile,
+             std::optional<std::string> const &packageDir) {
+            return loader.load(urdfFile, srdfFile.value_or(""), packageDir.value_or(""));
+          },
+          py::arg("urdf_file"), py::arg("srdf_file") = py::none(),
+          py::arg("package_dir") = py::none(),
+          "returns the single articulation in the URDF file, raises if it contains multiple "
+          "objects");
+
+  PyCollisionShapeRecord
+      .def(py::init([](CollisionShapeRecord::Type type, std::string const &filename, Vec3 scale,
+                       float radius, float length,
+                       std::shared_ptr<physx::PhysxMaterial> material, Pose const &pose,
+                       float density, float patchRadius, float minPatchRadius, bool isTrigger) {
+             return CollisionShapeRecord{type,        filename,       scale,   radius,
+                                         length,      material,       pose,    density,
+                                         patchRadius, minPatchRadius, isTrigger};
+           }),
+           py::arg("type"), py::arg("filename") = "", py::arg("scale") = Vec3(1.f),
+           py::arg("radius") = 1.f, py::arg("length") = 1.f, py::arg("material") = nullptr,
+           py::arg("pose") = Pose(), py::arg("density") = 1000.f, py::arg("patch_radius") = 0.f,
+           py::arg("min_patch_radius") = 0.f, py::arg("is_trigger") = false)
+      .def_readwrite("type", &CollisionShapeRecord::type)
+      .def_readwrite("filename", &CollisionShapeRecord::filename)
+      .def_readwrite("scale", &CollisionShapeRecord::scale)
+      .def_readwrite("radius", &CollisionShapeRecord::radius)
+      .def_readwrite("length", &CollisionShapeRecord::length)
+      .def_readwrite("material", &CollisionShapeRecord::material)
+      .def_readwrite("pose", &CollisionShapeRecord::pose)
+      .def_readwrite("density", &CollisionShapeRecord::density)
+      .def_readwrite("patch_radius", &CollisionShapeRecord::patchRadius)
+      .def_readwrite("min_patch_radius", &CollisionShapeRecord::minPatchRadius)
+      .def_readwrite("is_trigger", &CollisionShapeRecord::isTrigger);
+
+  PyVisualShapeRecord
+      .def(py::init([](VisualShapeRecord::Type type, std::string const &filename, Vec3 scale,
+                       float radius, float length,
+                       std::shared_ptr<sapien_renderer::SapienRenderMaterial> material,
+                       Pose const &pose, std::string const &name) {
+             return VisualShapeRecord{type, filename, scale, radius, length, material, pose, name};
+           }),
+           py::arg("type"), py::arg("filename") = "", py::arg("scale") = Vec3(1.f),
+           py::arg("radius") = 1.f, py::arg("length") = 1.f, py::arg("material") = nullptr,
+           py::arg("pose") = Pose(), py::arg("name") = "")
+      .def_readwrite("type", &VisualShapeRecord::type)
+      .def_readwrite("filename", &VisualShapeRecord::filename)
+      .def_readwrite("scale", &VisualShapeRecord::scale)
+      .def_readwrite("radius", &VisualShapeRecord::radius)
+      .def_readwrite("length", &VisualShapeRecord::length)
+      .def_readwrite("material", &VisualShapeRecord::material)
+      .def_readwrite("pose", &VisualShapeRecord::pose)
+      .def_readwrite("name", &VisualShapeRecord::name);
+
+  PyActorBuilder
+      .def(py::init<>(), "Native actor builder, use ActorBuilder.to_native to convert a Python "
+                         "builder")
+      .def("add_collision", &ActorBuilder::addCollision, py::arg("record"),
+           py::return_value_policy::reference_internal)
+      .def("add_visual", &ActorBuilder::addVisual, py::arg("record"),
+           py::return_value_policy::reference_internal)
+      .def_property_readonly("collision_records", &ActorBuilder::getCollisionRecords)
+      .def_property_readonly("visual_records", &ActorBuilder::getVisualRecords)
+      .def(
+          "set_scene",
+          [](ActorBuilder &builder, std::shared_ptr<Scene> scene) -> ActorBuilder & {
+            builder.setScene(scene);
+            return builder;
+          },
+          py::arg("scene"), py::return_value_policy::reference_internal)
+      .def_property("name", &ActorBuilder::getName, &ActorBuilder::setName)
+      .def_property("physx_body_type", &ActorBuilder::getBodyType, &ActorBuilder::setBodyType)
+      .def_property("initial_pose", &ActorBuilder::getInitialPose, &ActorBuilder::setInitialPose)
+      .def_property("collision_groups", &ActorBuilder::getCollisionGroups,
+                    &ActorBuilder::setCollisionGroups)
+      .def("set_mass_and_inertia", &ActorBuilder::setMassAndInertia, py::arg("mass"),
+           py::arg("cmass_local_pose"), py::arg("inertia"))
+      .def("build", &ActorBuilder::build)
+      .def("build_many", &ActorBuilder::buildMany, py::arg("poses"),
+           py::arg("scenes") = std::vector<std::shared_ptr<Scene>>{},
+           "Build one entity per pose in a single call. scenes contains one scene for all "
+           "entities or one scene per pose, an empty list uses the builder's scene. Cooked "
+           "meshes, materials and render meshes are shared by all entities.");
+
+  PySceneBVH
+      .def(py::init<std::shared_ptr<Scene>, SceneBVH::Source, float>(), py::arg("scene"),
+           py::arg("source") = SceneBVH::Source::ePhysx, py::arg("margin") = 0.05f,
+           "Bounding volume hierarchy over physx rigid bodies or render bodies of a scene. It "
+           "is refit before the first query after each physx step, call update after changing "
+           "poses, shapes or entities between steps. Queries return indices into components, "
+           "valid until the next refit, or components when return_components is True.")
+      .def("update", &SceneBVH::update)
+      .def_property_readonly("components", &SceneBVH::getComponents)
+      .def_property_readonly("tree_height", &SceneBVH::getTreeHeight)
+      .def(
+          "get_aabb",
+          [](SceneBVH &bvh, uint32_t index) {
+            auto box = bvh.getAABB(index);
+            return std::make_tuple(box.lower, box.upper);
+          },
+          py::arg("index"))
+      .def(
+          "query_box",
+          [](SceneBVH &bvh, Vec3 const &lower, Vec3 const &upper, bool returnComponents) {
+            return BVHResult(bvh, bvh.queryBox({lower, upper}), returnComponents);
+          },
+          py::arg("lower"), py::arg("upper"), py::arg("return_components") = false)
+      .def(
+          "query_sphere",
+          [](SceneBVH &bvh, Vec3 const &center, float radius, bool returnComponents) {
+            return BVHResult(bvh, bvh.querySphere(center, radius), returnComponents);
+          },
+          py::arg("center"), py::arg("radius"), py::arg("return_components") = false)
+      .def(
+          "query_frustum",
+          [](SceneBVH &bvh, Eigen::Matrix<float, Eigen::Dynamic, 4, Eigen::RowMajor> const &planes,
+             bool returnComponents) {
+            std::vector<std::array<float, 4>> p(planes.rows());
+            for (uint32_t i = 0; i < planes.rows(); ++i) {
+              p[i] = {planes(i, 0), planes(i, 1), planes(i, 2), planes(i, 3)};
+            }
+            return BVHResult(bvh, bvh.queryFrustum(p), returnComponents);
+          },
+          py::arg("planes"), py::arg("return_components") = false,
+          "planes is an [N, 4] array of (a, b, c, d) with a x + b y + c z + d >= 0 inside")
+      .def(
+          "query_nearest",
+          [](SceneBVH &bvh, Vec3 const &point, uint32_t k, bool returnComponents) {
+            return BVHResult(bvh, bvh.queryNearest(point, k), returnComponents);
+          },
+          py::arg("point"), py::arg("k"), py::arg("return_components") = false,
+          "k components whose bounding boxes are closest to point, sorted by distance");
+
+  PyCpuArrayPool
+      .def_static("get", &CpuArrayPool::Get,
+                  "Pool of aligned host memory backing CPU images. Returned numpy arrays share "
+                  "pooled memory and return it to the pool when they are released.")
+      .def_property("max_pooled_bytes", &CpuArrayPool::getMaxPooledBytes,
+                    &CpuArrayPool::setMaxPooledBytes)
+      .def_property_readonly("pooled_bytes", &CpuArrayPool::getPooledBytes)
+      .def("clear", &CpuArrayPool::clear);
+
   PyCudaArray
       .def(py::init<>([](py::object obj) {
              auto interface = obj.attr("__cuda_array_interface__").cast<py::dict>();
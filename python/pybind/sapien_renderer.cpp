@@ -1,4 +1,5 @@
 #include "sapien/sapien_renderer/sapien_renderer.h"
+#include "sapien/utils/frame_recorder.h"
 #include "array.hpp"
 #include "format.hpp"
 #include "sapien_type_caster.h"
@@ -45,6 +46,34 @@ template <> struct type_caster<CameraMode> {
   }
 };
 
+template <> struct type_caster<PointCloudFrame> {
+  PYBIND11_TYPE_CASTER(PointCloudFrame, _("typing.Literal['world', 'camera']"));
+
+  bool load(py::handle src, bool convert) {
+    std::string name = py::cast<std::string>(src);
+    if (name == "world") {
+      value = PointCloudFrame::eWorld;
+      return true;
+    } else if (name == "camera") {
+      value = PointCloudFrame::eCamera;
+      return true;
+    }
+    return false;
+  }
+
+  static py::handle cast(PointCloudFrame const &src, py::return_value_policy policy,
+                         py::handle parent) {
+    switch (src) {
+    case PointCloudFrame::eWorld:
+      return py::str("world").release();
+    case PointCloudFrame::eCamera:
+      return py::str("camera").release();
+    default:
+      return py::str("none").release();
+    }
+  }
+};
+
 template <> struct type_caster<svulkan2::renderer::RTRenderer::DenoiserType> {
   PYBIND11_TYPE_CASTER(svulkan2::renderer::RTRenderer::DenoiserType,
                        _("typing.Literal['none', 'oidn', 'optix']"));
@@ -385,6 +414,43 @@ template <> struct type_caster<SapienRenderTexture::FilterMode> {
   }
 };
 
+template <> struct type_caster<FrameRecorder::Format> {
+  PYBIND11_TYPE_CASTER(FrameRecorder::Format, _("typing.Literal['png', 'exr', 'npy', 'bin']"));
+
+  bool load(py::handle src, bool convert) {
+    std::string name = py::cast<std::string>(src);
+    if (name == "png") {
+      value = FrameRecorder::Format::ePNG;
+      return true;
+    } else if (name == "exr") {
+      value = FrameRecorder::Format::eEXR;
+      return true;
+    } else if (name == "npy") {
+      value = FrameRecorder::Format::eNPY;
+      return true;
+    } else if (name == "bin") {
+      value = FrameRecorder::Format::eBIN;
+      return true;
+    }
+    return false;
+  }
+
+  static py::handle cast(FrameRecorder::Format const &src, py::return_value_policy policy,
+                         py::handle parent) {
+    switch (src) {
+    case FrameRecorder::Format::ePNG:
+      return py::str("png").release();
+    case FrameRecorder::Format::eEXR:
+      return py::str("exr").release();
+    case FrameRecorder::Format::eNPY:
+      return py::str("npy").release();
+    case FrameRecorder::Format::eBIN:
+      return py::str("bin").release();
+    }
+    throw std::runtime_error("invalid frame recorder format");
+  }
+};
+
 template <> struct type_caster<SapienRenderTexture::AddressMode> {
   PYBIND11_TYPE_CASTER(SapienRenderTexture::AddressMode,
                        _("typing.Literal['repeat', 'border', 'edge', 'mirror']"));
@@ -465,6 +531,13 @@ void init_sapien_renderer(py::module &sapien) {
       .def("set_msaa", &SapienRendererDefault::setMSAA, py::arg("msaa"))
       .def("set_picture_format", &SapienRendererDefault::setRenderTargetFormat, py::arg("name"),
            py::arg("format"))
+      .def("set_mesh_lod_levels", &SapienRendererDefault::setMeshLodLevels, py::arg("levels"),
+           "Generate this many LOD levels for every mesh loaded from file afterwards, 0 disables "
+           "LOD generation")
+      .def("set_mesh_lod_cache_dir", &SapienRendererDefault::setMeshLodCacheDirectory,
+           py::arg("dir"),
+           "Directory caching LODs of meshes loaded from file, empty disables caching. Defaults "
+           "to ~/.sapien/lod_cache")
 
       .def("get_imgui_ini_filename", &SapienRendererDefault::getImguiIniFilename)
       .def("get_vr_action_manifest_filename", &SapienRendererDefault::getVRActionManifestFilename)
@@ -477,13 +550,18 @@ void init_sapien_renderer(py::module &sapien) {
       .def("get_ray_tracing_dof_aperture", &SapienRendererDefault::getRayTracingDoFAperture)
       .def("get_ray_tracing_dof_plane", &SapienRendererDefault::getRayTracingDoFPlane)
       .def("get_msaa", &SapienRendererDefault::getMSAA)
+      .def("get_mesh_lod_levels", &SapienRendererDefault::getMeshLodLevels)
+      .def("get_mesh_lod_cache_dir", &SapienRendererDefault::getMeshLodCacheDirectory)
 
       .def("set_log_level", &svulkan2::logger::setLogLevel, py::arg("level"))
       .def(
           "clear_cache",
           [](bool models, bool images, bool shaders) {
-            SapienRenderEngine::Get(nullptr)->getResourceManager()->clearCachedResources(
-                models, images, shaders);
+            auto engine = SapienRenderEngine::Get(nullptr);
+            engine->getResourceManager()->clearCachedResources(models, images, shaders);
+            if (models || images) {
+              engine->getResourceCache()->clearUnused();
+            }
           },
           py::arg("models") = true, py::arg("images") = true, py::arg("shaders") = false)
 
@@ -495,6 +573,25 @@ void init_sapien_renderer(py::module &sapien) {
           py::arg("filename"), py::arg("apply_scale") = true)
       .def("get_device_summary", []() { return SapienRenderEngine::Get(nullptr)->getSummary(); })
 
+      .def(
+          "set_resource_memory_budget",
+          [](uint64_t bytes) {
+            SapienRenderEngine::Get(nullptr)->getResourceCache()->setMemoryBudget(bytes);
+          },
+          py::arg("bytes"),
+          "Evict meshes and textures loaded from files, least recently used first, when they "
+          "are no longer used and the cache exceeds this many bytes. 0 means unlimited.")
+      .def("get_resource_memory_budget",
+           []() {
+             return SapienRenderEngine::Get(nullptr)->getResourceCache()->getMemoryBudget();
+           })
+      .def("get_resource_cache_stats",
+           []() { return SapienRenderEngine::Get(nullptr)->getResourceCache()->getStats(); })
+      .def(
+          "clear_unused_resources",
+          []() { SapienRenderEngine::Get(nullptr)->getResourceCache()->clearUnused(); },
+          "Evict all cached meshes and textures that are no longer used")
+
       .def("set_global_config", &SapienRendererDefault::setGlobalConfig,
            py::arg("max_num_materials") = 128, py::arg("max_num_textures") = 512,
            py::arg("default_mipmap_levels") = 1, py::arg("do_not_load_texture") = false,
@@ -503,6 +600,25 @@ void init_sapien_renderer(py::module &sapien) {
 
   ////////// end global //////////
 
+  auto PyRenderResourceCacheStats =
+      py::class_<RenderResourceCacheStats>(m, "RenderResourceCacheStats");
+  PyRenderResourceCacheStats.def_readonly("model_count", &RenderResourceCacheStats::modelCount)
+      .def_readonly("texture_count", &RenderResourceCacheStats::textureCount)
+      .def_readonly("mesh_count", &RenderResourceCacheStats::meshCount)
+      .def_readonly("unused_count", &RenderResourceCacheStats::unusedCount)
+      .def_readonly("bytes", &RenderResourceCacheStats::bytes)
+      .def_readonly("unused_bytes", &RenderResourceCacheStats::unusedBytes)
+      .def_readonly("budget", &RenderResourceCacheStats::budget)
+      .def_readonly("hits", &RenderResourceCacheStats::hits)
+      .def_readonly("misses", &RenderResourceCacheStats::misses)
+      .def_readonly("evictions", &RenderResourceCacheStats::evictions)
+      .def("__repr__", [](RenderResourceCacheStats const &s) {
+        return "RenderResourceCacheStats(bytes=" + std::to_string(s.bytes) +
+               ", unused_bytes=" + std::to_string(s.unusedBytes) +
+               ", hits=" + std::to_string(s.hits) + ", misses=" + std::to_string(s.misses) +
+               ")";
+      });
+
   auto PySapienRenderer = py::class_<SapienRenderEngine>(m, "SapienRenderer");
   auto PyRenderTexture = py::class_<SapienRenderTexture>(m, "RenderTexture");
   auto PyRenderTexture2D = py::class_<SapienRenderTexture2D>(m, "RenderTexture2D");
@@ -533,6 +649,8 @@ void init_sapien_renderer(py::module &sapien) {
 
   auto PyRenderSystemGroup = py::class_<BatchedRenderSystem>(m, "RenderSystemGroup");
   auto PyCameraGroup = py::class_<BatchedCamera>(m, "RenderCameraGroup");
+  auto PyHostCameraGroup = py::class_<HostBatchedCamera>(m, "RenderHostCameraGroup");
+  auto PyFrameRecorder = py::class_<FrameRecorder>(m, "FrameRecorder");
 
   auto PyRenderBodyComponent =
       py::class_<SapienRenderBodyComponent, Component>(m, "RenderBodyComponent");
@@ -583,6 +701,88 @@ This function waits for any pending CUDA operations on cuda stream provided by :
   PyCameraGroup.def("take_picture", &BatchedCamera::takePicture)
       .def("get_picture_cuda", &BatchedCamera::getPictureCuda, py::arg("name"));
 
+  PyHostCameraGroup
+      .def(py::init<std::vector<std::shared_ptr<SapienRenderCameraComponent>>,
+                    std::vector<std::string>>(),
+           py::arg("cameras"), py::arg("picture_names"), R"doc(
+Render many cameras, possibly from different scenes, and read the chosen pictures
+back into host memory with a single wait. Only requires Vulkan.
+
+Usage:
+
+group = sapien.render.RenderHostCameraGroup(cameras, ["Color"])
+for scene in scenes:
+    scene.update_render()
+group.take_picture()
+rgba = group.get_picture("Color")  # [N, H, W, 4]
+)doc")
+      .def_property_readonly("cameras", &HostBatchedCamera::getCameras)
+      .def("take_picture", &HostBatchedCamera::takePicture)
+      .def("get_picture", &HostBatchedCamera::getPicture, py::arg("name"));
+
+  PyFrameRecorder
+      .def(py::init<std::string, FrameRecorder::Format, uint32_t, uint32_t>(),
+           py::arg("directory"), py::arg("format") = FrameRecorder::Format::ePNG,
+           py::arg("thread_count") = 0, py::arg("max_queued_frames") = 16, R"doc(
+Write camera pictures to disk on background threads. Each picture name is a stream
+written to directory/name/<frame>.png|exr|npy, or appended to directory/name.bin in the
+order the pictures were added.
+Adding a picture blocks only while max_queued_frames pictures are waiting.
+
+png: uint8 and uint16 pictures, float pictures in [0, 1] are stored as 8 bit
+exr: uncompressed float32, uint32 and int32 pictures
+npy, bin: any picture
+
+Usage:
+
+recorder = sapien.render.FrameRecorder("out", "png")
+for frame in range(100):
+    scene.step()
+    scene.update_render()
+    camera.take_picture()
+    recorder.add_camera(camera, frame, ["Color"])
+recorder.flush()
+)doc")
+      .def(
+          "add_image",
+          [](FrameRecorder &r, std::string const &name, uint64_t frame, py::array image) {
+            CpuArrayHandle handle{.shape = {image.shape(), image.shape() + image.ndim()},
+                                  .strides = {image.strides(), image.strides() + image.ndim()},
+                                  .type = py::cast<std::string>(image.dtype().attr("str")),
+                                  .ptr = const_cast<void *>(image.data())};
+            py::gil_scoped_release release;
+            r.addImage(name, frame, handle);
+          },
+          py::arg("name"), py::arg("frame"), py::arg("image"),
+          "Queue an image [H, W] or [H, W, C], or a batch [N, H, W, C] written to streams "
+          "name_0 to name_(N-1)")
+      .def(
+          "add_camera",
+          [](FrameRecorder &r, SapienRenderCameraComponent &camera, uint64_t frame,
+             std::vector<std::string> const &names) {
+            for (auto &name : names) {
+              CpuArrayHandle image = camera.getImage(name);
+              py::gil_scoped_release release;
+              r.addImage(name, frame, image);
+            }
+          },
+          py::arg("camera"), py::arg("frame"), py::arg("picture_names"))
+      .def(
+          "add_camera_group",
+          [](FrameRecorder &r, HostBatchedCamera &group, uint64_t frame,
+             std::vector<std::string> const &names) {
+            for (auto &name : names) {
+              CpuArrayHandle images = group.getPicture(name);
+              py::gil_scoped_release release;
+              r.addImage(name, frame, images);
+            }
+          },
+          py::arg("group"), py::arg("frame"), py::arg("picture_names"),
+          "Queue pictures of all cameras in the group, camera i is written to stream name_i")
+      .def("flush", &FrameRecorder::flush, py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly("queued_frame_count", &FrameRecorder::getQueuedFrameCount)
+      .def_property_readonly("written_frame_count", &FrameRecorder::getWrittenFrameCount);
+
   PyRenderSystem
       .def(py::init([](std::shared_ptr<Device> device) {
              return std::make_shared<SapienRendererSystem>(device);
@@ -610,6 +810,16 @@ This function waits for any pending CUDA operations on cuda stream provided by :
       .def_property_readonly("lights", &SapienRendererSystem::getLightComponents)
       .def("get_lights", &SapienRendererSystem::getLightComponents)
 
+      .def_property_readonly("updated_node_count", &SapienRendererSystem::getUpdatedNodeCount,
+                             "number of render bodies and point clouds moved by the last update")
+      .def_property("culling_thread_count", &SapienRendererSystem::getCullingThreadCount,
+                    &SapienRendererSystem::setCullingThreadCount,
+                    "threads used by camera frustum culling in large scenes, 0 uses all cores")
+      .def_property("lod_bias", &SapienRendererSystem::getLodBias,
+                    &SapienRendererSystem::setLodBias,
+                    "levels added to the LOD level selected by cameras, positive values select "
+                    "coarser meshes")
+
       .def_property("cubemap", &SapienRendererSystem::getCubemap,
                     &SapienRendererSystem::setCubemap)
       .def("get_cubemap", &SapienRendererSystem::getCubemap)
@@ -666,6 +876,16 @@ This function waits for any pending CUDA operations on cuda stream provided by :
            "Create texture from file. The srgb parameter only affects files in uint8 format; it "
            "should be true for color textures (diffuse, emission) and false for others (normal, "
            "roughness)")
+      .def_static("prefetch", &SapienRenderTexture2D::Prefetch, py::arg("filenames"),
+                  py::arg("mipmap_levels") = 1,
+                  py::arg("filter_mode") = SapienRenderTexture::FilterMode::eLINEAR,
+                  py::arg("address_mode") = SapienRenderTexture::AddressMode::eREPEAT,
+                  py::arg("srgb") = true, py::arg("thread_count") = 0,
+                  "Decode texture files on worker threads and upload them, so creating "
+                  "textures from these files with the same parameters afterwards does not "
+                  "block. KTX2 files in BCn or other Vulkan formats skip decoding. Prefetched "
+                  "textures are kept over the resource memory budget until they are created or "
+                  "clear_unused_resources is called.")
       .def_property_readonly("width", &SapienRenderTexture2D::getWidth)
       .def("get_width", &SapienRenderTexture2D::getWidth)
       .def_property_readonly("height", &SapienRenderTexture2D::getHeight)
@@ -879,7 +1099,15 @@ This function waits for any pending CUDA operations on cuda stream provided by :
                     &RenderShapeTriangleMesh::setScale)
       .def("get_scale", &RenderShapeTriangleMesh::getScale)
       .def("set_scale", &RenderShapeTriangleMesh::setScale, py::arg("scale"),
-           "Note: this function only works when the shape is not added to scene");
+           "Note: this function only works when the shape is not added to scene")
+      .def("generate_lods", &RenderShapeTriangleMesh::generateLods, py::arg("levels"),
+           py::arg("ratio") = 0.25f,
+           "Generate simplified meshes, each keeping about ratio of the triangles of the "
+           "previous level. Meshes loaded from file cache the result in the directory set by "
+           "set_mesh_lod_cache_dir. Note: "
+           "this function only works when the shape is not attached to a render body")
+      .def_property_readonly("lod_count",
+                             [](RenderShapeTriangleMesh &s) { return s.getLodModels().size(); });
 
   PyRenderBodyComponent.def(py::init<>())
       .def("attach", &SapienRenderBodyComponent::attachRenderShape, py::arg("shape"))
@@ -912,6 +1140,12 @@ This function waits for any pending CUDA operations on cuda stream provided by :
                              &SapienRenderBodyComponent::getRenderIdDisabled)
       .def("disable_render_id", &SapienRenderBodyComponent::disableRenderId)
       .def("enable_render_id", &SapienRenderBodyComponent::enableRenderId)
+      .def_property("static", &SapienRenderBodyComponent::getStatic,
+                    &SapienRenderBodyComponent::setStatic,
+                    "Static bodies are not checked for pose changes on every render update. "
+                    "They are only updated when added to scene and by set_pose on their entity, "
+                    "so they must not be moved by physics. Can only be set before adding to "
+                    "scene.")
       .def("clone", &SapienRenderBodyComponent::clone);
 
   PyRenderPointCloudComponent.def(py::init<uint32_t>(), py::arg("capacity") = 0)
@@ -1021,6 +1255,16 @@ This function waits for any pending CUDA operations on cuda stream provided by :
       .def("take_picture", &SapienRenderCameraComponent::takePicture)
       .def("get_picture_names", &SapienRenderCameraComponent::getImageNames)
 
+      .def_property("frustum_culling", &SapienRenderCameraComponent::getFrustumCulling,
+                    &SapienRenderCameraComponent::setFrustumCulling,
+                    "Hide objects outside the view frustum while taking pictures, only "
+                    "supported by the rasterizer. Culled objects do not cast shadows into the "
+                    "picture.")
+      .def_property_readonly("culled_object_count",
+                             &SapienRenderCameraComponent::getCulledObjectCount)
+      .def_property_readonly("lod_object_count", &SapienRenderCameraComponent::getLodObjectCount)
+      .def("get_frustum_planes", &SapienRenderCameraComponent::getFrustumPlanes)
+
       .def(
           "get_picture",
           [](SapienRenderCameraComponent &c, std::string const &name) {
@@ -1028,6 +1272,89 @@ This function waits for any pending CUDA operations on cuda stream provided by :
           },
           py::arg("name"))
 
+      .def(
+          "get_point_cloud",
+          [](SapienRenderCameraComponent &c, PointCloudFrame frame, bool color,
+             bool segmentation, float minDepth, float maxDepth,
+             std::vector<uint32_t> segmentationIds, uint32_t segmentationLevel,
+             uint32_t threadCount) {
+            PointCloud pc;
+            {
+              py::gil_scoped_release release;
+              pc = c.getPointCloud({.frame = frame,
+                                    .color = color,
+                                    .segmentation = segmentation,
+                                    .minDepth = minDepth,
+                                    .maxDepth = maxDepth,
+                                    .segmentationIds = segmentationIds,
+                                    .segmentationLevel = segmentationLevel,
+                                    .threadCount = threadCount});
+            }
+            py::dict result("points"_a = pc.points);
+            if (color) {
+              result["colors"] = pc.colors;
+            }
+            if (segmentation) {
+              result["segmentation"] = pc.segmentation;
+            }
+            return result;
+          },
+          py::arg("frame") = PointCloudFrame::eWorld, py::arg("color") = false,
+          py::arg("segmentation") = false, py::arg("min_depth") = 0.f,
+          py::arg("max_depth") = 0.f, py::arg("segmentation_ids") = std::vector<uint32_t>{},
+          py::arg("segmentation_level") = 1, py::arg("thread_count") = 0,
+          R"doc(
+Build a point cloud from the Position target of the last picture in one native
+pass, instead of reshaping, masking and transforming pictures in numpy.
+
+:param frame: "world", or "camera" for the frame of the Position target (x right,
+    y up, z back)
+:param color: also return "colors", [N, 4] float32 from the Color target
+:param segmentation: also return "segmentation", [N, 4] uint32 from the
+    Segmentation target
+:param min_depth: drop points closer than this along the view direction
+:param max_depth: drop points farther than this along the view direction, 0
+    keeps all rendered points
+:param segmentation_ids: keep only points whose segmentation id is listed
+:param segmentation_level: segmentation channel matched by segmentation_ids, 0
+    for render shapes and 1 for entities
+:param thread_count: threads used to build the point cloud, 0 uses all cores
+:return: dict with "points" [N, 3] float32 and the requested arrays
+
+Usage:
+
+camera.take_picture()
+pc = camera.get_point_cloud(color=True, segmentation_ids=[box.per_scene_id])
+xyz, rgba = pc["points"], pc["colors"]
+)doc")
+
+      .def_property("async_readback_targets",
+                    &SapienRenderCameraComponent::getAsyncReadbackTargets,
+                    &SapienRenderCameraComponent::setAsyncReadbackTargets)
+      .def("get_async_frame", &SapienRenderCameraComponent::getAsyncFrame,
+           py::arg("wait") = false)
+      .def(
+          "get_picture_async",
+          [](SapienRenderCameraComponent &c, std::string const &name, uint64_t frame) {
+            return CpuArrayHandle(c.getImageAsync(name, frame));
+          },
+          py::arg("name"), py::arg("frame"),
+          R"doc(
+Read a render target copied to host memory by take_picture without stalling the
+GPU. The target must be listed in async_readback_targets.
+
+Usage:
+
+camera.async_readback_targets = ["Color"]
+while True:
+    scene.update_render()
+    camera.take_picture()  # renders frame N + 1 while frame N is read
+    frame = camera.get_async_frame()  # newest completed picture, 0 if none
+    if frame:
+        rgba = camera.get_picture_async("Color", frame)
+    scene.step()
+)doc")
+
       // .def("gpu_init", &SapienRenderCameraComponent::gpuInit,
       //      "Do rendering once to ensure all GPU resources for this camera is initialized")
       .def_property_readonly(
@@ -0,0 +1,193 @@
+#include "sapien/actor_builder.h"
+#include "./logger.h"
+#include "sapien/entity.h"
+#include "sapien/physx/physx.h"
+#include "sapien/profiler.h"
+#include "sapien/sapien_renderer/sapien_renderer.h"
+#include "sapien/scene.h"
+
+namespace sapien {
+
+using namespace physx;
+using namespace sapien_renderer;
+
+void ActorBuilder::setMassAndInertia(float mass, Pose const &cmassLocalPose,
+                                     Vec3 const &inertia) {
+  mMass = mass;
+  mCMassLocalPose = cmassLocalPose;
+  mInertia = inertia;
+  mAutoInertial = false;
+}
+
+std::vector<std::shared_ptr<PhysxCollisionShape>> ActorBuilder::buildCollisionShapes() const {
+  SAPIEN_PROFILE_FUNCTION;
+
+  std::vector<std::shared_ptr<PhysxCollisionShape>> result;
+  for (auto const &r : mCollisionRecords) {
+    auto material = r.material ? r.material : PhysxDefault::GetDefaultMaterial();
+
+    std::vector<std::shared_ptr<PhysxCollisionShape>> shapes;
+    try {
+      switch (r.type) {
+      case CollisionShapeRecord::Type::ePlane:
+        shapes.push_back(std::make_shared<PhysxCollisionShapePlane>(material));
+        break;
+      case CollisionShapeRecord::Type::eBox:
+        shapes.push_back(std::make_shared<PhysxCollisionShapeBox>(r.scale, material));
+        break;
+      case CollisionShapeRecord::Type::eCapsule:
+        shapes.push_back(
+            std::make_shared<PhysxCollisionShapeCapsule>(r.radius, r.length, material));
+        break;
+      case CollisionShapeRecord::Type::eCylinder:
+        shapes.push_back(
+            std::make_shared<PhysxCollisionShapeCylinder>(r.radius, r.length, material));
+        break;
+      case CollisionShapeRecord::Type::eSphere:
+        shapes.push_back(std::make_shared<PhysxCollisionShapeSphere>(r.radius, material));
+        break;
+      case CollisionShapeRecord::Type::eConvexMesh:
+        shapes.push_back(
+            std::make_shared<PhysxCollisionShapeConvexMesh>(r.filename, r.scale, material));
+        break;
+      case CollisionShapeRecord::Type::eNonconvexMesh:
+        shapes.push_back(std::make_shared<PhysxCollisionShapeTriangleMesh>(
+            r.filename, r.scale, material, mBodyType == BodyType::eDynamic));
+        break;
+      case CollisionShapeRecord::Type::eMultipleConvexMeshes: {
+        auto meshes = PhysxCollisionShapeConvexMesh::LoadMultiple(r.filename, r.scale, material);
+        shapes.insert(shapes.end(), meshes.begin(), meshes.end());
+        break;
+      }
+      }
+    } catch (std::runtime_error const &e) {
+      // same as the Python builder, shapes that fail to build (e.g. cooking) are skipped
+      logger::warn("failed to build collision shape: {}", e.what());
+      continue;
+    }
+
+    for (auto &shape : shapes) {
+      shape->setLocalPose(r.pose);
+      shape->setCollisionGroups(mCollisionGroups);
+      shape->setDensity(r.type == CollisionShapeRecord::Type::ePlane ? 0.f : r.density);
+      shape->setTorsionalPatchRadius(r.patchRadius);
+      shape->setMinTorsionalPatchRadius(r.minPatchRadius);
+      shape->setIsTrigger(r.isTrigger);
+      result.push_back(shape);
+    }
+  }
+  return result;
+}
+
+std::shared_ptr<SapienRenderBodyComponent> ActorBuilder::buildRenderComponent() const {
+  SAPIEN_PROFILE_FUNCTION;
+
+  auto component = std::make_shared<SapienRenderBodyComponent>();
+  for (auto const &r : mVisualRecords) {
+    auto material = r.material;
+    if (!material && r.type != VisualShapeRecord::Type::eFile) {
+      material = std::make_shared<SapienRenderMaterial>();
+    }
+
+    std::shared_ptr<RenderShape> shape;
+    switch (r.type) {
+    case VisualShapeRecord::Type::ePlane:
+      shape = std::make_shared<RenderShapePlane>(r.scale, material);
+      break;
+    case VisualShapeRecord::Type::eBox:
+      shape = std::make_shared<RenderShapeBox>(r.scale, material);
+      break;
+    case VisualShapeRecord::Type::eSphere:
+      shape = std::make_shared<RenderShapeSphere>(r.radius, material);
+      break;
+    case VisualShapeRecord::Type::eCapsule:
+      shape = std::make_shared<RenderShapeCapsule>(r.radius, r.length, material);
+      break;
+    case VisualShapeRecord::Type::eCylinder:
+      shape = std::make_shared<RenderShapeCylinder>(r.radius, r.length, material);
+      break;
+    case VisualShapeRecord::Type::eFile:
+      shape = std::make_shared<RenderShapeTriangleMesh>(r.filename, r.scale, material);
+      if (r.scale.x * r.scale.y * r.scale.z < 0.f) {
+        shape->setFrontFace(vk::FrontFace::eClockwise);
+      }
+      break;
+    }
+    shape->setLocalPose(r.pose);
+    shape->setName(r.name);
+    component->attachRenderShape(shape);
+  }
+  component->setName(mName);
+  return component;
+}
+
+std::shared_ptr<Entity> ActorBuilder::build() { return buildMany({mInitialPose}).at(0); }
+
+std::vector<std::shared_ptr<Entity>>
+ActorBuilder::buildMany(std::vector<Pose> const &poses,
+                        std::vector<std::shared_ptr<Scene>> scenes) {
+  SAPIEN_PROFILE_FUNCTION;
+
+  if (scenes.empty() && mScene) {
+    scenes.push_back(mScene);
+  }
+  if (scenes.empty()) {
+    throw std::runtime_error(
+        "failed to build actors: you need to set the scene of the actor builder");
+  }
+  if (scenes.size() != 1 && scenes.size() != poses.size()) {
+    throw std::runtime_error(
+        "failed to build actors: the number of scenes must be 1 or match the number of poses");
+  }
+
+  // shapes are built once and cloned, clones share meshes and materials with the prototypes
+  auto collisionShapes = buildCollisionShapes();
+  std::shared_ptr<SapienRenderBodyComponent> renderPrototype;
+  if (!mVisualRecords.empty()) {
+    renderPrototype = buildRenderComponent();
+  }
+
+  std::vector<std::shared_ptr<Entity>> entities;
+  entities.reserve(poses.size());
+  for (uint32_t i = 0; i < poses.size(); ++i) {
+    // the last instance takes the prototypes themselves
+    bool last = i + 1 == poses.size();
+    auto entity = std::make_shared<Entity>();
+
+    if (renderPrototype) {
+      auto render = last ? renderPrototype : renderPrototype->clone();
+      render->setName(mName);
+      entity->addComponent(render);
+    }
+
+    std::shared_ptr<PhysxRigidBaseComponent> body;
+    if (mBodyType == BodyType::eStatic) {
+      body = std::make_shared<PhysxRigidStaticComponent>();
+    } else {
+      auto dynamic = std::make_shared<PhysxRigidDynamicComponent>();
+      if (mBodyType == BodyType::eKinematic) {
+        dynamic->setKinematic(true);
+      }
+      body = dynamic;
+    }
+    for (auto &shape : collisionShapes) {
+      body->attachCollision(last ? shape : shape->clone());
+    }
+    if (!mAutoInertial && mBodyType == BodyType::eDynamic) {
+      auto dynamic = std::static_pointer_cast<PhysxRigidDynamicComponent>(body);
+      dynamic->setMass(mMass);
+      dynamic->setCMassLocalPose(mCMassLocalPose);
+      dynamic->setInertia(mInertia);
+    }
+    body->setName(mName);
+    entity->addComponent(body);
+
+    entity->setName(mName);
+    entity->setPose(poses[i]);
+    (scenes.size() == 1 ? scenes[0] : scenes[i])->addEntity(entity);
+    entities.push_back(entity);
+  }
+  return entities;
+}
+
+} // namespace sapien
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <sstream>
 #include "sapien/array.h"
 #include "sapien/utils/cuda.h"
@@ -127,6 +128,41 @@ DLManagedTensor *CudaArrayHandle::toDLPack() const {
   return tensor;
 }
 
+struct CpuDLPackContext {
+  std::shared_ptr<void> owner;
+  std::vector<int64_t> shape;
+  std::vector<int64_t> strides;
+};
+
+static void CpuDLManagedTensorDeleter(DLManagedTensor *self) {
+  delete static_cast<CpuDLPackContext *>(self->manager_ctx);
+  delete self;
+}
+
+DLManagedTensor *CpuArrayHandle::toDLPack() const {
+  auto dtype = TypestrToDLDataType(type);
+  auto context = new CpuDLPackContext{.owner = owner};
+  int itemsize = typestrBytes(type);
+  for (uint32_t i = 0; i < shape.size(); ++i) {
+    context->shape.push_back(shape[i]);
+    context->strides.push_back(strides[i] / itemsize);
+  }
+
+  auto tensor = new DLManagedTensor();
+  tensor->manager_ctx = context;
+  tensor->deleter = &CpuDLManagedTensorDeleter;
+
+  tensor->dl_tensor.data = ptr;
+  tensor->dl_tensor.device = {kDLCPU, 0};
+  tensor->dl_tensor.ndim = shape.size();
+  tensor->dl_tensor.dtype = dtype;
+  tensor->dl_tensor.shape = context->shape.data();
+  tensor->dl_tensor.strides = context->strides.data();
+  tensor->dl_tensor.byte_offset = 0;
+
+  return tensor;
+}
+
 CudaArray CudaArray::FromData(void *data, int size) {
   CudaArray buffer({size}, "u1");
 #ifdef SAPIEN_CUDA
@@ -0,0 +1,139 @@
+#include "sapien/array.h"
+#include "sapien/utils/typestr.h"
+#include <bit>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace sapien {
+
+static constexpr size_t CpuArrayAlignment = 64;
+
+static void *AlignedAlloc(size_t bytes) {
+#ifdef _MSC_VER
+  void *ptr = _aligned_malloc(bytes, CpuArrayAlignment);
+#else
+  void *ptr = std::aligned_alloc(CpuArrayAlignment, bytes);
+#endif
+  if (!ptr) {
+    throw std::runtime_error("failed to allocate cpu array: out of memory");
+  }
+  return ptr;
+}
+
+static void AlignedFree(void *ptr) {
+#ifdef _MSC_VER
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+static std::shared_ptr<CpuArrayPool> gPool;
+static std::once_flag gPoolFlag;
+
+std::shared_ptr<CpuArrayPool> CpuArrayPool::Get() {
+  std::call_once(gPoolFlag, []() { gPool = std::make_shared<CpuArrayPool>(); });
+  return gPool;
+}
+
+std::shared_ptr<void> CpuArrayPool::allocate(size_t bytes) {
+  if (bytes == 0) {
+    return nullptr;
+  }
+  size_t blockSize = std::bit_ceil(std::max(bytes, CpuArrayAlignment));
+
+  void *ptr{};
+  {
+    std::lock_guard lock(mMutex);
+    auto it = mFreeBlocks.find(blockSize);
+    if (it != mFreeBlocks.end() && !it->second.empty()) {
+      ptr = it->second.back();
+      it->second.pop_back();
+      mPooledBytes -= blockSize;
+    }
+  }
+  if (!ptr) {
+    ptr = AlignedAlloc(blockSize);
+  }
+
+  // blocks released after the pool is destroyed are freed directly
+  std::weak_ptr<CpuArrayPool> pool = weak_from_this();
+  return std::shared_ptr<void>(ptr, [pool, blockSize](void *ptr) {
+    if (auto p = pool.lock()) {
+      p->release(ptr, blockSize);
+    } else {
+      AlignedFree(ptr);
+    }
+  });
+}
+
+void CpuArrayPool::release(void *ptr, size_t bytes) {
+  std::lock_guard lock(mMutex);
+  if (mPooledBytes + bytes > mMaxPooledBytes) {
+    AlignedFree(ptr);
+    return;
+  }
+  mFreeBlocks[bytes].push_back(ptr);
+  mPooledBytes += bytes;
+}
+
+void CpuArrayPool::trim(size_t maxBytes) {
+  // free the largest blocks first
+  for (auto it = mFreeBlocks.rbegin(); it != mFreeBlocks.rend() && mPooledBytes > maxBytes;
+       ++it) {
+    auto &blocks = it->second;
+    while (!blocks.empty() && mPooledBytes > maxBytes) {
+      AlignedFree(blocks.back());
+      blocks.pop_back();
+      mPooledBytes -= it->first;
+    }
+  }
+}
+
+void CpuArrayPool::setMaxPooledBytes(size_t bytes) {
+  std::lock_guard lock(mMutex);
+  mMaxPooledBytes = bytes;
+  trim(bytes);
+}
+
+void CpuArrayPool::clear() {
+  std::lock_guard lock(mMutex);
+  trim(0);
+  mFreeBlocks.clear();
+}
+
+CpuArrayPool::~CpuArrayPool() { trim(0); }
+
+bool CpuArrayHandle::isContiguous() const {
+  return strides == ShapeToStrides(shape, typestrBytes(type));
+}
+
+int CpuArrayHandle::bytes() const {
+  int size = 1;
+  for (auto s : shape) {
+    size *= s;
+  }
+  return size * typestrBytes(type);
+}
+
+CpuArray::CpuArray(std::vector<int> shape_, std::string type_) : shape(shape_), type(type_) {
+  data = CpuArrayPool::Get()->allocate(bytes());
+}
+
+CpuArrayHandle CpuArray::handle() const {
+  return CpuArrayHandle{.shape = shape,
+                        .strides = ShapeToStrides(shape, typestrBytes(type)),
+                        .type = type,
+                        .ptr = data.get(),
+                        .owner = data};
+}
+
+int CpuArray::bytes() const {
+  int size = 1;
+  for (auto s : shape) {
+    size *= s;
+  }
+  return size * typestrBytes(type);
+}
+
+} // namespace sapien
@@ -17,6 +17,7 @@ std::shared_ptr<Scene> Entity::getScene() { return mScene ? mScene->shared_from_
 
 void Entity::setPose(Pose const &pose) {
   mPose = pose;
+  mPoseVersion++;
 
   // TODO: defer the sync?
   for (auto &c : mComponents) {
@@ -80,7 +81,15 @@ void Entity::onRemoveFromScene(Scene &scene) {
 }
 
 Pose Entity::getPose() const { return mPose; }
-void Entity::internalSyncPose(Pose const &pose) { mPose = pose; }
+void Entity::internalSyncPose(Pose const &pose) {
+  // physx syncs every body on every step, sleeping bodies keep their version
+  if (pose.p.x != mPose.p.x || pose.p.y != mPose.p.y || pose.p.z != mPose.p.z ||
+      pose.q.w != mPose.q.w || pose.q.x != mPose.q.x || pose.q.y != mPose.q.y ||
+      pose.q.z != mPose.q.z) {
+    mPose = pose;
+    mPoseVersion++;
+  }
+}
 
 /** same as Scene::addEntity */
 std::shared_ptr<Entity> Entity::addToScene(Scene &scene) {
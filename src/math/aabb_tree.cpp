@@ -0,0 +1,210 @@
+#include "sapien/math/aabb_tree.h"
+#include <stdexcept>
+
+namespace sapien {
+
+static float SurfaceArea(AABB const &box) {
+  Vec3 d = box.upper - box.lower;
+  return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+int32_t AABBTree::allocateNode() {
+  if (mFreeList == Null) {
+    mNodes.emplace_back();
+    return static_cast<int32_t>(mNodes.size() - 1);
+  }
+  int32_t index = mFreeList;
+  mFreeList = mNodes[index].parent;
+  mNodes[index] = Node{};
+  return index;
+}
+
+void AABBTree::freeNode(int32_t index) {
+  mNodes[index].parent = mFreeList;
+  mNodes[index].height = -1;
+  mFreeList = index;
+}
+
+int32_t AABBTree::insert(AABB const &box, uint32_t data) {
+  int32_t leaf = allocateNode();
+  mNodes[leaf].box = box;
+  mNodes[leaf].data = data;
+  mNodes[leaf].height = 0;
+  insertLeaf(leaf);
+  mLeafCount++;
+  return leaf;
+}
+
+void AABBTree::remove(int32_t leaf) {
+  if (leaf < 0 || leaf >= static_cast<int32_t>(mNodes.size()) || !mNodes[leaf].isLeaf() ||
+      mNodes[leaf].height != 0) {
+    throw std::runtime_error("failed to remove from AABB tree: invalid leaf");
+  }
+  removeLeaf(leaf);
+  freeNode(leaf);
+  mLeafCount--;
+}
+
+void AABBTree::move(int32_t leaf, AABB const &box) {
+  removeLeaf(leaf);
+  mNodes[leaf].box = box;
+  insertLeaf(leaf);
+}
+
+void AABBTree::clear() {
+  mNodes.clear();
+  mRoot = Null;
+  mFreeList = Null;
+  mLeafCount = 0;
+}
+
+void AABBTree::insertLeaf(int32_t leaf) {
+  if (mRoot == Null) {
+    mRoot = leaf;
+    mNodes[leaf].parent = Null;
+    return;
+  }
+
+  // descend to the sibling with the lowest cost, the cost of a node is the area of the new
+  // parent plus the area increase of all its ancestors
+  AABB box = mNodes[leaf].box;
+  int32_t index = mRoot;
+  while (!mNodes[index].isLeaf()) {
+    auto const &node = mNodes[index];
+    float area = SurfaceArea(node.box);
+    float combinedArea = SurfaceArea(node.box + box);
+    float cost = 2.f * combinedArea;
+    float inheritanceCost = 2.f * (combinedArea - area);
+
+    auto childCost = [&](int32_t child) {
+      auto const &c = mNodes[child];
+      float newArea = SurfaceArea(c.box + box);
+      return c.isLeaf() ? newArea + inheritanceCost
+                        : newArea - SurfaceArea(c.box) + inheritanceCost;
+    };
+    float cost1 = childCost(node.child1);
+    float cost2 = childCost(node.child2);
+    if (cost < cost1 && cost < cost2) {
+      break;
+    }
+    index = cost1 < cost2 ? node.child1 : node.child2;
+  }
+
+  int32_t sibling = index;
+  int32_t oldParent = mNodes[sibling].parent;
+  int32_t newParent = allocateNode();
+  mNodes[newParent].parent = oldParent;
+  mNodes[newParent].box = box + mNodes[sibling].box;
+  mNodes[newParent].height = mNodes[sibling].height + 1;
+  mNodes[newParent].child1 = sibling;
+  mNodes[newParent].child2 = leaf;
+  mNodes[sibling].parent = newParent;
+  mNodes[leaf].parent = newParent;
+
+  if (oldParent == Null) {
+    mRoot = newParent;
+  } else if (mNodes[oldParent].child1 == sibling) {
+    mNodes[oldParent].child1 = newParent;
+  } else {
+    mNodes[oldParent].child2 = newParent;
+  }
+
+  refitAncestors(mNodes[leaf].parent);
+}
+
+void AABBTree::removeLeaf(int32_t leaf) {
+  if (leaf == mRoot) {
+    mRoot = Null;
+    return;
+  }
+
+  int32_t parent = mNodes[leaf].parent;
+  int32_t grandParent = mNodes[parent].parent;
+  int32_t sibling =
+      mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+  if (grandParent == Null) {
+    mRoot = sibling;
+    mNodes[sibling].parent = Null;
+    freeNode(parent);
+    return;
+  }
+
+  if (mNodes[grandParent].child1 == parent) {
+    mNodes[grandParent].child1 = sibling;
+  } else {
+    mNodes[grandParent].child2 = sibling;
+  }
+  mNodes[sibling].parent = grandParent;
+  freeNode(parent);
+  refitAncestors(grandParent);
+}
+
+void AABBTree::refitAncestors(int32_t index) {
+  while (index != Null) {
+    index = balance(index);
+    auto &node = mNodes[index];
+    auto const &c1 = mNodes[node.child1];
+    auto const &c2 = mNodes[node.child2];
+    node.height = 1 + std::max(c1.height, c2.height);
+    node.box = c1.box + c2.box;
+    index = node.parent;
+  }
+}
+
+// rotate the taller child of A up if A is unbalanced, returns the new root of the subtree
+int32_t AABBTree::balance(int32_t iA) {
+  Node &A = mNodes[iA];
+  if (A.isLeaf() || A.height < 2) {
+    return iA;
+  }
+
+  int32_t iB = A.child1;
+  int32_t iC = A.child2;
+  Node &B = mNodes[iB];
+  Node &C = mNodes[iC];
+  int32_t diff = C.height - B.height;
+
+  // rotate up X (the taller child), Y is the other child of A
+  auto rotate = [&](int32_t iX, Node &X, Node &Y, bool xIsChild2) {
+    int32_t iF = X.child1;
+    int32_t iG = X.child2;
+    Node &F = mNodes[iF];
+    Node &G = mNodes[iG];
+
+    X.child1 = iA;
+    X.parent = A.parent;
+    A.parent = iX;
+    if (X.parent == Null) {
+      mRoot = iX;
+    } else if (mNodes[X.parent].child1 == iA) {
+      mNodes[X.parent].child1 = iX;
+    } else {
+      mNodes[X.parent].child2 = iX;
+    }
+
+    // the taller grandchild stays under X, the other one replaces X under A
+    int32_t iKeep = F.height > G.height ? iF : iG;
+    int32_t iMove = F.height > G.height ? iG : iF;
+    Node &keep = mNodes[iKeep];
+    Node &moved = mNodes[iMove];
+    X.child2 = iKeep;
+    (xIsChild2 ? A.child2 : A.child1) = iMove;
+    moved.parent = iA;
+    A.box = Y.box + moved.box;
+    A.height = 1 + std::max(Y.height, moved.height);
+    X.box = A.box + keep.box;
+    X.height = 1 + std::max(A.height, keep.height);
+    return iX;
+  };
+
+  if (diff > 1) {
+    return rotate(iC, C, B, true);
+  }
+  if (diff < -1) {
+    return rotate(iB, B, C, false);
+  }
+  return iA;
+}
+
+} // namespace sapien
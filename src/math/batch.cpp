@@ -0,0 +1,458 @@
+#include "sapien/math/batch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SAPIEN_BATCH_AVX2
+#define SAPIEN_AVX2_TARGET __attribute__((target("avx2,fma")))
+#elif defined(__AVX2__)
+#define SAPIEN_BATCH_AVX2
+#define SAPIEN_AVX2_TARGET
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SAPIEN_BATCH_NEON
+#endif
+
+namespace sapien {
+
+namespace {
+
+// row-major 3x3 linear part and translation of pose * diag(scale)
+struct Affine {
+  float m[9];
+  float p[3];
+};
+
+Affine MakeAffine(Pose const &pose, Vec3 const &scale) {
+  Quat q = pose.q.getNormalized();
+  float w = q.w, x = q.x, y = q.y, z = q.z;
+  float r[9] = {1.f - 2.f * (y * y + z * z), 2.f * (x * y - w * z), 2.f * (x * z + w * y),
+                2.f * (x * y + w * z), 1.f - 2.f * (x * x + z * z), 2.f * (y * z - w * x),
+                2.f * (x * z - w * y), 2.f * (y * z + w * x), 1.f - 2.f * (x * x + y * y)};
+  float s[3] = {scale.x, scale.y, scale.z};
+  Affine a;
+  for (int j = 0; j < 3; ++j) {
+    for (int k = 0; k < 3; ++k) {
+      a.m[j * 3 + k] = r[j * 3 + k] * s[k];
+    }
+  }
+  a.p[0] = pose.p.x;
+  a.p[1] = pose.p.y;
+  a.p[2] = pose.p.z;
+  return a;
+}
+
+inline void TransformPoint(Affine const &a, float const *in, float *out) {
+  float x = in[0], y = in[1], z = in[2];
+  out[0] = a.m[0] * x + a.m[1] * y + a.m[2] * z + a.p[0];
+  out[1] = a.m[3] * x + a.m[4] * y + a.m[5] * z + a.p[1];
+  out[2] = a.m[6] * x + a.m[7] * y + a.m[8] * z + a.p[2];
+}
+
+void TransformScalar(Affine const &a, float const *in, float *out, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    TransformPoint(a, in + 3 * i, out + 3 * i);
+  }
+}
+
+void BoundsScalar(Affine const &a, float const *in, size_t begin, size_t end, float *lower,
+                  float *upper) {
+  for (size_t i = begin; i < end; ++i) {
+    float v[3];
+    TransformPoint(a, in + 3 * i, v);
+    for (int k = 0; k < 3; ++k) {
+      lower[k] = std::min(lower[k], v[k]);
+      upper[k] = std::max(upper[k], v[k]);
+    }
+  }
+}
+
+#ifdef SAPIEN_BATCH_AVX2
+
+bool HasAVX2() {
+#if defined(__GNUC__) || defined(__clang__)
+  static bool has = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }();
+  return has;
+#else
+  return true;
+#endif
+}
+
+// 8 xyz points (24 floats) to x, y, z registers
+SAPIEN_AVX2_TARGET inline void Load8(float const *p, __m256 &x, __m256 &y, __m256 &z) {
+  __m256 m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)),
+                                    _mm_loadu_ps(p + 12), 1);
+  __m256 m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)),
+                                    _mm_loadu_ps(p + 16), 1);
+  __m256 m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 8)),
+                                    _mm_loadu_ps(p + 20), 1);
+  __m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+  __m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+  x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+  y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+  z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+SAPIEN_AVX2_TARGET inline void Store8(float *p, __m256 x, __m256 y, __m256 z) {
+  __m256 rxy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+  __m256 ryz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+  __m256 rzx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+  __m256 r03 = _mm256_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0));
+  __m256 r14 = _mm256_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0));
+  __m256 r25 = _mm256_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1));
+  _mm_storeu_ps(p, _mm256_castps256_ps128(r03));
+  _mm_storeu_ps(p + 4, _mm256_castps256_ps128(r14));
+  _mm_storeu_ps(p + 8, _mm256_castps256_ps128(r25));
+  _mm_storeu_ps(p + 12, _mm256_extractf128_ps(r03, 1));
+  _mm_storeu_ps(p + 16, _mm256_extractf128_ps(r14, 1));
+  _mm_storeu_ps(p + 20, _mm256_extractf128_ps(r25, 1));
+}
+
+SAPIEN_AVX2_TARGET inline __m256 Row8(float const *m, float p, __m256 x, __m256 y, __m256 z) {
+  __m256 r = _mm256_fmadd_ps(_mm256_set1_ps(m[0]), x, _mm256_set1_ps(p));
+  r = _mm256_fmadd_ps(_mm256_set1_ps(m[1]), y, r);
+  return _mm256_fmadd_ps(_mm256_set1_ps(m[2]), z, r);
+}
+
+SAPIEN_AVX2_TARGET size_t TransformAVX2(Affine const &a, float const *in, float *out,
+                                        size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 x, y, z;
+    Load8(in + 3 * i, x, y, z);
+    Store8(out + 3 * i, Row8(a.m, a.p[0], x, y, z), Row8(a.m + 3, a.p[1], x, y, z),
+           Row8(a.m + 6, a.p[2], x, y, z));
+  }
+  return i;
+}
+
+SAPIEN_AVX2_TARGET inline float ReduceMin8(__m256 v) {
+  __m128 m = _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 1));
+  return _mm_cvtss_f32(m);
+}
+
+SAPIEN_AVX2_TARGET inline float ReduceMax8(__m256 v) {
+  __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+  return _mm_cvtss_f32(m);
+}
+
+SAPIEN_AVX2_TARGET size_t BoundsAVX2(Affine const &a, float const *in, size_t count,
+                                     float *lower, float *upper) {
+  __m256 lo[3], hi[3];
+  for (int k = 0; k < 3; ++k) {
+    lo[k] = _mm256_set1_ps(lower[k]);
+    hi[k] = _mm256_set1_ps(upper[k]);
+  }
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 x, y, z;
+    Load8(in + 3 * i, x, y, z);
+    for (int k = 0; k < 3; ++k) {
+      __m256 v = Row8(a.m + 3 * k, a.p[k], x, y, z);
+      lo[k] = _mm256_min_ps(lo[k], v);
+      hi[k] = _mm256_max_ps(hi[k], v);
+    }
+  }
+  for (int k = 0; k < 3; ++k) {
+    lower[k] = ReduceMin8(lo[k]);
+    upper[k] = ReduceMax8(hi[k]);
+  }
+  return i;
+}
+
+#endif
+
+#ifdef SAPIEN_BATCH_NEON
+
+inline float32x4_t Row4(float const *m, float p, float32x4x3_t const &v) {
+  float32x4_t r = vfmaq_n_f32(vdupq_n_f32(p), v.val[0], m[0]);
+  r = vfmaq_n_f32(r, v.val[1], m[1]);
+  return vfmaq_n_f32(r, v.val[2], m[2]);
+}
+
+size_t TransformNEON(Affine const &a, float const *in, float *out, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    float32x4x3_t v = vld3q_f32(in + 3 * i);
+    float32x4x3_t r;
+    r.val[0] = Row4(a.m, a.p[0], v);
+    r.val[1] = Row4(a.m + 3, a.p[1], v);
+    r.val[2] = Row4(a.m + 6, a.p[2], v);
+    vst3q_f32(out + 3 * i, r);
+  }
+  return i;
+}
+
+size_t BoundsNEON(Affine const &a, float const *in, size_t count, float *lower, float *upper) {
+  float32x4_t lo[3], hi[3];
+  for (int k = 0; k < 3; ++k) {
+    lo[k] = vdupq_n_f32(lower[k]);
+    hi[k] = vdupq_n_f32(upper[k]);
+  }
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    float32x4x3_t v = vld3q_f32(in + 3 * i);
+    for (int k = 0; k < 3; ++k) {
+      float32x4_t r = Row4(a.m + 3 * k, a.p[k], v);
+      lo[k] = vminq_f32(lo[k], r);
+      hi[k] = vmaxq_f32(hi[k], r);
+    }
+  }
+  for (int k = 0; k < 3; ++k) {
+    lower[k] = vminvq_f32(lo[k]);
+    upper[k] = vmaxvq_f32(hi[k]);
+  }
+  return i;
+}
+
+#endif
+
+// Pose kernels work on blocks of Lanes poses transposed to structure-of-arrays so the
+// per-lane loops have a fixed trip count and are vectorized by the compiler.
+constexpr size_t Lanes = 8;
+using PoseBlock = float[7][Lanes];
+
+void LoadBlock(float const *poses, size_t count, size_t begin, PoseBlock &block) {
+  size_t n = std::min(Lanes, count - begin);
+  for (size_t l = 0; l < Lanes; ++l) {
+    // broadcast a single pose and pad the tail with the last pose
+    size_t i = count == 1 ? 0 : begin + std::min(l, n - 1);
+    for (int c = 0; c < 7; ++c) {
+      block[c][l] = poses[7 * i + c];
+    }
+  }
+}
+
+void StoreBlock(PoseBlock const &block, float *poses, size_t count, size_t begin) {
+  size_t n = std::min(Lanes, count - begin);
+  for (size_t l = 0; l < n; ++l) {
+    for (int c = 0; c < 7; ++c) {
+      poses[7 * (begin + l) + c] = block[c][l];
+    }
+  }
+}
+
+// out = q.rotate(v) for unit quaternions, v + w t + u x t with t = 2 u x v
+inline void Rotate(float w, float x, float y, float z, float vx, float vy, float vz, float &ox,
+                   float &oy, float &oz) {
+  float tx = 2.f * (y * vz - z * vy);
+  float ty = 2.f * (z * vx - x * vz);
+  float tz = 2.f * (x * vy - y * vx);
+  ox = vx + w * tx + (y * tz - z * ty);
+  oy = vy + w * ty + (z * tx - x * tz);
+  oz = vz + w * tz + (x * ty - y * tx);
+}
+
+} // namespace
+
+void transformPoints(Pose const &pose, Vec3 const &scale, float const *in, float *out,
+                     size_t count) {
+  Affine a = MakeAffine(pose, scale);
+  size_t done = 0;
+#if defined(SAPIEN_BATCH_AVX2)
+  if (HasAVX2()) {
+    done = TransformAVX2(a, in, out, count);
+  }
+#elif defined(SAPIEN_BATCH_NEON)
+  done = TransformNEON(a, in, out, count);
+#endif
+  TransformScalar(a, in, out, done, count);
+}
+
+void transformPoints(Pose const &pose, float const *in, float *out, size_t count) {
+  transformPoints(pose, Vec3(1.f), in, out, count);
+}
+
+void computeTransformedBounds(Pose const &pose, Vec3 const &scale, float const *points,
+                              size_t count, Vec3 &lower, Vec3 &upper) {
+  Affine a = MakeAffine(pose, scale);
+  float lo[3], hi[3];
+  std::fill_n(lo, 3, std::numeric_limits<float>::infinity());
+  std::fill_n(hi, 3, -std::numeric_limits<float>::infinity());
+  size_t done = 0;
+#if defined(SAPIEN_BATCH_AVX2)
+  if (HasAVX2()) {
+    done = BoundsAVX2(a, points, count, lo, hi);
+  }
+#elif defined(SAPIEN_BATCH_NEON)
+  done = BoundsNEON(a, points, count, lo, hi);
+#endif
+  BoundsScalar(a, points, done, count, lo, hi);
+  lower = {lo[0], lo[1], lo[2]};
+  upper = {hi[0], hi[1], hi[2]};
+}
+
+void composePoses(float const *a, size_t countA, float const *b, size_t countB, float *out) {
+  if (countA != countB && countA != 1 && countB != 1) {
+    throw std::runtime_error("failed to compose poses: pose counts do not match");
+  }
+  size_t count = std::max(countA, countB);
+  for (size_t i = 0; i < count; i += Lanes) {
+    PoseBlock A, B, C;
+    LoadBlock(a, countA, countA == 1 ? 0 : i, A);
+    LoadBlock(b, countB, countB == 1 ? 0 : i, B);
+    for (size_t l = 0; l < Lanes; ++l) {
+      float qw = A[3][l], qx = A[4][l], qy = A[5][l], qz = A[6][l];
+      float rw = B[3][l], rx = B[4][l], ry = B[5][l], rz = B[6][l];
+      Rotate(qw, qx, qy, qz, B[0][l], B[1][l], B[2][l], C[0][l], C[1][l], C[2][l]);
+      C[0][l] += A[0][l];
+      C[1][l] += A[1][l];
+      C[2][l] += A[2][l];
+      C[3][l] = qw * rw - qx * rx - qy * ry - qz * rz;
+      C[4][l] = qw * rx + rw * qx + qy * rz - ry * qz;
+      C[5][l] = qw * ry + rw * qy + qz * rx - rz * qx;
+      C[6][l] = qw * rz + rw * qz + qx * ry - rx * qy;
+    }
+    StoreBlock(C, out, count, i);
+  }
+}
+
+void invertPoses(float const *poses, float *out, size_t count) {
+  for (size_t i = 0; i < count; i += Lanes) {
+    PoseBlock A, C;
+    LoadBlock(poses, count, i, A);
+    for (size_t l = 0; l < Lanes; ++l) {
+      float qw = A[3][l], qx = -A[4][l], qy = -A[5][l], qz = -A[6][l];
+      Rotate(qw, qx, qy, qz, -A[0][l], -A[1][l], -A[2][l], C[0][l], C[1][l], C[2][l]);
+      C[3][l] = qw;
+      C[4][l] = qx;
+      C[5][l] = qy;
+      C[6][l] = qz;
+    }
+    StoreBlock(C, out, count, i);
+  }
+}
+
+void posesToMatrices(float const *poses, float *matrices, size_t count) {
+  for (size_t i = 0; i < count; i += Lanes) {
+    PoseBlock A;
+    float M[16][Lanes];
+    LoadBlock(poses, count, i, A);
+    for (size_t l = 0; l < Lanes; ++l) {
+      float w = A[3][l], x = A[4][l], y = A[5][l], z = A[6][l];
+      // 2 / |q|^2 normalizes the quaternion
+      float n = w * w + x * x + y * y + z * z;
+      float s = n > 0.f ? 2.f / n : 0.f;
+      M[0][l] = 1.f - s * (y * y + z * z);
+      M[1][l] = s * (x * y - w * z);
+      M[2][l] = s * (x * z + w * y);
+      M[3][l] = A[0][l];
+      M[4][l] = s * (x * y + w * z);
+      M[5][l] = 1.f - s * (x * x + z * z);
+      M[6][l] = s * (y * z - w * x);
+      M[7][l] = A[1][l];
+      M[8][l] = s * (x * z - w * y);
+      M[9][l] = s * (y * z + w * x);
+      M[10][l] = 1.f - s * (x * x + y * y);
+      M[11][l] = A[2][l];
+      M[12][l] = 0.f;
+      M[13][l] = 0.f;
+      M[14][l] = 0.f;
+      M[15][l] = 1.f;
+    }
+    size_t n = std::min(Lanes, count - i);
+    for (size_t l = 0; l < n; ++l) {
+      for (int c = 0; c < 16; ++c) {
+        matrices[16 * (i + l) + c] = M[c][l];
+      }
+    }
+  }
+}
+
+void matricesToPoses(float const *matrices, float *poses, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    float const *m = matrices + 16 * i;
+    float *p = poses + 7 * i;
+    float m00 = m[0], m01 = m[1], m02 = m[2];
+    float m10 = m[4], m11 = m[5], m12 = m[6];
+    float m20 = m[8], m21 = m[9], m22 = m[10];
+
+    // Shepperd's method, start from the largest component for stability
+    float w, x, y, z;
+    float trace = m00 + m11 + m22;
+    if (trace > 0.f) {
+      float s = 0.5f / std::sqrt(trace + 1.f);
+      w = 0.25f / s;
+      x = (m21 - m12) * s;
+      y = (m02 - m20) * s;
+      z = (m10 - m01) * s;
+    } else if (m00 > m11 && m00 > m22) {
+      float s = 2.f * std::sqrt(1.f + m00 - m11 - m22);
+      w = (m21 - m12) / s;
+      x = 0.25f * s;
+      y = (m01 + m10) / s;
+      z = (m02 + m20) / s;
+    } else if (m11 > m22) {
+      float s = 2.f * std::sqrt(1.f + m11 - m00 - m22);
+      w = (m02 - m20) / s;
+      x = (m01 + m10) / s;
+      y = 0.25f * s;
+      z = (m12 + m21) / s;
+    } else {
+      float s = 2.f * std::sqrt(1.f + m22 - m00 - m11);
+      w = (m10 - m01) / s;
+      x = (m02 + m20) / s;
+      y = (m12 + m21) / s;
+      z = 0.25f * s;
+    }
+    float il = 1.f / std::sqrt(w * w + x * x + y * y + z * z);
+
+    p[0] = m[3];
+    p[1] = m[7];
+    p[2] = m[11];
+    p[3] = w * il;
+    p[4] = x * il;
+    p[5] = y * il;
+    p[6] = z * il;
+  }
+}
+
+void quatsToRPY(float const *quats, float *rpy, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    float w = quats[4 * i], x = quats[4 * i + 1], y = quats[4 * i + 2], z = quats[4 * i + 3];
+    float il = 1.f / std::sqrt(w * w + x * x + y * y + z * z);
+    w *= il;
+    x *= il;
+    y *= il;
+    z *= il;
+    rpy[3 * i] = std::atan2(2.f * (w * x + y * z), 1.f - 2.f * (x * x + y * y));
+    rpy[3 * i + 1] = std::asin(std::clamp(2.f * (w * y - z * x), -1.f, 1.f));
+    rpy[3 * i + 2] = std::atan2(2.f * (w * z + x * y), 1.f - 2.f * (y * y + z * z));
+  }
+}
+
+void rpyToQuats(float const *rpy, float *quats, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    float cr = std::cos(rpy[3 * i] * 0.5f), sr = std::sin(rpy[3 * i] * 0.5f);
+    float cp = std::cos(rpy[3 * i + 1] * 0.5f), sp = std::sin(rpy[3 * i + 1] * 0.5f);
+    float cy = std::cos(rpy[3 * i + 2] * 0.5f), sy = std::sin(rpy[3 * i + 2] * 0.5f);
+    quats[4 * i] = cr * cp * cy + sr * sp * sy;
+    quats[4 * i + 1] = sr * cp * cy - cr * sp * sy;
+    quats[4 * i + 2] = cr * sp * cy + sr * cp * sy;
+    quats[4 * i + 3] = cr * cp * sy - sr * sp * cy;
+  }
+}
+
+char const *getBatchMathBackend() {
+#if defined(SAPIEN_BATCH_AVX2)
+  return HasAVX2() ? "avx2" : "scalar";
+#elif defined(SAPIEN_BATCH_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+} // namespace sapien
@@ -0,0 +1,302 @@
+#include "sapien/math/mesh_simplify.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+
+namespace sapien {
+
+namespace {
+
+struct Vec3d {
+  double x, y, z;
+  Vec3d operator-(Vec3d const &o) const { return {x - o.x, y - o.y, z - o.z}; }
+  Vec3d operator*(double s) const { return {x * s, y * s, z * s}; }
+  double dot(Vec3d const &o) const { return x * o.x + y * o.y + z * o.z; }
+  Vec3d cross(Vec3d const &o) const {
+    return {y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x};
+  }
+  double norm() const { return std::sqrt(dot(*this)); }
+};
+
+/** symmetric 4x4 quadric stored as its upper triangle */
+struct Quadric {
+  std::array<double, 10> q{};
+
+  static Quadric Plane(Vec3d const &n, double d, double weight) {
+    return {{weight * n.x * n.x, weight * n.x * n.y, weight * n.x * n.z, weight * n.x * d,
+             weight * n.y * n.y, weight * n.y * n.z, weight * n.y * d, weight * n.z * n.z,
+             weight * n.z * d, weight * d * d}};
+  }
+
+  Quadric &operator+=(Quadric const &o) {
+    for (int i = 0; i < 10; ++i) {
+      q[i] += o.q[i];
+    }
+    return *this;
+  }
+
+  double evaluate(Vec3d const &p) const {
+    double x = p.x, y = p.y, z = p.z;
+    return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x + q[4] * y * y +
+           2 * q[5] * y * z + 2 * q[6] * y + q[7] * z * z + 2 * q[8] * z + q[9];
+  }
+};
+
+// boundaries are much more visible than small deviations of the surface
+constexpr double BoundaryWeight = 10.0;
+
+struct Collapse {
+  float cost;
+  uint32_t from;
+  uint32_t to;
+  uint32_t fromVersion;
+  uint32_t toVersion;
+  bool operator>(Collapse const &o) const { return cost > o.cost; }
+};
+
+class Simplifier {
+public:
+  Simplifier(float const *vertices, uint32_t vertexCount, uint32_t const *triangles,
+             uint32_t triangleCount)
+      : mPositions(vertexCount), mQuadrics(vertexCount), mVertexTriangles(vertexCount),
+        mVersions(vertexCount, 0), mTriangles(triangleCount), mRemoved(triangleCount, false),
+        mTriangleCount(triangleCount), mMarks(vertexCount, 0) {
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+      mPositions[i] = {vertices[3 * i], vertices[3 * i + 1], vertices[3 * i + 2]};
+    }
+
+    std::vector<uint64_t> edges;
+    edges.reserve(3 * static_cast<size_t>(triangleCount));
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+      for (int k = 0; k < 3; ++k) {
+        uint32_t v = triangles[3 * t + k];
+        if (v >= vertexCount) {
+          throw std::runtime_error("failed to simplify mesh: triangle index out of range");
+        }
+        mTriangles[t][k] = v;
+        mVertexTriangles[v].push_back(t);
+      }
+      for (int k = 0; k < 3; ++k) {
+        edges.push_back(EdgeKey(mTriangles[t][k], mTriangles[t][(k + 1) % 3]));
+      }
+
+      Vec3d n = normal(mTriangles[t]);
+      double area2 = n.norm();
+      if (area2 == 0.0) {
+        continue;
+      }
+      n = n * (1.0 / area2);
+      Quadric plane = Quadric::Plane(n, -n.dot(mPositions[mTriangles[t][0]]), 0.5 * area2);
+      for (auto v : mTriangles[t]) {
+        mQuadrics[v] += plane;
+      }
+    }
+
+    std::sort(edges.begin(), edges.end());
+
+    // boundary and non-manifold edges are held by planes perpendicular to their faces
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+      Vec3d n = normal(mTriangles[t]);
+      double area2 = n.norm();
+      if (area2 == 0.0) {
+        continue;
+      }
+      n = n * (1.0 / area2);
+      for (int k = 0; k < 3; ++k) {
+        uint32_t a = mTriangles[t][k];
+        uint32_t b = mTriangles[t][(k + 1) % 3];
+        auto range = std::equal_range(edges.begin(), edges.end(), EdgeKey(a, b));
+        if (range.second - range.first == 2) {
+          continue;
+        }
+        Vec3d e = mPositions[b] - mPositions[a];
+        Vec3d bn = e.cross(n);
+        double length = bn.norm();
+        if (length == 0.0) {
+          continue;
+        }
+        bn = bn * (1.0 / length);
+        Quadric plane =
+            Quadric::Plane(bn, -bn.dot(mPositions[a]), BoundaryWeight * e.dot(e));
+        mQuadrics[a] += plane;
+        mQuadrics[b] += plane;
+      }
+    }
+
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    std::vector<Collapse> collapses;
+    collapses.reserve(edges.size());
+    for (auto key : edges) {
+      collapses.push_back(cheaperCollapse(key >> 32, key & 0xffffffff));
+    }
+    mQueue = decltype(mQueue)(std::greater<Collapse>(), std::move(collapses));
+  }
+
+  void run(uint32_t target, float maxError) {
+    while (mTriangleCount > target && !mQueue.empty()) {
+      Collapse c = mQueue.top();
+      mQueue.pop();
+      if (c.cost > maxError) {
+        break;
+      }
+      if (c.fromVersion != mVersions[c.from] || c.toVersion != mVersions[c.to]) {
+        continue;
+      }
+      if (!canCollapse(c.from, c.to)) {
+        continue;
+      }
+      collapse(c.from, c.to);
+    }
+  }
+
+  std::vector<uint32_t> result() const {
+    std::vector<uint32_t> indices;
+    indices.reserve(mTriangleCount * 3);
+    for (uint32_t t = 0; t < mTriangles.size(); ++t) {
+      if (!mRemoved[t]) {
+        indices.insert(indices.end(), mTriangles[t].begin(), mTriangles[t].end());
+      }
+    }
+    return indices;
+  }
+
+private:
+  static uint64_t EdgeKey(uint32_t a, uint32_t b) {
+    return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+  }
+
+  Vec3d normal(std::array<uint32_t, 3> const &t) const {
+    return (mPositions[t[1]] - mPositions[t[0]]).cross(mPositions[t[2]] - mPositions[t[0]]);
+  }
+
+  /** the edge collapses in the direction that keeps the vertex with the lower error */
+  Collapse cheaperCollapse(uint32_t a, uint32_t b) const {
+    Quadric q = mQuadrics[a];
+    q += mQuadrics[b];
+    float costA = static_cast<float>(std::max(q.evaluate(mPositions[a]), 0.0));
+    float costB = static_cast<float>(std::max(q.evaluate(mPositions[b]), 0.0));
+    if (costA < costB) {
+      return {costA, b, a, mVersions[b], mVersions[a]};
+    }
+    return {costB, a, b, mVersions[a], mVersions[b]};
+  }
+
+  /** calls f once for each vertex sharing a live triangle with v */
+  template <typename F> void forEachNeighbor(uint32_t v, F const &f) {
+    uint32_t stamp = ++mStamp;
+    for (auto t : mVertexTriangles[v]) {
+      if (mRemoved[t]) {
+        continue;
+      }
+      for (auto w : mTriangles[t]) {
+        if (w != v && mMarks[w] != stamp) {
+          mMarks[w] = stamp;
+          f(w);
+        }
+      }
+    }
+  }
+
+  bool canCollapse(uint32_t from, uint32_t to) {
+    // link condition: the only common neighbors are the opposite vertices of shared triangles
+    uint32_t shared = 0;
+    for (auto t : mVertexTriangles[from]) {
+      auto &tri = mTriangles[t];
+      if (!mRemoved[t] && std::find(tri.begin(), tri.end(), to) != tri.end()) {
+        shared++;
+      }
+    }
+    if (shared == 0) {
+      return false;
+    }
+    forEachNeighbor(from, [](uint32_t) {});
+    uint32_t fromStamp = mStamp;
+    uint32_t common = 0;
+    for (auto t : mVertexTriangles[to]) {
+      if (mRemoved[t]) {
+        continue;
+      }
+      for (auto w : mTriangles[t]) {
+        // stamp + 1 marks common neighbors that were already counted
+        if (w != to && mMarks[w] == fromStamp) {
+          mMarks[w] = fromStamp + 1;
+          common++;
+        }
+      }
+    }
+    mStamp = fromStamp + 1;
+    if (common != shared) {
+      return false;
+    }
+
+    // moved triangles must not flip or degenerate
+    for (auto t : mVertexTriangles[from]) {
+      auto tri = mTriangles[t];
+      if (mRemoved[t] || std::find(tri.begin(), tri.end(), to) != tri.end()) {
+        continue;
+      }
+      Vec3d before = normal(tri);
+      std::replace(tri.begin(), tri.end(), from, to);
+      Vec3d after = normal(tri);
+      double lb = before.norm();
+      double la = after.norm();
+      if (la <= 1e-12 * std::max(lb, 1e-30) || before.dot(after) <= 0.2 * lb * la) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void collapse(uint32_t from, uint32_t to) {
+    for (auto t : mVertexTriangles[from]) {
+      if (mRemoved[t]) {
+        continue;
+      }
+      auto &tri = mTriangles[t];
+      if (std::find(tri.begin(), tri.end(), to) != tri.end()) {
+        mRemoved[t] = true;
+        mTriangleCount--;
+      } else {
+        std::replace(tri.begin(), tri.end(), from, to);
+        mVertexTriangles[to].push_back(t);
+      }
+    }
+    mVertexTriangles[from].clear();
+    mQuadrics[to] += mQuadrics[from];
+
+    // invalidate queued collapses of both vertices and requeue the edges around the survivor
+    mVersions[from]++;
+    mVersions[to]++;
+    auto &ts = mVertexTriangles[to];
+    ts.erase(std::remove_if(ts.begin(), ts.end(), [&](uint32_t t) { return mRemoved[t]; }),
+             ts.end());
+    forEachNeighbor(to, [&](uint32_t w) { mQueue.push(cheaperCollapse(to, w)); });
+  }
+
+  std::vector<Vec3d> mPositions;
+  std::vector<Quadric> mQuadrics;
+  std::vector<std::vector<uint32_t>> mVertexTriangles;
+  std::vector<uint32_t> mVersions;
+  std::vector<std::array<uint32_t, 3>> mTriangles;
+  std::vector<bool> mRemoved;
+  uint32_t mTriangleCount;
+
+  // scratch marks for neighbor queries
+  std::vector<uint32_t> mMarks;
+  uint32_t mStamp{0};
+  std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> mQueue;
+};
+
+} // namespace
+
+std::vector<uint32_t> simplifyMesh(float const *vertices, uint32_t vertexCount,
+                                   uint32_t const *triangles, uint32_t triangleCount,
+                                   uint32_t targetTriangleCount, float maxError) {
+  Simplifier simplifier(vertices, vertexCount, triangles, triangleCount);
+  simplifier.run(targetTriangleCount, maxError);
+  return simplifier.result();
+}
+
+} // namespace sapien
@@ -643,8 +643,6 @@ PhysxArticulationLinkComponent::cloneArticulation(
   newArt->setRootLinearVelocity(art->getRootLinearVelocity());
   newArt->setRootAngularVelocity(art->getRootAngularVelocity());
 
-  ProfilerBlockEnd();
-
   return newLinks;
 }
 
@@ -497,6 +497,7 @@ std::shared_ptr<PhysxCollisionShape> PhysxCollisionShapeCylinder::clone() const
 std::shared_ptr<PhysxCollisionShape> PhysxCollisionShapeConvexMesh::clone() const {
   auto shape = std::make_shared<PhysxCollisionShapeConvexMesh>(getMesh(), getScale(),
                                                                getPhysicalMaterial());
+  copyProperties(*shape);
   return shape;
 }
 
@@ -16,15 +16,15 @@ namespace sapien {
 namespace physx {
 
 static std::shared_ptr<MeshManager> gManager;
+static std::once_flag gManagerFlag;
 std::shared_ptr<MeshManager> MeshManager::Get() {
-  if (!gManager) {
-    gManager = std::make_shared<MeshManager>();
-  }
+  std::call_once(gManagerFlag, []() { gManager = std::make_shared<MeshManager>(); });
   return gManager;
 }
 
 void MeshManager::Clear() {
   if (gManager) {
+    std::lock_guard lock(gManager->mMutex);
     gManager->mTriangleMeshWithSDFRegistry.clear();
     gManager->mTriangleMeshRegistry.clear();
     gManager->mConvexMeshRegistry.clear();
@@ -45,68 +45,83 @@ MeshManager::MeshManager() {}
 std::shared_ptr<PhysxTriangleMesh> MeshManager::loadTriangleMesh(const std::string &filename) {
   std::string fullPath = getFullPath(filename);
 
-  auto it = mTriangleMeshRegistry.find(fullPath);
-  if (it != mTriangleMeshRegistry.end()) {
-    logger::info("Using loaded mesh: {}", filename);
-    return it->second;
+  {
+    std::lock_guard lock(mMutex);
+    auto it = mTriangleMeshRegistry.find(fullPath);
+    if (it != mTriangleMeshRegistry.end()) {
+      logger::info("Using loaded mesh: {}", filename);
+      return it->second;
+    }
   }
 
   auto mesh = std::make_shared<PhysxTriangleMesh>(fullPath, false);
-  mTriangleMeshRegistry[fullPath] = mesh;
 
-  return mesh;
+  // another thread may have cooked the same file meanwhile, keep the first one
+  std::lock_guard lock(mMutex);
+  return mTriangleMeshRegistry.try_emplace(fullPath, mesh).first->second;
 }
 
 std::shared_ptr<PhysxTriangleMesh>
 MeshManager::loadTriangleMeshWithSDF(const std::string &filename) {
   std::string fullPath = getFullPath(filename);
 
-  auto it = mTriangleMeshWithSDFRegistry.find(fullPath);
-  if (it != mTriangleMeshWithSDFRegistry.end()) {
-    if (it->second->getSDFSpacing() == PhysxDefault::getSDFShapeConfig().spacing &&
-        it->second->getSDFSubgridSize() == PhysxDefault::getSDFShapeConfig().subgridSize) {
-      logger::info("Using loaded mesh with SDF: {}", filename);
-      return it->second;
-    } else {
-      logger::warn(
-          "Loading same mesh with different SDF parameters: {}. This may be due to an error.",
-          filename);
+  {
+    std::lock_guard lock(mMutex);
+    auto it = mTriangleMeshWithSDFRegistry.find(fullPath);
+    if (it != mTriangleMeshWithSDFRegistry.end()) {
+      if (it->second->getSDFSpacing() == PhysxDefault::getSDFShapeConfig().spacing &&
+          it->second->getSDFSubgridSize() == PhysxDefault::getSDFShapeConfig().subgridSize) {
+        logger::info("Using loaded mesh with SDF: {}", filename);
+        return it->second;
+      } else {
+        logger::warn(
+            "Loading same mesh with different SDF parameters: {}. This may be due to an error.",
+            filename);
+      }
     }
   }
 
   auto mesh = std::make_shared<PhysxTriangleMesh>(fullPath, true);
-  mTriangleMeshWithSDFRegistry[fullPath] = mesh;
 
+  std::lock_guard lock(mMutex);
+  mTriangleMeshWithSDFRegistry[fullPath] = mesh;
   return mesh;
 }
 
 std::vector<std::shared_ptr<PhysxConvexMesh>>
 MeshManager::loadConvexMeshGroup(const std::string &filename) {
   std::string fullPath = getFullPath(filename);
-  auto it = mConvexMeshGroupRegistry.find(fullPath);
-  if (it != mConvexMeshGroupRegistry.end()) {
-    logger::info("Using loaded mesh group: {}", filename);
-    return it->second;
+  {
+    std::lock_guard lock(mMutex);
+    auto it = mConvexMeshGroupRegistry.find(fullPath);
+    if (it != mConvexMeshGroupRegistry.end()) {
+      logger::info("Using loaded mesh group: {}", filename);
+      return it->second;
+    }
   }
 
   auto meshes = PhysxConvexMesh::LoadByConnectedParts(fullPath);
-  mConvexMeshGroupRegistry[fullPath] = meshes;
 
-  return meshes;
+  std::lock_guard lock(mMutex);
+  return mConvexMeshGroupRegistry.try_emplace(fullPath, meshes).first->second;
 }
 
 std::shared_ptr<PhysxConvexMesh> MeshManager::loadConvexMesh(const std::string &filename) {
 
   std::string fullPath = getFullPath(filename);
-  auto it = mConvexMeshRegistry.find(fullPath);
-  if (it != mConvexMeshRegistry.end()) {
-    logger::info("Using loaded mesh: {}", filename);
-    return it->second;
+  {
+    std::lock_guard lock(mMutex);
+    auto it = mConvexMeshRegistry.find(fullPath);
+    if (it != mConvexMeshRegistry.end()) {
+      logger::info("Using loaded mesh: {}", filename);
+      return it->second;
+    }
   }
 
   auto mesh = std::make_shared<PhysxConvexMesh>(fullPath);
-  mConvexMeshRegistry[fullPath] = mesh;
-  return mesh;
+
+  std::lock_guard lock(mMutex);
+  return mConvexMeshRegistry.try_emplace(fullPath, mesh).first->second;
 }
 
 } // namespace physx
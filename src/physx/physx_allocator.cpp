@@ -0,0 +1,231 @@
+#include "./physx_allocator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace sapien {
+namespace physx {
+
+static void *AlignedAlloc(size_t size) {
+  size = (size + 15) & ~size_t(15);
+#ifdef _WIN32
+  return _aligned_malloc(size, 16);
+#else
+  return std::aligned_alloc(16, size);
+#endif
+}
+
+static void AlignedFree(void *ptr) {
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+static thread_local uint32_t gCurrentTag = 0;
+
+// counters of names and systems this thread has seen, for the allocator with id allocator
+struct ThreadCache {
+  uint64_t allocator{0};
+  std::unordered_map<char const *, uint16_t> categories;
+  std::unordered_map<uint32_t, std::atomic<int64_t> *> systems;
+};
+static thread_local ThreadCache gThreadCache;
+static std::atomic<uint64_t> gNextAllocatorId{1};
+
+static ThreadCache &GetThreadCache(uint64_t allocator) {
+  if (gThreadCache.allocator != allocator) {
+    gThreadCache.allocator = allocator;
+    gThreadCache.categories.clear();
+    gThreadCache.systems.clear();
+  }
+  return gThreadCache;
+}
+
+PhysxAllocatorScope::PhysxAllocatorScope(uint32_t tag) : mPrevious(gCurrentTag) {
+  gCurrentTag = tag;
+}
+PhysxAllocatorScope::~PhysxAllocatorScope() { gCurrentTag = mPrevious; }
+uint32_t PhysxAllocatorScope::Current() { return gCurrentTag; }
+
+SapienAllocatorCallback::SapienAllocatorCallback() : mId(gNextAllocatorId++) {
+  mCategories[kMaxCategories - 1].name = "other";
+}
+
+SapienAllocatorCallback::~SapienAllocatorCallback() {
+  for (auto &pool : mPools) {
+    if (pool.usedBytes == 0) {
+      for (void *chunk : pool.chunks) {
+        AlignedFree(chunk);
+      }
+    }
+  }
+}
+
+uint16_t SapienAllocatorCallback::findCategory(char const *typeName) {
+  auto &cache = GetThreadCache(mId);
+  auto it = cache.categories.find(typeName);
+  if (it != cache.categories.end()) {
+    return it->second;
+  }
+
+  uint16_t index;
+  {
+    std::lock_guard lock(mLock);
+    auto [entry, inserted] = mCategoryIndex.try_emplace(typeName, kMaxCategories - 1);
+    // names are string literals owned by PhysX
+    if (inserted && mCategoryCount < kMaxCategories - 1) {
+      entry->second = mCategoryCount++;
+      mCategories[entry->second].name = typeName ? typeName : "unknown";
+    }
+    index = entry->second;
+  }
+  cache.categories[typeName] = index;
+  return index;
+}
+
+std::atomic<int64_t> &SapienAllocatorCallback::findSystem(uint32_t tag) {
+  auto &cache = GetThreadCache(mId);
+  auto it = cache.systems.find(tag);
+  if (it != cache.systems.end()) {
+    return *it->second;
+  }
+
+  std::atomic<int64_t> *counter;
+  {
+    std::lock_guard lock(mLock);
+    auto &entry = mSystemBytes[tag];
+    if (!entry) {
+      entry = std::make_unique<std::atomic<int64_t>>(0);
+    }
+    counter = entry.get();
+  }
+  cache.systems[tag] = counter;
+  return *counter;
+}
+
+void *SapienAllocatorCallback::poolAllocate(uint32_t poolClass) {
+  auto &pool = mPools[poolClass];
+  uint32_t blockSize = sizeof(Header) + (poolClass + 1) * kPoolGranularity;
+
+  std::lock_guard lock(pool.lock);
+  if (!pool.freeList) {
+    char *chunk = static_cast<char *>(AlignedAlloc(kPoolChunkSize));
+    if (!chunk) {
+      return nullptr;
+    }
+    pool.chunks.push_back(chunk);
+    pool.reservedBytes += kPoolChunkSize;
+    for (uint32_t offset = 0; offset + blockSize <= kPoolChunkSize; offset += blockSize) {
+      void *block = chunk + offset;
+      *static_cast<void **>(block) = pool.freeList;
+      pool.freeList = block;
+    }
+  }
+  void *block = pool.freeList;
+  pool.freeList = *static_cast<void **>(block);
+  pool.usedBytes += blockSize;
+  return block;
+}
+
+void SapienAllocatorCallback::poolDeallocate(uint32_t poolClass, void *block) {
+  auto &pool = mPools[poolClass];
+  uint32_t blockSize = sizeof(Header) + (poolClass + 1) * kPoolGranularity;
+
+  std::lock_guard lock(pool.lock);
+  *static_cast<void **>(block) = pool.freeList;
+  pool.freeList = block;
+  pool.usedBytes -= blockSize;
+}
+
+void *SapienAllocatorCallback::allocate(size_t size, const char *typeName, const char *filename,
+                                        int line) {
+  uint16_t poolClass = 0;
+  void *block;
+  if (mPoolEnabled && size > 0 && size <= kPoolMaxSize) {
+    poolClass = static_cast<uint16_t>((size + kPoolGranularity - 1) / kPoolGranularity);
+    block = poolAllocate(poolClass - 1);
+  } else {
+    block = AlignedAlloc(sizeof(Header) + size);
+  }
+  if (!block) {
+    return nullptr;
+  }
+
+  auto header = static_cast<Header *>(block);
+  header->size = size;
+  header->tag = gCurrentTag;
+  header->pool = poolClass;
+
+  header->category = findCategory(typeName);
+
+  auto &category = mCategories[header->category];
+  category.bytes.fetch_add(size, std::memory_order_relaxed);
+  category.count.fetch_add(1, std::memory_order_relaxed);
+  if (header->tag) {
+    findSystem(header->tag).fetch_add(size, std::memory_order_relaxed);
+  }
+  int64_t current = mCurrentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+  int64_t peak = mPeakBytes.load(std::memory_order_relaxed);
+  while (current > peak &&
+         !mPeakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+  }
+  mLiveAllocations.fetch_add(1, std::memory_order_relaxed);
+  mTotalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+  return header + 1;
+}
+
+void SapienAllocatorCallback::deallocate(void *ptr) {
+  if (!ptr) {
+    return;
+  }
+  auto header = static_cast<Header *>(ptr) - 1;
+
+  auto &category = mCategories[header->category];
+  category.bytes.fetch_sub(header->size, std::memory_order_relaxed);
+  category.count.fetch_sub(1, std::memory_order_relaxed);
+  if (header->tag) {
+    findSystem(header->tag).fetch_sub(header->size, std::memory_order_relaxed);
+  }
+  mCurrentBytes.fetch_sub(header->size, std::memory_order_relaxed);
+  mLiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+
+  if (header->pool) {
+    poolDeallocate(header->pool - 1, header);
+  } else {
+    AlignedFree(header);
+  }
+}
+
+PhysxMemoryStats SapienAllocatorCallback::getStats() const {
+  PhysxMemoryStats stats;
+  stats.tracking = true;
+  stats.currentBytes = mCurrentBytes.load(std::memory_order_relaxed);
+  stats.peakBytes = mPeakBytes.load(std::memory_order_relaxed);
+  stats.liveAllocations = mLiveAllocations.load(std::memory_order_relaxed);
+  stats.totalAllocations = mTotalAllocations.load(std::memory_order_relaxed);
+  for (auto &c : mCategories) {
+    auto name = c.name.load();
+    int64_t bytes = c.bytes.load(std::memory_order_relaxed);
+    if (name && c.count.load(std::memory_order_relaxed)) {
+      stats.bytesByName[name] += bytes;
+    }
+  }
+  for (auto &pool : mPools) {
+    std::lock_guard lock(pool.lock);
+    stats.poolReservedBytes += pool.reservedBytes;
+    stats.poolUsedBytes += pool.usedBytes;
+  }
+  return stats;
+}
+
+uint64_t SapienAllocatorCallback::getSystemBytes(uint32_t tag) const {
+  std::lock_guard lock(mLock);
+  auto it = mSystemBytes.find(tag);
+  return it == mSystemBytes.end() ? 0 : it->second->load(std::memory_order_relaxed);
+}
+
+} // namespace physx
+} // namespace sapien
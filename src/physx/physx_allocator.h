@@ -0,0 +1,104 @@
+#pragma once
+#include "sapien/physx/physx_default.h"
+#include "sapien/physx/physx_engine.h"
+#include <PxPhysicsAPI.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sapien {
+namespace physx {
+
+/** PhysX allocator that records live bytes per allocation name and per PhysX system, and
+ * optionally serves small allocations from size-class pools whose chunks are never returned to
+ * the OS, which bounds fragmentation across many scene create/destroy cycles.
+ *
+ * Every allocation is prefixed by a 16-byte header so the allocation can be attributed on free.
+ * Counters are atomic and each thread caches the counters of names and systems it has seen, so
+ * the registration lock is only taken the first time a thread meets a name or system.
+ */
+class SapienAllocatorCallback : public ::physx::PxAllocatorCallback {
+public:
+  static constexpr uint32_t kPoolGranularity = 16;
+  static constexpr uint32_t kPoolClasses = 16; // pooled sizes: 16, 32, ..., 256
+  static constexpr uint32_t kPoolMaxSize = kPoolGranularity * kPoolClasses;
+  static constexpr uint32_t kPoolChunkSize = 64 * 1024;
+  static constexpr uint32_t kMaxCategories = 1024; // further names are merged into "other"
+
+  SapienAllocatorCallback();
+  /** frees the chunks of pools no longer in use, PhysX may still hold blocks at exit */
+  ~SapienAllocatorCallback();
+
+  void setPoolEnabled(bool enabled) { mPoolEnabled = enabled; }
+
+  void *allocate(size_t size, const char *typeName, const char *filename, int line) override;
+  void deallocate(void *ptr) override;
+
+  PhysxMemoryStats getStats() const;
+  uint64_t getSystemBytes(uint32_t tag) const;
+
+private:
+  struct Header {
+    uint64_t size;
+    uint32_t tag;      // PhysX system the allocation is attributed to, 0 for none
+    uint16_t category; // index into mCategories
+    uint16_t pool;     // pool class + 1, 0 for not pooled
+  };
+  static_assert(sizeof(Header) == 16);
+
+  struct Category {
+    std::atomic<char const *> name{};
+    std::atomic<int64_t> bytes{};
+    std::atomic<int64_t> count{};
+  };
+
+  struct Pool {
+    mutable std::mutex lock;
+    void *freeList{};
+    uint64_t reservedBytes{};
+    uint64_t usedBytes{};
+    std::vector<void *> chunks;
+  };
+
+  void *poolAllocate(uint32_t poolClass);
+  void poolDeallocate(uint32_t poolClass, void *block);
+
+  uint16_t findCategory(char const *typeName);
+  std::atomic<int64_t> &findSystem(uint32_t tag);
+
+  uint64_t mId; // identifies this allocator in thread caches
+  bool mPoolEnabled{false};
+
+  // guards registration of names and systems
+  mutable std::mutex mLock;
+  std::unordered_map<char const *, uint16_t> mCategoryIndex;
+  uint32_t mCategoryCount{0};
+  std::array<Category, kMaxCategories> mCategories;
+  // counters are never removed, so references cached by threads stay valid
+  std::unordered_map<uint32_t, std::unique_ptr<std::atomic<int64_t>>> mSystemBytes;
+
+  std::atomic<int64_t> mCurrentBytes{};
+  std::atomic<int64_t> mPeakBytes{};
+  std::atomic<int64_t> mLiveAllocations{};
+  std::atomic<uint64_t> mTotalAllocations{};
+
+  std::array<Pool, kPoolClasses> mPools;
+};
+
+/** attribute PhysX allocations made by this thread to a PhysX system within the scope */
+class PhysxAllocatorScope {
+public:
+  explicit PhysxAllocatorScope(uint32_t tag);
+  ~PhysxAllocatorScope();
+
+  static uint32_t Current();
+
+private:
+  uint32_t mPrevious;
+};
+
+} // namespace physx
+} // namespace sapien
@@ -1,6 +1,8 @@
 #include "sapien/physx/physx_default.h"
 #include "sapien/physx/material.h"
+#include "sapien/physx/physx_engine.h"
 #include "sapien/physx/physx_system.h"
+#include <atomic>
 
 namespace sapien {
 namespace physx {
@@ -10,10 +12,12 @@ static float gDynamicFriction{0.3};
 static float gRestitution{0.1};
 static std::weak_ptr<PhysxMaterial> gDefaultMaterial;
 static bool gGPUEnabled{false};
+static std::atomic<bool> gProfilerEnabled{false};
 static PhysxSceneConfig gSceneConfig{};
 static PhysxBodyConfig gBodyConfig{};
 static PhysxShapeConfig gShapeConfig{};
 static PhysxSDFShapeConfig gSDFConfig{};
+static PhysxAllocatorConfig gAllocatorConfig{};
 
 static ::physx::PxgDynamicsMemoryConfig gGpuMemoryConfig{};
 
@@ -103,7 +107,28 @@ void PhysxDefault::setSDFShapeConfig(float spacing, uint32_t subgridSize,
 void PhysxDefault::setSDFShapeConfig(PhysxSDFShapeConfig const &c) { gSDFConfig = c; }
 PhysxSDFShapeConfig PhysxDefault::getSDFShapeConfig() { return gSDFConfig; }
 
+void PhysxDefault::setAllocatorConfig(bool enableTracking, bool enablePool) {
+  setAllocatorConfig({.enableTracking = enableTracking, .enablePool = enablePool});
+}
+void PhysxDefault::setAllocatorConfig(PhysxAllocatorConfig const &c) {
+  if (PhysxEngine::GetIfExists()) {
+    throw std::runtime_error(
+        "PhysX allocator can only be configured before any other code involving PhysX");
+  }
+  gAllocatorConfig = c;
+}
+PhysxAllocatorConfig const &PhysxDefault::getAllocatorConfig() { return gAllocatorConfig; }
+
 bool PhysxDefault::GetGPUEnabled() { return gGPUEnabled; }
+
+void PhysxDefault::SetProfilerEnabled(bool enabled) {
+  gProfilerEnabled = enabled;
+  // the foundation callback is only installed while enabled so disabled zones cost nothing
+  if (PhysxEngine::GetIfExists()) {
+    ::physx::PxSetProfilerCallback(enabled ? PhysxEngine::GetProfilerCallback() : nullptr);
+  }
+}
+bool PhysxDefault::GetProfilerEnabled() { return gProfilerEnabled; }
 std::string PhysxDefault::getPhysxVersion() { return PHYSX_VERSION; }
 
 } // namespace physx
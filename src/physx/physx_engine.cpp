@@ -1,6 +1,8 @@
 #include "sapien/physx/physx_engine.h"
 #include "../logger.h"
+#include "./physx_allocator.h"
 #include "sapien/physx/physx_default.h"
+#include "sapien/profiler.h"
 
 #include "../utils/cuda_lib.h"
 #include "sapien/utils/cuda.h"
@@ -11,6 +13,7 @@ namespace sapien {
 namespace physx {
 
 static PxDefaultAllocator gDefaultAllocatorCallback;
+static SapienAllocatorCallback gTrackingAllocatorCallback;
 
 class SapienErrorCallback : public PxErrorCallback {
   PxErrorCode::Enum mLastErrorCode = PxErrorCode::eNO_ERROR;
@@ -35,6 +38,31 @@ public:
 
 static SapienErrorCallback gDefaultErrorCallback;
 
+// forwards PhysX profile zones (only emitted by checked/profile PhysX builds) to SAPIEN profiler
+class SapienProfilerCallback : public PxProfilerCallback {
+public:
+  void *zoneStart(const char *eventName, bool detached, uint64_t contextId) override {
+    if (!PhysxDefault::GetProfilerEnabled() || !ProfilerIsRunning()) {
+      return nullptr;
+    }
+    // zones may end on a different thread, so carry the start time instead of using the stack
+    return reinterpret_cast<void *>(static_cast<uintptr_t>(ProfilerNow()) + 1);
+  }
+
+  void zoneEnd(void *profilerData, const char *eventName, bool detached,
+               uint64_t contextId) override {
+    if (!profilerData) {
+      return;
+    }
+    int64_t begin = static_cast<int64_t>(reinterpret_cast<uintptr_t>(profilerData) - 1);
+    ProfilerRecordBlock(eventName, begin, ProfilerNow());
+  }
+};
+
+static SapienProfilerCallback gProfilerCallback;
+
+PxProfilerCallback *PhysxEngine::GetProfilerCallback() { return &gProfilerCallback; }
+
 static std::weak_ptr<PhysxEngine> gEngine;
 std::shared_ptr<PhysxEngine> PhysxEngine::Get(float toleranceLength, float toleranceSpeed) {
   auto engine = gEngine.lock();
@@ -49,11 +77,26 @@ std::shared_ptr<PhysxEngine> PhysxEngine::GetIfExists() { return gEngine.lock();
 PhysxEngine::PhysxEngine(float toleranceLength, float toleranceSpeed) {
   logger::getLogger();
 
-  mPxFoundation =
-      PxCreateFoundation(PX_PHYSICS_VERSION, gDefaultAllocatorCallback, gDefaultErrorCallback);
+  auto &allocatorConfig = PhysxDefault::getAllocatorConfig();
+  mTrackingAllocator = allocatorConfig.enableTracking || allocatorConfig.enablePool;
+  if (mTrackingAllocator) {
+    gTrackingAllocatorCallback.setPoolEnabled(allocatorConfig.enablePool);
+  }
+
+  mPxFoundation = PxCreateFoundation(
+      PX_PHYSICS_VERSION,
+      mTrackingAllocator ? static_cast<PxAllocatorCallback &>(gTrackingAllocatorCallback)
+                         : gDefaultAllocatorCallback,
+      gDefaultErrorCallback);
   if (!mPxFoundation) {
     throw std::runtime_error("PhysX foundation creation failed");
   }
+  if (mTrackingAllocator) {
+    mPxFoundation->setReportAllocationNames(true);
+  }
+  if (PhysxDefault::GetProfilerEnabled()) {
+    PxSetProfilerCallback(&gProfilerCallback);
+  }
 
   PxTolerancesScale toleranceScale(toleranceLength, toleranceSpeed);
 
@@ -111,14 +154,30 @@ PhysxEngine::PhysxEngine(float toleranceLength, float toleranceSpeed) {
   }
 
   cudaContextManagerDesc.ctx = &context;
-  mCudaContextManagers[cudaId] =
-      PxCreateCudaContextManager(*mPxFoundation, cudaContextManagerDesc, PxGetProfilerCallback());
+  // like the foundation callback, GPU zones are only forwarded while the profiler is enabled
+  mCudaContextManagers[cudaId] = PxCreateCudaContextManager(
+      *mPxFoundation, cudaContextManagerDesc,
+      PhysxDefault::GetProfilerEnabled() ? &gProfilerCallback : nullptr);
 
   return mCudaContextManagers[cudaId];
 
   // TODO clean up
 }
 
+PhysxMemoryStats PhysxEngine::getMemoryStats() const {
+  if (!mTrackingAllocator) {
+    return {};
+  }
+  return gTrackingAllocatorCallback.getStats();
+}
+
+uint64_t PhysxEngine::getSystemAllocatedBytes(uint32_t tag) const {
+  if (!mTrackingAllocator) {
+    return 0;
+  }
+  return gTrackingAllocatorCallback.getSystemBytes(tag);
+}
+
 PhysxEngine::~PhysxEngine() {
   PxCloseExtensions();
   mPxPhysics->release();
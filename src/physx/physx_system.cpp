@@ -1,6 +1,7 @@
 #include "sapien/physx/physx_system.h"
 #include "../logger.h"
 #include "./filter_shader.hpp"
+#include "./physx_allocator.h"
 #include "sapien/math/conversion.h"
 #include "sapien/physx/articulation.h"
 #include "sapien/physx/articulation_link_component.h"
@@ -8,6 +9,8 @@
 #include "sapien/physx/physx_default.h"
 #include "sapien/physx/rigid_component.h"
 #include "sapien/profiler.h"
+#include <atomic>
+#include <chrono>
 #include <extensions/PxExtensionsAPI.h>
 
 #include "./physx_system.cuh"
@@ -26,8 +29,25 @@ struct SapienBodyDataTest {
 
 static_assert(sizeof(SapienBodyDataTest) == 52);
 
+using StepClock = std::chrono::steady_clock;
+
+// milliseconds elapsed since t, t is reset to now
+static double Lap(StepClock::time_point &t) {
+  auto now = StepClock::now();
+  double ms = std::chrono::duration<double, std::milli>(now - t).count();
+  t = now;
+  return ms;
+}
+
+static std::atomic<uint32_t> gNextMemoryTag{1};
+
 PhysxSystem::PhysxSystem()
-    : mSceneConfig(PhysxDefault::getSceneConfig()), mEngine(PhysxEngine::Get()) {}
+    : mSceneConfig(PhysxDefault::getSceneConfig()), mEngine(PhysxEngine::Get()),
+      mMemoryTag(gNextMemoryTag++) {}
+
+uint64_t PhysxSystem::getAllocatedBytes() const {
+  return mEngine->getSystemAllocatedBytes(mMemoryTag);
+}
 
 PhysxSystemCpu::PhysxSystemCpu() {
   if (PhysxDefault::GetGPUEnabled()) {
@@ -37,6 +57,8 @@ PhysxSystemCpu::PhysxSystemCpu() {
         "explicitly and pass it to sapien.Scene constructor.");
   }
 
+  PhysxAllocatorScope allocatorScope(mMemoryTag);
+
   auto &config = mSceneConfig;
   PxSceneDesc sceneDesc(mEngine->getPxPhysics()->getTolerancesScale());
   sceneDesc.gravity = Vec3ToPxVec3(config.gravity);
@@ -67,6 +89,8 @@ PhysxSystemCpu::PhysxSystemCpu() {
   sceneDesc.cpuDispatcher = mPxCPUDispatcher;
   mPxScene = mEngine->getPxPhysics()->createScene(sceneDesc);
   mPxScene->setSimulationEventCallback(&mSimulationCallback);
+
+  setScratchBlockSize(config.scratchBlockSize);
 }
 
 PhysxSystemGpu::PhysxSystemGpu(std::shared_ptr<Device> device) {
@@ -86,6 +110,8 @@ PhysxSystemGpu::PhysxSystemGpu(std::shared_ptr<Device> device) {
   }
   mDevice = device;
 
+  PhysxAllocatorScope allocatorScope(mMemoryTag);
+
   auto &config = mSceneConfig;
   PxSceneDesc sceneDesc(mEngine->getPxPhysics()->getTolerancesScale());
   sceneDesc.gravity = Vec3ToPxVec3(config.gravity);
@@ -126,6 +152,8 @@ PhysxSystemGpu::PhysxSystemGpu(std::shared_ptr<Device> device) {
   }
   sceneDesc.cpuDispatcher = mPxCPUDispatcher;
   mPxScene = mEngine->getPxPhysics()->createScene(sceneDesc);
+
+  setScratchBlockSize(config.scratchBlockSize);
 }
 
 void PhysxSystemCpu::registerComponent(std::shared_ptr<PhysxRigidDynamicComponent> component) {
@@ -212,8 +240,23 @@ std::unique_ptr<PhysxHitInfo> PhysxSystemCpu::raycast(Vec3 const &origin, Vec3 c
 }
 
 void PhysxSystemCpu::step() {
-  mPxScene->simulate(mTimestep);
+  SAPIEN_PROFILE_BLOCK(PhysxSystemCpu::step);
+  PhysxAllocatorScope allocatorScope(mMemoryTag);
+
+  ++mTotalSteps;
+  auto t = StepClock::now();
+
+  SAPIEN_PROFILE_BLOCK_BEGIN(simulate);
+  mPxScene->simulate(mTimestep, nullptr, getScratchBlock(), getScratchBlockSize());
+  SAPIEN_PROFILE_BLOCK_END;
+  mSimulateTime = Lap(t);
+
+  SAPIEN_PROFILE_BLOCK_BEGIN(fetchResults);
   mPxScene->fetchResults(true);
+  SAPIEN_PROFILE_BLOCK_END;
+  mFetchResultsTime = Lap(t);
+
+  SAPIEN_PROFILE_BLOCK_BEGIN(syncPoseToEntity);
   for (auto c : mRigidStaticComponents) {
     c->syncPoseToEntity();
   }
@@ -223,6 +266,11 @@ void PhysxSystemCpu::step() {
   for (auto c : mArticulationLinkComponents) {
     c->syncPoseToEntity();
   }
+  SAPIEN_PROFILE_BLOCK_END;
+  mSyncPoseTime = Lap(t);
+
+  updateScratchBlock();
+  recordStepStatistics();
 }
 
 void PhysxSystemGpu::step() {
@@ -230,11 +278,27 @@ void PhysxSystemGpu::step() {
     throw std::runtime_error("failed to step: gpu simulation is not initialized.");
   }
 
+  SAPIEN_PROFILE_BLOCK(PhysxSystemGpu::step);
+  PhysxAllocatorScope allocatorScope(mMemoryTag);
+
   mContactUpToDate = false;
 
   ++mTotalSteps;
-  mPxScene->simulate(mTimestep);
+  auto t = StepClock::now();
+
+  SAPIEN_PROFILE_BLOCK_BEGIN(simulate);
+  mPxScene->simulate(mTimestep, nullptr, getScratchBlock(), getScratchBlockSize());
+  SAPIEN_PROFILE_BLOCK_END;
+  mSimulateTime = Lap(t);
+
+  SAPIEN_PROFILE_BLOCK_BEGIN(fetchResults);
   mPxScene->fetchResults(true);
+  SAPIEN_PROFILE_BLOCK_END;
+  mFetchResultsTime = Lap(t);
+  mSyncPoseTime = 0.0;
+
+  updateScratchBlock();
+  recordStepStatistics();
 
   // TODO: does the GPU API require fetch results?
 }
@@ -244,15 +308,33 @@ void PhysxSystemGpu::stepStart() {
     throw std::runtime_error("failed to step: gpu simulation is not initialized.");
   }
 
+  SAPIEN_PROFILE_FUNCTION;
+  PhysxAllocatorScope allocatorScope(mMemoryTag);
+
   mContactUpToDate = false;
 
   ++mTotalSteps;
-  mPxScene->simulate(mTimestep);
+  auto t = StepClock::now();
+  mPxScene->simulate(mTimestep, nullptr, getScratchBlock(), getScratchBlockSize());
+  mSimulating = true;
+  mSimulateTime = Lap(t);
 }
 
-void PhysxSystemGpu::stepFinish() { mPxScene->fetchResults(true); }
+void PhysxSystemGpu::stepFinish() {
+  SAPIEN_PROFILE_FUNCTION;
+  PhysxAllocatorScope allocatorScope(mMemoryTag);
+  auto t = StepClock::now();
+  mPxScene->fetchResults(true);
+  mSimulating = false;
+  mFetchResultsTime = Lap(t);
+  mSyncPoseTime = 0.0;
+
+  updateScratchBlock();
+  recordStepStatistics();
+}
 
 std::string PhysxSystemCpu::packState() const {
+  SAPIEN_PROFILE_FUNCTION;
   std::ostringstream ss;
   for (auto &actor : mRigidDynamicComponents) {
     Pose pose = actor->getPose();
@@ -292,6 +374,7 @@ std::string PhysxSystemCpu::packState() const {
 }
 
 void PhysxSystemCpu::unpackState(std::string const &data) {
+  SAPIEN_PROFILE_FUNCTION;
   std::istringstream ss(data);
   for (auto &actor : mRigidDynamicComponents) {
     Pose pose;
@@ -339,6 +422,119 @@ void PhysxSystemCpu::unpackState(std::string const &data) {
   }
 }
 
+PhysxStepStatistics PhysxSystem::getStepStatistics() const {
+  PxSimulationStatistics s;
+  getPxScene()->getSimulationStatistics(s);
+
+  PhysxStepStatistics stats;
+  stats.step = mTotalSteps;
+  stats.activeDynamicBodies = s.nbActiveDynamicBodies;
+  stats.activeKinematicBodies = s.nbActiveKinematicBodies;
+  stats.staticBodies = s.nbStaticBodies;
+  stats.dynamicBodies = s.nbDynamicBodies;
+  stats.kinematicBodies = s.nbKinematicBodies;
+  stats.articulations = s.nbArticulations;
+  stats.activeConstraints = s.nbActiveConstraints;
+  stats.axisSolverConstraints = s.nbAxisSolverConstraints;
+
+  stats.broadPhaseAdds = s.getNbBroadPhaseAdds();
+  stats.broadPhaseRemoves = s.getNbBroadPhaseRemoves();
+  stats.discreteContactPairs = s.nbDiscreteContactPairsTotal;
+  stats.discreteContactPairsWithCacheHits = s.nbDiscreteContactPairsWithCacheHits;
+  stats.discreteContactPairsWithContacts = s.nbDiscreteContactPairsWithContacts;
+  stats.newPairs = s.nbNewPairs;
+  stats.lostPairs = s.nbLostPairs;
+  stats.newTouches = s.nbNewTouches;
+  stats.lostTouches = s.nbLostTouches;
+  stats.partitions = s.nbPartitions;
+  stats.peakConstraintMemory = s.peakConstraintMemory;
+  stats.requiredContactConstraintMemory = s.requiredContactConstraintMemory;
+  stats.compressedContactSize = s.compressedContactSize;
+  stats.scratchBlockSize = mScratchBlockSize;
+  stats.scratchGrowCount = mScratchGrowCount;
+
+  stats.simulateTime = mSimulateTime;
+  stats.fetchResultsTime = mFetchResultsTime;
+  stats.syncPoseTime = mSyncPoseTime;
+
+  fillStepStatistics(stats);
+  return stats;
+}
+
+void PhysxSystem::ScratchDeleter::operator()(void *p) const {
+  ::operator delete(p, std::align_val_t(16));
+}
+
+void PhysxSystem::setScratchBlockSize(uint32_t size) {
+  // PhysX requires the scratch block to be 16-byte aligned and a multiple of 16K
+  constexpr uint64_t kScratchGranularity = 16 * 1024;
+  constexpr uint64_t kMaxScratchBlockSize = UINT32_MAX / kScratchGranularity * kScratchGranularity;
+  uint64_t rounded = (size + kScratchGranularity - 1) / kScratchGranularity * kScratchGranularity;
+  size = static_cast<uint32_t>(std::min(rounded, kMaxScratchBlockSize));
+  if (size == mScratchBlockSize) {
+    return;
+  }
+  if (mSimulating) {
+    throw std::runtime_error(
+        "failed to set scratch block size: the scene is simulating, call step_finish first");
+  }
+  mScratchBlock.reset();
+  if (size) {
+    mScratchBlock.reset(::operator new(size, std::align_val_t(16)));
+  }
+  mScratchBlockSize = size;
+}
+
+void PhysxSystem::updateScratchBlock() {
+  if (!mSceneConfig.enableScratchAutoGrow) {
+    return;
+  }
+  PxSimulationStatistics s;
+  mPxScene->getSimulationStatistics(s);
+  // constraint memory is the main consumer of scratch memory, keep 25% headroom
+  uint64_t required =
+      uint64_t(s.peakConstraintMemory) + uint64_t(s.requiredContactConstraintMemory);
+  if (required > mScratchBlockSize) {
+    uint64_t size = std::min<uint64_t>(required * 5 / 4, UINT32_MAX / 2);
+    setScratchBlockSize(static_cast<uint32_t>(size));
+    ++mScratchGrowCount;
+  }
+}
+
+void PhysxSystem::setStepStatisticsHistorySize(uint32_t size) {
+  mStepStatisticsHistorySize = size;
+  while (mStepStatisticsHistory.size() > size) {
+    mStepStatisticsHistory.pop_front();
+  }
+}
+
+void PhysxSystem::recordStepStatistics() {
+  if (mStepStatisticsHistorySize == 0) {
+    return;
+  }
+  if (mStepStatisticsHistory.size() == mStepStatisticsHistorySize) {
+    mStepStatisticsHistory.pop_front();
+  }
+  mStepStatisticsHistory.push_back(getStepStatistics());
+}
+
+void PhysxSystemCpu::fillStepStatistics(PhysxStepStatistics &stats) const {
+  auto contacts = mSimulationCallback.getContacts();
+  stats.contactPairs = static_cast<int>(contacts.size());
+  stats.contactPoints = 0;
+  for (auto c : contacts) {
+    stats.contactPoints += static_cast<int>(c->points.size());
+  }
+
+  uint32_t count = mPxScene->getNbArticulations();
+  std::vector<PxArticulationReducedCoordinate *> articulations(count);
+  mPxScene->getArticulations(articulations.data(), count);
+  stats.awakeArticulations = 0;
+  for (auto a : articulations) {
+    stats.awakeArticulations += !a->isSleeping();
+  }
+}
+
 int PhysxSystem::getArticulationCount() const {
   // TODO: ensure this count matches registered articulations
   return getPxScene()->getNbArticulations();
@@ -369,7 +565,7 @@ int PhysxSystem::computeArticulationMaxLinkCount() const {
 void PhysxSystemGpu::gpuInit() {
   ++mTotalSteps;
   ensureCudaDevice();
-  mPxScene->simulate(mTimestep);
+  mPxScene->simulate(mTimestep, nullptr, getScratchBlock(), getScratchBlockSize());
   while (!mPxScene->fetchResults(true)) {
   }
 
@@ -927,7 +1123,13 @@ void PhysxSystemGpu::gpuApplyArticulationQTargetVel(CudaArrayHandle const &indic
   mCudaEventWait.wait(mCudaStream);
 }
 
+void PhysxSystemGpu::fillStepStatistics(PhysxStepStatistics &stats) const {
+  // contacts are only copied from GPU on demand
+  stats.contactPairs = mContactUpToDate ? mContactCount : -1;
+}
+
 void PhysxSystemGpu::syncPosesGpuToCpu() {
+  SAPIEN_PROFILE_FUNCTION;
   checkGpuInitialized();
   gpuFetchRigidDynamicData();
   gpuFetchArticulationLinkPose();
@@ -1,10 +1,492 @@
 #include "sapien/profiler.h"
+#include <mutex>
 #include <nvtx3/nvToolsExt.h>
+#include <stdexcept>
+#include <unordered_set>
+
+#ifdef SAPIEN_PROFILE
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+#endif
 
 namespace sapien {
 
+char const *ProfilerInternName(std::string const &name) {
+  static std::mutex lock;
+  static std::unordered_set<std::string> names;
+  std::lock_guard guard(lock);
+  return names.insert(name).first->c_str();
+}
+
+#ifdef SAPIEN_PROFILE
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int64_t Now() {
+  static Clock::time_point const epoch = Clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count();
+}
+
+struct TraceEvent {
+  char const *name;
+  int64_t begin; // ns
+  int64_t end;   // ns, equals begin for instant events
+  uint32_t depth;
+  bool instant;
+};
+
+// log-linear histogram over nanoseconds: 4 buckets per power of 2 (<= 12.5% relative error)
+constexpr uint32_t kHistogramBuckets = 256;
+
+uint32_t HistogramBucket(uint64_t ns) {
+  if (ns < 4) {
+    return static_cast<uint32_t>(ns);
+  }
+  uint32_t e = 63 - std::countl_zero(ns);
+  uint32_t sub = (ns >> (e - 2)) & 3;
+  return 4 * (e - 1) + sub;
+}
+
+double HistogramBucketValue(uint32_t bucket) {
+  if (bucket < 4) {
+    return bucket;
+  }
+  uint32_t e = bucket / 4 + 1;
+  uint32_t sub = bucket % 4;
+  double lower = static_cast<double>((4ull + sub) << (e - 2));
+  double upper = static_cast<double>((5ull + sub) << (e - 2));
+  return 0.5 * (lower + upper);
+}
+
+// written by the owning thread only, read by any thread
+struct BlockStats {
+  char const *name{};
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> total{0};
+  std::atomic<uint64_t> min{UINT64_MAX};
+  std::atomic<uint64_t> max{0};
+  std::array<std::atomic<uint64_t>, kHistogramBuckets> histogram{};
+
+  void add(uint64_t ns) {
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    total.store(total.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    if (ns < min.load(std::memory_order_relaxed)) {
+      min.store(ns, std::memory_order_relaxed);
+    }
+    if (ns > max.load(std::memory_order_relaxed)) {
+      max.store(ns, std::memory_order_relaxed);
+    }
+    auto &h = histogram[HistogramBucket(ns)];
+    h.store(h.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  void clear() {
+    count.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    min.store(UINT64_MAX, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+    for (auto &h : histogram) {
+      h.store(0, std::memory_order_relaxed);
+    }
+  }
+};
+
+constexpr uint64_t kChunkSize = 1 << 16;
+constexpr uint32_t kMaxChunks = 4096;
+constexpr uint32_t kMaxBlocksPerThread = 4096;
+
+// incremented by ProfilerReset, each thread clears its own data when it sees a new epoch
+std::atomic<uint64_t> gResetEpoch{0};
+
+struct ThreadData {
+  uint32_t tid{};
+
+  // Events are appended by the owner into chunks that never move and published through
+  // eventCount. Readers only look at threads whose epoch matches gResetEpoch.
+  std::array<std::atomic<TraceEvent *>, kMaxChunks> chunks{};
+  std::atomic<uint64_t> eventCount{0};
+  std::atomic<uint64_t> droppedEvents{0};
+  std::atomic<uint64_t> epoch{0};
+  uint64_t reservedEvents{0}; // owner only, share of gMaxTraceEvents held by this thread
+
+  // statistics slots are only appended by the owner and published through statsCount
+  std::array<std::atomic<BlockStats *>, kMaxBlocksPerThread> stats{};
+  std::atomic<uint32_t> statsCount{0};
+  std::unordered_map<char const *, BlockStats *> statsLookup; // owner only
+
+  bool current() const {
+    return epoch.load(std::memory_order_acquire) == gResetEpoch.load(std::memory_order_relaxed);
+  }
+
+  ~ThreadData() {
+    for (auto &chunk : chunks) {
+      delete[] chunk.load();
+    }
+    for (uint32_t i = 0; i < statsCount; ++i) {
+      delete stats[i].load();
+    }
+  }
+};
+
+struct LocalState {
+  std::vector<std::pair<char const *, int64_t>> stack;
+  std::shared_ptr<ThreadData> data;
+};
+
+std::atomic<bool> gRunning{false};
+std::atomic<uint64_t> gMaxTraceEvents{1 << 22};
+std::atomic<uint64_t> gReservedTraceEvents{0};
+
+std::mutex gRegistryLock;
+std::vector<std::shared_ptr<ThreadData>> gThreads;
+
+// serializes readers with ProfilerReset, never taken while recording
+std::mutex gReadLock;
+
+LocalState &GetLocalState() {
+  thread_local LocalState state;
+  return state;
+}
+
+ThreadData &GetThreadData(LocalState &state) {
+  if (!state.data) {
+    state.data = std::make_shared<ThreadData>();
+    state.data->epoch = gResetEpoch.load();
+    std::lock_guard lock(gRegistryLock);
+    state.data->tid = static_cast<uint32_t>(gThreads.size());
+    gThreads.push_back(state.data);
+  }
+  return *state.data;
+}
+
+std::vector<std::shared_ptr<ThreadData>> GetThreads() {
+  std::lock_guard lock(gRegistryLock);
+  return gThreads;
+}
+
+void ApplyReset(ThreadData &t, uint64_t epoch) {
+  uint32_t count = t.statsCount.load(std::memory_order_relaxed);
+  for (uint32_t i = 0; i < count; ++i) {
+    t.stats[i].load(std::memory_order_relaxed)->clear();
+  }
+  t.eventCount.store(0, std::memory_order_relaxed);
+  t.droppedEvents.store(0, std::memory_order_relaxed);
+  t.reservedEvents = 0;
+  t.epoch.store(epoch, std::memory_order_release);
+}
+
+// take up to one chunk of the trace event limit, so the shared counter is not touched per event
+void ReserveEvents(ThreadData &t) {
+  uint64_t maxEvents = gMaxTraceEvents.load(std::memory_order_relaxed);
+  uint64_t reserved = gReservedTraceEvents.load(std::memory_order_relaxed);
+  uint64_t n;
+  do {
+    n = std::min(kChunkSize, maxEvents > reserved ? maxEvents - reserved : 0);
+    n = std::min(n, kChunkSize * kMaxChunks - t.reservedEvents);
+    if (n == 0) {
+      return;
+    }
+  } while (!gReservedTraceEvents.compare_exchange_weak(reserved, reserved + n,
+                                                       std::memory_order_relaxed));
+  t.reservedEvents += n;
+}
+
+void Record(ThreadData &t, TraceEvent const &event) {
+  uint64_t epoch = gResetEpoch.load(std::memory_order_relaxed);
+  if (t.epoch.load(std::memory_order_relaxed) != epoch) {
+    ApplyReset(t, epoch);
+  }
+
+  uint64_t index = t.eventCount.load(std::memory_order_relaxed);
+  if (index == t.reservedEvents) {
+    ReserveEvents(t);
+  }
+  if (index < t.reservedEvents) {
+    auto &slot = t.chunks[index / kChunkSize];
+    TraceEvent *chunk = slot.load(std::memory_order_relaxed);
+    if (!chunk) {
+      chunk = new TraceEvent[kChunkSize];
+      slot.store(chunk, std::memory_order_relaxed);
+    }
+    chunk[index % kChunkSize] = event;
+    t.eventCount.store(index + 1, std::memory_order_release);
+  } else {
+    t.droppedEvents.store(t.droppedEvents.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+  }
+
+  if (event.instant) {
+    return;
+  }
+
+  BlockStats *stats{};
+  auto it = t.statsLookup.find(event.name);
+  if (it != t.statsLookup.end()) {
+    stats = it->second;
+  } else {
+    uint32_t count = t.statsCount.load(std::memory_order_relaxed);
+    if (count == kMaxBlocksPerThread) {
+      return;
+    }
+    stats = new BlockStats;
+    stats->name = event.name;
+    t.stats[count].store(stats, std::memory_order_relaxed);
+    t.statsCount.store(count + 1, std::memory_order_release);
+    t.statsLookup[event.name] = stats;
+  }
+  stats->add(event.end - event.begin);
+}
+
+std::string JsonEscape(char const *s) {
+  std::string result;
+  for (; *s; ++s) {
+    switch (*s) {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    default:
+      if (static_cast<unsigned char>(*s) < 0x20) {
+        result += ' ';
+      } else {
+        result += *s;
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+void ProfilerEvent(char const *name) {
+  nvtxMarkA(name);
+  if (gRunning.load(std::memory_order_relaxed)) {
+    auto &state = GetLocalState();
+    int64_t t = Now();
+    Record(GetThreadData(state),
+           {name, t, t, static_cast<uint32_t>(state.stack.size()), true});
+  }
+}
+
+void ProfilerBlockBegin(char const *name) {
+  nvtxRangePushA(name);
+  // blocks started while the profiler is stopped are marked with -1 and ignored
+  GetLocalState().stack.push_back(
+      {name, gRunning.load(std::memory_order_relaxed) ? Now() : int64_t(-1)});
+}
+
+void ProfilerBlockEnd() {
+  nvtxRangePop();
+  auto &state = GetLocalState();
+  if (state.stack.empty()) {
+    return;
+  }
+  auto [name, begin] = state.stack.back();
+  state.stack.pop_back();
+  if (begin < 0) {
+    return;
+  }
+  Record(GetThreadData(state),
+         {name, begin, Now(), static_cast<uint32_t>(state.stack.size()), false});
+}
+
+int64_t ProfilerNow() { return Now(); }
+
+void ProfilerRecordBlock(char const *name, int64_t begin, int64_t end) {
+  if (!gRunning.load(std::memory_order_relaxed) || begin < 0) {
+    return;
+  }
+  auto &state = GetLocalState();
+  Record(GetThreadData(state),
+         {name, begin, std::max(begin, end), static_cast<uint32_t>(state.stack.size()), false});
+}
+
+void ProfilerStart(uint64_t maxTraceEvents) {
+  gMaxTraceEvents = maxTraceEvents;
+  Now(); // initialize epoch
+  gRunning = true;
+}
+
+void ProfilerStop() { gRunning = false; }
+
+bool ProfilerIsRunning() { return gRunning; }
+
+void ProfilerReset() {
+  // threads clear their own events and statistics on their next record, readers skip threads
+  // that have not done so yet
+  std::lock_guard lock(gReadLock);
+  gReservedTraceEvents = 0;
+  ++gResetEpoch;
+}
+
+void ProfilerDumpChromeTrace(std::string const &filename) {
+  std::ofstream f(filename);
+  if (!f) {
+    throw std::runtime_error("failed to open file for writing: " + filename);
+  }
+
+  std::lock_guard lock(gReadLock);
+  auto threads = GetThreads();
+  std::vector<uint64_t> eventCounts(threads.size(), 0);
+  uint64_t dropped = 0;
+  for (size_t i = 0; i < threads.size(); ++i) {
+    if (threads[i]->current()) {
+      eventCounts[i] = threads[i]->eventCount.load(std::memory_order_acquire);
+      dropped += threads[i]->droppedEvents.load(std::memory_order_relaxed);
+    }
+  }
+
+  f << std::fixed << std::setprecision(3);
+  f << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << dropped
+    << "},\"traceEvents\":[";
+
+  for (uint32_t tid = 0; tid < threads.size(); ++tid) {
+    f << (tid ? "," : "") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid
+      << ",\"args\":{\"name\":\"thread " << tid << "\"}}";
+  }
+
+  for (uint32_t tid = 0; tid < threads.size(); ++tid) {
+    auto &t = *threads[tid];
+    for (uint64_t i = 0; i < eventCounts[tid]; ++i) {
+      auto const &e = t.chunks[i / kChunkSize].load(std::memory_order_relaxed)[i % kChunkSize];
+      f << ",\n{\"name\":\"" << JsonEscape(e.name) << "\",\"pid\":0,\"tid\":" << tid
+        << ",\"ts\":" << e.begin * 1e-3;
+      if (e.instant) {
+        f << ",\"ph\":\"i\",\"s\":\"t\"}";
+      } else {
+        f << ",\"ph\":\"X\",\"dur\":" << (e.end - e.begin) * 1e-3 << "}";
+      }
+    }
+  }
+  f << "]}\n";
+}
+
+std::vector<ProfilerBlockStats> ProfilerGetSummary() {
+  struct Aggregate {
+    uint64_t count{0};
+    uint64_t total{0};
+    uint64_t min{UINT64_MAX};
+    uint64_t max{0};
+    std::array<uint64_t, kHistogramBuckets> histogram{};
+  };
+
+  std::lock_guard lock(gReadLock);
+
+  // the same name may come from different threads or different string literals
+  std::map<std::string, Aggregate> aggregates;
+  for (auto &t : GetThreads()) {
+    if (!t->current()) {
+      continue;
+    }
+    uint32_t count = t->statsCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; ++i) {
+      auto &s = *t->stats[i].load(std::memory_order_relaxed);
+      if (s.count == 0) {
+        continue;
+      }
+      auto &a = aggregates[s.name];
+      a.count += s.count;
+      a.total += s.total;
+      a.min = std::min<uint64_t>(a.min, s.min);
+      a.max = std::max<uint64_t>(a.max, s.max);
+      for (uint32_t b = 0; b < kHistogramBuckets; ++b) {
+        a.histogram[b] += s.histogram[b];
+      }
+    }
+  }
+
+  std::vector<ProfilerBlockStats> result;
+  for (auto &[name, a] : aggregates) {
+    auto percentile = [&](double p) {
+      uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(p * a.count + 0.5));
+      uint64_t sum = 0;
+      for (uint32_t b = 0; b < kHistogramBuckets; ++b) {
+        sum += a.histogram[b];
+        if (sum >= target) {
+          return std::clamp(HistogramBucketValue(b), static_cast<double>(a.min),
+                            static_cast<double>(a.max)) *
+                 1e-6;
+        }
+      }
+      return a.max * 1e-6;
+    };
+
+    result.push_back({.name = name,
+                      .count = a.count,
+                      .total = a.total * 1e-6,
+                      .mean = a.total * 1e-6 / a.count,
+                      .min = a.min * 1e-6,
+                      .max = a.max * 1e-6,
+                      .p50 = percentile(0.5),
+                      .p90 = percentile(0.9),
+                      .p99 = percentile(0.99)});
+  }
+
+  std::sort(result.begin(), result.end(),
+            [](auto const &a, auto const &b) { return a.total > b.total; });
+  return result;
+}
+
+std::string ProfilerGetSummaryTable() {
+  auto summary = ProfilerGetSummary();
+  size_t width = 5;
+  for (auto &s : summary) {
+    width = std::max(width, s.name.length());
+  }
+
+  std::ostringstream ss;
+  ss << std::left << std::setw(width) << "block" << std::right << std::setw(10) << "count"
+     << std::setw(12) << "total(ms)" << std::setw(12) << "mean(ms)" << std::setw(12) << "min(ms)"
+     << std::setw(12) << "max(ms)" << std::setw(12) << "p50(ms)" << std::setw(12) << "p90(ms)"
+     << std::setw(12) << "p99(ms)"
+     << "\n";
+  ss << std::fixed << std::setprecision(4);
+  for (auto &s : summary) {
+    ss << std::left << std::setw(width) << s.name << std::right << std::setw(10) << s.count
+       << std::setw(12) << s.total << std::setw(12) << s.mean << std::setw(12) << s.min
+       << std::setw(12) << s.max << std::setw(12) << s.p50 << std::setw(12) << s.p90
+       << std::setw(12) << s.p99 << "\n";
+  }
+  return ss.str();
+}
+
+#else
+
 void ProfilerEvent(char const *name) { nvtxMarkA(name); }
 void ProfilerBlockBegin(char const *name) { nvtxRangePushA(name); }
 void ProfilerBlockEnd() { nvtxRangePop(); }
 
+int64_t ProfilerNow() { return 0; }
+void ProfilerRecordBlock(char const *, int64_t, int64_t) {}
+
+void ProfilerStart(uint64_t) {
+  throw std::runtime_error("SAPIEN is built without profiler support (SAPIEN_PROFILE=OFF)");
+}
+void ProfilerStop() {}
+bool ProfilerIsRunning() { return false; }
+void ProfilerReset() {}
+void ProfilerDumpChromeTrace(std::string const &) {
+  throw std::runtime_error("SAPIEN is built without profiler support (SAPIEN_PROFILE=OFF)");
+}
+std::vector<ProfilerBlockStats> ProfilerGetSummary() { return {}; }
+std::string ProfilerGetSummaryTable() { return ""; }
+
+#endif
+
 } // namespace sapien
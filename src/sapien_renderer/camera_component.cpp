@@ -6,7 +6,10 @@
 #include "sapien/sapien_renderer/sapien_renderer_system.h"
 #include "sapien/sapien_renderer/texture.h"
 #include "sapien/scene.h"
+#include <algorithm>
+#include <array>
 #include <numbers>
+#include <optional>
 #include <svulkan2/renderer/renderer.h>
 #include <svulkan2/renderer/renderer_base.h>
 
@@ -30,8 +33,8 @@ struct SapienRenderCameraInternal {
   std::unique_ptr<svulkan2::renderer::RendererBase> mRenderer;
   svulkan2::scene::Camera *mCamera;
 
-  // CPU image buffer
-  std::unordered_map<std::string, std::vector<char>> mImageBuffers;
+  // CPU image buffer, shared with returned images
+  std::unordered_map<std::string, CpuArray> mImageBuffers;
 
   // GPU image buffer
 #ifdef SAPIEN_CUDA
@@ -40,6 +43,17 @@ struct SapienRenderCameraInternal {
   std::unique_ptr<svulkan2::core::CommandPool> mCommandPool;
   vk::UniqueCommandBuffer mCommandBuffer;
 
+  // async readback, pictures alternate between two host visible staging slots
+  struct ReadbackSlot {
+    uint64_t frame{0};
+    std::unordered_map<std::string, std::shared_ptr<svulkan2::core::Buffer>> buffers;
+    vk::UniqueCommandBuffer commandBuffer;
+  };
+  std::vector<std::string> mReadbackTargets;
+  std::array<ReadbackSlot, 2> mReadbackSlots;
+  vk::UniqueSemaphore mReadbackSemaphore;
+  uint64_t mReadbackFrame{0};
+
   SapienRenderCameraInternal(uint32_t width, uint32_t height, std::string const &shaderDir,
                              std::shared_ptr<svulkan2::scene::Scene> scene) {
     mWidth = width;
@@ -105,13 +119,128 @@ struct SapienRenderCameraInternal {
     }
   }
 
+  void waitForReadback(uint64_t frame) {
+    if (!mReadbackSemaphore || frame == 0) {
+      return;
+    }
+    auto result = mEngine->getContext()->getDevice().waitSemaphores(
+        vk::SemaphoreWaitInfo({}, mReadbackSemaphore.get(), frame), UINT64_MAX);
+    if (result != vk::Result::eSuccess) {
+      throw std::runtime_error("failed to read back image: wait for semaphore failed");
+    }
+  }
+
+  void setReadbackTargets(std::vector<std::string> const &names) {
+    auto available = getImageNames();
+    for (auto &name : names) {
+      if (std::find(available.begin(), available.end(), name) == available.end()) {
+        throw std::runtime_error("failed to set readback targets: invalid render target " +
+                                 name);
+      }
+    }
+    waitForReadback(mReadbackFrame);
+    mReadbackTargets = names;
+    // buffers and commands are created on the next picture when render targets exist
+    for (auto &slot : mReadbackSlots) {
+      slot = {};
+    }
+  }
+
+  void recordReadback(ReadbackSlot &slot) {
+    auto context = mEngine->getContext();
+    if (!mCommandPool) {
+      mCommandPool = context->createCommandPool();
+    }
+    slot.commandBuffer = mCommandPool->allocateCommandBuffer();
+    slot.commandBuffer->begin(vk::CommandBufferBeginInfo());
+    for (auto &name : mReadbackTargets) {
+      auto &image = mRenderer->getRenderImage(name);
+      auto extent = image.getExtent();
+      vk::DeviceSize size =
+          extent.width * extent.height * extent.depth * svulkan2::getFormatSize(image.getFormat());
+      auto buffer = svulkan2::core::Buffer::Create(
+          size, vk::BufferUsageFlagBits::eTransferDst, VMA_MEMORY_USAGE_GPU_TO_CPU);
+      image.recordCopyToBuffer(slot.commandBuffer.get(),
+                               mRenderer->getRenderTargetImageLayout(name),
+                               buffer->getVulkanBuffer(), 0, size, {0, 0, 0}, extent, 0);
+      slot.buffers[name] = std::move(buffer);
+    }
+    slot.commandBuffer->end();
+  }
+
   void takePicture() {
+    auto context = mEngine->getContext();
     if (!mSemaphore) {
-      mSemaphore = mEngine->getContext()->createTimelineSemaphore(mFrameCounter);
+      mSemaphore = context->createTimelineSemaphore(mFrameCounter);
     }
     waitForRender();
     mFrameCounter++;
-    mRenderer->render(*mCamera, {}, {}, {}, mSemaphore.get(), mFrameCounter);
+
+    if (mReadbackTargets.empty()) {
+      mRenderer->render(*mCamera, {}, {}, {}, mSemaphore.get(), mFrameCounter);
+      return;
+    }
+
+    if (!mReadbackSemaphore) {
+      mReadbackSemaphore = context->createTimelineSemaphore(0);
+    }
+
+    // render targets must not be overwritten before the previous readback copied them
+    vk::PipelineStageFlags stage = vk::PipelineStageFlagBits::eAllCommands;
+    mRenderer->render(*mCamera, mReadbackSemaphore.get(), stage, mReadbackFrame,
+                      mSemaphore.get(), mFrameCounter);
+
+    auto &slot = mReadbackSlots[mFrameCounter % 2];
+    waitForReadback(slot.frame);
+    if (!slot.commandBuffer) {
+      recordReadback(slot);
+    }
+    vk::PipelineStageFlags transferStage = vk::PipelineStageFlagBits::eTransfer;
+    context->getQueue().submit(slot.commandBuffer.get(), mSemaphore.get(), transferStage,
+                               mFrameCounter, mReadbackSemaphore.get(), mFrameCounter, {});
+    slot.frame = mFrameCounter;
+    mReadbackFrame = mFrameCounter;
+  }
+
+  uint64_t getReadbackFrame(bool wait) {
+    if (!mReadbackSemaphore) {
+      return 0;
+    }
+    if (wait) {
+      waitForReadback(mReadbackFrame);
+    }
+    uint64_t frame =
+        mEngine->getContext()->getDevice().getSemaphoreCounterValue(mReadbackSemaphore.get());
+    for (auto &slot : mReadbackSlots) {
+      if (slot.frame == frame) {
+        return frame;
+      }
+    }
+    // targets changed since the last completed readback
+    return 0;
+  }
+
+  SapienRenderImageCpu getImageAsync(std::string const &name, uint64_t frame) {
+    auto it = std::find_if(mReadbackSlots.begin(), mReadbackSlots.end(),
+                           [=](auto &slot) { return frame != 0 && slot.frame == frame; });
+    if (it == mReadbackSlots.end()) {
+      throw std::runtime_error("failed to get image: frame " + std::to_string(frame) +
+                               " is not available for readback");
+    }
+    if (!it->buffers.contains(name)) {
+      throw std::runtime_error("failed to get image: " + name + " is not a readback target");
+    }
+    waitForReadback(frame);
+
+    auto &image = mRenderer->getRenderImage(name);
+    vk::Format format = image.getFormat();
+    size_t size = mWidth * mHeight * svulkan2::getFormatSize(format);
+    auto &buffer = mImageBuffers[name];
+    if (!buffer.data || buffer.data.use_count() > 1 || buffer.bytes() != static_cast<int>(size)) {
+      buffer = CpuArray({static_cast<int>(size)}, "u1");
+    }
+    it->buffers.at(name)->download(buffer.ptr(), size);
+    return SapienRenderImageCpu(mWidth, mHeight, format, buffer.ptr(), buffer.data);
   }
 
   std::vector<std::string> getImageNames() const { return mRenderer->getRenderTargetNames(); }
@@ -122,9 +251,13 @@ struct SapienRenderCameraInternal {
     vk::Format format = image.getFormat();
     uint32_t formatSize = svulkan2::getFormatSize(format);
     size_t size = mWidth * mHeight * formatSize;
-    mImageBuffers[name].resize(size);
-    image.download(mImageBuffers[name].data(), size);
-    return SapienRenderImageCpu(mWidth, mHeight, format, mImageBuffers[name].data());
+    auto &buffer = mImageBuffers[name];
+    // images returned earlier may still be in use, download into a new buffer in that case
+    if (!buffer.data || buffer.data.use_count() > 1 || buffer.bytes() != static_cast<int>(size)) {
+      buffer = CpuArray({static_cast<int>(size)}, "u1");
+    }
+    image.download(buffer.ptr(), size);
+    return SapienRenderImageCpu(mWidth, mHeight, format, buffer.ptr(), buffer.data);
   }
 
   SapienRenderImageCuda getImageCuda(std::string const &name) {
@@ -167,7 +300,10 @@ struct SapienRenderCameraInternal {
   svulkan2::renderer::RendererBase &getRenderer() const { return *mRenderer; }
   svulkan2::scene::Camera &getCamera() const { return *mCamera; }
 
-  ~SapienRenderCameraInternal() { mScene->removeNode(*mCamera); }
+  ~SapienRenderCameraInternal() {
+    waitForReadback(mReadbackFrame);
+    mScene->removeNode(*mCamera);
+  }
 };
 
 void SapienRenderCameraComponent::setProperty(std::string const &name, int property) {
@@ -256,6 +392,9 @@ void SapienRenderCameraComponent::onAddToScene(Scene &scene) {
       mCamera->mRenderer->setCustomProperty(k, std::get<float>(v));
     }
   }
+  if (!mAsyncReadbackTargets.empty()) {
+    mCamera->setReadbackTargets(mAsyncReadbackTargets);
+  }
   system->registerComponent(
       std::static_pointer_cast<SapienRenderCameraComponent>(shared_from_this()));
 }
@@ -271,10 +410,61 @@ void SapienRenderCameraComponent::takePicture() {
   if (!mCamera) {
     throw std::runtime_error("failed to take picture: the camera is not added to scene");
   }
-  mCamera->takePicture();
+
+  mCulledObjectCount = 0;
+  mLodObjectCount = 0;
+  auto system = getScene()->getSapienRendererSystem();
+  bool rasterizer = dynamic_cast<svulkan2::renderer::Renderer *>(&mCamera->getRenderer());
+
+  // LOD levels stay selected after the picture, so a camera looking at a similar view again
+  // does not change the scene
+  if (rasterizer && mMode == CameraMode::ePerspective) {
+    mLodObjectCount = system->updateLods(getGlobalPose().p, mFy);
+  } else {
+    system->resetLods();
+  }
+
+  if (!rasterizer || !mFrustumCulling) {
+    mCamera->takePicture();
+    mUpdatedWithoutTakingPicture = false;
+    return;
+  }
+
+  // hide culled objects only while the picture is recorded
+  std::vector<std::pair<svulkan2::scene::Object *, float>> hidden;
+  for (auto obj : system->cullObjects(getFrustumPlanes())) {
+    if (obj->getTransparency() < 1.f) {
+      hidden.push_back({obj, obj->getTransparency()});
+      obj->setTransparency(1.f);
+    }
+  }
+  mCulledObjectCount = hidden.size();
+  try {
+    mCamera->takePicture();
+  } catch (...) {
+    for (auto &[obj, transparency] : hidden) {
+      obj->setTransparency(transparency);
+    }
+    throw;
+  }
+  for (auto &[obj, transparency] : hidden) {
+    obj->setTransparency(transparency);
+  }
   mUpdatedWithoutTakingPicture = false;
 }
 
+std::vector<std::array<float, 4>> SapienRenderCameraComponent::getFrustumPlanes() const {
+  Mat4 m = getProjectionMatrix() * getModelMatrix().inverse();
+  // near plane from z >= -w is conservative for both [-1, 1] and [0, 1] clip depth
+  std::vector<std::array<float, 4>> planes;
+  for (auto [row, sign] : std::initializer_list<std::pair<int, float>>{
+           {0, 1.f}, {0, -1.f}, {1, 1.f}, {1, -1.f}, {2, 1.f}, {2, -1.f}}) {
+    Eigen::RowVector4f p = m.row(3) + sign * m.row(row);
+    planes.push_back({p[0], p[1], p[2], p[3]});
+  }
+  return planes;
+}
+
 std::vector<std::string> SapienRenderCameraComponent::getImageNames() const {
   if (!mCamera) {
     throw std::runtime_error("failed to get image names: the camera is not added to scene");
@@ -293,6 +483,49 @@ SapienRenderImageCpu SapienRenderCameraComponent::getImage(std::string const &na
   return image;
 }
 
+PointCloud SapienRenderCameraComponent::getPointCloud(PointCloudOptions const &options) {
+  if (!mCamera) {
+    throw std::runtime_error("failed to get point cloud: the camera is not added to scene");
+  }
+  if (mUpdatedWithoutTakingPicture) {
+    logger::warn("getting point cloud without taking picture since last camera update");
+  }
+  auto position = mCamera->getImage("Position");
+  std::optional<SapienRenderImageCpu> color;
+  std::optional<SapienRenderImageCpu> segmentation;
+  if (options.color) {
+    color = mCamera->getImage("Color");
+  }
+  if (options.segmentation || !options.segmentationIds.empty()) {
+    segmentation = mCamera->getImage("Segmentation");
+  }
+  return computePointCloud(position, color ? &*color : nullptr,
+                           segmentation ? &*segmentation : nullptr,
+                           getGlobalPose() * POSE_GL_TO_ROS, options, mPointCloudBuffer);
+}
+
+void SapienRenderCameraComponent::setAsyncReadbackTargets(std::vector<std::string> const &names) {
+  if (mCamera) {
+    mCamera->setReadbackTargets(names);
+  }
+  mAsyncReadbackTargets = names;
+}
+
+uint64_t SapienRenderCameraComponent::getAsyncFrame(bool wait) {
+  if (!mCamera) {
+    throw std::runtime_error("failed to get async frame: the camera is not added to scene");
+  }
+  return mCamera->getReadbackFrame(wait);
+}
+
+SapienRenderImageCpu SapienRenderCameraComponent::getImageAsync(std::string const &name,
+                                                                uint64_t frame) {
+  if (!mCamera) {
+    throw std::runtime_error("failed to get image: the camera is not added to scene");
+  }
+  return mCamera->getImageAsync(name, frame);
+}
+
 SapienRenderImageCuda SapienRenderCameraComponent::getImageCuda(std::string const &name) {
 #ifdef SAPIEN_CUDA
   if (!mCamera) {
@@ -0,0 +1,174 @@
+#include "sapien/sapien_renderer/camera_point_cloud.h"
+#include "sapien/math/batch.h"
+#include "sapien/profiler.h"
+#include "sapien/utils/thread_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace sapien {
+namespace sapien_renderer {
+
+// below this many pixels per thread, handing work to another thread costs more than it saves
+static constexpr size_t PixelsPerThread = 16384;
+
+static void CheckImage(CpuArrayHandle const &image, int height, int width,
+                       std::vector<std::string> const &types, std::string const &name) {
+  if (image.shape.size() != 3 || image.shape[0] != height || image.shape[1] != width ||
+      image.shape[2] != 4) {
+    throw std::runtime_error("failed to compute point cloud: " + name +
+                             " image must have shape [H, W, 4] matching the Position image");
+  }
+  if (std::find(types.begin(), types.end(), image.type) == types.end()) {
+    throw std::runtime_error("failed to compute point cloud: unsupported " + name +
+                             " image type " + image.type);
+  }
+  if (!image.isContiguous()) {
+    throw std::runtime_error("failed to compute point cloud: " + name +
+                             " image must be contiguous");
+  }
+}
+
+PointCloud computePointCloud(CpuArrayHandle const &position, CpuArrayHandle const *color,
+                             CpuArrayHandle const *segmentation, Pose const &cameraPose,
+                             PointCloudOptions const &options, CpuArray &buffer) {
+  SAPIEN_PROFILE_FUNCTION;
+  if (position.shape.size() != 3) {
+    throw std::runtime_error("failed to compute point cloud: Position image must have shape "
+                             "[H, W, 4]");
+  }
+  int height = position.shape[0];
+  int width = position.shape[1];
+  CheckImage(position, height, width, {"f4"}, "Position");
+
+  bool filterIds = !options.segmentationIds.empty();
+  if (options.color) {
+    if (!color) {
+      throw std::runtime_error("failed to compute point cloud: Color image is missing");
+    }
+    CheckImage(*color, height, width, {"f4", "u1"}, "Color");
+  }
+  if (options.segmentation || filterIds) {
+    if (!segmentation) {
+      throw std::runtime_error("failed to compute point cloud: Segmentation image is missing");
+    }
+    CheckImage(*segmentation, height, width, {"u4"}, "Segmentation");
+    if (options.segmentationLevel >= 4) {
+      throw std::runtime_error("failed to compute point cloud: segmentation level must be "
+                               "less than 4");
+    }
+  }
+
+  // output sections are sized for every pixel, points are compacted after filtering
+  size_t pixelCount = static_cast<size_t>(height) * width;
+  size_t colorOffset = pixelCount * 3 * sizeof(float);
+  size_t segmentationOffset = colorOffset + (options.color ? pixelCount * 4 * sizeof(float) : 0);
+  size_t bytes =
+      segmentationOffset + (options.segmentation ? pixelCount * 4 * sizeof(uint32_t) : 0);
+  if (!buffer.data || buffer.data.use_count() > 1 ||
+      static_cast<size_t>(buffer.bytes()) < bytes) {
+    buffer = CpuArray({static_cast<int>(std::max<size_t>(bytes, 1))}, "u1");
+  }
+  auto base = static_cast<char *>(buffer.ptr());
+  auto outPoints = reinterpret_cast<float *>(base);
+  auto outColors = reinterpret_cast<float *>(base + colorOffset);
+  auto outSegmentation = reinterpret_cast<uint32_t *>(base + segmentationOffset);
+
+  auto inPosition = static_cast<float const *>(position.ptr);
+  auto inSegmentation =
+      segmentation ? static_cast<uint32_t const *>(segmentation->ptr) : nullptr;
+  bool colorU8 = options.color && color->type == "u1";
+
+  std::vector<uint32_t> ids = options.segmentationIds;
+  std::sort(ids.begin(), ids.end());
+  float minDepth = options.minDepth;
+  float maxDepth = options.maxDepth > 0.f ? options.maxDepth : std::numeric_limits<float>::max();
+  uint32_t level = options.segmentationLevel;
+
+  uint32_t threadCount =
+      options.threadCount ? options.threadCount : std::thread::hardware_concurrency();
+  threadCount =
+      std::clamp<size_t>(pixelCount / PixelsPerThread, 1, std::max(threadCount, 1u));
+  size_t chunk = (pixelCount + threadCount - 1) / threadCount;
+  std::vector<size_t> counts(threadCount, 0);
+
+  // each thread writes the points of its pixels starting at its first pixel index
+  auto process = [&](uint32_t thread) {
+    size_t begin = std::min(pixelCount, thread * chunk);
+    size_t end = std::min(pixelCount, begin + chunk);
+    size_t n = begin;
+    for (size_t i = begin; i < end; ++i) {
+      float const *p = inPosition + 4 * i;
+      float depth = -p[2];
+      if (!(p[3] < 1.f) || depth < minDepth || depth > maxDepth) {
+        continue;
+      }
+      if (filterIds &&
+          !std::binary_search(ids.begin(), ids.end(), inSegmentation[4 * i + level])) {
+        continue;
+      }
+      std::copy_n(p, 3, outPoints + 3 * n);
+      if (colorU8) {
+        auto c = static_cast<uint8_t const *>(color->ptr) + 4 * i;
+        for (int k = 0; k < 4; ++k) {
+          outColors[4 * n + k] = c[k] / 255.f;
+        }
+      } else if (options.color) {
+        std::copy_n(static_cast<float const *>(color->ptr) + 4 * i, 4, outColors + 4 * n);
+      }
+      if (options.segmentation) {
+        std::copy_n(inSegmentation + 4 * i, 4, outSegmentation + 4 * n);
+      }
+      ++n;
+    }
+    counts[thread] = n - begin;
+    if (options.frame == PointCloudFrame::eWorld) {
+      transformPoints(cameraPose, outPoints + 3 * begin, outPoints + 3 * begin, n - begin);
+    }
+  };
+
+  ThreadPool::Get().parallelFor(threadCount, threadCount, process);
+
+  // move the points of each chunk next to the previous ones
+  size_t total = counts[0];
+  for (uint32_t t = 1; t < threadCount; ++t) {
+    size_t begin = std::min(pixelCount, t * chunk);
+    std::memmove(outPoints + 3 * total, outPoints + 3 * begin, counts[t] * 3 * sizeof(float));
+    if (options.color) {
+      std::memmove(outColors + 4 * total, outColors + 4 * begin, counts[t] * 4 * sizeof(float));
+    }
+    if (options.segmentation) {
+      std::memmove(outSegmentation + 4 * total, outSegmentation + 4 * begin,
+                   counts[t] * 4 * sizeof(uint32_t));
+    }
+    total += counts[t];
+  }
+
+  int n = static_cast<int>(total);
+  PointCloud result;
+  result.points = {.shape = {n, 3},
+                   .strides = {12, 4},
+                   .type = "f4",
+                   .ptr = outPoints,
+                   .owner = buffer.data};
+  if (options.color) {
+    result.colors = {.shape = {n, 4},
+                     .strides = {16, 4},
+                     .type = "f4",
+                     .ptr = outColors,
+                     .owner = buffer.data};
+  }
+  if (options.segmentation) {
+    result.segmentation = {.shape = {n, 4},
+                           .strides = {16, 4},
+                           .type = "u4",
+                           .ptr = outSegmentation,
+                           .owner = buffer.data};
+  }
+  return result;
+}
+
+} // namespace sapien_renderer
+} // namespace sapien
@@ -0,0 +1,136 @@
+#include "sapien/sapien_renderer/host_batched_camera.h"
+#include "sapien/sapien_renderer/camera_component.h"
+#include "sapien/sapien_renderer/image.h"
+#include <svulkan2/renderer/renderer_base.h>
+
+namespace sapien {
+namespace sapien_renderer {
+
+HostBatchedCamera::HostBatchedCamera(
+    std::vector<std::shared_ptr<SapienRenderCameraComponent>> cameras,
+    std::vector<std::string> renderTargets)
+    : mCameras(cameras) {
+  if (cameras.empty()) {
+    throw std::runtime_error("failed to create HostBatchedCamera: empty cameras");
+  }
+  uint32_t width = cameras.at(0)->getWidth();
+  uint32_t height = cameras.at(0)->getHeight();
+
+  for (auto &cam : cameras) {
+    if (!cam->getScene()) {
+      throw std::runtime_error(
+          "failed to create HostBatchedCamera: some camera is not added to scene");
+    }
+    if (cam->getWidth() != width || cam->getHeight() != height) {
+      throw std::runtime_error(
+          "failed to create HostBatchedCamera: the cameras must have the same width and height");
+    }
+  }
+
+  auto context = SapienRenderEngine::Get()->getContext();
+  auto device = context->getDevice();
+
+  // render targets are created on the first render
+  auto fence = device.createFenceUnique({});
+  for (auto &cam : cameras) {
+    device.resetFences(fence.get());
+    cam->getInternalRenderer().render(cam->getInternalCamera(), {}, {}, {}, fence.get());
+    if (device.waitForFences(fence.get(), true, UINT64_MAX) != vk::Result::eSuccess) {
+      throw std::runtime_error("failed to create HostBatchedCamera: the camera failed to render");
+    }
+  }
+
+  // every target is copied into one buffer sized for the first camera's image
+  for (auto &name : renderTargets) {
+    auto &first = cameras[0]->getInternalRenderer().getRenderImage(name);
+    for (auto &cam : cameras) {
+      auto &image = cam->getInternalRenderer().getRenderImage(name);
+      if (image.getExtent() != first.getExtent() || image.getFormat() != first.getFormat()) {
+        throw std::runtime_error("failed to create HostBatchedCamera: render target " + name +
+                                 " must have the same size and format for all cameras");
+      }
+    }
+  }
+
+  mCommandPool = context->createCommandPool();
+  mCommandBuffer = mCommandPool->allocateCommandBuffer();
+  mCommandBuffer->begin(vk::CommandBufferBeginInfo());
+  for (uint32_t i = 0; i < cameras.size(); ++i) {
+    auto &cam = cameras[i];
+    for (auto &name : renderTargets) {
+      auto &image = cam->getInternalRenderer().getRenderImage(name);
+      auto extent = image.getExtent();
+      vk::Format format = image.getFormat();
+      vk::DeviceSize imageSize =
+          extent.width * extent.height * extent.depth * svulkan2::getFormatSize(format);
+
+      if (!mTargets.contains(name)) {
+        auto &target = mTargets[name];
+        target.buffer = svulkan2::core::Buffer::Create(imageSize * cameras.size(),
+                                                       vk::BufferUsageFlagBits::eTransferDst,
+                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
+        int channels = getFormatChannels(format);
+        target.shape = {static_cast<int>(cameras.size()), static_cast<int>(extent.height),
+                        static_cast<int>(extent.width)};
+        if (channels != 1) {
+          target.shape.push_back(channels);
+        }
+        target.type = getFormatTypestr(format);
+      }
+      image.recordCopyToBuffer(mCommandBuffer.get(),
+                               cam->getInternalRenderer().getRenderTargetImageLayout(name),
+                               mTargets.at(name).buffer->getVulkanBuffer(), i * imageSize,
+                               imageSize, {0, 0, 0}, extent, 0);
+    }
+  }
+  mCommandBuffer->end();
+
+  mSemaphore = context->createTimelineSemaphore(mFrameCounter);
+}
+
+void HostBatchedCamera::waitForPicture() {
+  auto result = SapienRenderEngine::Get()->getContext()->getDevice().waitSemaphores(
+      vk::SemaphoreWaitInfo({}, mSemaphore.get(), mFrameCounter), UINT64_MAX);
+  if (result != vk::Result::eSuccess) {
+    throw std::runtime_error("take picture failed: wait for semaphore failed");
+  }
+}
+
+void HostBatchedCamera::takePicture() {
+  auto context = SapienRenderEngine::Get()->getContext();
+
+  // make sure previous takePicture has finished
+  waitForPicture();
+
+  for (auto &cam : mCameras) {
+    cam->getInternalRenderer().render(cam->getInternalCamera(), {}, {}, {}, {});
+  }
+  // copies are ordered after the renders by the image barriers they record
+  mFrameCounter++;
+  context->getQueue().submit(mCommandBuffer.get(), {}, {}, {}, mSemaphore.get(), mFrameCounter,
+                             {});
+}
+
+CpuArrayHandle HostBatchedCamera::getPicture(std::string const &name) {
+  auto it = mTargets.find(name);
+  if (it == mTargets.end()) {
+    throw std::runtime_error("failed to get picture with name: " + name +
+                             ". Did you forget to specify it when creating the camera group?");
+  }
+  waitForPicture();
+
+  auto &target = it->second;
+  // pictures returned earlier may still be in use, download into a new array in that case
+  if (!target.array.data || target.array.data.use_count() > 1) {
+    target.array = CpuArray(target.shape, target.type);
+  }
+  target.buffer->download(target.array.ptr(), target.array.bytes());
+  return target.array.handle();
+}
+
+HostBatchedCamera::~HostBatchedCamera() {
+  SapienRenderEngine::Get()->getContext()->getDevice().waitIdle();
+}
+
+} // namespace sapien_renderer
+} // namespace sapien
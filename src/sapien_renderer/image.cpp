@@ -45,7 +45,8 @@ std::string getFormatTypestr(vk::Format format) {
   return getFormatDescriptor(format) + std::to_string(getFormatChannelSize(format));
 }
 
-SapienRenderImageCpu::SapienRenderImageCpu(int width, int height, vk::Format format, void *ptr) {
+SapienRenderImageCpu::SapienRenderImageCpu(int width, int height, vk::Format format, void *ptr,
+                                           std::shared_ptr<void> owner) {
   this->format = format;
 
   int channels = getFormatChannels(format);
@@ -59,6 +60,7 @@ SapienRenderImageCpu::SapienRenderImageCpu(int width, int height, vk::Format for
 
   this->type = getFormatTypestr(format);
   this->ptr = ptr;
+  this->owner = owner;
 }
 
 SapienRenderImageCuda::SapienRenderImageCuda(int width, int height, vk::Format format, void *ptr,
@@ -7,6 +7,7 @@ namespace sapien_renderer {
 
 std::unique_ptr<RenderSceneLoaderNode> LoadScene(std::string const &filename, bool applyScale) {
   auto scene = svulkan2::scene::LoadScene(filename);
+  auto cache = SapienRenderEngine::Get()->getResourceCache();
 
   std::unique_ptr<RenderSceneLoaderNode> rootNode;
 
@@ -56,6 +57,11 @@ std::unique_ptr<RenderSceneLoaderNode> LoadScene(std::string const &filename, bo
 
     if (auto obj = dynamic_cast<svulkan2::scene::Object *>(node)) {
       for (auto shape : obj->getModel()->getShapes()) {
+        // repeated meshes in the scene and across loads share one copy
+        auto mesh = cache->deduplicateMesh(shape->mesh);
+        if (mesh != shape->mesh) {
+          shape = svulkan2::resource::SVShape::Create(mesh, shape->material);
+        }
         std::vector<std::shared_ptr<RenderShapeTriangleMeshPart>> parts = {
             std::make_shared<RenderShapeTriangleMeshPart>(shape)};
         auto renderShape = std::make_shared<RenderShapeTriangleMesh>(parts);
@@ -34,6 +34,7 @@ void PointCloudComponent::onAddToScene(Scene &scene) {
   auto system = scene.getSapienRendererSystem();
   auto s = system->getScene();
   mObject = &s->addPointObject(mPointSet, getTransform());
+  mPoseVersion = ~0ull;
   system->registerComponent(std::static_pointer_cast<PointCloudComponent>(shared_from_this()));
 }
 
@@ -46,10 +47,16 @@ void PointCloudComponent::onRemoveFromScene(Scene &scene) {
 }
 
 // called by system to sync pose
-void PointCloudComponent::internalUpdate() {
-  auto pose = getEntity()->getPose();
+bool PointCloudComponent::internalUpdate() {
+  auto entity = getEntity();
+  if (entity->getPoseVersion() == mPoseVersion) {
+    return false;
+  }
+  mPoseVersion = entity->getPoseVersion();
+  auto pose = entity->getPose();
   mObject->setPosition({pose.p.x, pose.p.y, pose.p.z});
   mObject->setRotation({pose.q.w, pose.q.x, pose.q.y, pose.q.z});
+  return true;
 }
 
 CudaArrayHandle PointCloudComponent::getCudaArray() const {
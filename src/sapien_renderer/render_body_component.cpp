@@ -49,6 +49,7 @@ void SapienRenderBodyComponent::onAddToScene(Scene &scene) {
   auto system = scene.getSapienRendererSystem();
   auto s = system->getScene();
   mNode = &s->addNode();
+  mPoseVersion = ~0ull;
   for (auto &shape : mRenderShapes) {
     auto &obj = s->addObject(*mNode, shape->getModel());
     obj.setTransform(shape->getLocalTransform());
@@ -60,6 +61,18 @@ void SapienRenderBodyComponent::onAddToScene(Scene &scene) {
 
     obj.setSegmentation({id, getEntity()->getPerSceneId(), scene.getId(), 0});
     obj.setTransparency(1.f - mVisibility);
+
+    // LOD objects stay hidden until a camera selects them
+    std::vector<svulkan2::scene::Object *> lodObjects;
+    for (auto &model : shape->getLodModels()) {
+      auto &lod = s->addObject(*mNode, model);
+      lod.setTransform(shape->getLocalTransform());
+      lod.setFrontFace(shape->getFrontFace());
+      lod.setSegmentation({id, getEntity()->getPerSceneId(), scene.getId(), 0});
+      lod.setTransparency(1.f);
+      lodObjects.push_back(&lod);
+    }
+    shape->internalSetLodObjects(lodObjects);
   }
 
   // register
@@ -73,6 +86,7 @@ void SapienRenderBodyComponent::onRemoveFromScene(Scene &scene) {
   for (auto &s : mRenderShapes) {
     s->internalSetRenderId(0);
     s->internalSetRenderObject(nullptr);
+    s->internalSetLodObjects({});
   }
   s->removeNode(*mNode);
   mNode = nullptr;
@@ -84,10 +98,8 @@ void SapienRenderBodyComponent::onRemoveFromScene(Scene &scene) {
 void SapienRenderBodyComponent::setVisibility(float v) {
   mVisibility = v;
   if (mNode) {
-    for (auto c : mNode->getChildren()) {
-      if (auto o = dynamic_cast<svulkan2::scene::Object *>(c)) {
-        o->setTransparency(1.f - v);
-      }
+    for (auto &shape : mRenderShapes) {
+      shape->internalGetDisplayedObject()->setTransparency(1.f - v);
     }
   }
 }
@@ -165,10 +177,30 @@ void SapienRenderBodyComponent::setTextureArray(
   }
 }
 
-void SapienRenderBodyComponent::internalUpdate() {
-  auto pose = getEntity()->getPose();
+bool SapienRenderBodyComponent::internalUpdate() {
+  auto entity = getEntity();
+  if (entity->getPoseVersion() == mPoseVersion) {
+    return false;
+  }
+  mPoseVersion = entity->getPoseVersion();
+  auto pose = entity->getPose();
   mNode->setPosition({pose.p.x, pose.p.y, pose.p.z});
   mNode->setRotation({pose.q.w, pose.q.x, pose.q.y, pose.q.z});
+  return true;
+}
+
+void SapienRenderBodyComponent::onSetPose(Pose const &pose) {
+  // non-static bodies are updated by the system
+  if (mStatic && mNode) {
+    internalUpdate();
+  }
+}
+
+void SapienRenderBodyComponent::setStatic(bool isStatic) {
+  if (getScene()) {
+    throw std::runtime_error("failed to set static: component already added to scene");
+  }
+  mStatic = isStatic;
 }
 
 SapienRenderBodyComponent::~SapienRenderBodyComponent() {
@@ -200,6 +232,7 @@ std::shared_ptr<SapienRenderBodyComponent> SapienRenderBodyComponent::clone() co
   body->setVisibility(getVisibility());
   body->setShadingMode(getShadingMode());
   body->mRenderIdDisabled = mRenderIdDisabled;
+  body->mStatic = mStatic;
   // TODO copy properties
   return body;
 }
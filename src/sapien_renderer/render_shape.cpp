@@ -1,5 +1,17 @@
 #include "sapien/sapien_renderer/render_shape.h"
+#include "../logger.h"
+#include "sapien/math/mesh_simplify.h"
 #include "sapien/sapien_renderer/render_body_component.h"
+#include "sapien/sapien_renderer/resource_cache.h"
+#include "sapien/sapien_renderer/sapien_renderer_default.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <thread>
 
 namespace sapien {
 namespace sapien_renderer {
@@ -13,6 +25,17 @@ std::shared_ptr<SapienRenderBodyComponent> RenderShape::getParent() const {
 
 RenderShape::RenderShape() { mEngine = SapienRenderEngine::Get(); }
 
+void RenderShape::internalSetLodLevel(uint32_t level) {
+  if (level == mLodLevel) {
+    return;
+  }
+  auto previous = internalGetDisplayedObject();
+  mLodLevel = level;
+  auto current = internalGetDisplayedObject();
+  current->setTransparency(previous->getTransparency());
+  previous->setTransparency(1.f);
+}
+
 void RenderShape::setLocalPose(Pose const &pose) {
   if (mParent) {
     throw std::runtime_error(
@@ -225,7 +248,7 @@ std::shared_ptr<SapienRenderMaterial> RenderShapeTriangleMeshPart::getMaterial()
 RenderShapeTriangleMesh::RenderShapeTriangleMesh(std::string const &filename, Vec3 scale,
                                                  std::shared_ptr<SapienRenderMaterial> material)
     : mFilename(filename) {
-  mModel = mEngine->getContext()->getResourceManager()->CreateModelFromFile(filename);
+  mModel = mEngine->getResourceCache()->getModel(filename);
   mMaterial = material;
   mScale = scale;
   if (material) {
@@ -237,6 +260,9 @@ RenderShapeTriangleMesh::RenderShapeTriangleMesh(std::string const &filename, Ve
     }
     mModel = svulkan2::resource::SVModel::FromData(shapes);
   }
+  if (uint32_t levels = SapienRendererDefault::getMeshLodLevels()) {
+    generateLods(levels);
+  }
 }
 
 RenderShapeTriangleMesh::RenderShapeTriangleMesh(
@@ -283,6 +309,273 @@ void RenderShapeTriangleMesh::setScale(Vec3 const &scale) {
   mScale = scale;
 }
 
+// simplifying further gives little speedup and visibly wrong silhouettes
+static constexpr uint32_t MinLodTriangles = 64;
+
+// part -> level -> triangle indices
+using LodIndices = std::vector<std::vector<std::vector<uint32_t>>>;
+
+struct LodCacheHeader {
+  char magic[8];
+  uint64_t sourceSize;
+  int64_t sourceTime;
+  float ratio;
+  uint32_t levels;
+  uint32_t partCount;
+  uint32_t pathLength; // followed by the canonical path of the source file
+};
+static constexpr char LodCacheMagic[8] = {'S', 'A', 'P', 'I', 'E', 'N', 'L', '2'};
+
+/** cache file in the LOD cache directory named by the hash of the canonical source path, empty
+ *  when caching is disabled */
+static std::string LodCachePath(std::string const &canonical) {
+  auto dir = SapienRendererDefault::getMeshLodCacheDirectory();
+  if (dir.empty()) {
+    return "";
+  }
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.lod",
+                static_cast<unsigned long long>(std::hash<std::string>{}(canonical)));
+  return (std::filesystem::path(dir) / name).string();
+}
+
+static LodCacheHeader MakeLodCacheHeader(std::string const &canonical, float ratio,
+                                         uint32_t levels, uint32_t partCount) {
+  LodCacheHeader header{};
+  std::copy(std::begin(LodCacheMagic), std::end(LodCacheMagic), header.magic);
+  header.sourceSize = std::filesystem::file_size(canonical);
+  header.sourceTime = std::filesystem::last_write_time(canonical).time_since_epoch().count();
+  header.ratio = ratio;
+  header.levels = levels;
+  header.partCount = partCount;
+  header.pathLength = canonical.length();
+  return header;
+}
+
+/** cached indices if the cache matches the source file, ratio, levels and part sizes */
+static std::optional<LodIndices> LoadLodCache(std::string const &canonical, float ratio,
+                                              uint32_t levels,
+                                              std::vector<std::array<uint32_t, 2>> const &sizes) {
+  try {
+    auto path = LodCachePath(canonical);
+    if (path.empty()) {
+      return std::nullopt;
+    }
+    std::ifstream f(path, std::ios::binary);
+    if (!f) {
+      return std::nullopt;
+    }
+    LodCacheHeader expected = MakeLodCacheHeader(canonical, ratio, levels, sizes.size());
+    LodCacheHeader header;
+    std::string source(canonical.length(), '\0');
+    if (!f.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(&header, &expected, sizeof(header)) != 0 ||
+        !f.read(source.data(), source.length()) || source != canonical) {
+      return std::nullopt;
+    }
+
+    LodIndices lods(sizes.size());
+    for (uint32_t p = 0; p < sizes.size(); ++p) {
+      uint32_t partHeader[3];
+      if (!f.read(reinterpret_cast<char *>(partHeader), sizeof(partHeader)) ||
+          partHeader[0] != sizes[p][0] || partHeader[1] != sizes[p][1] ||
+          partHeader[2] > levels) {
+        return std::nullopt;
+      }
+      for (uint32_t l = 0; l < partHeader[2]; ++l) {
+        uint32_t count;
+        if (!f.read(reinterpret_cast<char *>(&count), sizeof(count)) ||
+            count > 3 * sizes[p][1] || count % 3 != 0) {
+          return std::nullopt;
+        }
+        std::vector<uint32_t> indices(count);
+        if (!f.read(reinterpret_cast<char *>(indices.data()), count * sizeof(uint32_t))) {
+          return std::nullopt;
+        }
+        for (auto i : indices) {
+          if (i >= sizes[p][0]) {
+            return std::nullopt;
+          }
+        }
+        lods[p].push_back(std::move(indices));
+      }
+    }
+    return lods;
+  } catch (std::exception const &) {
+    return std::nullopt;
+  }
+}
+
+static void SaveLodCache(std::string const &canonical, float ratio, uint32_t levels,
+                         std::vector<std::array<uint32_t, 2>> const &sizes,
+                         LodIndices const &lods) {
+  auto path = LodCachePath(canonical);
+  if (path.empty()) {
+    return;
+  }
+  // unique per thread so concurrent loads of the same file do not share a temporary file
+  auto tmp =
+      path + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+      ".tmp";
+  try {
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+    {
+      std::ofstream f(tmp, std::ios::binary);
+      LodCacheHeader header = MakeLodCacheHeader(canonical, ratio, levels, sizes.size());
+      f.write(reinterpret_cast<char const *>(&header), sizeof(header));
+      f.write(canonical.data(), canonical.length());
+      for (uint32_t p = 0; p < sizes.size(); ++p) {
+        uint32_t partHeader[3] = {sizes[p][0], sizes[p][1], static_cast<uint32_t>(lods[p].size())};
+        f.write(reinterpret_cast<char const *>(partHeader), sizeof(partHeader));
+        for (auto &indices : lods[p]) {
+          uint32_t count = indices.size();
+          f.write(reinterpret_cast<char const *>(&count), sizeof(count));
+          f.write(reinterpret_cast<char const *>(indices.data()), count * sizeof(uint32_t));
+        }
+      }
+      if (!f) {
+        throw std::runtime_error("write failed");
+      }
+    }
+    // readers never see a partially written cache
+    std::filesystem::rename(tmp, path);
+  } catch (std::exception const &e) {
+    // an unwritable cache directory would otherwise warn for every mesh
+    static std::atomic<bool> warned{false};
+    if (!warned.exchange(true)) {
+      logger::warn("failed to write LOD cache {}: {}", path, e.what());
+    }
+    std::error_code ec;
+    std::filesystem::remove(tmp, ec);
+  }
+}
+
+/** mesh made of the vertices used by indices, with all per-vertex attributes of mesh */
+static std::shared_ptr<svulkan2::resource::SVMesh>
+CreateLodMesh(svulkan2::resource::SVMesh &mesh, std::vector<uint32_t> const &indices) {
+  auto position = mesh.getVertexAttribute("position");
+  uint32_t vertexCount = position.size() / 3;
+
+  std::vector<uint32_t> remap(vertexCount, ~0u);
+  std::vector<uint32_t> used;
+  std::vector<uint32_t> newIndices;
+  newIndices.reserve(indices.size());
+  for (auto i : indices) {
+    if (remap[i] == ~0u) {
+      remap[i] = used.size();
+      used.push_back(i);
+    }
+    newIndices.push_back(remap[i]);
+  }
+
+  auto gather = [&](std::vector<float> const &attribute) {
+    uint32_t dim = attribute.size() / vertexCount;
+    std::vector<float> result;
+    result.reserve(used.size() * dim);
+    for (auto i : used) {
+      result.insert(result.end(), attribute.begin() + i * dim, attribute.begin() + (i + 1) * dim);
+    }
+    return result;
+  };
+
+  auto lodMesh = svulkan2::resource::SVMesh::Create(gather(position), newIndices);
+  for (auto name : {"normal", "uv", "tangent", "bitangent", "color"}) {
+    std::vector<float> attribute;
+    try {
+      attribute = mesh.getVertexAttribute(name);
+    } catch (std::exception const &) {
+      continue;
+    }
+    if (!attribute.empty() && attribute.size() % vertexCount == 0) {
+      lodMesh->setVertexAttribute(name, gather(attribute));
+    }
+  }
+  return lodMesh;
+}
+
+void RenderShapeTriangleMesh::generateLods(uint32_t levels, float ratio) {
+  if (mParent) {
+    throw std::runtime_error(
+        "failed to generate LODs: only allowed when not attached to component");
+  }
+  if (!(ratio > 0.f && ratio < 1.f)) {
+    throw std::runtime_error("failed to generate LODs: ratio must be between 0 and 1");
+  }
+  mLodModels.clear();
+  mLodRatio = ratio;
+  if (levels == 0) {
+    return;
+  }
+
+  mModel->loadAsync().get();
+  auto shapes = mModel->getShapes();
+  std::vector<std::array<uint32_t, 2>> sizes;
+  for (auto &shape : shapes) {
+    sizes.push_back({shape->mesh->getVertexCount(), shape->mesh->getTriangleCount()});
+  }
+
+  std::string canonical;
+  if (!mFilename.empty()) {
+    std::error_code ec;
+    canonical = std::filesystem::canonical(mFilename, ec).string();
+  }
+  std::optional<LodIndices> cached;
+  if (!canonical.empty()) {
+    cached = LoadLodCache(canonical, ratio, levels, sizes);
+  }
+  LodIndices lods;
+  if (cached) {
+    lods = std::move(*cached);
+  } else {
+    lods.resize(shapes.size());
+    for (uint32_t p = 0; p < shapes.size(); ++p) {
+      auto position = shapes[p]->mesh->getVertexAttribute("position");
+      std::vector<uint32_t> indices = shapes[p]->mesh->getIndices();
+      for (uint32_t l = 0; l < levels; ++l) {
+        uint32_t count = indices.size() / 3;
+        uint32_t target = count * ratio;
+        if (target < MinLodTriangles) {
+          break;
+        }
+        auto simplified =
+            simplifyMesh(position.data(), sizes[p][0], indices.data(), count, target);
+        // stop when boundaries and feature edges prevent meaningful simplification
+        if (simplified.size() / 3 > count * (1.f + ratio) / 2.f) {
+          break;
+        }
+        indices = simplified;
+        lods[p].push_back(std::move(simplified));
+      }
+    }
+    if (!canonical.empty()) {
+      SaveLodCache(canonical, ratio, levels, sizes, lods);
+    }
+  }
+
+  // parts that cannot be simplified further keep their last level
+  uint32_t levelCount = 0;
+  for (auto &part : lods) {
+    levelCount = std::max<uint32_t>(levelCount, part.size());
+  }
+  std::vector<std::vector<std::shared_ptr<svulkan2::resource::SVShape>>> partShapes(
+      shapes.size());
+  for (uint32_t p = 0; p < shapes.size(); ++p) {
+    for (auto &indices : lods[p]) {
+      partShapes[p].push_back(svulkan2::resource::SVShape::Create(
+          CreateLodMesh(*shapes[p]->mesh, indices), shapes[p]->material));
+    }
+  }
+  for (uint32_t l = 0; l < levelCount; ++l) {
+    std::vector<std::shared_ptr<svulkan2::resource::SVShape>> levelShapes;
+    for (uint32_t p = 0; p < shapes.size(); ++p) {
+      levelShapes.push_back(partShapes[p].empty()
+                                ? shapes[p]
+                                : partShapes[p][std::min<size_t>(l, partShapes[p].size() - 1)]);
+    }
+    mLodModels.push_back(svulkan2::resource::SVModel::FromData(levelShapes));
+  }
+}
+
 std::vector<std::shared_ptr<RenderShapeTriangleMeshPart>> RenderShapeTriangleMesh::getParts() {
   std::vector<std::shared_ptr<RenderShapeTriangleMeshPart>> parts;
   for (auto shape : mModel->getShapes()) {
@@ -428,6 +721,8 @@ std::shared_ptr<RenderShape> RenderShapeTriangleMesh::clone() const {
   newShape->mScale = mScale;
   newShape->mFilename = mFilename;
   newShape->mMaterial = mMaterial;
+  newShape->mLodModels = mLodModels;
+  newShape->mLodRatio = mLodRatio;
 
   newShape->setFrontFace(getFrontFace());
   newShape->setName(getName());
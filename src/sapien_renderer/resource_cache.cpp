@@ -0,0 +1,681 @@
+#include "sapien/sapien_renderer/resource_cache.h"
+#include "../logger.h"
+#include "sapien/sapien_renderer/sapien_renderer_system.h"
+#include "sapien/utils/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace sapien {
+namespace sapien_renderer {
+
+// vertex layout of the default shaders: position, normal, uv, tangent and bitangent
+static constexpr uint64_t EstimatedVertexBytes = 14 * sizeof(float);
+
+static uint64_t Mix(uint64_t h, uint64_t v) {
+  h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  return h;
+}
+
+static uint64_t HashBytes(void const *data, size_t size, uint64_t h) {
+  auto bytes = static_cast<char const *>(data);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t v;
+    std::memcpy(&v, bytes + i, 8);
+    h = Mix(h, v);
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, bytes + i, size - i);
+  return Mix(h, tail ^ size);
+}
+
+template <typename T> static uint64_t HashVector(std::vector<T> const &v, uint64_t h) {
+  return HashBytes(v.data(), v.size() * sizeof(T), h);
+}
+
+static std::string ToHex(uint64_t v) {
+  char buffer[17];
+  std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(v));
+  return buffer;
+}
+
+uint64_t RenderResourceCache::hashFile(std::string const &filename) {
+  uint64_t size = std::filesystem::file_size(filename);
+  auto time = std::filesystem::last_write_time(filename);
+  {
+    std::lock_guard lock(mMutex);
+    auto it = mFileHashes.find(filename);
+    if (it != mFileHashes.end() && it->second.size == size && it->second.time == time) {
+      return it->second.hash;
+    }
+  }
+
+  // files are read without holding the lock so prefetch threads hash in parallel
+
+  std::ifstream f(filename, std::ios::binary);
+  if (!f) {
+    throw std::runtime_error("failed to read file: " + filename);
+  }
+  std::vector<char> buffer(1 << 20);
+  uint64_t hash = 0;
+  while (f) {
+    f.read(buffer.data(), buffer.size());
+    hash = HashBytes(buffer.data(), f.gcount(), hash);
+  }
+  std::lock_guard lock(mMutex);
+  mFileHashes[filename] = {size, time, hash};
+  return hash;
+}
+
+static bool SameContents(std::string const &a, std::string const &b) {
+  if (std::filesystem::file_size(a) != std::filesystem::file_size(b)) {
+    return false;
+  }
+  std::ifstream fa(a, std::ios::binary);
+  std::ifstream fb(b, std::ios::binary);
+  std::vector<char> ba(1 << 20);
+  std::vector<char> bb(1 << 20);
+  while (fa && fb) {
+    fa.read(ba.data(), ba.size());
+    fb.read(bb.data(), bb.size());
+    if (fa.gcount() != fb.gcount() || std::memcmp(ba.data(), bb.data(), fa.gcount()) != 0) {
+      return false;
+    }
+  }
+  return !fa && !fb;
+}
+
+static std::string Lowercase(std::string s) {
+  std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+  return s;
+}
+
+static std::string Extension(std::string const &filename) {
+  return Lowercase(std::filesystem::path(filename).extension().string());
+}
+
+// material libraries of an OBJ file
+static std::vector<std::string> ObjMaterialLibraries(std::string const &filename) {
+  std::vector<std::string> result;
+  std::ifstream f(filename);
+  std::string line;
+  while (std::getline(f, line)) {
+    std::istringstream ss(line);
+    std::string keyword, name;
+    if (ss >> keyword && keyword == "mtllib") {
+      while (ss >> name) {
+        result.push_back(name);
+      }
+    }
+  }
+  return result;
+}
+
+// texture maps of an MTL file, the file name is the last token after any options
+static std::vector<std::string> MtlTextures(std::string const &filename) {
+  std::vector<std::string> result;
+  std::ifstream f(filename);
+  std::string line;
+  while (std::getline(f, line)) {
+    std::istringstream ss(line);
+    std::string keyword, token, name;
+    if (!(ss >> keyword)) {
+      continue;
+    }
+    keyword = Lowercase(keyword);
+    if (!keyword.starts_with("map_") && keyword != "bump" && keyword != "disp" &&
+        keyword != "decal" && keyword != "refl" && keyword != "norm") {
+      continue;
+    }
+    while (ss >> token) {
+      name = token;
+    }
+    if (!name.empty()) {
+      result.push_back(name);
+    }
+  }
+  return result;
+}
+
+// external buffer and image uris of a glTF file, the JSON chunk of GLB files is plain text
+static std::vector<std::string> GltfUris(std::string const &filename) {
+  std::ifstream f(filename, std::ios::binary);
+  std::string text{std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+  std::vector<std::string> result;
+  for (size_t pos = text.find("\"uri\""); pos != std::string::npos;
+       pos = text.find("\"uri\"", pos + 1)) {
+    size_t begin = text.find_first_not_of(" \t\r\n:", pos + 5);
+    if (begin == std::string::npos || text[begin] != '"') {
+      continue;
+    }
+    size_t end = text.find('"', begin + 1);
+    if (end == std::string::npos) {
+      break;
+    }
+    std::string uri = text.substr(begin + 1, end - begin - 1);
+    if (uri.starts_with("data:")) {
+      continue;
+    }
+    std::string decoded;
+    for (size_t i = 0; i < uri.size(); ++i) {
+      if (uri[i] == '%' && i + 2 < uri.size()) {
+        decoded += static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16));
+        i += 2;
+      } else {
+        decoded += uri[i];
+      }
+    }
+    result.push_back(decoded);
+  }
+  return result;
+}
+
+std::vector<RenderResourceCache::Source>
+RenderResourceCache::getModelSources(std::string const &filename, bool &complete) {
+  auto directory = std::filesystem::path(filename).parent_path();
+  std::vector<Source> sources{{"", filename}};
+  auto add = [&](std::string const &reference) {
+    sources.push_back({reference, (directory / reference).lexically_normal().string()});
+  };
+
+  auto extension = Extension(filename);
+  complete = true;
+  if (extension == ".obj") {
+    for (auto &library : ObjMaterialLibraries(filename)) {
+      add(library);
+      // textures are resolved relative to the model like the material libraries
+      if (std::filesystem::is_regular_file(sources.back().path)) {
+        for (auto &texture : MtlTextures(sources.back().path)) {
+          add(texture);
+        }
+      }
+    }
+  } else if (extension == ".gltf" || extension == ".glb") {
+    for (auto &uri : GltfUris(filename)) {
+      add(uri);
+    }
+  } else if (extension != ".stl" && extension != ".ply") {
+    complete = false;
+  }
+  return sources;
+}
+
+uint64_t RenderResourceCache::hashSources(std::vector<Source> const &sources) {
+  uint64_t hash = 0;
+  for (auto &source : sources) {
+    hash = HashBytes(source.reference.data(), source.reference.size(), hash);
+    // missing files are part of the key by reference only
+    hash = Mix(hash, std::filesystem::is_regular_file(source.path) ? hashFile(source.path) : 0);
+  }
+  return hash;
+}
+
+bool RenderResourceCache::matches(Entry &entry, std::vector<Source> const &sources) {
+  std::string const &filename = sources.at(0).path;
+  if (entry.verified.contains(filename)) {
+    return true;
+  }
+  if (entry.sources.size() != sources.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < sources.size(); ++i) {
+    auto &a = entry.sources[i];
+    auto &b = sources[i];
+    if (a.reference != b.reference) {
+      return false;
+    }
+    if (a.path == b.path) {
+      continue;
+    }
+    bool existsA = std::filesystem::is_regular_file(a.path);
+    bool existsB = std::filesystem::is_regular_file(b.path);
+    if (existsA != existsB || (existsA && !SameContents(a.path, b.path))) {
+      return false;
+    }
+  }
+  entry.verified.insert(filename);
+  return true;
+}
+
+static std::shared_future<void> ReadyFuture() {
+  std::promise<void> promise;
+  promise.set_value();
+  return promise.get_future().share();
+}
+
+static bool IsKtx2(std::string const &filename) { return Extension(filename) == ".ktx2"; }
+
+/** bytes of a width x height image in a block compressed format (BCn, ETC2, EAC or ASTC), 0 for
+ *  other formats */
+static uint64_t BlockCompressedSize(uint32_t format, uint32_t width, uint32_t height) {
+  uint32_t blockWidth = 4;
+  uint32_t blockHeight = 4;
+  uint32_t blockBytes;
+  if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC1_RGBA_SRGB_BLOCK) {
+    blockBytes = 8;
+  } else if (format >= VK_FORMAT_BC4_UNORM_BLOCK && format <= VK_FORMAT_BC4_SNORM_BLOCK) {
+    blockBytes = 8;
+  } else if (format >= VK_FORMAT_BC2_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK) {
+    blockBytes = 16;
+  } else if (format >= VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK &&
+             format <= VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK) {
+    blockBytes = 8;
+  } else if (format >= VK_FORMAT_EAC_R11_UNORM_BLOCK && format <= VK_FORMAT_EAC_R11_SNORM_BLOCK) {
+    blockBytes = 8;
+  } else if (format >= VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK &&
+             format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK) {
+    blockBytes = 16;
+  } else if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK &&
+             format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK) {
+    // unorm and srgb variants of 4x4, 5x4, 5x5, 6x5, 6x6, 8x5, 8x6, 8x8, 10x5, 10x6, 10x8,
+    // 10x10, 12x10 and 12x12 blocks
+    static constexpr uint32_t Blocks[][2] = {{4, 4},  {5, 4},  {5, 5},   {6, 5},   {6, 6},
+                                             {8, 5},  {8, 6},  {8, 8},   {10, 5},  {10, 6},
+                                             {10, 8}, {10, 10}, {12, 10}, {12, 12}};
+    auto block = Blocks[(format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2];
+    blockWidth = block[0];
+    blockHeight = block[1];
+    blockBytes = 16;
+  } else {
+    return 0;
+  }
+  return static_cast<uint64_t>((width + blockWidth - 1) / blockWidth) *
+         ((height + blockHeight - 1) / blockHeight) * blockBytes;
+}
+
+/** Texture from a KTX2 file whose data is stored in its Vulkan format without
+ *  supercompression, e.g. BCn textures baked offline. Block compressed data is uploaded as is,
+ *  so only the base level is used and no mipmaps are generated. */
+static std::shared_ptr<svulkan2::resource::SVTexture>
+LoadKtx2(std::string const &filename, uint32_t mipLevels, vk::Filter filter,
+         vk::SamplerAddressMode addressMode, bool srgb) {
+  struct Header {
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+  };
+  struct Level {
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+  };
+  static constexpr uint8_t Identifier[12] = {0xab, 'K', 'T', 'X', ' ', '2',
+                                             '0', 0xbb, '\r', '\n', 0x1a, '\n'};
+
+  std::ifstream f(filename, std::ios::binary);
+  Header header;
+  Level level;
+  if (!f.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(header.identifier, Identifier, sizeof(Identifier)) != 0 ||
+      !f.read(reinterpret_cast<char *>(&level), sizeof(level))) {
+    throw std::runtime_error("failed to load KTX2 texture " + filename + ": invalid file");
+  }
+  if (header.supercompressionScheme != 0 || header.vkFormat == 0) {
+    throw std::runtime_error("failed to load KTX2 texture " + filename +
+                             ": supercompressed and Basis Universal files are not supported");
+  }
+  if (header.depth > 1 || header.layerCount > 1 || header.faceCount != 1) {
+    throw std::runtime_error("failed to load KTX2 texture " + filename +
+                             ": only single 2D images are supported");
+  }
+
+  auto format = static_cast<vk::Format>(header.vkFormat);
+  uint64_t compressedSize = BlockCompressedSize(header.vkFormat, header.width, header.height);
+  uint64_t size = compressedSize ? compressedSize
+                                 : static_cast<uint64_t>(header.width) * header.height *
+                                       svulkan2::getFormatSize(format);
+  if (level.byteLength != size) {
+    throw std::runtime_error("failed to load KTX2 texture " + filename + ": level size " +
+                             std::to_string(level.byteLength) + " does not match " +
+                             std::to_string(size) + " bytes of the image");
+  }
+
+  std::vector<char> data(level.byteLength);
+  f.seekg(level.byteOffset);
+  if (!f.read(data.data(), data.size())) {
+    throw std::runtime_error("failed to load KTX2 texture " + filename + ": truncated file");
+  }
+
+  // mipmaps are generated by blits, which block compressed formats do not support
+  bool compressed = compressedSize != 0;
+  return svulkan2::resource::SVTexture::FromRawData(
+      header.width, header.height, 1, format, data, 2, compressed ? 1 : mipLevels, filter,
+      filter, addressMode, addressMode, addressMode, srgb);
+}
+
+RenderResourceCache::Entry *RenderResourceCache::find(std::string const &key) {
+  auto it = mEntries.find(key);
+  if (it == mEntries.end()) {
+    mMisses++;
+    return nullptr;
+  }
+  mHits++;
+  mLru.splice(mLru.begin(), mLru, it->second.lru);
+  return &it->second;
+}
+
+void RenderResourceCache::insert(std::string const &key, Entry entry) {
+  mLru.push_front(key);
+  entry.lru = mLru.begin();
+  mEntries[key] = std::move(entry);
+  if (mBudget) {
+    evict(mBudget);
+  }
+}
+
+std::shared_ptr<svulkan2::resource::SVModel>
+RenderResourceCache::getModel(std::string const &filename) {
+  bool complete;
+  auto sources = getModelSources(filename, complete);
+  std::string key = "model:" + ToHex(hashSources(sources));
+  if (!complete) {
+    key += ":" + std::filesystem::weakly_canonical(filename).string();
+  }
+
+  std::lock_guard lock(mMutex);
+  if (auto entry = find(key)) {
+    if (matches(*entry, sources)) {
+      return entry->model;
+    }
+    logger::warn("resource cache hash collision for {}, loading it without caching", filename);
+    auto model = svulkan2::resource::SVModel::FromFile(filename);
+    model->loadAsync();
+    return model;
+  }
+  auto model = svulkan2::resource::SVModel::FromFile(filename);
+  insert(key, Entry{.type = Type::eModel,
+                    .model = model,
+                    .loaded = model->loadAsync().share(),
+                    .sources = sources});
+  return model;
+}
+
+std::shared_ptr<svulkan2::resource::SVTexture>
+RenderResourceCache::getTexture(std::string const &filename, uint32_t mipLevels,
+                                vk::Filter filter, vk::SamplerAddressMode addressMode,
+                                bool srgb) {
+  return loadTexture(filename, mipLevels, filter, addressMode, srgb, false).first;
+}
+
+std::pair<std::shared_ptr<svulkan2::resource::SVTexture>, std::shared_future<void>>
+RenderResourceCache::loadTexture(std::string const &filename, uint32_t mipLevels,
+                                 vk::Filter filter, vk::SamplerAddressMode addressMode, bool srgb,
+                                 bool pin) {
+  std::vector<Source> sources{{"", filename}};
+  std::string key = "texture:" + ToHex(hashFile(filename)) + ":" + std::to_string(mipLevels) +
+                    ":" + std::to_string(static_cast<int>(filter)) + ":" +
+                    std::to_string(static_cast<int>(addressMode)) + ":" + std::to_string(srgb);
+  bool collision = false;
+  {
+    std::lock_guard lock(mMutex);
+    if (auto entry = find(key)) {
+      if (matches(*entry, sources)) {
+        // a prefetched texture is released to the budget once it is requested
+        entry->pinned = pin;
+        return {entry->texture, entry->loaded};
+      }
+      logger::warn("resource cache hash collision for {}, loading it without caching", filename);
+      collision = true;
+    }
+  }
+
+  std::shared_ptr<svulkan2::resource::SVTexture> texture;
+  std::shared_future<void> loaded;
+  uint64_t bytes = 0;
+  if (IsKtx2(filename)) {
+    texture = LoadKtx2(filename, mipLevels, filter, addressMode, srgb);
+    loaded = ReadyFuture();
+    // texel sizes of compressed formats are not known to the estimate in updateBytes
+    bytes = std::filesystem::file_size(filename);
+  } else {
+    texture = svulkan2::resource::SVTexture::FromFile(filename, mipLevels, filter, filter,
+                                                      addressMode, addressMode, srgb);
+    loaded = texture->loadAsync().share();
+  }
+
+  if (collision) {
+    return {texture, loaded};
+  }
+  std::lock_guard lock(mMutex);
+  // another thread may have loaded the same texture meanwhile
+  auto it = mEntries.find(key);
+  if (it != mEntries.end()) {
+    if (matches(it->second, sources)) {
+      it->second.pinned = pin;
+      return {it->second.texture, it->second.loaded};
+    }
+    return {texture, loaded};
+  }
+  insert(key, Entry{.type = Type::eTexture,
+                    .texture = texture,
+                    .loaded = loaded,
+                    .bytes = bytes,
+                    .pinned = pin,
+                    .sources = sources});
+  return {texture, loaded};
+}
+
+void RenderResourceCache::prefetchTextures(std::vector<std::string> const &filenames,
+                                           uint32_t mipLevels, vk::Filter filter,
+                                           vk::SamplerAddressMode addressMode, bool srgb,
+                                           uint32_t threadCount) {
+  threadCount = threadCount ? threadCount : std::thread::hardware_concurrency();
+  threadCount = std::clamp<size_t>(threadCount, 1, std::max<size_t>(filenames.size(), 1));
+
+  // each worker keeps one decode in flight, which bounds decoding to threadCount images
+  std::vector<std::shared_ptr<svulkan2::resource::SVTexture>> textures(filenames.size());
+  std::atomic<size_t> next{0};
+  ThreadPool::Get().parallelFor(threadCount, threadCount, [&](uint32_t) {
+    for (size_t i = next++; i < filenames.size(); i = next++) {
+      auto [texture, loaded] =
+          loadTexture(filenames[i], mipLevels, filter, addressMode, srgb, true);
+      loaded.get();
+      textures[i] = texture;
+    }
+  });
+
+  // Uploads are issued from the calling thread after all decodes finished. Each texture is
+  // uploaded and mipmapped by its own submission, svulkan2 textures do not record uploads into
+  // a shared command buffer.
+  for (auto &texture : textures) {
+    texture->uploadToDevice();
+  }
+}
+
+static char const *MeshAttributes[] = {"position", "normal",    "uv",
+                                       "tangent",  "bitangent", "color"};
+
+static std::vector<float> GetAttribute(svulkan2::resource::SVMesh &mesh, char const *name) {
+  try {
+    return mesh.getVertexAttribute(name);
+  } catch (std::exception const &) {
+    return {};
+  }
+}
+
+static bool SameMeshData(svulkan2::resource::SVMesh &a, svulkan2::resource::SVMesh &b) {
+  if (a.getIndices() != b.getIndices()) {
+    return false;
+  }
+  for (auto name : MeshAttributes) {
+    if (GetAttribute(a, name) != GetAttribute(b, name)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<svulkan2::resource::SVMesh>
+RenderResourceCache::deduplicateMesh(std::shared_ptr<svulkan2::resource::SVMesh> mesh) {
+  uint64_t hash = HashVector(mesh->getIndices(), 0);
+  for (auto name : MeshAttributes) {
+    auto attribute = GetAttribute(*mesh, name);
+    hash = attribute.empty() ? Mix(hash, 0) : HashVector(attribute, hash);
+  }
+
+  std::lock_guard lock(mMutex);
+  std::string key = "mesh:" + ToHex(hash);
+  if (auto entry = find(key)) {
+    // meshes are in memory, so compare them on every hit
+    return SameMeshData(*entry->mesh, *mesh) ? entry->mesh : mesh;
+  }
+  insert(key, Entry{.type = Type::eMesh, .mesh = mesh, .loaded = ReadyFuture()});
+  return mesh;
+}
+
+static bool IsReady(std::shared_future<void> const &f) {
+  return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+static uint64_t MeshBytes(svulkan2::resource::SVMesh &mesh) {
+  return mesh.getVertexCount() * EstimatedVertexBytes +
+         mesh.getTriangleCount() * 3 * sizeof(uint32_t);
+}
+
+void RenderResourceCache::updateBytes(Entry &entry) {
+  if (entry.bytes || !IsReady(entry.loaded)) {
+    return;
+  }
+  switch (entry.type) {
+  case Type::eModel:
+    for (auto &shape : entry.model->getShapes()) {
+      entry.bytes += MeshBytes(*shape->mesh);
+    }
+    break;
+  case Type::eTexture: {
+    auto image = entry.texture->getImage();
+    uint64_t bytes = static_cast<uint64_t>(image->getWidth()) * image->getHeight() *
+                     svulkan2::getFormatSize(image->getFormat());
+    // a full mip chain adds a third
+    entry.bytes = entry.texture->getDescription().mipLevels == 1 ? bytes : bytes * 4 / 3;
+    break;
+  }
+  case Type::eMesh:
+    entry.bytes = MeshBytes(*entry.mesh);
+    break;
+  }
+}
+
+bool RenderResourceCache::isUsed(Entry const &entry) const {
+  // loader threads may still hold the resource
+  if (entry.pinned || !IsReady(entry.loaded)) {
+    return true;
+  }
+  switch (entry.type) {
+  case Type::eModel:
+    if (entry.model.use_count() > 1) {
+      return true;
+    }
+    // shapes with overridden materials keep the meshes of the model
+    for (auto &shape : entry.model->getShapes()) {
+      if (shape->mesh.use_count() > 1) {
+        return true;
+      }
+    }
+    return false;
+  case Type::eTexture:
+    return entry.texture.use_count() > 1;
+  case Type::eMesh:
+    return entry.mesh.use_count() > 1;
+  }
+  return true;
+}
+
+void RenderResourceCache::evict(uint64_t budget) {
+  uint64_t bytes = 0;
+  for (auto &[key, entry] : mEntries) {
+    updateBytes(entry);
+    bytes += entry.bytes;
+  }
+  // a budget of 0 evicts every unused entry
+  for (auto it = mLru.end(); it != mLru.begin() && (budget == 0 || bytes > budget);) {
+    --it;
+    auto entry = mEntries.find(*it);
+    if (isUsed(entry->second)) {
+      continue;
+    }
+    bytes -= entry->second.bytes;
+    mEntries.erase(entry);
+    it = mLru.erase(it);
+    mEvictions++;
+  }
+}
+
+void RenderResourceCache::setMemoryBudget(uint64_t bytes) {
+  std::lock_guard lock(mMutex);
+  mBudget = bytes;
+  if (mBudget) {
+    evict(mBudget);
+  }
+}
+
+void RenderResourceCache::trim() {
+  std::lock_guard lock(mMutex);
+  if (mBudget) {
+    evict(mBudget);
+  }
+}
+
+void RenderResourceCache::clearUnused() {
+  std::lock_guard lock(mMutex);
+  // pending loads would otherwise count as used
+  for (auto &[key, entry] : mEntries) {
+    entry.loaded.wait();
+    entry.pinned = false;
+  }
+  evict(0);
+}
+
+RenderResourceCacheStats RenderResourceCache::getStats() {
+  std::lock_guard lock(mMutex);
+  RenderResourceCacheStats stats{};
+  for (auto &[key, entry] : mEntries) {
+    updateBytes(entry);
+    stats.bytes += entry.bytes;
+    if (!isUsed(entry)) {
+      stats.unusedCount++;
+      stats.unusedBytes += entry.bytes;
+    }
+    switch (entry.type) {
+    case Type::eModel:
+      stats.modelCount++;
+      break;
+    case Type::eTexture:
+      stats.textureCount++;
+      break;
+    case Type::eMesh:
+      stats.meshCount++;
+      break;
+    }
+  }
+  stats.budget = mBudget;
+  stats.hits = mHits;
+  stats.misses = mMisses;
+  stats.evictions = mEvictions;
+  return stats;
+}
+
+} // namespace sapien_renderer
+} // namespace sapien
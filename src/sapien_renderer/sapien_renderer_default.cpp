@@ -61,6 +61,10 @@ void SapienRendererDefault::setRayTracingDoFPlane(float depth) {
   Get().rayTracingDoFPlane = depth;
 }
 void SapienRendererDefault::setMSAA(int msaa) { Get().msaa = msaa; }
+void SapienRendererDefault::setMeshLodLevels(uint32_t levels) { Get().meshLodLevels = levels; }
+void SapienRendererDefault::setMeshLodCacheDirectory(std::string const &dir) {
+  Get().meshLodCacheDirectory = dir;
+}
 
 void SapienRendererDefault::setRenderTargetFormat(std::string const &name, vk::Format format) {
   Get().renderTargetFormats[name] = format;
@@ -82,6 +86,10 @@ svulkan2::renderer::RTRenderer::DenoiserType SapienRendererDefault::getRayTracin
 float SapienRendererDefault::getRayTracingDoFAperture() { return Get().rayTracingDoFAperture; }
 float SapienRendererDefault::getRayTracingDoFPlane() { return Get().rayTracingDoFPlane; }
 int SapienRendererDefault::getMSAA() { return Get().msaa; }
+uint32_t SapienRendererDefault::getMeshLodLevels() { return Get().meshLodLevels; }
+std::string SapienRendererDefault::getMeshLodCacheDirectory() {
+  return Get().meshLodCacheDirectory;
+}
 
 SapienRendererDefault &SapienRendererDefault::Get() {
   static SapienRendererDefault gSapienRendererDefault;
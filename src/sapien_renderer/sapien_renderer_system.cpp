@@ -5,12 +5,19 @@
 #include "sapien/sapien_renderer/light_component.h"
 #include "sapien/sapien_renderer/point_cloud_component.h"
 #include "sapien/sapien_renderer/render_body_component.h"
+#include "sapien/sapien_renderer/render_shape.h"
+#include "sapien/sapien_renderer/resource_cache.h"
 #include "sapien/sapien_renderer/sapien_renderer_default.h"
+#include "sapien/profiler.h"
+#include "sapien/utils/thread_pool.h"
+#include "sapien/math/aabb_tree.h"
+#include <algorithm>
 #include <svulkan2/core/context.h>
 #include <svulkan2/core/physical_device.h>
 #include <svulkan2/renderer/renderer.h>
 #include <svulkan2/renderer/rt_renderer.h>
 #include <svulkan2/scene/scene.h>
+#include <thread>
 
 #include "sapien/utils/cuda.h"
 #include <cuda_runtime.h>
@@ -72,6 +79,7 @@ SapienRenderEngine::SapienRenderEngine(std::shared_ptr<Device> device) {
                                              d.getDefaultMipMaps(), d.getDoNotLoadTexture(),
                                              device->getAlias(), d.getVREnabled());
   mResourceManager = mContext->createResourceManager();
+  mResourceCache = std::make_shared<RenderResourceCache>();
 }
 
 std::shared_ptr<svulkan2::resource::SVMesh> SapienRenderEngine::getSphereMesh() {
@@ -121,6 +129,12 @@ std::shared_ptr<SapienRenderCubemap> SapienRendererSystem::getCubemap() const {
 
 void SapienRendererSystem::registerComponent(std::shared_ptr<SapienRenderBodyComponent> c) {
   mRenderBodyComponents.insert(c);
+  mCullingItemsDirty = true;
+  if (c->getStatic()) {
+    c->internalUpdate();
+  } else {
+    mMovableRenderBodyComponents.insert(c);
+  }
 }
 
 void SapienRendererSystem::registerComponent(std::shared_ptr<SapienRenderCameraComponent> c) {
@@ -141,6 +155,8 @@ void SapienRendererSystem::registerComponent(std::shared_ptr<CudaDeformableMeshC
 
 void SapienRendererSystem::unregisterComponent(std::shared_ptr<SapienRenderBodyComponent> c) {
   mRenderBodyComponents.erase(c);
+  mMovableRenderBodyComponents.erase(c);
+  mCullingItemsDirty = true;
 }
 
 void SapienRendererSystem::unregisterComponent(std::shared_ptr<SapienRenderCameraComponent> c) {
@@ -160,8 +176,12 @@ void SapienRendererSystem::unregisterComponent(std::shared_ptr<CudaDeformableMes
 }
 
 void SapienRendererSystem::step() {
-  for (auto c : mRenderBodyComponents) {
-    c->internalUpdate();
+  SAPIEN_PROFILE_BLOCK(SapienRendererSystem::step);
+
+  SAPIEN_PROFILE_BLOCK_BEGIN(internalUpdate);
+  mUpdatedNodeCount = 0;
+  for (auto &c : mMovableRenderBodyComponents) {
+    mUpdatedNodeCount += c->internalUpdate();
   }
   for (auto c : mRenderCameraComponents) {
     c->internalUpdate();
@@ -169,13 +189,121 @@ void SapienRendererSystem::step() {
   for (auto c : mRenderLightComponents) {
     c->internalUpdate();
   }
-  for (auto c : mPointCloudComponents) {
-    c->internalUpdate();
+  for (auto &c : mPointCloudComponents) {
+    mUpdatedNodeCount += c->internalUpdate();
   }
   for (auto c : mCudaDeformableMeshComponents) {
     c->internalUpdate();
   }
+  SAPIEN_PROFILE_BLOCK_END;
+
+  SAPIEN_PROFILE_BLOCK_BEGIN(updateModelMatrices);
   mScene->updateModelMatrices();
+  SAPIEN_PROFILE_BLOCK_END;
+
+  mCullingItemsDirty = true;
+}
+
+// below this many items per thread, culling is faster on a single thread
+static constexpr size_t CullingItemsPerThread = 4096;
+
+template <typename F> static void ParallelFor(size_t count, uint32_t threadCount, F const &f) {
+  threadCount = threadCount ? threadCount : std::thread::hardware_concurrency();
+  threadCount = std::clamp<size_t>(count / CullingItemsPerThread, 1, std::max(threadCount, 1u));
+  size_t chunk = (count + threadCount - 1) / threadCount;
+  ThreadPool::Get().parallelFor(threadCount, threadCount, [&](uint32_t t) {
+    f(t, std::min(count, t * chunk), std::min(count, (t + 1) * chunk));
+  });
+}
+
+void SapienRendererSystem::updateCullingItems() {
+  SAPIEN_PROFILE_FUNCTION;
+  std::vector<std::shared_ptr<RenderShape>> shapes;
+  for (auto &body : mRenderBodyComponents) {
+    for (auto &shape : body->getRenderShapes()) {
+      if (shape->internalGetRenderObject()) {
+        shapes.push_back(shape);
+      }
+    }
+  }
+  mCullingItems.resize(shapes.size());
+  ParallelFor(shapes.size(), mCullingThreadCount, [&](uint32_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      mCullingItems[i] = {shapes[i].get(), shapes[i]->getGlobalAABBFast()};
+    }
+  });
+  mCullingItemsDirty = false;
+}
+
+std::vector<svulkan2::scene::Object *>
+SapienRendererSystem::cullObjects(std::vector<std::array<float, 4>> const &planes) {
+  SAPIEN_PROFILE_FUNCTION;
+  if (mCullingItemsDirty) {
+    updateCullingItems();
+  }
+
+  std::vector<std::vector<svulkan2::scene::Object *>> culled(
+      std::max(mCullingThreadCount ? mCullingThreadCount : std::thread::hardware_concurrency(),
+               1u));
+  ParallelFor(mCullingItems.size(), mCullingThreadCount,
+              [&](uint32_t thread, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                  if (isAABBOutsidePlanes(mCullingItems[i].box, planes)) {
+                    culled[thread].push_back(mCullingItems[i].shape->internalGetDisplayedObject());
+                  }
+                }
+              });
+
+  std::vector<svulkan2::scene::Object *> result;
+  for (auto &c : culled) {
+    result.insert(result.end(), c.begin(), c.end());
+  }
+  return result;
+}
+
+// objects larger than this on screen are always drawn at full detail
+static constexpr float LodFullDetailPixels = 256.f;
+
+uint32_t SapienRendererSystem::updateLods(Vec3 const &cameraPosition, float focalPixels) {
+  SAPIEN_PROFILE_FUNCTION;
+  if (mCullingItemsDirty) {
+    updateCullingItems();
+  }
+
+  uint32_t count = 0;
+  for (auto &item : mCullingItems) {
+    auto &lods = item.shape->internalGetLodObjects();
+    if (lods.empty()) {
+      continue;
+    }
+    Vec3 center = (item.box.lower + item.box.upper) * 0.5f;
+    float radius = (item.box.upper - item.box.lower).length() * 0.5f;
+    float distance = (center - cameraPosition).length();
+    uint32_t l = 0;
+    if (distance > radius) {
+      float pixels = 2.f * radius * focalPixels / distance;
+      float level = 2.f * std::log2(LodFullDetailPixels / pixels) /
+                        std::log2(1.f / item.shape->getLodRatio()) +
+                    mLodBias;
+      if (level >= 1.f) {
+        l = std::min<uint32_t>(static_cast<uint32_t>(level), lods.size());
+      }
+    }
+    item.shape->internalSetLodLevel(l);
+    if (l && item.shape->internalGetDisplayedObject()->getTransparency() < 1.f) {
+      count++;
+    }
+  }
+  return count;
+}
+
+void SapienRendererSystem::resetLods() {
+  if (mCullingItemsDirty) {
+    updateCullingItems();
+  }
+  for (auto &item : mCullingItems) {
+    item.shape->internalSetLodLevel(0);
+  }
 }
 
 CudaArrayHandle SapienRendererSystem::getTransformCudaArray() {
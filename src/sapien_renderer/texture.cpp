@@ -1,4 +1,5 @@
 #include "sapien/sapien_renderer/texture.h"
+#include "sapien/sapien_renderer/resource_cache.h"
 #include "sapien/sapien_renderer/sapien_renderer_system.h"
 
 namespace sapien {
@@ -188,11 +189,19 @@ SapienRenderTexture2D::SapienRenderTexture2D(std::string_view filename, uint32_t
     break;
   }
 
-  mTexture = mEngine->getContext()->getResourceManager()->CreateTextureFromFile(
-      {filename.begin(), filename.end()}, mipLevels, vkf, vkf, vka, vka, srgb);
+  mTexture = mEngine->getResourceCache()->getTexture({filename.begin(), filename.end()},
+                                                     mipLevels, vkf, vka, srgb);
   mTexture->loadAsync().get();
 }
 
+void SapienRenderTexture2D::Prefetch(std::vector<std::string> const &filenames,
+                                     uint32_t mipLevels, FilterMode filterMode,
+                                     AddressMode addressMode, bool srgb, uint32_t threadCount) {
+  SapienRenderEngine::Get()->getResourceCache()->prefetchTextures(
+      filenames, mipLevels, convertFilterMode(filterMode), convertAddressMode(addressMode), srgb,
+      threadCount);
+}
+
 SapienRenderTexture2D::SapienRenderTexture2D(std::shared_ptr<svulkan2::resource::SVTexture> tex) {
   mEngine = SapienRenderEngine::Get();
   mTexture = tex;
@@ -444,9 +444,12 @@ SapienRenderImageCpu SapienRendererWindow::getImage(std::string const &name) {
   uint32_t width = image.getExtent().width;
   uint32_t height = image.getExtent().height;
   size_t size = image.getExtent().width * image.getExtent().height * formatSize;
-  mImageBuffers[name].resize(size);
-  image.download(mImageBuffers[name].data(), size);
-  return SapienRenderImageCpu(width, height, format, mImageBuffers[name].data());
+  auto &buffer = mImageBuffers[name];
+  if (!buffer.data || buffer.data.use_count() > 1 || buffer.bytes() != static_cast<int>(size)) {
+    buffer = CpuArray({static_cast<int>(size)}, "u1");
+  }
+  image.download(buffer.ptr(), size);
+  return SapienRenderImageCpu(width, height, format, buffer.ptr(), buffer.data);
 }
 
 CpuArray SapienRendererWindow::getImagePixel(std::string const &name, uint32_t x, uint32_t y) {
@@ -458,16 +461,15 @@ CpuArray SapienRendererWindow::getImagePixel(std::string const &name, uint32_t x
   }
   vk::Format format = image.getFormat();
   uint32_t formatSize = svulkan2::getFormatSize(format);
-  std::vector<char> buffer(formatSize);
-  image.downloadPixel(buffer.data(), formatSize, vk::Offset3D(x, y, 0));
-
   int channels = svulkan2::getFormatChannels(format);
   int itemsize = getFormatChannelSize(format);
   std::string type = getFormatTypestr(format);
 
-  assert(static_cast<int>(buffer.size()) == channels * itemsize);
+  assert(static_cast<int>(formatSize) == channels * itemsize);
 
-  return CpuArray{.shape = {channels}, .type = type, .data = buffer};
+  CpuArray pixel({channels}, type);
+  image.downloadPixel(pixel.ptr(), formatSize, vk::Offset3D(x, y, 0));
+  return pixel;
 }
 
 std::array<uint32_t, 2> SapienRendererWindow::getRenderTargetSize(std::string const &name) const {
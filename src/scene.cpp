@@ -2,6 +2,7 @@
 #include "./logger.h"
 #include "sapien/entity.h"
 #include "sapien/physx/physx_system.h"
+#include "sapien/profiler.h"
 #include "sapien/sapien_renderer/sapien_renderer.h"
 
 namespace sapien {
@@ -73,6 +74,7 @@ void Scene::removeEntity(std::shared_ptr<Entity> entity) {
 }
 
 std::string Scene::packEntityPoses() {
+  SAPIEN_PROFILE_FUNCTION;
   std::ostringstream ss;
   for (auto e : mEntities) {
     Pose pose = e->getPose();
@@ -82,6 +84,7 @@ std::string Scene::packEntityPoses() {
 }
 
 void Scene::unpackEntityPoses(std::string const &data) {
+  SAPIEN_PROFILE_FUNCTION;
   std::istringstream ss(data);
   for (auto e : mEntities) {
     Pose pose;
@@ -0,0 +1,192 @@
+#include "sapien/scene_bvh.h"
+#include "sapien/entity.h"
+#include "sapien/physx/physx_system.h"
+#include "sapien/physx/rigid_component.h"
+#include "sapien/profiler.h"
+#include "sapien/sapien_renderer/render_body_component.h"
+#include "sapien/scene.h"
+
+namespace sapien {
+
+static bool PoseEqual(Pose const &a, Pose const &b) {
+  return a.p.x == b.p.x && a.p.y == b.p.y && a.p.z == b.p.z && a.q.w == b.q.w &&
+         a.q.x == b.q.x && a.q.y == b.q.y && a.q.z == b.q.z;
+}
+
+SceneBVH::SceneBVH(std::shared_ptr<Scene> scene, Source source, float margin)
+    : mScene(scene), mSource(source), mMargin(margin) {
+  if (!scene) {
+    throw std::runtime_error("failed to create scene BVH: scene is null");
+  }
+  if (margin < 0.f) {
+    throw std::runtime_error("failed to create scene BVH: margin must be non-negative");
+  }
+}
+
+std::shared_ptr<Component> SceneBVH::findComponent(Entity &entity) const {
+  if (mSource == Source::ePhysx) {
+    auto body = entity.getComponent<physx::PhysxRigidBaseComponent>();
+    if (body && body->getEnabled() && !body->getCollisionShapes().empty()) {
+      return body;
+    }
+  } else {
+    auto body = entity.getComponent<sapien_renderer::SapienRenderBodyComponent>();
+    if (body && body->getEnabled() && !body->getRenderShapes().empty()) {
+      return body;
+    }
+  }
+  return nullptr;
+}
+
+AABB SceneBVH::computeAABB(Component &component) const {
+  if (mSource == Source::ePhysx) {
+    return static_cast<physx::PhysxRigidBaseComponent &>(component).getGlobalAABBFast();
+  }
+  return static_cast<sapien_renderer::SapienRenderBodyComponent &>(component)
+      .getGlobalAABBFast();
+}
+
+AABB SceneBVH::fatten(AABB const &box) const {
+  return {box.lower - Vec3(mMargin), box.upper + Vec3(mMargin)};
+}
+
+void SceneBVH::refit(bool force) {
+  SAPIEN_PROFILE_FUNCTION;
+
+  std::vector<bool> seen(mItems.size(), false);
+  for (auto &entity : mScene->getEntities()) {
+    auto component = findComponent(*entity);
+    if (!component) {
+      continue;
+    }
+    Pose pose = entity->getPose();
+
+    auto it = mIndex.find(component.get());
+    if (it == mIndex.end()) {
+      uint32_t index = mItems.size();
+      AABB box = computeAABB(*component);
+      mItems.push_back({pose, box, mTree.insert(fatten(box), index)});
+      mComponents.push_back(component);
+      mIndex[component.get()] = index;
+      seen.push_back(true);
+      continue;
+    }
+
+    uint32_t index = it->second;
+    seen[index] = true;
+    auto &item = mItems[index];
+    if (!force && PoseEqual(item.pose, pose)) {
+      continue;
+    }
+    item.pose = pose;
+    item.box = computeAABB(*component);
+    if (!containsAABB(mTree.getAABB(item.leaf), item.box)) {
+      mTree.move(item.leaf, fatten(item.box));
+    }
+  }
+
+  // swap-remove components that left the scene, items after index i are all seen
+  for (int64_t i = static_cast<int64_t>(mItems.size()) - 1; i >= 0; --i) {
+    if (seen[i]) {
+      continue;
+    }
+    mTree.remove(mItems[i].leaf);
+    mIndex.erase(mComponents[i].get());
+    if (i + 1 != static_cast<int64_t>(mItems.size())) {
+      mItems[i] = mItems.back();
+      mComponents[i] = mComponents.back();
+      mIndex[mComponents[i].get()] = i;
+      mTree.setData(mItems[i].leaf, i);
+    }
+    mItems.pop_back();
+    mComponents.pop_back();
+  }
+}
+
+uint64_t SceneBVH::getStepCount() const {
+  if (mScene->hasSystem("physx")) {
+    if (auto system = mScene->getPhysxSystem()) {
+      return system->getStepCount();
+    }
+  }
+  // scenes without physx only change on update
+  return mStepCount;
+}
+
+void SceneBVH::update() {
+  refit(true);
+  mStepCount = getStepCount();
+}
+
+void SceneBVH::refitIfStepped() {
+  uint64_t stepCount = getStepCount();
+  if (stepCount != mStepCount) {
+    refit(false);
+    mStepCount = stepCount;
+  }
+}
+
+std::vector<std::shared_ptr<Component>> const &SceneBVH::getComponents() {
+  refitIfStepped();
+  return mComponents;
+}
+
+AABB SceneBVH::getAABB(uint32_t index) {
+  refitIfStepped();
+  return mItems.at(index).box;
+}
+
+std::vector<uint32_t> SceneBVH::queryBox(AABB const &box) {
+  SAPIEN_PROFILE_FUNCTION;
+  refitIfStepped();
+  std::vector<uint32_t> result;
+  mTree.query([&](AABB const &b) { return overlapsAABB(b, box); },
+              [&](uint32_t index) {
+                if (overlapsAABB(mItems[index].box, box)) {
+                  result.push_back(index);
+                }
+              });
+  return result;
+}
+
+std::vector<uint32_t> SceneBVH::querySphere(Vec3 const &center, float radius) {
+  SAPIEN_PROFILE_FUNCTION;
+  refitIfStepped();
+  float r2 = radius * radius;
+  std::vector<uint32_t> result;
+  mTree.query([&](AABB const &b) { return distance2ToAABB(b, center) <= r2; },
+              [&](uint32_t index) {
+                if (distance2ToAABB(mItems[index].box, center) <= r2) {
+                  result.push_back(index);
+                }
+              });
+  return result;
+}
+
+std::vector<uint32_t> SceneBVH::queryFrustum(std::vector<std::array<float, 4>> const &planes) {
+  SAPIEN_PROFILE_FUNCTION;
+  refitIfStepped();
+  std::vector<uint32_t> result;
+  mTree.query([&](AABB const &b) { return !isAABBOutsidePlanes(b, planes); },
+              [&](uint32_t index) {
+                if (!isAABBOutsidePlanes(mItems[index].box, planes)) {
+                  result.push_back(index);
+                }
+              });
+  return result;
+}
+
+std::vector<uint32_t> SceneBVH::queryNearest(Vec3 const &point, uint32_t k) {
+  SAPIEN_PROFILE_FUNCTION;
+  refitIfStepped();
+  auto nearest = mTree.nearest(
+      point, k, [&](uint32_t index) { return distance2ToAABB(mItems[index].box, point); });
+  std::vector<uint32_t> result;
+  result.reserve(nearest.size());
+  for (auto &[index, d] : nearest) {
+    result.push_back(index);
+  }
+  return result;
+}
+
+} // namespace sapien
@@ -0,0 +1,449 @@
+#include "sapien/urdf/urdf.h"
+#include "sapien/math/conversion.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <tinyxml2.h>
+
+namespace fs = std::filesystem;
+using namespace tinyxml2;
+
+namespace sapien {
+namespace urdf {
+
+URDFLink const &URDFRobot::getLink(std::string const &name) const {
+  for (auto &link : links) {
+    if (link.name == name) {
+      return link;
+    }
+  }
+  throw std::runtime_error("failed to find link " + name);
+}
+
+URDFJoint const *URDFRobot::getParentJoint(std::string const &link) const {
+  for (auto &joint : joints) {
+    if (joint.child == link) {
+      return &joint;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<URDFJoint const *> URDFRobot::getChildJoints(std::string const &link) const {
+  std::vector<URDFJoint const *> result;
+  for (auto &joint : joints) {
+    if (joint.parent == link) {
+      result.push_back(&joint);
+    }
+  }
+  return result;
+}
+
+std::string FindURDFAsset(std::string const &filename, std::string const &urdfDir,
+                          std::string const &packageDir) {
+  std::string const prefix = "package://";
+  if (filename.starts_with(prefix)) {
+    std::string name = filename.substr(prefix.length());
+    if (!packageDir.empty() && fs::is_regular_file(fs::path(packageDir) / name)) {
+      return fs::absolute(fs::path(packageDir) / name).string();
+    }
+    fs::path dir = fs::absolute(urdfDir);
+    while (true) {
+      if (fs::is_regular_file(dir / name)) {
+        return (dir / name).string();
+      }
+      if (!dir.has_parent_path() || dir.parent_path() == dir) {
+        break;
+      }
+      dir = dir.parent_path();
+    }
+    return filename;
+  }
+
+  fs::path path = fs::absolute(fs::path(urdfDir) / filename);
+  if (fs::is_regular_file(path)) {
+    return path.string();
+  }
+  return filename;
+}
+
+static std::vector<float> ParseFloats(char const *text) {
+  std::vector<float> result;
+  if (!text) {
+    return result;
+  }
+  char *end{};
+  for (float value = std::strtof(text, &end); text != end; value = std::strtof(text, &end)) {
+    result.push_back(value);
+    text = end;
+  }
+  return result;
+}
+
+/** parse a single number, what names the value in the error message */
+static float ParseFloat(char const *text, std::string const &what) {
+  char *end{};
+  errno = 0;
+  float value = std::strtof(text, &end);
+  bool valid = end != text && errno != ERANGE;
+  while (std::isspace(static_cast<unsigned char>(*end))) {
+    ++end;
+  }
+  if (!valid || *end) {
+    throw std::runtime_error("failed to parse URDF: invalid " + what + " \"" + text + "\"");
+  }
+  return value;
+}
+
+static int ParseInt(char const *text, std::string const &what) {
+  char *end{};
+  errno = 0;
+  long value = std::strtol(text, &end, 10);
+  bool valid = end != text && errno != ERANGE && value >= INT_MIN && value <= INT_MAX;
+  while (std::isspace(static_cast<unsigned char>(*end))) {
+    ++end;
+  }
+  if (!valid || *end) {
+    throw std::runtime_error("failed to parse URDF: invalid " + what + " \"" + text + "\"");
+  }
+  return static_cast<int>(value);
+}
+
+static Vec3 ParseVec3(char const *text, Vec3 fallback) {
+  auto values = ParseFloats(text);
+  if (values.size() == 1) {
+    return Vec3(values[0]);
+  }
+  if (values.size() != 3) {
+    return fallback;
+  }
+  return {values[0], values[1], values[2]};
+}
+
+static float FloatAttribute(XMLElement const *elem, char const *name, float fallback) {
+  return elem ? elem->FloatAttribute(name, fallback) : fallback;
+}
+
+static std::string StringAttribute(XMLElement const *elem, char const *name) {
+  char const *value = elem ? elem->Attribute(name) : nullptr;
+  return value ? value : "";
+}
+
+static std::string RequiredAttribute(XMLElement const *elem, char const *name) {
+  char const *value = elem ? elem->Attribute(name) : nullptr;
+  if (!value) {
+    throw std::runtime_error(std::string("failed to parse URDF: missing attribute ") + name +
+                             " in <" + (elem ? elem->Name() : "") + ">");
+  }
+  return value;
+}
+
+static float RequiredFloatAttribute(XMLElement const *elem, char const *name) {
+  return ParseFloat(RequiredAttribute(elem, name).c_str(),
+                    std::string("attribute ") + name + " in <" + elem->Name() + ">");
+}
+
+static Pose ParseOrigin(XMLElement const *elem) {
+  XMLElement const *origin = elem->FirstChildElement("origin");
+  if (!origin) {
+    return Pose();
+  }
+  Vec3 xyz = ParseVec3(origin->Attribute("xyz"), Vec3(0.f));
+  Vec3 rpy = ParseVec3(origin->Attribute("rpy"), Vec3(0.f));
+  return Pose(xyz, RPYToQuat(rpy));
+}
+
+static std::optional<URDFGeometry> ParseGeometry(XMLElement const *elem,
+                                                 std::string const &urdfDir,
+                                                 std::string const &packageDir) {
+  XMLElement const *geometry = elem->FirstChildElement("geometry");
+  if (!geometry) {
+    return {};
+  }
+
+  URDFGeometry result;
+  if (auto box = geometry->FirstChildElement("box")) {
+    result.type = URDFGeometry::Type::eBox;
+    result.size = ParseVec3(box->Attribute("size"), Vec3(1.f));
+  } else if (auto sphere = geometry->FirstChildElement("sphere")) {
+    result.type = URDFGeometry::Type::eSphere;
+    result.radius = RequiredFloatAttribute(sphere, "radius");
+  } else if (auto cylinder = geometry->FirstChildElement("cylinder")) {
+    result.type = URDFGeometry::Type::eCylinder;
+    result.radius = RequiredFloatAttribute(cylinder, "radius");
+    result.length = RequiredFloatAttribute(cylinder, "length");
+  } else if (auto capsule = geometry->FirstChildElement("capsule")) {
+    result.type = URDFGeometry::Type::eCapsule;
+    result.radius = RequiredFloatAttribute(capsule, "radius");
+    result.length = RequiredFloatAttribute(capsule, "length");
+  } else if (auto mesh = geometry->FirstChildElement("mesh")) {
+    result.type = URDFGeometry::Type::eMesh;
+    result.size = ParseVec3(mesh->Attribute("scale"), Vec3(1.f));
+    result.filename = FindURDFAsset(RequiredAttribute(mesh, "filename"), urdfDir, packageDir);
+  } else {
+    return {};
+  }
+  return result;
+}
+
+static URDFMaterial ParseMaterial(XMLElement const *elem, std::string const &urdfDir,
+                                  std::string const &packageDir) {
+  URDFMaterial material;
+  material.name = StringAttribute(elem, "name");
+  if (auto color = elem->FirstChildElement("color")) {
+    auto rgba = ParseFloats(color->Attribute("rgba"));
+    if (rgba.size() == 4) {
+      material.color = {rgba[0], rgba[1], rgba[2], rgba[3]};
+    }
+  }
+  if (auto texture = elem->FirstChildElement("texture")) {
+    if (texture->Attribute("filename")) {
+      material.texture = FindURDFAsset(texture->Attribute("filename"), urdfDir, packageDir);
+    }
+  }
+  return material;
+}
+
+static URDFLink ParseLink(XMLElement const *elem, std::string const &urdfDir,
+                          std::string const &packageDir,
+                          std::map<std::string, URDFMaterial> const &materials) {
+  URDFLink link;
+  link.name = RequiredAttribute(elem, "name");
+
+  if (auto inertial = elem->FirstChildElement("inertial")) {
+    URDFInertial result;
+    result.origin = ParseOrigin(inertial);
+    result.mass = FloatAttribute(inertial->FirstChildElement("mass"), "value", 0.f);
+    if (auto i = inertial->FirstChildElement("inertia")) {
+      float xx = i->FloatAttribute("ixx"), yy = i->FloatAttribute("iyy"),
+            zz = i->FloatAttribute("izz"), xy = i->FloatAttribute("ixy"),
+            yz = i->FloatAttribute("iyz"), xz = i->FloatAttribute("ixz");
+      result.inertia << xx, xy, xz, xy, yy, yz, xz, yz, zz;
+    }
+    link.inertial = result;
+  }
+
+  for (auto v = elem->FirstChildElement("visual"); v; v = v->NextSiblingElement("visual")) {
+    auto geometry = ParseGeometry(v, urdfDir, packageDir);
+    if (!geometry) {
+      continue;
+    }
+    URDFVisual visual{.name = StringAttribute(v, "name"),
+                      .origin = ParseOrigin(v),
+                      .geometry = *geometry};
+    if (auto m = v->FirstChildElement("material")) {
+      auto material = ParseMaterial(m, urdfDir, packageDir);
+      // a material without color or texture refers to a top-level definition
+      if (!material.color && material.texture.empty() && materials.contains(material.name)) {
+        material = materials.at(material.name);
+      }
+      visual.material = material;
+    }
+    link.visuals.push_back(visual);
+  }
+
+  for (auto c = elem->FirstChildElement("collision"); c;
+       c = c->NextSiblingElement("collision")) {
+    auto geometry = ParseGeometry(c, urdfDir, packageDir);
+    if (!geometry) {
+      continue;
+    }
+    link.collisions.push_back(URDFCollision{
+        .name = StringAttribute(c, "name"), .origin = ParseOrigin(c), .geometry = *geometry});
+  }
+  return link;
+}
+
+static URDFJoint ParseJoint(XMLElement const *elem) {
+  URDFJoint joint;
+  joint.name = RequiredAttribute(elem, "name");
+  joint.type = RequiredAttribute(elem, "type");
+  joint.parent = RequiredAttribute(elem->FirstChildElement("parent"), "link");
+  joint.child = RequiredAttribute(elem->FirstChildElement("child"), "link");
+  joint.origin = ParseOrigin(elem);
+  if (auto axis = elem->FirstChildElement("axis")) {
+    joint.axis = ParseVec3(axis->Attribute("xyz"), joint.axis);
+  }
+  if (auto limit = elem->FirstChildElement("limit")) {
+    joint.lower = limit->FloatAttribute("lower", 0.f);
+    joint.upper = limit->FloatAttribute("upper", 0.f);
+  }
+  if (auto dynamics = elem->FirstChildElement("dynamics")) {
+    joint.friction = dynamics->FloatAttribute("friction", 0.f);
+    joint.damping = dynamics->FloatAttribute("damping", 0.f);
+  }
+  if (auto mimic = elem->FirstChildElement("mimic")) {
+    joint.mimic = URDFMimic{.joint = RequiredAttribute(mimic, "joint"),
+                            .multiplier = mimic->FloatAttribute("multiplier", 1.f),
+                            .offset = mimic->FloatAttribute("offset", 0.f)};
+  }
+  return joint;
+}
+
+// value of <name> child element or attribute of fallback element
+static char const *ChildTextOrAttribute(XMLElement const *elem, char const *child,
+                                        XMLElement const *fallback, char const *attribute) {
+  if (auto c = elem ? elem->FirstChildElement(child) : nullptr) {
+    return c->GetText();
+  }
+  return fallback ? fallback->Attribute(attribute) : nullptr;
+}
+
+static std::optional<URDFCamera> ParseCamera(XMLElement const *sensor,
+                                             std::string const &parentLink) {
+  auto camera = sensor->FirstChildElement("camera");
+  if (!camera || parentLink.empty()) {
+    return {};
+  }
+
+  URDFCamera result;
+  result.parent = parentLink;
+  result.pose = ParseOrigin(sensor);
+
+  auto image = camera->FirstChildElement("image");
+  if (!image) {
+    throw std::runtime_error("failed to parse URDF: camera sensor has no <image>");
+  }
+
+  auto width = ChildTextOrAttribute(image, "width", image, "width");
+  auto height = ChildTextOrAttribute(image, "height", image, "height");
+  if (!width || !height) {
+    throw std::runtime_error("failed to parse URDF: camera requires width and height");
+  }
+  result.width = ParseInt(width, "camera width");
+  result.height = ParseInt(height, "camera height");
+  if (result.width <= 0 || result.height <= 0) {
+    throw std::runtime_error("failed to parse URDF: invalid camera width or height");
+  }
+
+  auto clip = camera->FirstChildElement("clip");
+  auto near = ChildTextOrAttribute(clip, "near", clip ? nullptr : image, "near");
+  auto far = ChildTextOrAttribute(clip, "far", clip ? nullptr : image, "far");
+  if (near && *near) {
+    result.near = ParseFloat(near, "camera near");
+  }
+  if (far && *far) {
+    result.far = ParseFloat(far, "camera far");
+  }
+
+  auto fovx = ChildTextOrAttribute(camera, "horizontal_fov", image, "hfov");
+  auto fovy = ChildTextOrAttribute(camera, "vertical_fov", image, "vfov");
+  if (fovx && *fovx) {
+    result.fovx = ParseFloat(fovx, "camera horizontal fov");
+  }
+  if (fovy && *fovy) {
+    result.fovy = ParseFloat(fovy, "camera vertical fov");
+  }
+  if (!result.fovx && !result.fovy) {
+    throw std::runtime_error("failed to parse URDF: camera requires horizontal or vertical fov");
+  }
+  return result;
+}
+
+URDFRobot ParseURDF(std::string const &xml, std::string const &urdfDir,
+                    std::string const &packageDir) {
+  XMLDocument doc;
+  if (doc.Parse(xml.c_str(), xml.length()) != XML_SUCCESS) {
+    throw std::runtime_error(std::string("failed to parse URDF: ") + doc.ErrorStr());
+  }
+  XMLElement const *root = doc.RootElement();
+  if (!root || std::string(root->Name()) != "robot") {
+    throw std::runtime_error("failed to parse URDF: root element must be <robot>");
+  }
+
+  URDFRobot robot;
+  robot.name = StringAttribute(root, "name");
+
+  std::map<std::string, URDFMaterial> materials;
+  for (auto m = root->FirstChildElement("material"); m; m = m->NextSiblingElement("material")) {
+    auto material = ParseMaterial(m, urdfDir, packageDir);
+    materials[material.name] = material;
+  }
+
+  for (auto l = root->FirstChildElement("link"); l; l = l->NextSiblingElement("link")) {
+    robot.links.push_back(ParseLink(l, urdfDir, packageDir, materials));
+  }
+  for (auto j = root->FirstChildElement("joint"); j; j = j->NextSiblingElement("joint")) {
+    robot.joints.push_back(ParseJoint(j));
+  }
+
+  std::set<std::string> linkNames;
+  for (auto &link : robot.links) {
+    if (!linkNames.insert(link.name).second) {
+      throw std::runtime_error("failed to parse URDF: duplicated link " + link.name);
+    }
+  }
+  std::set<std::string> children;
+  for (auto &joint : robot.joints) {
+    if (!linkNames.contains(joint.parent) || !linkNames.contains(joint.child)) {
+      throw std::runtime_error("failed to parse URDF: joint " + joint.name +
+                               " refers to an unknown link");
+    }
+    if (!children.insert(joint.child).second) {
+      throw std::runtime_error("failed to parse URDF: link " + joint.child +
+                               " has multiple parents");
+    }
+  }
+  for (auto &link : robot.links) {
+    if (!children.contains(link.name)) {
+      if (!robot.baseLink.empty()) {
+        throw std::runtime_error("failed to parse URDF: multiple root links " + robot.baseLink +
+                                 " and " + link.name);
+      }
+      robot.baseLink = link.name;
+    }
+  }
+  if (robot.baseLink.empty()) {
+    throw std::runtime_error("failed to parse URDF: no root link");
+  }
+
+  // cameras are <sensor> elements under <gazebo reference="link"> or at the top level
+  for (auto g = root->FirstChildElement("gazebo"); g; g = g->NextSiblingElement("gazebo")) {
+    if (!g->Attribute("reference")) {
+      continue;
+    }
+    for (auto s = g->FirstChildElement("sensor"); s; s = s->NextSiblingElement("sensor")) {
+      auto parent = s->FirstChildElement("parent");
+      auto camera =
+          ParseCamera(s, parent ? StringAttribute(parent, "link") : g->Attribute("reference"));
+      if (camera) {
+        robot.cameras.push_back(*camera);
+      }
+    }
+  }
+  for (auto s = root->FirstChildElement("sensor"); s; s = s->NextSiblingElement("sensor")) {
+    if (auto camera = ParseCamera(s, StringAttribute(s->FirstChildElement("parent"), "link"))) {
+      robot.cameras.push_back(*camera);
+    }
+  }
+
+  return robot;
+}
+
+std::vector<std::array<std::string, 2>> ParseSRDF(std::string const &xml) {
+  XMLDocument doc;
+  if (doc.Parse(xml.c_str(), xml.length()) != XML_SUCCESS) {
+    throw std::runtime_error(std::string("failed to parse SRDF: ") + doc.ErrorStr());
+  }
+  std::vector<std::array<std::string, 2>> pairs;
+  XMLElement const *root = doc.RootElement();
+  if (!root) {
+    return pairs;
+  }
+  for (auto elem = root->FirstChildElement("disable_collisions"); elem;
+       elem = elem->NextSiblingElement("disable_collisions")) {
+    std::string reason = RequiredAttribute(elem, "reason");
+    std::transform(reason.begin(), reason.end(), reason.begin(), ::tolower);
+    if (reason == "default") {
+      pairs.push_back({RequiredAttribute(elem, "link1"), RequiredAttribute(elem, "link2")});
+    }
+  }
+  return pairs;
+}
+
+} // namespace urdf
+} // namespace sapien
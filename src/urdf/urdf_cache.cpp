@@ -0,0 +1,129 @@
+#include "sapien/urdf/urdf_cache.h"
+#include "sapien/profiler.h"
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace sapien {
+namespace urdf {
+
+static std::string ReadFile(std::string const &filename) {
+  std::ifstream f(filename);
+  if (!f) {
+    throw std::runtime_error("failed to open file " + filename);
+  }
+  std::stringstream ss;
+  ss << f.rdbuf();
+  return ss.str();
+}
+
+static std::string DefaultSRDF(std::string const &urdfFile, std::string const &srdfFile) {
+  if (!srdfFile.empty()) {
+    return srdfFile;
+  }
+  return fs::path(urdfFile).replace_extension(".srdf").string();
+}
+
+static std::shared_ptr<URDFDescription const>
+Parse(std::string const &urdfFile, std::string const &urdf, std::string const &srdf,
+      std::string const &packageDir) {
+  auto description = std::make_shared<URDFDescription>();
+  description->robot = ParseURDF(urdf, fs::path(urdfFile).parent_path().string(), packageDir);
+  if (!srdf.empty()) {
+    description->ignorePairs = ParseSRDF(srdf);
+  }
+  return description;
+}
+
+static uint64_t Hash(std::string const &urdf, std::string const &srdf) {
+  uint64_t h = std::hash<std::string>{}(urdf);
+  return h ^ (std::hash<std::string>{}(srdf) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
+}
+
+static std::shared_ptr<URDFCache> gCache;
+static std::once_flag gCacheFlag;
+std::shared_ptr<URDFCache> URDFCache::Get() {
+  std::call_once(gCacheFlag, []() { gCache = std::make_shared<URDFCache>(); });
+  return gCache;
+}
+
+void URDFCache::Clear() {
+  if (gCache) {
+    std::lock_guard lock(gCache->mMutex);
+    gCache->mEntries.clear();
+  }
+}
+
+URDFCache::FileStamp URDFCache::Stamp(std::string const &filename) {
+  std::error_code ec;
+  auto size = fs::file_size(filename, ec);
+  if (ec) {
+    return {};
+  }
+  auto mtime = fs::last_write_time(filename, ec);
+  if (ec) {
+    return {};
+  }
+  return {true, static_cast<int64_t>(mtime.time_since_epoch().count()), size};
+}
+
+std::shared_ptr<URDFDescription const> URDFCache::Read(std::string const &urdfFile,
+                                                       std::string const &srdfFile,
+                                                       std::string const &packageDir) {
+  SAPIEN_PROFILE_FUNCTION;
+  auto srdf = DefaultSRDF(urdfFile, srdfFile);
+  return Parse(urdfFile, ReadFile(urdfFile), fs::is_regular_file(srdf) ? ReadFile(srdf) : "",
+               packageDir);
+}
+
+std::shared_ptr<URDFDescription const> URDFCache::load(std::string const &urdfFile,
+                                                       std::string const &srdfFile,
+                                                       std::string const &packageDir) {
+  SAPIEN_PROFILE_FUNCTION;
+  auto urdfPath = fs::absolute(urdfFile).lexically_normal().string();
+  auto srdfPath = fs::absolute(DefaultSRDF(urdfFile, srdfFile)).lexically_normal().string();
+  auto key = std::make_tuple(urdfPath, srdfPath,
+                             packageDir.empty()
+                                 ? std::string()
+                                 : fs::absolute(packageDir).lexically_normal().string());
+
+  auto urdfStamp = Stamp(urdfPath);
+  auto srdfStamp = Stamp(srdfPath);
+  {
+    std::lock_guard lock(mMutex);
+    auto it = mEntries.find(key);
+    if (it != mEntries.end() && it->second.urdfStamp == urdfStamp &&
+        it->second.srdfStamp == srdfStamp) {
+      mHitCount++;
+      return it->second.description;
+    }
+  }
+
+  // files are touched or new, compare content before reparsing
+  auto urdf = ReadFile(urdfPath);
+  auto srdf = srdfStamp.exists ? ReadFile(srdfPath) : "";
+  auto hash = Hash(urdf, srdf);
+  {
+    std::lock_guard lock(mMutex);
+    auto it = mEntries.find(key);
+    if (it != mEntries.end() && it->second.hash == hash) {
+      it->second.urdfStamp = urdfStamp;
+      it->second.srdfStamp = srdfStamp;
+      mHitCount++;
+      return it->second.description;
+    }
+  }
+
+  auto description = Parse(urdfPath, urdf, srdf, packageDir);
+
+  std::lock_guard lock(mMutex);
+  mEntries[key] = {urdfStamp, srdfStamp, hash, description};
+  mMissCount++;
+  return description;
+}
+
+} // namespace urdf
+} // namespace sapien
@@ -0,0 +1,602 @@
+#include "sapien/urdf/urdf_loader.h"
+#include "sapien/urdf/urdf_cache.h"
+#include "../logger.h"
+#include "sapien/entity.h"
+#include "sapien/physx/physx.h"
+#include "sapien/profiler.h"
+#include "sapien/sapien_renderer/sapien_renderer.h"
+#include "sapien/scene.h"
+#include "sapien/utils/thread_pool.h"
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <set>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace sapien {
+namespace urdf {
+
+using namespace physx;
+using namespace sapien_renderer;
+
+// capsules and cylinders are along x in SAPIEN and along z in URDF
+static Pose const POSE_Z_TO_X({0.f, 0.f, 0.f}, {0.7071068f, 0.f, 0.7071068f, 0.f});
+
+static bool IsUSD(std::string const &filename) {
+  auto ext = fs::path(filename).extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+  return ext == ".usd" || ext == ".usda" || ext == ".usdc" || ext == ".usdz";
+}
+
+void URDFLoader::setMaterial(float staticFriction, float dynamicFriction, float restitution) {
+  mMaterial = std::make_shared<PhysxMaterial>(staticFriction, dynamicFriction, restitution);
+}
+
+void URDFLoader::setLinkMaterial(std::string const &link, float staticFriction,
+                                 float dynamicFriction, float restitution) {
+  mLinkMaterial[link] =
+      std::make_shared<PhysxMaterial>(staticFriction, dynamicFriction, restitution);
+}
+
+std::shared_ptr<PhysxMaterial> URDFLoader::getMaterial(std::string const &link) const {
+  if (auto it = mLinkMaterial.find(link); it != mLinkMaterial.end()) {
+    return it->second;
+  }
+  return mMaterial ? mMaterial : PhysxDefault::GetDefaultMaterial();
+}
+
+float URDFLoader::getDensity(std::string const &link) const {
+  auto it = mLinkDensity.find(link);
+  return it == mLinkDensity.end() ? mDensity : it->second;
+}
+
+float URDFLoader::getPatchRadius(std::string const &link) const {
+  auto it = mLinkPatchRadius.find(link);
+  return it == mLinkPatchRadius.end() ? mPatchRadius : it->second;
+}
+
+float URDFLoader::getMinPatchRadius(std::string const &link) const {
+  auto it = mLinkMinPatchRadius.find(link);
+  return it == mLinkMinPatchRadius.end() ? mMinPatchRadius : it->second;
+}
+
+void URDFLoader::preloadMeshes(URDFRobot const &robot) const {
+  SAPIEN_PROFILE_FUNCTION;
+
+  std::set<std::string> collisionFiles;
+  std::set<std::string> visualFiles;
+  for (auto &link : robot.links) {
+    for (auto &c : link.collisions) {
+      if (c.geometry.type == URDFGeometry::Type::eMesh && !IsUSD(c.geometry.filename)) {
+        collisionFiles.insert(c.geometry.filename);
+        if (mCollisionIsVisual) {
+          visualFiles.insert(c.geometry.filename);
+        }
+      }
+    }
+    for (auto &v : link.visuals) {
+      if (v.geometry.type == URDFGeometry::Type::eMesh && !IsUSD(v.geometry.filename)) {
+        visualFiles.insert(v.geometry.filename);
+      }
+    }
+  }
+
+  // render models are loaded by the resource manager threads, the returned models are cached
+  std::vector<std::future<void>> visualFutures;
+  if (!visualFiles.empty()) {
+    auto cache = SapienRenderEngine::Get()->getResourceCache();
+    for (auto &file : visualFiles) {
+      visualFutures.push_back(cache->getModel(file)->loadAsync());
+    }
+  }
+
+  // collision meshes are cooked on worker threads and cached by the MeshManager
+  std::vector<std::string> files(collisionFiles.begin(), collisionFiles.end());
+  std::atomic<size_t> next{0};
+  auto cook = [&](uint32_t) {
+    for (size_t i = next++; i < files.size(); i = next++) {
+      try {
+        if (mLoadMultipleCollisions) {
+          MeshManager::Get()->loadConvexMeshGroup(files[i]);
+        } else {
+          MeshManager::Get()->loadConvexMesh(files[i]);
+        }
+      } catch (std::exception const &) {
+        // reported when the shape is created
+      }
+    }
+  };
+
+  uint32_t threadCount = mMeshLoadThreads ? mMeshLoadThreads : std::thread::hardware_concurrency();
+  threadCount = std::min<uint32_t>(std::max(threadCount, 1u), files.size());
+  ThreadPool::Get().parallelFor(threadCount, threadCount, cook);
+
+  for (auto &f : visualFutures) {
+    try {
+      f.get();
+    } catch (std::exception const &) {
+      // reported when the shape is created
+    }
+  }
+}
+
+void URDFLoader::buildCollisions(URDFLink const &link, PhysxRigidBodyComponent &body,
+                                 std::array<uint32_t, 4> const &collisionGroups) const {
+  auto material = getMaterial(link.name);
+  float density = getDensity(link.name);
+  float patchRadius = getPatchRadius(link.name);
+  float minPatchRadius = getMinPatchRadius(link.name);
+
+  for (auto &c : link.collisions) {
+    Pose pose = c.origin;
+    pose.p = pose.p * mScale;
+    auto &g = c.geometry;
+
+    std::vector<std::shared_ptr<PhysxCollisionShape>> shapes;
+    try {
+      switch (g.type) {
+      case URDFGeometry::Type::eBox:
+        shapes.push_back(
+            std::make_shared<PhysxCollisionShapeBox>(g.size * mScale / 2.f, material));
+        break;
+      case URDFGeometry::Type::eSphere:
+        shapes.push_back(std::make_shared<PhysxCollisionShapeSphere>(g.radius * mScale, material));
+        break;
+      case URDFGeometry::Type::eCapsule:
+        pose = pose * POSE_Z_TO_X;
+        shapes.push_back(std::make_shared<PhysxCollisionShapeCapsule>(
+            g.radius * mScale, g.length * mScale / 2.f, material));
+        break;
+      case URDFGeometry::Type::eCylinder:
+        pose = pose * POSE_Z_TO_X;
+        shapes.push_back(std::make_shared<PhysxCollisionShapeCylinder>(
+            g.radius * mScale, g.length * mScale / 2.f, material));
+        break;
+      case URDFGeometry::Type::eMesh:
+        if (IsUSD(g.filename)) {
+          logger::warn("USD collision mesh is not supported by the native URDF loader: {}",
+                       g.filename);
+          continue;
+        }
+        if (mLoadMultipleCollisions) {
+          auto meshes =
+              PhysxCollisionShapeConvexMesh::LoadMultiple(g.filename, g.size * mScale, material);
+          shapes.insert(shapes.end(), meshes.begin(), meshes.end());
+        } else {
+          shapes.push_back(std::make_shared<PhysxCollisionShapeConvexMesh>(
+              g.filename, g.size * mScale, material));
+        }
+        break;
+      }
+    } catch (std::exception const &e) {
+      // same as the Python loader, shapes that fail to load (e.g. cooking failure) are skipped
+      logger::warn("failed to load collision shape for link {}: {}", link.name, e.what());
+      continue;
+    }
+
+    for (auto &shape : shapes) {
+      shape->setLocalPose(pose);
+      shape->setCollisionGroups(collisionGroups);
+      shape->setDensity(density);
+      shape->setTorsionalPatchRadius(patchRadius);
+      shape->setMinTorsionalPatchRadius(minPatchRadius);
+      body.attachCollision(shape);
+    }
+  }
+
+  if (link.inertial && link.inertial->mass != 0.f && !link.inertial->inertia.isZero()) {
+    Eigen::Matrix3f const &inertia = link.inertial->inertia;
+    Eigen::Vector3f eigs;
+    Eigen::Matrix3f vecs;
+    if (inertia.isDiagonal()) {
+      eigs = inertia.diagonal();
+      vecs = Eigen::Matrix3f::Identity();
+    } else {
+      Eigen::SelfAdjointEigenSolver<Eigen::Matrix3f> solver(inertia);
+      eigs = solver.eigenvalues();
+      vecs = solver.eigenvectors();
+      if (vecs.determinant() < 0) {
+        vecs.col(2) = -vecs.col(2);
+      }
+    }
+    if ((eigs.array() <= 0.f).any()) {
+      throw std::runtime_error("invalid moment of inertia for link " + link.name);
+    }
+
+    Eigen::Quaternionf q(vecs);
+    Pose inertialPose = link.inertial->origin;
+    inertialPose.p = inertialPose.p * mScale;
+    Pose cmassPose = inertialPose * Pose(Quat(q.w(), q.x(), q.y(), q.z()).getNormalized());
+
+    float scale3 = mScale * mScale * mScale;
+    float scale5 = scale3 * mScale * mScale;
+    body.setMass(link.inertial->mass * scale3);
+    body.setCMassLocalPose(cmassPose);
+    body.setInertia(Vec3(eigs.x(), eigs.y(), eigs.z()) * scale5);
+  }
+}
+
+std::shared_ptr<SapienRenderBodyComponent> URDFLoader::buildVisuals(URDFLink const &link) const {
+  struct Record {
+    std::string name;
+    Pose pose;
+    URDFGeometry const *geometry;
+    std::shared_ptr<SapienRenderMaterial> material;
+  };
+
+  std::vector<Record> records;
+  for (auto &v : link.visuals) {
+    std::shared_ptr<SapienRenderMaterial> material;
+    if (v.material) {
+      material = std::make_shared<SapienRenderMaterial>();
+      if (v.material->color) {
+        material->setBaseColor(*v.material->color);
+      } else if (!v.material->texture.empty()) {
+        material->setBaseColorTexture(std::make_shared<SapienRenderTexture2D>(
+            v.material->texture, 1, SapienRenderTexture::FilterMode::eLINEAR,
+            SapienRenderTexture::AddressMode::eREPEAT, true));
+      }
+    }
+    records.push_back({v.name, v.origin, &v.geometry, material});
+  }
+  if (mCollisionIsVisual) {
+    for (auto &c : link.collisions) {
+      records.push_back({"", c.origin, &c.geometry, nullptr});
+    }
+  }
+  if (records.empty()) {
+    return nullptr;
+  }
+
+  auto component = std::make_shared<SapienRenderBodyComponent>();
+  for (auto &r : records) {
+    Pose pose = r.pose;
+    pose.p = pose.p * mScale;
+    auto &g = *r.geometry;
+
+    // primitives always have a material, meshes keep their own materials by default
+    auto material = r.material;
+    if (!material && g.type != URDFGeometry::Type::eMesh) {
+      material = std::make_shared<SapienRenderMaterial>();
+    }
+
+    std::shared_ptr<RenderShape> shape;
+    switch (g.type) {
+    case URDFGeometry::Type::eBox:
+      shape = std::make_shared<RenderShapeBox>(g.size * mScale / 2.f, material);
+      break;
+    case URDFGeometry::Type::eSphere:
+      shape = std::make_shared<RenderShapeSphere>(g.radius * mScale, material);
+      break;
+    case URDFGeometry::Type::eCapsule:
+      pose = pose * POSE_Z_TO_X;
+      shape = std::make_shared<RenderShapeCapsule>(g.radius * mScale, g.length * mScale / 2.f,
+                                                   material);
+      break;
+    case URDFGeometry::Type::eCylinder:
+      pose = pose * POSE_Z_TO_X;
+      shape = std::make_shared<RenderShapeCylinder>(g.radius * mScale, g.length * mScale / 2.f,
+                                                    material);
+      break;
+    case URDFGeometry::Type::eMesh: {
+      if (IsUSD(g.filename)) {
+        logger::warn("USD visual mesh is not supported by the native URDF loader: {}",
+                     g.filename);
+        continue;
+      }
+      Vec3 scale = g.size * mScale;
+      shape = std::make_shared<RenderShapeTriangleMesh>(g.filename, scale, material);
+      if (scale.x * scale.y * scale.z < 0.f) {
+        shape->setFrontFace(vk::FrontFace::eClockwise);
+      }
+      break;
+    }
+    }
+
+    shape->setLocalPose(pose);
+    shape->setName(r.name);
+    component->attachRenderShape(shape);
+  }
+  component->setName(link.name);
+  return component;
+}
+
+// roots are the base link and children of floating joints, which are only allowed on the base
+static std::vector<std::string>
+FindRoots(URDFRobot const &robot,
+          std::map<std::string, std::vector<URDFJoint const *>> &childJoints) {
+  for (auto &link : robot.links) {
+    childJoints[link.name] = {};
+  }
+  std::vector<std::string> roots = {robot.baseLink};
+  for (auto &joint : robot.joints) {
+    if (joint.type == "floating") {
+      if (joint.parent != robot.baseLink) {
+        throw std::runtime_error("failed to load URDF: floating joints are only supported as "
+                                 "children of the root link");
+      }
+      roots.push_back(joint.child);
+    } else {
+      childJoints[joint.parent].push_back(&joint);
+    }
+  }
+  return roots;
+}
+
+std::tuple<std::vector<std::shared_ptr<PhysxArticulation>>, std::vector<std::shared_ptr<Entity>>>
+URDFLoader::loadRobot(URDFRobot const &robot,
+                      std::vector<std::array<std::string, 2>> const &ignorePairs) {
+  SAPIEN_PROFILE_FUNCTION;
+
+  if (!mScene) {
+    throw std::runtime_error("failed to load URDF: scene is not set");
+  }
+
+  // hold the engine so worker threads do not race on creating it
+  auto engine = PhysxEngine::Get();
+  preloadMeshes(robot);
+
+  std::map<std::string, std::vector<URDFJoint const *>> childJoints;
+  auto roots = FindRoots(robot, childJoints);
+
+  std::map<std::string, std::shared_ptr<Entity>> name2entity;
+  std::vector<std::shared_ptr<PhysxArticulation>> articulations;
+  std::vector<std::shared_ptr<Entity>> actors;
+  std::vector<std::shared_ptr<Entity>> articulationEntities;
+
+  for (auto &root : roots) {
+    if (childJoints.at(root).empty()) {
+      continue;
+    }
+    bool fixBase = root == robot.baseLink ? mFixRootLink : false;
+
+    // same traversal order as the Python loader so link indices match
+    std::vector<std::string> order;
+    std::set<std::string> members;
+    std::vector<std::string> stack = {root};
+    while (!stack.empty()) {
+      auto name = stack.back();
+      stack.pop_back();
+      order.push_back(name);
+      members.insert(name);
+      auto &children = childJoints.at(name);
+      for (auto it = children.rbegin(); it != children.rend(); ++it) {
+        stack.push_back((*it)->child);
+      }
+    }
+
+    // SRDF pairs become bits in collision group 2, parent-child pairs are already ignored
+    std::map<std::string, std::array<uint32_t, 4>> groups;
+    for (auto &name : order) {
+      groups[name] = {1, 1, 0, 0};
+    }
+    uint32_t groupCount = 0;
+    for (auto &[l1, l2] : ignorePairs) {
+      if (!members.contains(l1) || !members.contains(l2)) {
+        continue;
+      }
+      auto j1 = l1 == root ? nullptr : robot.getParentJoint(l1);
+      auto j2 = l2 == root ? nullptr : robot.getParentJoint(l2);
+      if ((j1 && j1->parent == l2) || (j2 && j2->parent == l1)) {
+        continue;
+      }
+      if (++groupCount == 32) {
+        throw std::runtime_error("Too many collision groups. Please use a simpler SRDF file");
+      }
+      groups[l1][2] |= 1u << (groupCount - 1);
+      groups[l2][2] |= 1u << (groupCount - 1);
+    }
+
+    std::map<std::string, std::shared_ptr<PhysxArticulationLinkComponent>> name2link;
+    std::map<std::string, URDFJoint const *> name2joint;
+    std::vector<std::shared_ptr<Entity>> entities;
+    for (auto &name : order) {
+      auto &link = robot.getLink(name);
+      URDFJoint const *joint = name == root ? nullptr : robot.getParentJoint(name);
+
+      auto component =
+          PhysxArticulationLinkComponent::Create(joint ? name2link.at(joint->parent) : nullptr);
+      buildCollisions(link, *component, groups.at(name));
+
+      auto entity = std::make_shared<Entity>();
+      entity->addComponent(component);
+      if (auto body = buildVisuals(link)) {
+        entity->addComponent(body);
+      }
+      entity->setName(name);
+      component->setName(name);
+
+      auto j = component->getJoint();
+      j->setName(joint ? joint->name : "");
+      if (!joint) {
+        j->setType(fixBase ? ::physx::PxArticulationJointType::eFIX
+                           : ::physx::PxArticulationJointType::eUNDEFINED);
+      } else {
+        Pose jointPose = joint->origin;
+        jointPose.p = jointPose.p * mScale;
+
+        // joint axis becomes the x axis of the joint frame
+        Eigen::Vector3f axis(joint->axis.x, joint->axis.y, joint->axis.z);
+        if (axis.norm() < 1e-3) {
+          axis = {1.f, 0.f, 0.f};
+        } else {
+          axis.normalize();
+        }
+        Eigen::Vector3f axis1 = std::abs(axis.x()) > 0.9f ? axis.cross(Eigen::Vector3f::UnitZ())
+                                                           : axis.cross(Eigen::Vector3f::UnitX());
+        axis1.normalize();
+        Eigen::Vector3f axis2 = axis.cross(axis1);
+        Eigen::Matrix3f frame;
+        frame << axis, axis1, axis2;
+        Eigen::Quaternionf q(frame);
+        Pose axisPose(Quat(q.w(), q.x(), q.y(), q.z()).getNormalized());
+
+        Eigen::Matrix<float, Eigen::Dynamic, 2, Eigen::RowMajor> limit(1, 2);
+        if (joint->type == "revolute") {
+          j->setType(::physx::PxArticulationJointType::eREVOLUTE_UNWRAPPED);
+          limit << joint->lower, joint->upper;
+        } else if (joint->type == "continuous") {
+          j->setType(::physx::PxArticulationJointType::eREVOLUTE);
+          limit << -std::numeric_limits<float>::infinity(),
+              std::numeric_limits<float>::infinity();
+        } else if (joint->type == "prismatic") {
+          j->setType(::physx::PxArticulationJointType::ePRISMATIC);
+          limit << joint->lower * mScale, joint->upper * mScale;
+        } else if (joint->type == "fixed") {
+          j->setType(::physx::PxArticulationJointType::eFIX);
+        } else {
+          throw std::runtime_error("failed to load URDF: unsupported joint type " + joint->type);
+        }
+        j->setAnchorPoseInParent(jointPose * axisPose);
+        j->setAnchorPoseInChild(axisPose);
+
+        if (joint->type != "fixed") {
+          j->setLimit(limit);
+          j->setDriveProperties(0.f, joint->damping, PX_MAX_F32,
+                                ::physx::PxArticulationDriveType::eFORCE);
+        }
+      }
+
+      name2link[name] = component;
+      name2joint[name] = joint;
+      name2entity[name] = entity;
+      entities.push_back(entity);
+    }
+    entities.at(0)->setPose(Pose());
+
+    auto articulation = name2link.at(root)->getArticulation();
+
+    // mimic joints are implemented as fixed tendons
+    for (auto &name : order) {
+      auto joint = name2joint.at(name);
+      if (!joint || !joint->mimic) {
+        continue;
+      }
+      auto mimicIt = std::find_if(order.begin(), order.end(), [&](auto &n) {
+        return name2joint.at(n) && name2joint.at(n)->name == joint->mimic->joint;
+      });
+      if (mimicIt == order.end()) {
+        throw std::runtime_error("failed to load URDF: failed to find mimic joint " +
+                                 joint->mimic->joint);
+      }
+      auto mimicJoint = name2joint.at(*mimicIt);
+      float multiplier = joint->mimic->multiplier;
+      float offset = joint->mimic->offset;
+      auto parent = name2link.at(joint->parent);
+      auto child = name2link.at(name);
+
+      // joint mimics parent
+      if (joint->parent == mimicJoint->child) {
+        if (!parent->getParent()) {
+          // tendon must be attached to grandparent
+          continue;
+        }
+        articulation->createFixedTendon({parent->getParent(), parent, child},
+                                        {0.f, -multiplier, 1.f}, {0.f, -1.f / multiplier, 1.f},
+                                        offset, 0.f, 1e5f, 0.f, -PX_MAX_F32, PX_MAX_F32, 0.f);
+      }
+      // 2 children mimic each other
+      if (joint->parent == mimicJoint->parent) {
+        articulation->createFixedTendon({parent, child, name2link.at(mimicJoint->child)},
+                                        {0.f, -multiplier, 1.f}, {0.f, -1.f / multiplier, 1.f},
+                                        offset, 0.f, 1e5f, 0.f, -PX_MAX_F32, PX_MAX_F32, 0.f);
+      }
+    }
+
+    articulationEntities.insert(articulationEntities.end(), entities.begin(), entities.end());
+    articulations.push_back(articulation);
+  }
+
+  for (auto &root : roots) {
+    if (!childJoints.at(root).empty()) {
+      continue;
+    }
+    auto &link = robot.getLink(root);
+    auto entity = std::make_shared<Entity>();
+    if (auto body = buildVisuals(link)) {
+      entity->addComponent(body);
+    }
+    auto component = std::make_shared<PhysxRigidDynamicComponent>();
+    buildCollisions(link, *component, {1, 1, 0, 0});
+    component->setName(root);
+    entity->addComponent(component);
+    entity->setName(root);
+
+    auto joint = robot.getParentJoint(root);
+    if (joint && joint->type == "floating") {
+      Pose pose = joint->origin;
+      pose.p = pose.p * mScale;
+      entity->setPose(pose);
+    }
+    name2entity[root] = entity;
+    actors.push_back(entity);
+  }
+
+  for (auto &e : articulationEntities) {
+    mScene->addEntity(e);
+  }
+  for (auto &e : actors) {
+    mScene->addEntity(e);
+  }
+
+  for (auto &c : robot.cameras) {
+    auto it = name2entity.find(c.parent);
+    if (it == name2entity.end()) {
+      throw std::runtime_error("failed to load URDF: camera is attached to unknown link " +
+                               c.parent);
+    }
+    auto camera = std::make_shared<SapienRenderCameraComponent>(c.width, c.height, "");
+    if (c.fovx && c.fovy) {
+      camera->setFovX(*c.fovx, false);
+      camera->setFovY(*c.fovy, false);
+    } else if (c.fovx) {
+      camera->setFovX(*c.fovx, true);
+    } else {
+      camera->setFovY(*c.fovy, true);
+    }
+    camera->setNear(c.near);
+    camera->setFar(c.far);
+    camera->setLocalPose(c.pose);
+    it->second->addComponent(camera);
+  }
+
+  return {articulations, actors};
+}
+
+std::shared_ptr<URDFDescription const> URDFLoader::readDescription(
+    std::string const &urdfFile, std::string const &srdfFile,
+    std::string const &packageDir) const {
+  if (mUseCache) {
+    return URDFCache::Get()->load(urdfFile, srdfFile, packageDir);
+  }
+  return URDFCache::Read(urdfFile, srdfFile, packageDir);
+}
+
+std::tuple<std::vector<std::shared_ptr<PhysxArticulation>>, std::vector<std::shared_ptr<Entity>>>
+URDFLoader::loadMultiple(std::string const &urdfFile, std::string const &srdfFile,
+                         std::string const &packageDir) {
+  SAPIEN_PROFILE_FUNCTION;
+  auto description = readDescription(urdfFile, srdfFile, packageDir);
+  return loadRobot(description->robot, description->ignorePairs);
+}
+
+std::shared_ptr<PhysxArticulation> URDFLoader::load(std::string const &urdfFile,
+                                                     std::string const &srdfFile,
+                                                     std::string const &packageDir) {
+  SAPIEN_PROFILE_FUNCTION;
+  auto description = readDescription(urdfFile, srdfFile, packageDir);
+
+  std::map<std::string, std::vector<URDFJoint const *>> childJoints;
+  auto roots = FindRoots(description->robot, childJoints);
+  if (roots.size() != 1 || childJoints.at(roots[0]).empty()) {
+    throw std::runtime_error("URDF contains multiple objects, call loadMultiple instead");
+  }
+  return std::get<0>(loadRobot(description->robot, description->ignorePairs)).at(0);
+}
+
+} // namespace urdf
+} // namespace sapien
@@ -0,0 +1,457 @@
+#include "sapien/utils/frame_recorder.h"
+#include "sapien/utils/typestr.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <zlib.h>
+
+namespace sapien {
+
+static CpuArray CopyContiguous(CpuArrayHandle const &image) {
+  CpuArray array(image.shape, image.type);
+  if (image.isContiguous()) {
+    std::memcpy(array.ptr(), image.ptr, array.bytes());
+    return array;
+  }
+
+  // copy rows of the innermost dimension, walking the outer dimensions like an odometer
+  int elemSize = typestrBytes(image.type);
+  int dims = image.shape.size();
+  int rowBytes = image.shape.back() * elemSize;
+  bool packedRow = image.strides.back() == elemSize;
+  std::vector<int> index(dims, 0);
+  auto dst = static_cast<char *>(array.ptr());
+  for (int offset = 0; offset < array.bytes(); offset += rowBytes) {
+    auto src = static_cast<char const *>(image.ptr);
+    for (int d = 0; d + 1 < dims; ++d) {
+      src += index[d] * image.strides[d];
+    }
+    if (packedRow) {
+      std::memcpy(dst + offset, src, rowBytes);
+    } else {
+      for (int i = 0; i < image.shape.back(); ++i) {
+        std::memcpy(dst + offset + i * elemSize, src + i * image.strides.back(), elemSize);
+      }
+    }
+    for (int d = dims - 2; d >= 0 && ++index[d] == image.shape[d]; --d) {
+      index[d] = 0;
+    }
+  }
+  return array;
+}
+
+////////// encoders //////////
+
+template <typename T> static void Append(std::vector<char> &out, T value) {
+  size_t n = out.size();
+  out.resize(n + sizeof(T));
+  std::memcpy(out.data() + n, &value, sizeof(T));
+}
+
+static void AppendBigEndian(std::vector<char> &out, uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<char>((value >> shift) & 0xff));
+  }
+}
+
+static void AppendString(std::vector<char> &out, std::string const &s) {
+  out.insert(out.end(), s.begin(), s.end());
+}
+
+static void WriteFile(std::filesystem::path const &path, std::vector<char> const &data) {
+  std::ofstream f(path, std::ios::binary);
+  f.write(data.data(), data.size());
+  if (!f) {
+    throw std::runtime_error("failed to write file: " + path.string());
+  }
+}
+
+static std::array<int, 3> ImageSize(CpuArray const &image) {
+  return {image.shape.at(0), image.shape.at(1), image.shape.size() == 3 ? image.shape[2] : 1};
+}
+
+static void AppendPngChunk(std::vector<char> &out, char const *type,
+                           std::vector<char> const &data) {
+  AppendBigEndian(out, data.size());
+  size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  uLong crc = crc32(0, reinterpret_cast<Bytef const *>(out.data() + start), out.size() - start);
+  AppendBigEndian(out, crc);
+}
+
+static std::vector<char> EncodePng(CpuArray const &image) {
+  auto [height, width, channels] = ImageSize(image);
+  char code = typestrCode(image.type);
+  int elemSize = typestrBytes(image.type);
+  bool quantize = code == 'f' && elemSize == 4;
+  if (!(code == 'u' && (elemSize == 1 || elemSize == 2)) && !quantize) {
+    throw std::runtime_error("failed to encode PNG: unsupported type " + image.type);
+  }
+  if (channels < 1 || channels > 4) {
+    throw std::runtime_error("failed to encode PNG: unsupported channel count " +
+                             std::to_string(channels));
+  }
+  int depth = quantize ? 1 : elemSize;
+  size_t rowBytes = static_cast<size_t>(width) * channels * depth;
+
+  // every row uses the "up" filter, samples are big endian
+  std::vector<uint8_t> raw((rowBytes + 1) * height);
+  std::vector<uint8_t> row(rowBytes), previous(rowBytes, 0);
+  for (int y = 0; y < height; ++y) {
+    size_t count = static_cast<size_t>(width) * channels;
+    if (quantize) {
+      auto src = static_cast<float const *>(image.ptr()) + y * count;
+      for (size_t i = 0; i < count; ++i) {
+        row[i] = static_cast<uint8_t>(std::lround(std::clamp(src[i], 0.f, 1.f) * 255.f));
+      }
+    } else if (depth == 1) {
+      std::memcpy(row.data(), static_cast<uint8_t const *>(image.ptr()) + y * count, count);
+    } else {
+      auto src = static_cast<uint16_t const *>(image.ptr()) + y * count;
+      for (size_t i = 0; i < count; ++i) {
+        row[2 * i] = src[i] >> 8;
+        row[2 * i + 1] = src[i] & 0xff;
+      }
+    }
+    uint8_t *dst = raw.data() + y * (rowBytes + 1);
+    dst[0] = 2;
+    for (size_t i = 0; i < rowBytes; ++i) {
+      dst[i + 1] = row[i] - previous[i];
+    }
+    std::swap(row, previous);
+  }
+
+  uLongf compressedSize = compressBound(raw.size());
+  std::vector<char> compressed(compressedSize);
+  // favor throughput, dataset images are written far more often than read
+  if (compress2(reinterpret_cast<Bytef *>(compressed.data()), &compressedSize, raw.data(),
+                raw.size(), Z_BEST_SPEED) != Z_OK) {
+    throw std::runtime_error("failed to encode PNG: compression failed");
+  }
+  compressed.resize(compressedSize);
+
+  static constexpr uint8_t ColorTypes[5] = {0, 0, 4, 2, 6};
+  std::vector<char> header;
+  AppendBigEndian(header, width);
+  AppendBigEndian(header, height);
+  header.push_back(static_cast<char>(depth * 8));
+  header.push_back(static_cast<char>(ColorTypes[channels]));
+  header.insert(header.end(), {0, 0, 0});
+
+  std::vector<char> out{'\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n'};
+  AppendPngChunk(out, "IHDR", header);
+  AppendPngChunk(out, "IDAT", compressed);
+  AppendPngChunk(out, "IEND", {});
+  return out;
+}
+
+static void AppendExrAttribute(std::vector<char> &out, std::string const &name,
+                               std::string const &type, std::vector<char> const &value) {
+  AppendString(out, name);
+  out.push_back(0);
+  AppendString(out, type);
+  out.push_back(0);
+  Append<int32_t>(out, value.size());
+  out.insert(out.end(), value.begin(), value.end());
+}
+
+static std::vector<char> EncodeExr(CpuArray const &image) {
+  auto [height, width, channels] = ImageSize(image);
+  char code = typestrCode(image.type);
+  if (typestrBytes(image.type) != 4 || (code != 'f' && code != 'u' && code != 'i')) {
+    throw std::runtime_error("failed to encode EXR: unsupported type " + image.type);
+  }
+  int32_t pixelType = code == 'f' ? 2 : 0;
+
+  // channels are listed and stored in alphabetical order
+  std::vector<std::pair<std::string, int>> names;
+  switch (channels) {
+  case 1:
+    names = {{"Y", 0}};
+    break;
+  case 2:
+    names = {{"A", 1}, {"Y", 0}};
+    break;
+  case 3:
+    names = {{"B", 2}, {"G", 1}, {"R", 0}};
+    break;
+  case 4:
+    names = {{"A", 3}, {"B", 2}, {"G", 1}, {"R", 0}};
+    break;
+  default:
+    throw std::runtime_error("failed to encode EXR: unsupported channel count " +
+                             std::to_string(channels));
+  }
+
+  std::vector<char> out;
+  Append<uint32_t>(out, 20000630);
+  Append<uint32_t>(out, 2);
+
+  std::vector<char> channelList;
+  for (auto &[name, index] : names) {
+    AppendString(channelList, name);
+    channelList.push_back(0);
+    Append<int32_t>(channelList, pixelType);
+    Append<uint32_t>(channelList, 0); // pLinear and reserved
+    Append<int32_t>(channelList, 1);
+    Append<int32_t>(channelList, 1);
+  }
+  channelList.push_back(0);
+  AppendExrAttribute(out, "channels", "chlist", channelList);
+  AppendExrAttribute(out, "compression", "compression", {0});
+  std::vector<char> window;
+  for (int32_t v : {0, 0, width - 1, height - 1}) {
+    Append<int32_t>(window, v);
+  }
+  AppendExrAttribute(out, "dataWindow", "box2i", window);
+  AppendExrAttribute(out, "displayWindow", "box2i", window);
+  AppendExrAttribute(out, "lineOrder", "lineOrder", {0});
+  std::vector<char> one, center;
+  Append<float>(one, 1.f);
+  Append<float>(center, 0.f);
+  Append<float>(center, 0.f);
+  AppendExrAttribute(out, "pixelAspectRatio", "float", one);
+  AppendExrAttribute(out, "screenWindowCenter", "v2f", center);
+  AppendExrAttribute(out, "screenWindowWidth", "float", one);
+  out.push_back(0);
+
+  int32_t lineBytes = width * channels * 4;
+  uint64_t offset = out.size() + height * sizeof(uint64_t);
+  for (int y = 0; y < height; ++y) {
+    Append<uint64_t>(out, offset + y * (8ull + lineBytes));
+  }
+  auto pixels = static_cast<uint32_t const *>(image.ptr());
+  for (int32_t y = 0; y < height; ++y) {
+    Append<int32_t>(out, y);
+    Append<int32_t>(out, lineBytes);
+    for (auto &[name, index] : names) {
+      for (int x = 0; x < width; ++x) {
+        Append<uint32_t>(out, pixels[(static_cast<size_t>(y) * width + x) * channels + index]);
+      }
+    }
+  }
+  return out;
+}
+
+static std::vector<char> EncodeNpy(CpuArray const &image) {
+  std::string descr = image.type;
+  if (descr[0] != '<' && descr[0] != '>' && descr[0] != '|') {
+    descr = (typestrBytes(descr) == 1 ? "|" : "<") + descr;
+  }
+  std::string shape;
+  for (auto s : image.shape) {
+    shape += std::to_string(s) + ", ";
+  }
+  if (image.shape.size() > 1) {
+    shape.resize(shape.size() - 2);
+  }
+  std::string header = "{'descr': '" + descr + "', 'fortran_order': False, 'shape': (" + shape +
+                       "), }";
+  // magic, version and header length take 10 bytes, the data starts 64 byte aligned
+  header.resize(((10 + header.size() + 1 + 63) / 64) * 64 - 10 - 1, ' ');
+  header.push_back('\n');
+
+  std::vector<char> out{'\x93', 'N', 'U', 'M', 'P', 'Y', 1, 0};
+  Append<uint16_t>(out, header.size());
+  AppendString(out, header);
+  auto data = static_cast<char const *>(image.ptr());
+  out.insert(out.end(), data, data + image.bytes());
+  return out;
+}
+
+////////// recorder //////////
+
+FrameRecorder::FrameRecorder(std::string directory, Format format, uint32_t threadCount,
+                             uint32_t maxQueuedFrames)
+    : mDirectory(directory), mFormat(format), mMaxQueuedFrames(std::max(maxQueuedFrames, 1u)) {
+  std::filesystem::create_directories(mDirectory);
+  threadCount = threadCount ? threadCount : std::thread::hardware_concurrency();
+  for (uint32_t i = 0; i < std::max(threadCount, 1u); ++i) {
+    mThreads.emplace_back([this]() { work(); });
+  }
+}
+
+void FrameRecorder::addImage(std::string const &name, uint64_t frame,
+                             CpuArrayHandle const &image) {
+  rethrow();
+  if (image.shape.size() == 4) {
+    for (int i = 0; i < image.shape[0]; ++i) {
+      CpuArrayHandle slice{.shape = {image.shape.begin() + 1, image.shape.end()},
+                           .strides = {image.strides.begin() + 1, image.strides.end()},
+                           .type = image.type,
+                           .ptr = static_cast<char *>(image.ptr) + i * image.strides[0]};
+      addImage(name + "_" + std::to_string(i), frame, slice);
+    }
+    return;
+  }
+  if (image.shape.size() != 2 && image.shape.size() != 3) {
+    throw std::runtime_error("failed to record frame: image must be [H, W] or [H, W, C]");
+  }
+
+  // copy before waiting so the caller's buffer is not needed while blocked
+  Job job{name, frame, CopyContiguous(image), 0};
+  {
+    std::unique_lock lock(mMutex);
+    mJobTaken.wait(lock, [this]() { return mJobs.size() < mMaxQueuedFrames; });
+    if (mFormat == Format::eBIN) {
+      auto &c = mContainers[name];
+      if (!c) {
+        c = std::make_unique<Container>();
+      }
+      job.sequence = c->queued++;
+    }
+    mJobs.push_back(std::move(job));
+  }
+  mJobAdded.notify_one();
+}
+
+void FrameRecorder::flush() {
+  {
+    std::unique_lock lock(mMutex);
+    mJobDone.wait(lock, [this]() { return mJobs.empty() && mActiveJobs == 0; });
+  }
+  rethrow();
+}
+
+uint32_t FrameRecorder::getQueuedFrameCount() {
+  std::lock_guard lock(mMutex);
+  return mJobs.size() + mActiveJobs;
+}
+
+uint64_t FrameRecorder::getWrittenFrameCount() {
+  std::lock_guard lock(mMutex);
+  return mWrittenFrames;
+}
+
+void FrameRecorder::rethrow() {
+  std::exception_ptr error;
+  {
+    std::lock_guard lock(mMutex);
+    std::swap(error, mError);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void FrameRecorder::work() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock lock(mMutex);
+      mJobAdded.wait(lock, [this]() { return mStopping || !mJobs.empty(); });
+      // queued images are still written after stopping
+      if (mJobs.empty()) {
+        return;
+      }
+      job = std::move(mJobs.front());
+      mJobs.pop_front();
+      mActiveJobs++;
+    }
+    mJobTaken.notify_one();
+
+    bool written = false;
+    std::exception_ptr error;
+    try {
+      write(job);
+      written = true;
+    } catch (...) {
+      error = std::current_exception();
+    }
+    {
+      std::lock_guard lock(mMutex);
+      mActiveJobs--;
+      mWrittenFrames += written;
+      if (error && !mError) {
+        mError = error;
+      }
+    }
+    mJobDone.notify_all();
+  }
+}
+
+void FrameRecorder::write(Job const &job) {
+  std::filesystem::path directory(mDirectory);
+
+  if (mFormat == Format::eBIN) {
+    std::vector<char> record;
+    Append<uint64_t>(record, job.frame);
+    Append<uint32_t>(record, job.image.type.size());
+    AppendString(record, job.image.type);
+    Append<uint32_t>(record, job.image.shape.size());
+    for (auto s : job.image.shape) {
+      Append<uint32_t>(record, s);
+    }
+    auto data = static_cast<char const *>(job.image.ptr());
+
+    Container *container;
+    {
+      std::lock_guard lock(mMutex);
+      container = mContainers.at(job.name).get();
+    }
+
+    // jobs are taken in queue order, so the records before this one are already being written
+    // and waiting for them cannot deadlock
+    std::unique_lock lock(container->mutex);
+    container->written.wait(lock, [&]() { return container->next == job.sequence; });
+    if (job.sequence == 0) {
+      container->file.open(directory / (job.name + ".bin"), std::ios::binary | std::ios::trunc);
+    }
+    container->file.write(record.data(), record.size());
+    container->file.write(data, job.image.bytes());
+    container->file.flush();
+    bool failed = !container->file;
+    container->next++;
+    lock.unlock();
+    container->written.notify_all();
+    if (failed) {
+      throw std::runtime_error("failed to write frame container: " + job.name + ".bin");
+    }
+    return;
+  }
+
+  std::vector<char> encoded;
+  char const *extension{};
+  switch (mFormat) {
+  case Format::ePNG:
+    encoded = EncodePng(job.image);
+    extension = ".png";
+    break;
+  case Format::eEXR:
+    encoded = EncodeExr(job.image);
+    extension = ".exr";
+    break;
+  case Format::eNPY:
+    encoded = EncodeNpy(job.image);
+    extension = ".npy";
+    break;
+  case Format::eBIN:
+    break;
+  }
+
+  std::filesystem::path streamDirectory = directory / job.name;
+  std::error_code ec;
+  std::filesystem::create_directories(streamDirectory, ec);
+  char filename[32];
+  std::snprintf(filename, sizeof(filename), "%06llu",
+                static_cast<unsigned long long>(job.frame));
+  WriteFile(streamDirectory / (filename + std::string(extension)), encoded);
+}
+
+FrameRecorder::~FrameRecorder() {
+  {
+    std::lock_guard lock(mMutex);
+    mStopping = true;
+  }
+  mJobAdded.notify_all();
+  for (auto &t : mThreads) {
+    t.join();
+  }
+}
+
+} // namespace sapien
@@ -0,0 +1,104 @@
+#include "sapien/utils/thread_pool.h"
+#include <algorithm>
+
+namespace sapien {
+
+ThreadPool &ThreadPool::Get() {
+  // the calling thread takes part in every loop, so one core is left for it
+  static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+  return pool;
+}
+
+ThreadPool::ThreadPool(uint32_t workerCount) {
+  for (uint32_t i = 0; i < workerCount; ++i) {
+    mThreads.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(mMutex);
+    mStopping = true;
+  }
+  mJobAdded.notify_all();
+  for (auto &t : mThreads) {
+    t.join();
+  }
+}
+
+void ThreadPool::run(Job &job) {
+  for (uint32_t task = job.nextTask++; task < job.taskCount; task = job.nextTask++) {
+    try {
+      (*job.f)(task);
+    } catch (...) {
+      std::lock_guard lock(job.mutex);
+      if (!job.error) {
+        job.error = std::current_exception();
+      }
+    }
+    if (++job.doneTasks == job.taskCount) {
+      std::lock_guard lock(job.mutex);
+      job.done.notify_all();
+    }
+  }
+}
+
+void ThreadPool::work() {
+  std::unique_lock lock(mMutex);
+  while (true) {
+    mJobAdded.wait(lock, [this] { return mStopping || !mJobs.empty(); });
+    if (mStopping) {
+      return;
+    }
+    auto job = mJobs.front();
+    if (++job->helpers == job->helperLimit) {
+      mJobs.pop_front();
+    }
+    lock.unlock();
+    run(*job);
+    lock.lock();
+  }
+}
+
+void ThreadPool::parallelFor(uint32_t taskCount, uint32_t maxThreads,
+                             std::function<void(uint32_t)> const &f) {
+  if (taskCount == 0) {
+    return;
+  }
+  uint32_t threads = maxThreads ? maxThreads : getWorkerCount() + 1;
+  uint32_t helperLimit = std::min({threads, taskCount, getWorkerCount() + 1}) - 1;
+  if (helperLimit == 0) {
+    for (uint32_t task = 0; task < taskCount; ++task) {
+      f(task);
+    }
+    return;
+  }
+
+  auto job = std::make_shared<Job>();
+  job->f = &f;
+  job->taskCount = taskCount;
+  job->helperLimit = helperLimit;
+  {
+    std::lock_guard lock(mMutex);
+    mJobs.push_back(job);
+  }
+  if (helperLimit == 1) {
+    mJobAdded.notify_one();
+  } else {
+    mJobAdded.notify_all();
+  }
+
+  run(*job);
+  {
+    // workers that have not picked up the job yet are no longer needed
+    std::lock_guard lock(mMutex);
+    std::erase(mJobs, job);
+  }
+  std::unique_lock lock(job->mutex);
+  job->done.wait(lock, [&] { return job->doneTasks == job->taskCount; });
+  if (job->error) {
+    std::rethrow_exception(job->error);
+  }
+}
+
+} // namespace sapien
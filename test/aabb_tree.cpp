@@ -0,0 +1,90 @@
+#include "sapien/math/aabb_tree.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+using namespace sapien;
+
+static AABB RandomBox(std::mt19937 &gen) {
+  std::uniform_real_distribution<float> pos(-10.f, 10.f);
+  std::uniform_real_distribution<float> size(0.01f, 1.f);
+  Vec3 lower(pos(gen), pos(gen), pos(gen));
+  return {lower, lower + Vec3(size(gen), size(gen), size(gen))};
+}
+
+static std::set<uint32_t> QueryBox(AABBTree const &tree, AABB const &box) {
+  std::set<uint32_t> result;
+  tree.query([&](AABB const &b) { return overlapsAABB(b, box); },
+             [&](uint32_t data) { result.insert(data); });
+  return result;
+}
+
+TEST(AABBTree, Query) {
+  std::mt19937 gen(0);
+  AABBTree tree;
+  std::vector<AABB> boxes;
+  std::vector<int32_t> leaves;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    boxes.push_back(RandomBox(gen));
+    leaves.push_back(tree.insert(boxes.back(), i));
+  }
+
+  // move half of the boxes and remove a quarter
+  std::set<uint32_t> removed;
+  for (uint32_t i = 0; i < 1000; i += 2) {
+    boxes[i] = RandomBox(gen);
+    tree.move(leaves[i], boxes[i]);
+  }
+  for (uint32_t i = 1; i < 1000; i += 4) {
+    tree.remove(leaves[i]);
+    removed.insert(i);
+  }
+  EXPECT_EQ(tree.getLeafCount(), 750);
+  // balanced tree of 750 leaves
+  EXPECT_LE(tree.getHeight(), 20);
+
+  for (uint32_t q = 0; q < 50; ++q) {
+    AABB query = RandomBox(gen);
+    query.upper = query.upper + Vec3(2.f);
+    std::set<uint32_t> expected;
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+      if (!removed.contains(i) && overlapsAABB(boxes[i], query)) {
+        expected.insert(i);
+      }
+    }
+    EXPECT_EQ(QueryBox(tree, query), expected);
+  }
+}
+
+TEST(AABBTree, Nearest) {
+  std::mt19937 gen(1);
+  AABBTree tree;
+  std::vector<AABB> boxes;
+  for (uint32_t i = 0; i < 500; ++i) {
+    boxes.push_back(RandomBox(gen));
+    tree.insert(boxes.back(), i);
+  }
+
+  Vec3 point(0.5f, -1.f, 2.f);
+  auto result =
+      tree.nearest(point, 10, [&](uint32_t i) { return distance2ToAABB(boxes[i], point); });
+  ASSERT_EQ(result.size(), 10);
+
+  std::vector<float> distances;
+  for (auto &b : boxes) {
+    distances.push_back(distance2ToAABB(b, point));
+  }
+  std::sort(distances.begin(), distances.end());
+  for (uint32_t i = 0; i < 10; ++i) {
+    EXPECT_FLOAT_EQ(result[i].second, distances[i]);
+  }
+}
+
+TEST(AABBTree, Planes) {
+  AABB box{{0.f, 0.f, 0.f}, {1.f, 1.f, 1.f}};
+  // x >= 0.5
+  EXPECT_FALSE(isAABBOutsidePlanes(box, {{1.f, 0.f, 0.f, -0.5f}}));
+  // x >= 2
+  EXPECT_TRUE(isAABBOutsidePlanes(box, {{1.f, 0.f, 0.f, -2.f}}));
+  // x <= -1
+  EXPECT_TRUE(isAABBOutsidePlanes(box, {{-1.f, 0.f, 0.f, -1.f}}));
+}
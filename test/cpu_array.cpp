@@ -0,0 +1,47 @@
+#include "sapien/array.h"
+#include <dlpack/dlpack.h>
+#include <gtest/gtest.h>
+using namespace sapien;
+
+TEST(CpuArray, Pool) {
+  auto pool = std::make_shared<CpuArrayPool>();
+  void *first;
+  {
+    auto block = pool->allocate(1000);
+    first = block.get();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % 64, 0);
+    EXPECT_EQ(pool->getPooledBytes(), 0);
+  }
+  EXPECT_EQ(pool->getPooledBytes(), 1024);
+
+  // same size class reuses the block
+  auto block = pool->allocate(700);
+  EXPECT_EQ(block.get(), first);
+  EXPECT_EQ(pool->getPooledBytes(), 0);
+
+  pool->setMaxPooledBytes(0);
+  block.reset();
+  EXPECT_EQ(pool->getPooledBytes(), 0);
+}
+
+TEST(CpuArray, DLPack) {
+  CpuArray array({4, 3}, "f4");
+  ASSERT_EQ(array.bytes(), 48);
+  std::weak_ptr<void> weak = array.data;
+
+  auto handle = array.handle();
+  EXPECT_TRUE(handle.isContiguous());
+  auto tensor = handle.toDLPack();
+  array = CpuArray();
+  handle = CpuArrayHandle();
+  EXPECT_FALSE(weak.expired());
+
+  EXPECT_EQ(tensor->dl_tensor.device.device_type, kDLCPU);
+  EXPECT_EQ(tensor->dl_tensor.ndim, 2);
+  EXPECT_EQ(tensor->dl_tensor.shape[0], 4);
+  EXPECT_EQ(tensor->dl_tensor.strides[0], 3);
+  EXPECT_EQ(tensor->dl_tensor.dtype.code, kDLFloat);
+
+  tensor->deleter(tensor);
+  EXPECT_TRUE(weak.expired());
+}
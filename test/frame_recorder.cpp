@@ -0,0 +1,118 @@
+#include "sapien/utils/frame_recorder.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <zlib.h>
+using namespace sapien;
+
+static std::vector<char> ReadFile(std::filesystem::path const &path) {
+  std::ifstream f(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+}
+
+static uint32_t ReadBigEndian(char const *p) {
+  auto u = reinterpret_cast<uint8_t const *>(p);
+  return (u[0] << 24) | (u[1] << 16) | (u[2] << 8) | u[3];
+}
+
+class FrameRecorderTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    mDirectory = std::filesystem::temp_directory_path() /
+                 ("sapien_frame_recorder_" + std::to_string(::testing::UnitTest::GetInstance()
+                                                                ->current_test_info()
+                                                                ->line()));
+    std::filesystem::remove_all(mDirectory);
+  }
+  void TearDown() override { std::filesystem::remove_all(mDirectory); }
+
+  std::filesystem::path mDirectory;
+};
+
+TEST_F(FrameRecorderTest, Png) {
+  // 3 x 2 RGB image, viewed with a row stride larger than the row
+  std::vector<uint8_t> pixels(3 * 8 * 3);
+  for (uint32_t i = 0; i < pixels.size(); ++i) {
+    pixels[i] = i * 7;
+  }
+  CpuArrayHandle image{
+      .shape = {3, 2, 3}, .strides = {24, 3, 1}, .type = "u1", .ptr = pixels.data()};
+  {
+    FrameRecorder recorder(mDirectory.string(), FrameRecorder::Format::ePNG, 2, 1);
+    for (uint64_t frame = 0; frame < 8; ++frame) {
+      recorder.addImage("color", frame, image);
+    }
+    recorder.flush();
+    EXPECT_EQ(recorder.getWrittenFrameCount(), 8);
+    EXPECT_EQ(recorder.getQueuedFrameCount(), 0);
+  }
+
+  auto png = ReadFile(mDirectory / "color" / "000007.png");
+  ASSERT_GT(png.size(), 33);
+  EXPECT_EQ(std::string(png.data() + 1, 3), "PNG");
+  EXPECT_EQ(std::string(png.data() + 12, 4), "IHDR");
+  EXPECT_EQ(ReadBigEndian(png.data() + 16), 2);
+  EXPECT_EQ(ReadBigEndian(png.data() + 20), 3);
+
+  // inflate IDAT and undo the filters
+  uint32_t idatSize = ReadBigEndian(png.data() + 33);
+  EXPECT_EQ(std::string(png.data() + 37, 4), "IDAT");
+  std::vector<uint8_t> raw(3 * (1 + 6));
+  uLongf rawSize = raw.size();
+  ASSERT_EQ(
+      uncompress(raw.data(), &rawSize, reinterpret_cast<Bytef *>(png.data() + 41), idatSize),
+      Z_OK);
+  ASSERT_EQ(rawSize, raw.size());
+  std::vector<uint8_t> previous(6, 0);
+  for (int y = 0; y < 3; ++y) {
+    ASSERT_EQ(raw[y * 7], 2);
+    for (int i = 0; i < 6; ++i) {
+      previous[i] += raw[y * 7 + 1 + i];
+      EXPECT_EQ(previous[i], pixels[y * 24 + i]);
+    }
+  }
+}
+
+TEST_F(FrameRecorderTest, NpyAndBin) {
+  std::vector<float> depth{0.f, 1.f, 2.f, 3.f, 4.f, 5.f};
+  CpuArrayHandle image{.shape = {2, 3}, .strides = {12, 4}, .type = "f4", .ptr = depth.data()};
+  {
+    FrameRecorder npy(mDirectory.string(), FrameRecorder::Format::eNPY);
+    FrameRecorder bin(mDirectory.string(), FrameRecorder::Format::eBIN, 4);
+    npy.addImage("depth", 3, image);
+    for (uint64_t frame = 3; frame < 67; ++frame) {
+      bin.addImage("depth", frame, image);
+    }
+  }
+
+  auto npy = ReadFile(mDirectory / "depth" / "000003.npy");
+  ASSERT_EQ(npy.size(), 128 + depth.size() * 4);
+  std::string header(npy.data() + 10, 118);
+  EXPECT_NE(header.find("'descr': '<f4'"), std::string::npos);
+  EXPECT_NE(header.find("'shape': (2, 3)"), std::string::npos);
+  EXPECT_EQ(header.back(), '\n');
+  EXPECT_EQ(std::memcmp(npy.data() + 128, depth.data(), depth.size() * 4), 0);
+
+  // frame, typestr length, typestr, dimension count, dimensions, data
+  uint32_t recordSize = 8 + 4 + 2 + 4 + 8 + 24;
+  auto bin = ReadFile(mDirectory / "depth.bin");
+  ASSERT_EQ(bin.size(), 64 * recordSize);
+  // records of a stream keep the order they were added in, even with several workers
+  for (uint64_t i = 0; i < 64; ++i) {
+    uint64_t frame;
+    std::memcpy(&frame, bin.data() + i * recordSize, 8);
+    EXPECT_EQ(frame, i + 3);
+  }
+  EXPECT_EQ(std::memcmp(bin.data() + recordSize - 24, depth.data(), 24), 0);
+}
+
+TEST_F(FrameRecorderTest, Error) {
+  std::vector<double> data(4);
+  CpuArrayHandle image{.shape = {2, 2}, .strides = {16, 8}, .type = "f8", .ptr = data.data()};
+  FrameRecorder recorder(mDirectory.string(), FrameRecorder::Format::ePNG, 1);
+  recorder.addImage("bad", 0, image);
+  EXPECT_THROW(recorder.flush(), std::runtime_error);
+  EXPECT_EQ(recorder.getWrittenFrameCount(), 0);
+  EXPECT_NO_THROW(recorder.flush());
+}
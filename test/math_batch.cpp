@@ -0,0 +1,137 @@
+#include "sapien/math/batch.h"
+#include "sapien/math/bounding_box.h"
+#include "sapien/math/conversion.h"
+#include <gtest/gtest.h>
+#include <random>
+using namespace sapien;
+
+static Pose RandomPose(std::mt19937 &gen) {
+  std::uniform_real_distribution<float> dis(-1.f, 1.f);
+  return {{dis(gen), dis(gen), dis(gen)},
+          Quat(dis(gen), dis(gen), dis(gen), dis(gen)).getNormalized()};
+}
+
+static std::vector<float> PoseArray(std::vector<Pose> const &poses) {
+  std::vector<float> result;
+  for (auto &pose : poses) {
+    result.insert(result.end(), {pose.p.x, pose.p.y, pose.p.z, pose.q.w, pose.q.x, pose.q.y,
+                                 pose.q.z});
+  }
+  return result;
+}
+
+static void ExpectPoseNear(float const *a, Pose const &b) {
+  EXPECT_NEAR(a[0], b.p.x, 1e-5);
+  EXPECT_NEAR(a[1], b.p.y, 1e-5);
+  EXPECT_NEAR(a[2], b.p.z, 1e-5);
+  // q and -q are the same rotation
+  float dot = a[3] * b.q.w + a[4] * b.q.x + a[5] * b.q.y + a[6] * b.q.z;
+  EXPECT_NEAR(std::abs(dot), 1.f, 1e-5);
+}
+
+TEST(MathBatch, TransformPoints) {
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dis(-5.f, 5.f);
+  Pose pose = RandomPose(gen);
+  Vec3 scale(0.5f, 2.f, 1.5f);
+
+  // odd count covers both the vector and the scalar tail
+  uint32_t count = 101;
+  std::vector<float> points(count * 3);
+  for (auto &v : points) {
+    v = dis(gen);
+  }
+  std::vector<float> result(count * 3);
+  transformPoints(pose, scale, points.data(), result.data(), count);
+
+  Vec3 lower(std::numeric_limits<float>::infinity());
+  Vec3 upper(-std::numeric_limits<float>::infinity());
+  for (uint32_t i = 0; i < count; ++i) {
+    Vec3 p(points[3 * i], points[3 * i + 1], points[3 * i + 2]);
+    Vec3 expected = pose * (p * scale);
+    EXPECT_NEAR(result[3 * i], expected.x, 1e-4);
+    EXPECT_NEAR(result[3 * i + 1], expected.y, 1e-4);
+    EXPECT_NEAR(result[3 * i + 2], expected.z, 1e-4);
+    lower = {std::min(lower.x, expected.x), std::min(lower.y, expected.y),
+             std::min(lower.z, expected.z)};
+    upper = {std::max(upper.x, expected.x), std::max(upper.y, expected.y),
+             std::max(upper.z, expected.z)};
+  }
+
+  Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>> vertices(points.data(),
+                                                                               count, 3);
+  AABB aabb = computeAABB(vertices, scale, pose);
+  EXPECT_NEAR(aabb.lower.x, lower.x, 1e-4);
+  EXPECT_NEAR(aabb.lower.y, lower.y, 1e-4);
+  EXPECT_NEAR(aabb.lower.z, lower.z, 1e-4);
+  EXPECT_NEAR(aabb.upper.x, upper.x, 1e-4);
+  EXPECT_NEAR(aabb.upper.y, upper.y, 1e-4);
+  EXPECT_NEAR(aabb.upper.z, upper.z, 1e-4);
+
+  // in place
+  transformPoints(pose, scale, points.data(), points.data(), count);
+  for (uint32_t i = 0; i < count * 3; ++i) {
+    EXPECT_FLOAT_EQ(points[i], result[i]);
+  }
+}
+
+TEST(MathBatch, Poses) {
+  std::mt19937 gen(1);
+  std::vector<Pose> a, b;
+  for (uint32_t i = 0; i < 11; ++i) {
+    a.push_back(RandomPose(gen));
+    b.push_back(RandomPose(gen));
+  }
+  auto arrayA = PoseArray(a);
+  auto arrayB = PoseArray(b);
+  std::vector<float> out(arrayA.size());
+
+  composePoses(arrayA.data(), a.size(), arrayB.data(), b.size(), out.data());
+  for (uint32_t i = 0; i < a.size(); ++i) {
+    ExpectPoseNear(&out[7 * i], a[i] * b[i]);
+  }
+
+  composePoses(arrayA.data(), 1, arrayB.data(), b.size(), out.data());
+  for (uint32_t i = 0; i < a.size(); ++i) {
+    ExpectPoseNear(&out[7 * i], a[0] * b[i]);
+  }
+  EXPECT_THROW(composePoses(arrayA.data(), 11, arrayB.data(), 3, out.data()),
+               std::runtime_error);
+
+  invertPoses(arrayA.data(), out.data(), a.size());
+  for (uint32_t i = 0; i < a.size(); ++i) {
+    ExpectPoseNear(&out[7 * i], a[i].getInverse());
+  }
+
+  std::vector<float> matrices(a.size() * 16);
+  posesToMatrices(arrayA.data(), matrices.data(), a.size());
+  for (uint32_t i = 0; i < a.size(); ++i) {
+    Eigen::Matrix<float, 4, 4, Eigen::RowMajor> expected = PoseToEigenMat4(a[i]);
+    for (uint32_t k = 0; k < 16; ++k) {
+      EXPECT_NEAR(matrices[16 * i + k], expected.data()[k], 1e-5);
+    }
+  }
+  matricesToPoses(matrices.data(), out.data(), a.size());
+  for (uint32_t i = 0; i < a.size(); ++i) {
+    ExpectPoseNear(&out[7 * i], a[i]);
+  }
+}
+
+TEST(MathBatch, RPY) {
+  std::mt19937 gen(2);
+  std::vector<float> quats;
+  for (uint32_t i = 0; i < 20; ++i) {
+    Quat q = RandomPose(gen).q;
+    quats.insert(quats.end(), {q.w, q.x, q.y, q.z});
+  }
+  std::vector<float> rpy(20 * 3), result(20 * 4);
+  quatsToRPY(quats.data(), rpy.data(), 20);
+  rpyToQuats(rpy.data(), result.data(), 20);
+  for (uint32_t i = 0; i < 20; ++i) {
+    Quat expected = RPYToQuat({rpy[3 * i], rpy[3 * i + 1], rpy[3 * i + 2]});
+    Quat q(quats[4 * i], quats[4 * i + 1], quats[4 * i + 2], quats[4 * i + 3]);
+    Quat r(result[4 * i], result[4 * i + 1], result[4 * i + 2], result[4 * i + 3]);
+    EXPECT_NEAR(std::abs((q * expected.getConjugate()).w), 1.f, 1e-5);
+    EXPECT_NEAR(std::abs((q * r.getConjugate()).w), 1.f, 1e-5);
+  }
+}
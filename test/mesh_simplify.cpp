@@ -0,0 +1,102 @@
+#include "sapien/math/mesh_simplify.h"
+#include "sapien/math/vec3.h"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <map>
+#include <numbers>
+using namespace sapien;
+
+static Vec3 Vertex(std::vector<float> const &vertices, uint32_t i) {
+  return {vertices[3 * i], vertices[3 * i + 1], vertices[3 * i + 2]};
+}
+
+static Vec3 Normal(std::vector<float> const &vertices, uint32_t const *t) {
+  Vec3 a = Vertex(vertices, t[0]);
+  return (Vertex(vertices, t[1]) - a).cross(Vertex(vertices, t[2]) - a);
+}
+
+TEST(MeshSimplify, Plane) {
+  // n x n grid on the unit square
+  uint32_t n = 20;
+  std::vector<float> vertices;
+  std::vector<uint32_t> triangles;
+  for (uint32_t i = 0; i <= n; ++i) {
+    for (uint32_t j = 0; j <= n; ++j) {
+      vertices.insert(vertices.end(), {float(i) / n, float(j) / n, 0.f});
+    }
+  }
+  for (uint32_t i = 0; i < n; ++i) {
+    for (uint32_t j = 0; j < n; ++j) {
+      uint32_t a = i * (n + 1) + j;
+      uint32_t b = a + n + 1;
+      triangles.insert(triangles.end(), {a, b, a + 1, a + 1, b, b + 1});
+    }
+  }
+
+  auto result = simplifyMesh(vertices.data(), vertices.size() / 3, triangles.data(),
+                             triangles.size() / 3, 8);
+  ASSERT_EQ(result.size() % 3, 0);
+  EXPECT_LE(result.size() / 3, 8);
+
+  // the square keeps its boundary, area and orientation
+  float area = 0.f;
+  for (uint32_t t = 0; t < result.size(); t += 3) {
+    for (uint32_t k = 0; k < 3; ++k) {
+      ASSERT_LT(result[t + k], vertices.size() / 3);
+    }
+    Vec3 normal = Normal(vertices, &result[t]);
+    EXPECT_GT(normal.z, 0.f);
+    area += normal.z / 2.f;
+  }
+  EXPECT_NEAR(area, 1.f, 1e-5);
+}
+
+TEST(MeshSimplify, Sphere) {
+  uint32_t stacks = 32, slices = 64;
+  std::vector<float> vertices{0.f, 0.f, 1.f, 0.f, 0.f, -1.f};
+  for (uint32_t i = 1; i < stacks; ++i) {
+    float theta = std::numbers::pi_v<float> * i / stacks;
+    for (uint32_t j = 0; j < slices; ++j) {
+      float phi = 2.f * std::numbers::pi_v<float> * j / slices;
+      vertices.insert(vertices.end(), {std::sin(theta) * std::cos(phi),
+                                       std::sin(theta) * std::sin(phi), std::cos(theta)});
+    }
+  }
+  auto ring = [&](uint32_t i, uint32_t j) { return 2 + (i - 1) * slices + j % slices; };
+  std::vector<uint32_t> triangles;
+  for (uint32_t j = 0; j < slices; ++j) {
+    triangles.insert(triangles.end(), {0, ring(1, j), ring(1, j + 1)});
+    triangles.insert(triangles.end(), {1, ring(stacks - 1, j + 1), ring(stacks - 1, j)});
+    for (uint32_t i = 1; i + 1 < stacks; ++i) {
+      triangles.insert(triangles.end(), {ring(i, j), ring(i + 1, j), ring(i + 1, j + 1)});
+      triangles.insert(triangles.end(), {ring(i, j), ring(i + 1, j + 1), ring(i, j + 1)});
+    }
+  }
+  uint32_t count = triangles.size() / 3;
+
+  auto result = simplifyMesh(vertices.data(), vertices.size() / 3, triangles.data(), count,
+                             count / 8);
+  EXPECT_LE(result.size() / 3, count / 8);
+  EXPECT_GT(result.size() / 3, count / 16);
+
+  // a closed surface stays closed: every edge is shared by exactly two triangles
+  std::map<std::pair<uint32_t, uint32_t>, int> edges;
+  for (uint32_t t = 0; t < result.size(); t += 3) {
+    Vec3 normal = Normal(vertices, &result[t]);
+    Vec3 center = (Vertex(vertices, result[t]) + Vertex(vertices, result[t + 1]) +
+                   Vertex(vertices, result[t + 2])) /
+                  3.f;
+    EXPECT_GT(normal.dot(center), 0.f);
+    for (uint32_t k = 0; k < 3; ++k) {
+      edges[std::minmax(result[t + k], result[t + (k + 1) % 3])]++;
+    }
+  }
+  for (auto &[edge, n] : edges) {
+    EXPECT_EQ(n, 2);
+  }
+
+  // no collapse is allowed past the error bound
+  auto exact = simplifyMesh(vertices.data(), vertices.size() / 3, triangles.data(), count, 0,
+                            1e-12f);
+  EXPECT_EQ(exact.size(), triangles.size());
+}
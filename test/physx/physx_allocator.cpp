@@ -0,0 +1,94 @@
+#include "physx/physx_allocator.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace sapien::physx;
+
+TEST(SapienAllocatorCallback, Accounting) {
+  SapienAllocatorCallback allocator;
+  void *a = allocator.allocate(100, "A", __FILE__, __LINE__);
+  void *b;
+  void *empty;
+  {
+    PhysxAllocatorScope scope(7);
+    b = allocator.allocate(50, "B", __FILE__, __LINE__);
+    empty = allocator.allocate(0, "B", __FILE__, __LINE__);
+  }
+
+  auto stats = allocator.getStats();
+  EXPECT_TRUE(stats.tracking);
+  EXPECT_EQ(stats.currentBytes, 150);
+  EXPECT_EQ(stats.peakBytes, 150);
+  EXPECT_EQ(stats.liveAllocations, 3);
+  EXPECT_EQ(stats.bytesByName.at("A"), 100);
+  EXPECT_EQ(stats.bytesByName.at("B"), 50);
+  EXPECT_EQ(allocator.getSystemBytes(7), 50);
+  EXPECT_EQ(allocator.getSystemBytes(8), 0);
+
+  // releasing the empty allocation must keep the system counter usable
+  allocator.deallocate(empty);
+  allocator.deallocate(b);
+  EXPECT_EQ(allocator.getSystemBytes(7), 0);
+  allocator.deallocate(a);
+
+  stats = allocator.getStats();
+  EXPECT_EQ(stats.currentBytes, 0);
+  EXPECT_EQ(stats.peakBytes, 150);
+  EXPECT_EQ(stats.liveAllocations, 0);
+  EXPECT_EQ(stats.totalAllocations, 3);
+  EXPECT_TRUE(stats.bytesByName.empty());
+}
+
+TEST(SapienAllocatorCallback, PoolReuse) {
+  SapienAllocatorCallback allocator;
+  allocator.setPoolEnabled(true);
+
+  void *small = allocator.allocate(40, "small", __FILE__, __LINE__);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(small) % 16, 0);
+  auto stats = allocator.getStats();
+  EXPECT_EQ(stats.poolReservedBytes, SapienAllocatorCallback::kPoolChunkSize);
+  EXPECT_EQ(stats.poolUsedBytes, 16 + 48);
+
+  allocator.deallocate(small);
+  EXPECT_EQ(allocator.getStats().poolUsedBytes, 0);
+  EXPECT_EQ(allocator.allocate(33, "small", __FILE__, __LINE__), small);
+
+  void *large =
+      allocator.allocate(SapienAllocatorCallback::kPoolMaxSize + 1, "large", __FILE__, __LINE__);
+  stats = allocator.getStats();
+  EXPECT_EQ(stats.poolReservedBytes, SapienAllocatorCallback::kPoolChunkSize);
+  EXPECT_EQ(stats.currentBytes, 33 + SapienAllocatorCallback::kPoolMaxSize + 1);
+  allocator.deallocate(large);
+  allocator.deallocate(small);
+}
+
+TEST(SapienAllocatorCallback, Threads) {
+  SapienAllocatorCallback allocator;
+  allocator.setPoolEnabled(true);
+
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      PhysxAllocatorScope scope(t + 1);
+      std::vector<void *> blocks;
+      for (int i = 0; i < 1000; ++i) {
+        blocks.push_back(allocator.allocate(i % 300 + 1, i % 2 ? "odd" : "even", "", 0));
+      }
+      for (void *block : blocks) {
+        allocator.deallocate(block);
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  auto stats = allocator.getStats();
+  EXPECT_EQ(stats.currentBytes, 0);
+  EXPECT_EQ(stats.totalAllocations, 4000);
+  EXPECT_GT(stats.peakBytes, 0);
+  EXPECT_EQ(stats.poolUsedBytes, 0);
+  for (uint32_t tag = 1; tag <= 4; ++tag) {
+    EXPECT_EQ(allocator.getSystemBytes(tag), 0);
+  }
+}
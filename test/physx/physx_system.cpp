@@ -1,7 +1,9 @@
 #include "sapien/entity.h"
 #include "sapien/physx/physx.h"
+#include "sapien/profiler.h"
 #include "sapien/scene.h"
 #include <gtest/gtest.h>
+#include <thread>
 
 using namespace sapien;
 using namespace sapien::physx;
@@ -23,6 +25,43 @@ TEST(Engine, Creation) {
   }
 }
 
+#ifdef SAPIEN_PROFILE
+
+TEST(Engine, ProfilerCallback) {
+  auto callback = PhysxEngine::GetProfilerCallback();
+  ProfilerReset();
+  ProfilerStart();
+  {
+    auto engine = PhysxEngine::Get();
+    EXPECT_EQ(::physx::PxGetProfilerCallback(), nullptr);
+    EXPECT_EQ(callback->zoneStart("zone", false, 0), nullptr);
+
+    PhysxDefault::SetProfilerEnabled(true);
+    EXPECT_EQ(::physx::PxGetProfilerCallback(), callback);
+    void *data = callback->zoneStart("zone", false, 0);
+    ASSERT_NE(data, nullptr);
+    callback->zoneEnd(data, "zone", false, 0);
+
+    // detached zones may end on another thread
+    data = callback->zoneStart("detached", true, 0);
+    std::thread([&]() { callback->zoneEnd(data, "detached", true, 0); }).join();
+
+    PhysxDefault::SetProfilerEnabled(false);
+    EXPECT_EQ(::physx::PxGetProfilerCallback(), nullptr);
+  }
+  ProfilerStop();
+
+  auto summary = ProfilerGetSummary();
+  ASSERT_EQ(summary.size(), 2);
+  for (auto &s : summary) {
+    EXPECT_TRUE(s.name == "zone" || s.name == "detached");
+    EXPECT_EQ(s.count, 1);
+  }
+  ProfilerReset();
+}
+
+#endif
+
 TEST(PhysxSystemCpu, Creation) {
   auto scene = std::make_shared<Scene>();
   scene->addSystem(std::make_shared<PhysxSystemCpu>());
@@ -40,3 +79,97 @@ TEST(PhysxSystemCpu, Creation) {
 
   scene->addEntity(entity);
 }
+
+TEST(PhysxSystemCpu, StepStatistics) {
+  auto scene = std::make_shared<Scene>();
+  auto system = std::make_shared<PhysxSystemCpu>();
+  scene->addSystem(system);
+  system->setStepStatisticsHistorySize(3);
+
+  auto mat = std::make_shared<PhysxMaterial>(0.3, 0.3, 0.1);
+  auto ground = std::make_shared<PhysxRigidStaticComponent>();
+  auto plane = std::make_shared<PhysxCollisionShapePlane>(mat);
+  plane->setLocalPose({{0.f, 0.f, 0.f}, {0.7071068, 0, -0.7071068, 0}});
+  ground->attachCollision(std::move(plane));
+  auto groundEntity = std::make_shared<Entity>();
+  groundEntity->addComponent(ground);
+  scene->addEntity(groundEntity);
+
+  auto body = std::make_shared<PhysxRigidDynamicComponent>();
+  body->attachCollision(std::make_shared<PhysxCollisionShapeBox>(Vec3{0.1f, 0.1f, 0.1f}, mat));
+  auto bodyEntity = std::make_shared<Entity>();
+  bodyEntity->addComponent(body);
+  bodyEntity->setPose({{0.f, 0.f, 0.1f}, {1.f, 0.f, 0.f, 0.f}});
+  scene->addEntity(bodyEntity);
+
+  for (int i = 0; i < 5; ++i) {
+    system->step();
+  }
+
+  auto stats = system->getStepStatistics();
+  EXPECT_EQ(stats.step, 5);
+  EXPECT_EQ(stats.staticBodies, 1);
+  EXPECT_EQ(stats.dynamicBodies, 1);
+  EXPECT_EQ(stats.awakeArticulations, 0);
+  EXPECT_GE(stats.contactPairs, 1);
+  EXPECT_GE(stats.contactPoints, 1);
+  EXPECT_GE(stats.simulateTime, 0.0);
+
+  auto history = system->getStepStatisticsHistory();
+  ASSERT_EQ(history.size(), 3);
+  EXPECT_EQ(history.front().step, 3);
+  EXPECT_EQ(history.back().step, 5);
+}
+
+TEST(PhysxSystemCpu, ScratchBlock) {
+  auto defaultConfig = PhysxDefault::getSceneConfig();
+  auto config = defaultConfig;
+  config.scratchBlockSize = 20000;
+  config.enableScratchAutoGrow = true;
+  PhysxDefault::setSceneConfig(config);
+  auto scene = std::make_shared<Scene>();
+  auto system = std::make_shared<PhysxSystemCpu>();
+  scene->addSystem(system);
+  PhysxDefault::setSceneConfig(defaultConfig);
+
+  // size is rounded up to a multiple of 16K
+  EXPECT_EQ(system->getScratchBlockSize(), 32 * 1024);
+  ASSERT_NE(system->getScratchBlock(), nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(system->getScratchBlock()) % 16, 0);
+  system->setScratchBlockSize(0);
+  EXPECT_EQ(system->getScratchBlockSize(), 0);
+  EXPECT_EQ(system->getScratchBlock(), nullptr);
+
+  auto mat = std::make_shared<PhysxMaterial>(0.3, 0.3, 0.1);
+  auto ground = std::make_shared<PhysxRigidStaticComponent>();
+  auto plane = std::make_shared<PhysxCollisionShapePlane>(mat);
+  plane->setLocalPose({{0.f, 0.f, 0.f}, {0.7071068, 0, -0.7071068, 0}});
+  ground->attachCollision(std::move(plane));
+  auto groundEntity = std::make_shared<Entity>();
+  groundEntity->addComponent(ground);
+  scene->addEntity(groundEntity);
+
+  auto body = std::make_shared<PhysxRigidDynamicComponent>();
+  body->attachCollision(std::make_shared<PhysxCollisionShapeBox>(Vec3{0.1f, 0.1f, 0.1f}, mat));
+  auto bodyEntity = std::make_shared<Entity>();
+  bodyEntity->addComponent(body);
+  bodyEntity->setPose({{0.f, 0.f, 0.1f}, {1.f, 0.f, 0.f, 0.f}});
+  scene->addEntity(bodyEntity);
+
+  // auto grow allocates scratch memory for the constraints of the resting box
+  system->step();
+  auto stats = system->getStepStatistics();
+  uint32_t required = stats.peakConstraintMemory + stats.requiredContactConstraintMemory;
+  ASSERT_GT(required, 0);
+  EXPECT_EQ(stats.scratchGrowCount, 1);
+  EXPECT_GE(stats.scratchBlockSize, required);
+  EXPECT_EQ(stats.scratchBlockSize % (16 * 1024), 0);
+
+  // the same block is passed to later steps while it fits
+  void *block = system->getScratchBlock();
+  for (int i = 0; i < 10; ++i) {
+    system->step();
+    EXPECT_EQ(system->getScratchBlock(), block);
+  }
+  EXPECT_EQ(system->getStepStatistics().scratchGrowCount, 1);
+}
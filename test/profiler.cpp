@@ -0,0 +1,104 @@
+#include "sapien/profiler.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+using namespace sapien;
+
+#ifdef SAPIEN_PROFILE
+
+TEST(Profiler, Summary) {
+  ProfilerReset();
+  ProfilerStart();
+  for (int i = 0; i < 10; ++i) {
+    SAPIEN_PROFILE_BLOCK(outer);
+    for (int j = 0; j < 3; ++j) {
+      SAPIEN_PROFILE_BLOCK(inner);
+    }
+  }
+  ProfilerStop();
+
+  // blocks recorded after stop are ignored
+  { SAPIEN_PROFILE_BLOCK(outer); }
+
+  auto summary = ProfilerGetSummary();
+  ASSERT_EQ(summary.size(), 2);
+  for (auto &s : summary) {
+    if (s.name == "outer") {
+      EXPECT_EQ(s.count, 10);
+    } else {
+      EXPECT_EQ(s.name, "inner");
+      EXPECT_EQ(s.count, 30);
+    }
+    EXPECT_LE(s.min, s.max);
+    EXPECT_GE(s.total, 0.0);
+  }
+
+  ProfilerReset();
+  EXPECT_TRUE(ProfilerGetSummary().empty());
+}
+
+TEST(Profiler, ResetWhileRecording) {
+  ProfilerReset();
+  ProfilerStart();
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&]() {
+      while (!done) {
+        SAPIEN_PROFILE_BLOCK(busy);
+      }
+    });
+  }
+  for (int i = 0; i < 100; ++i) {
+    ProfilerReset();
+    ProfilerGetSummary();
+  }
+  done = true;
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  // threads that have not recorded since the reset are not reported
+  ProfilerReset();
+  EXPECT_TRUE(ProfilerGetSummary().empty());
+  { SAPIEN_PROFILE_BLOCK(busy); }
+  auto summary = ProfilerGetSummary();
+  ASSERT_EQ(summary.size(), 1);
+  EXPECT_EQ(summary[0].count, 1);
+  ProfilerStop();
+  ProfilerReset();
+}
+
+TEST(Profiler, TraceLimit) {
+  ProfilerReset();
+  ProfilerStart(10);
+  for (int i = 0; i < 25; ++i) {
+    SAPIEN_PROFILE_BLOCK(limited);
+  }
+  ProfilerStop();
+
+  // dropped events are still counted in the summary
+  auto summary = ProfilerGetSummary();
+  ASSERT_EQ(summary.size(), 1);
+  EXPECT_EQ(summary[0].count, 25);
+
+  std::string filename = testing::TempDir() + "sapien_profiler_trace.json";
+  ProfilerDumpChromeTrace(filename);
+  std::stringstream ss;
+  ss << std::ifstream(filename).rdbuf();
+  std::remove(filename.c_str());
+  std::string trace = ss.str();
+  EXPECT_NE(trace.find("\"droppedEvents\":15"), std::string::npos);
+  size_t count = 0;
+  for (size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos;
+       pos = trace.find("\"ph\":\"X\"", pos + 1)) {
+    ++count;
+  }
+  EXPECT_EQ(count, 10);
+  ProfilerReset();
+}
+
+#endif
@@ -0,0 +1,87 @@
+#include "sapien/sapien_renderer/camera_point_cloud.h"
+#include <gtest/gtest.h>
+
+using namespace sapien;
+using namespace sapien::sapien_renderer;
+
+TEST(PointCloud, FilterAndTransform) {
+  // large enough to be split across threads
+  int height = 128;
+  int width = 256;
+  int count = height * width;
+  std::vector<float> position(count * 4);
+  std::vector<uint8_t> color(count * 4);
+  std::vector<uint32_t> segmentation(count * 4);
+  for (int i = 0; i < count; ++i) {
+    position[4 * i] = i;
+    position[4 * i + 1] = 1.f;
+    position[4 * i + 2] = -(i % 7 + 0.5f);
+    position[4 * i + 3] = i % 3 ? 0.5f : 1.f;
+    for (int k = 0; k < 4; ++k) {
+      color[4 * i + k] = (i + k) % 256;
+      segmentation[4 * i + k] = (i + k) % 5;
+    }
+  }
+  CpuArrayHandle positionImage{.shape = {height, width, 4},
+                               .strides = {width * 16, 16, 4},
+                               .type = "f4",
+                               .ptr = position.data()};
+  CpuArrayHandle colorImage{.shape = {height, width, 4},
+                            .strides = {width * 4, 4, 1},
+                            .type = "u1",
+                            .ptr = color.data()};
+  CpuArrayHandle segmentationImage{.shape = {height, width, 4},
+                                   .strides = {width * 16, 16, 4},
+                                   .type = "u4",
+                                   .ptr = segmentation.data()};
+
+  Pose pose({1.f, 2.f, 3.f}, {0.f, 0.f, 0.f, 1.f}); // 180 degrees about z
+  PointCloudOptions options{.color = true,
+                            .segmentation = true,
+                            .minDepth = 1.f,
+                            .maxDepth = 5.f,
+                            .segmentationIds = {3, 1},
+                            .threadCount = 4};
+  CpuArray buffer;
+  auto pc = computePointCloud(positionImage, &colorImage, &segmentationImage, pose, options,
+                              buffer);
+
+  std::vector<int> expected;
+  for (int i = 0; i < count; ++i) {
+    float depth = i % 7 + 0.5f;
+    int id = (i + 1) % 5;
+    if (i % 3 && depth >= 1.f && depth <= 5.f && (id == 1 || id == 3)) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_EQ(pc.points.shape, std::vector<int>({static_cast<int>(expected.size()), 3}));
+  ASSERT_EQ(pc.colors.shape, std::vector<int>({static_cast<int>(expected.size()), 4}));
+  ASSERT_EQ(pc.segmentation.shape, std::vector<int>({static_cast<int>(expected.size()), 4}));
+  auto points = static_cast<float *>(pc.points.ptr);
+  auto colors = static_cast<float *>(pc.colors.ptr);
+  auto ids = static_cast<uint32_t *>(pc.segmentation.ptr);
+  for (size_t n = 0; n < expected.size(); ++n) {
+    int i = expected[n];
+    ASSERT_FLOAT_EQ(points[3 * n], 1.f - i);
+    ASSERT_FLOAT_EQ(points[3 * n + 1], 1.f);
+    ASSERT_FLOAT_EQ(points[3 * n + 2], 3.f - (i % 7 + 0.5f));
+    ASSERT_FLOAT_EQ(colors[4 * n + 2], ((i + 2) % 256) / 255.f);
+    ASSERT_EQ(ids[4 * n + 3], (i + 3) % 5);
+  }
+
+  // the buffer is reused once the previous result is released
+  void *ptr = buffer.ptr();
+  pc = {};
+  options.frame = PointCloudFrame::eCamera;
+  options.color = false;
+  options.segmentation = false;
+  options.segmentationIds = {};
+  pc = computePointCloud(positionImage, nullptr, nullptr, pose, options, buffer);
+  EXPECT_EQ(buffer.ptr(), ptr);
+  EXPECT_TRUE(pc.colors.shape.empty());
+  EXPECT_FLOAT_EQ(static_cast<float *>(pc.points.ptr)[2], -1.5f);
+
+  options.segmentationIds = {1};
+  EXPECT_THROW(computePointCloud(positionImage, nullptr, nullptr, pose, options, buffer),
+               std::runtime_error);
+}
@@ -0,0 +1,64 @@
+#include "sapien/utils/thread_pool.h"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <stdexcept>
+using namespace sapien;
+
+TEST(ThreadPool, AllTasksOnce) {
+  ThreadPool pool(3);
+  std::vector<std::atomic<int>> calls(1000);
+  pool.parallelFor(calls.size(), 0, [&](uint32_t task) { calls[task]++; });
+  for (auto &c : calls) {
+    EXPECT_EQ(c, 1);
+  }
+  pool.parallelFor(0, 0, [&](uint32_t) { FAIL(); });
+}
+
+TEST(ThreadPool, MaxThreads) {
+  ThreadPool pool(4);
+  std::atomic<int> running{0};
+  std::atomic<int> peak{0};
+  pool.parallelFor(64, 2, [&](uint32_t) {
+    int r = ++running;
+    for (int p = peak; r > p && !peak.compare_exchange_weak(p, r);) {
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    --running;
+  });
+  EXPECT_LE(peak, 2);
+
+  // a single thread runs the tasks in order on the calling thread
+  std::vector<uint32_t> order;
+  auto id = std::this_thread::get_id();
+  pool.parallelFor(5, 1, [&](uint32_t task) {
+    EXPECT_EQ(std::this_thread::get_id(), id);
+    order.push_back(task);
+  });
+  EXPECT_EQ(order, std::vector<uint32_t>({0, 1, 2, 3, 4}));
+}
+
+TEST(ThreadPool, Nested) {
+  ThreadPool pool(2);
+  std::atomic<int> sum{0};
+  pool.parallelFor(8, 0, [&](uint32_t i) {
+    pool.parallelFor(8, 0, [&](uint32_t j) { sum += i * 8 + j; });
+  });
+  EXPECT_EQ(sum, 63 * 64 / 2);
+}
+
+TEST(ThreadPool, Exception) {
+  ThreadPool pool(2);
+  std::atomic<int> calls{0};
+  EXPECT_THROW(pool.parallelFor(16, 0,
+                                [&](uint32_t task) {
+                                  calls++;
+                                  if (task == 3) {
+                                    throw std::runtime_error("task failed");
+                                  }
+                                }),
+               std::runtime_error);
+  // other tasks still run
+  EXPECT_EQ(calls, 16);
+  pool.parallelFor(4, 0, [&](uint32_t) { calls++; });
+  EXPECT_EQ(calls, 20);
+}
@@ -0,0 +1,204 @@
+#include "sapien/urdf/urdf.h"
+#include "sapien/urdf/urdf_cache.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace sapien;
+using namespace sapien::urdf;
+
+static std::string const kRobot = R"(
+<robot name="test">
+  <material name="green">
+    <color rgba="0 1 0 1"/>
+  </material>
+  <link name="base">
+    <inertial>
+      <origin xyz="0 0 0.1"/>
+      <mass value="2"/>
+      <inertia ixx="1" iyy="2" izz="3" ixy="0" iyz="0" ixz="0"/>
+    </inertial>
+    <visual>
+      <geometry><box size="0.2 0.4 0.6"/></geometry>
+      <material name="green"/>
+    </visual>
+    <collision>
+      <origin xyz="1 2 3" rpy="0 0 1.5707963"/>
+      <geometry><cylinder radius="0.1" length="0.5"/></geometry>
+    </collision>
+  </link>
+  <link name="arm">
+    <collision>
+      <geometry><mesh filename="package://assets/cube.obj" scale="2"/></geometry>
+    </collision>
+  </link>
+  <link name="finger"/>
+  <joint name="j1" type="revolute">
+    <parent link="base"/>
+    <child link="arm"/>
+    <axis xyz="0 0 1"/>
+    <limit lower="-1" upper="1"/>
+    <dynamics damping="0.5"/>
+  </joint>
+  <joint name="j2" type="prismatic">
+    <parent link="arm"/>
+    <child link="finger"/>
+    <mimic joint="j1" multiplier="2"/>
+  </joint>
+  <gazebo reference="arm">
+    <sensor name="cam">
+      <camera>
+        <horizontal_fov>1.0</horizontal_fov>
+        <image><width>64</width><height>32</height></image>
+        <clip><near>0.1</near><far>10</far></clip>
+      </camera>
+    </sensor>
+  </gazebo>
+</robot>
+)";
+
+static std::string TestDir() {
+  return std::filesystem::path(__FILE__).parent_path().string();
+}
+
+TEST(URDF, Parse) {
+  auto robot = ParseURDF(kRobot, TestDir());
+
+  EXPECT_EQ(robot.name, "test");
+  EXPECT_EQ(robot.baseLink, "base");
+  ASSERT_EQ(robot.links.size(), 3);
+  ASSERT_EQ(robot.joints.size(), 2);
+
+  auto &base = robot.getLink("base");
+  ASSERT_TRUE(base.inertial);
+  EXPECT_FLOAT_EQ(base.inertial->mass, 2.f);
+  EXPECT_FLOAT_EQ(base.inertial->inertia(2, 2), 3.f);
+  EXPECT_FLOAT_EQ(base.inertial->origin.p.z, 0.1f);
+
+  ASSERT_EQ(base.visuals.size(), 1);
+  EXPECT_EQ(base.visuals[0].geometry.type, URDFGeometry::Type::eBox);
+  EXPECT_FLOAT_EQ(base.visuals[0].geometry.size.y, 0.4f);
+  ASSERT_TRUE(base.visuals[0].material);
+  ASSERT_TRUE(base.visuals[0].material->color);
+  EXPECT_FLOAT_EQ(base.visuals[0].material->color->at(1), 1.f);
+
+  ASSERT_EQ(base.collisions.size(), 1);
+  auto &collision = base.collisions[0];
+  EXPECT_EQ(collision.geometry.type, URDFGeometry::Type::eCylinder);
+  EXPECT_FLOAT_EQ(collision.geometry.length, 0.5f);
+  EXPECT_FLOAT_EQ(collision.origin.p.y, 2.f);
+  EXPECT_NEAR(collision.origin.q.w, 0.7071068f, 1e-5);
+  EXPECT_NEAR(collision.origin.q.z, 0.7071068f, 1e-5);
+
+  // package:// is resolved by searching parent directories of the URDF directory
+  auto &mesh = robot.getLink("arm").collisions.at(0).geometry;
+  EXPECT_EQ(mesh.type, URDFGeometry::Type::eMesh);
+  EXPECT_TRUE(std::filesystem::is_regular_file(mesh.filename));
+  EXPECT_FLOAT_EQ(mesh.size.z, 2.f);
+
+  auto j1 = robot.getParentJoint("arm");
+  ASSERT_TRUE(j1);
+  EXPECT_EQ(j1->type, "revolute");
+  EXPECT_FLOAT_EQ(j1->axis.z, 1.f);
+  EXPECT_FLOAT_EQ(j1->lower, -1.f);
+  EXPECT_FLOAT_EQ(j1->damping, 0.5f);
+  EXPECT_FALSE(robot.getParentJoint("base"));
+  EXPECT_EQ(robot.getChildJoints("base").size(), 1);
+
+  auto j2 = robot.getParentJoint("finger");
+  ASSERT_TRUE(j2 && j2->mimic);
+  EXPECT_EQ(j2->mimic->joint, "j1");
+  EXPECT_FLOAT_EQ(j2->mimic->multiplier, 2.f);
+  EXPECT_FLOAT_EQ(j2->axis.x, 1.f);
+
+  ASSERT_EQ(robot.cameras.size(), 1);
+  EXPECT_EQ(robot.cameras[0].parent, "arm");
+  EXPECT_EQ(robot.cameras[0].width, 64);
+  EXPECT_EQ(robot.cameras[0].height, 32);
+  EXPECT_FLOAT_EQ(robot.cameras[0].far, 10.f);
+  EXPECT_TRUE(robot.cameras[0].fovx);
+  EXPECT_FALSE(robot.cameras[0].fovy);
+}
+
+TEST(URDF, ParseInvalid) {
+  EXPECT_THROW(ParseURDF("<robot>", TestDir()), std::runtime_error);
+  EXPECT_THROW(ParseURDF("<robot><link name='a'/><link name='b'/></robot>", TestDir()),
+               std::runtime_error);
+  EXPECT_THROW(ParseURDF(R"(<robot><link name="a"/>
+                              <joint name="j" type="fixed">
+                                <parent link="a"/><child link="b"/>
+                              </joint></robot>)",
+                         TestDir()),
+               std::runtime_error);
+
+  // malformed numbers are reported with the attribute that holds them
+  auto expectError = [](std::string const &urdf, std::string const &what) {
+    try {
+      ParseURDF(urdf, TestDir());
+      ADD_FAILURE() << "expected an error for " << what;
+    } catch (std::runtime_error const &e) {
+      EXPECT_NE(std::string(e.what()).find(what), std::string::npos) << e.what();
+    }
+  };
+  expectError(R"(<robot><link name="a"><collision>
+                   <geometry><cylinder radius="0.1" length="long"/></geometry>
+                 </collision></link></robot>)",
+              "length in <cylinder>");
+  expectError(R"(<robot><link name="a"><visual>
+                   <geometry><sphere radius="1e99"/></geometry>
+                 </visual></link></robot>)",
+              "radius in <sphere>");
+  std::string camera = R"(<robot><link name="a"/><gazebo reference="a"><sensor><camera>
+                            <horizontal_fov>1</horizontal_fov>
+                            <image><width>{width}</width><height>32</height></image>
+                            <clip><near>{near}</near><far>10</far></clip>
+                          </camera></sensor></gazebo></robot>)";
+  auto makeCamera = [&](std::string width, std::string near) {
+    auto urdf = camera;
+    urdf.replace(urdf.find("{width}"), 7, width);
+    urdf.replace(urdf.find("{near}"), 6, near);
+    return urdf;
+  };
+  EXPECT_NO_THROW(ParseURDF(makeCamera(" 64 ", "0.1"), TestDir()));
+  expectError(makeCamera("wide", "0.1"), "camera width");
+  expectError(makeCamera("99999999999", "0.1"), "camera width");
+  expectError(makeCamera("64", "0.1m"), "camera near");
+}
+
+TEST(URDF, ParseSRDF) {
+  auto pairs = ParseSRDF(R"(
+<robot name="test">
+  <disable_collisions link1="a" link2="b" reason="Default"/>
+  <disable_collisions link1="a" link2="c" reason="Adjacent"/>
+</robot>
+)");
+  ASSERT_EQ(pairs.size(), 1);
+  EXPECT_EQ(pairs[0][0], "a");
+  EXPECT_EQ(pairs[0][1], "b");
+}
+
+TEST(URDF, Cache) {
+  auto filename = (std::filesystem::temp_directory_path() / "sapien_test_cache.urdf").string();
+  std::ofstream(filename) << kRobot;
+
+  auto cache = URDFCache::Get();
+  auto misses = cache->getMissCount();
+  auto d0 = cache->load(filename);
+  auto d1 = cache->load(filename);
+  EXPECT_EQ(d0, d1);
+  EXPECT_EQ(cache->getMissCount(), misses + 1);
+  EXPECT_EQ(d0->robot.links.size(), 3);
+  EXPECT_TRUE(d0->ignorePairs.empty());
+
+  // same content with a new timestamp reuses the entry
+  std::ofstream(filename) << kRobot;
+  EXPECT_EQ(cache->load(filename), d0);
+
+  std::ofstream(filename) << "<robot name=\"single\"><link name=\"base\"/></robot>";
+  auto d2 = cache->load(filename);
+  EXPECT_NE(d2, d0);
+  EXPECT_EQ(d2->robot.links.size(), 1);
+  EXPECT_EQ(cache->getMissCount(), misses + 2);
+
+  std::filesystem::remove(filename);
+}
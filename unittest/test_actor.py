@@ -217,3 +217,37 @@ class TestActor(unittest.TestCase):
             sapien.physx.PhysxRigidBaseComponent
         ).get_collision_shapes()
         self.assertEqual(len(shapes), 3)
+
+    def test_build_many(self):
+        scenes = [sapien.Scene(), sapien.Scene()]
+
+        builder = scenes[0].create_actor_builder()
+        mat = sapien.physx.PhysxMaterial(0.3, 0.2, 0.1)
+        builder.add_box_collision(half_size=[0.1, 0.2, 0.3], material=mat)
+        builder.add_convex_collision_from_file("assets/cone.stl", material=mat)
+        builder.add_box_visual(half_size=[0.1, 0.2, 0.3], material=[1, 0, 0])
+        builder.set_name("clutter")
+
+        poses = [rand_pose() for _ in range(4)]
+        actors = builder.build_many(poses, [scenes[0], scenes[1]] * 2)
+        self.assertEqual(len(actors), 4)
+        self.assertEqual(len(scenes[0].entities), 2)
+        self.assertEqual(len(scenes[1].entities), 2)
+
+        meshes = []
+        for actor, pose in zip(actors, poses):
+            self.assertEqual(actor.name, "clutter")
+            self.assertTrue(pose_equal(actor.pose, pose))
+            body = actor.find_component_by_type(sapien.physx.PhysxRigidDynamicComponent)
+            shapes = body.get_collision_shapes()
+            self.assertEqual(len(shapes), 2)
+            self.assertTrue(np.allclose(shapes[0].half_size, [0.1, 0.2, 0.3]))
+            self.assertAlmostEqual(
+                shapes[1].get_physical_material().static_friction, 0.3, places=5
+            )
+            meshes.append(shapes[1].vertices)
+            self.assertIsNotNone(
+                actor.find_component_by_type(sapien.render.RenderBodyComponent)
+            )
+        for m in meshes[1:]:
+            self.assertTrue(np.allclose(m, meshes[0]))
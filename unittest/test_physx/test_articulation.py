@@ -1,4 +1,5 @@
 import os
+import tempfile
 import unittest
 from pathlib import Path
 
@@ -72,6 +73,85 @@ class TestArticulation(unittest.TestCase):
         robot.set_qf(q)
         self.assertTrue(np.allclose(robot.get_qf(), q))
 
+    def test_native_urdf_loader(self):
+        scene = sapien.Scene()
+        urdf = str(Path(".") / "assets" / "movo_simple.urdf")
+        robot = scene.create_urdf_loader().load(urdf)
+        native = scene.create_urdf_loader(native=True).load(urdf)
+
+        self.assertEqual([l.name for l in robot.links], [l.name for l in native.links])
+        self.assertEqual(
+            [j.name for j in robot.joints], [j.name for j in native.joints]
+        )
+        for j0, j1 in zip(robot.joints, native.joints):
+            self.assertEqual(j0.type, j1.type)
+            self.assertTrue(np.allclose(j0.limit, j1.limit))
+            self.assertTrue(
+                pose_equal(j0.pose_in_parent, j1.pose_in_parent, atol=1e-5)
+            )
+            self.assertTrue(pose_equal(j0.pose_in_child, j1.pose_in_child, atol=1e-5))
+        for l0, l1 in zip(robot.links, native.links):
+            self.assertAlmostEqual(l0.mass, l1.mass, places=5)
+            self.assertTrue(np.allclose(l0.inertia, l1.inertia, rtol=1e-5, atol=1e-6))
+            self.assertEqual(len(l0.collision_shapes), len(l1.collision_shapes))
+
+    def test_urdf_cache(self):
+        from sapien.wrapper.urdf_loader import urdf_cache
+
+        urdf = """
+<robot name="cache">
+  <link name="base"/>
+  <link name="arm">
+    <collision><geometry><box size="{size} 0.1 0.1"/></geometry></collision>
+  </link>
+  <joint name="j" type="revolute">
+    <parent link="base"/><child link="arm"/><limit lower="-1" upper="1"/>
+  </joint>
+</robot>
+"""
+        with tempfile.TemporaryDirectory() as d:
+            filename = os.path.join(d, "robot.urdf")
+            with open(filename, "w") as f:
+                f.write(urdf.format(size=0.2))
+
+            scene = sapien.Scene()
+            loader = scene.create_urdf_loader()
+            native = scene.create_urdf_loader(native=True)
+            misses = urdf_cache.misses
+            stats = sapien.pysapien.URDFLoader.get_cache_stats
+            native_misses = stats()["misses"]
+            for _ in range(3):
+                loader.load(filename)
+                native.load(filename)
+            self.assertEqual(urdf_cache.misses, misses + 1)
+            self.assertEqual(stats()["misses"], native_misses + 1)
+
+            with open(filename, "w") as f:
+                f.write(urdf.format(size=0.25))
+            for l in [loader, native]:
+                robot = l.load(filename)
+                shape = robot.links[1].collision_shapes[0]
+                self.assertTrue(np.allclose(shape.half_size, [0.125, 0.05, 0.05]))
+            self.assertEqual(urdf_cache.misses, misses + 2)
+
+    def test_urdf_cache_scale(self):
+        # scaling must not modify the cached URDF shared by later loads
+        urdf = str(Path(".") / "assets" / "movo_simple.urdf")
+        robots = []
+        for _ in range(2):
+            loader = sapien.Scene().create_urdf_loader()
+            loader.scale = 2
+            robots.append(loader.load(urdf))
+
+        for l0, l1 in zip(robots[0].links, robots[1].links):
+            self.assertTrue(pose_equal(l0.pose, l1.pose))
+            self.assertTrue(pose_equal(l0.cmass_local_pose, l1.cmass_local_pose))
+            for s0, s1 in zip(l0.collision_shapes, l1.collision_shapes):
+                self.assertTrue(pose_equal(s0.local_pose, s1.local_pose))
+        for j0, j1 in zip(robots[0].joints, robots[1].joints):
+            self.assertTrue(pose_equal(j0.pose_in_parent, j1.pose_in_parent))
+            self.assertTrue(pose_equal(j0.pose_in_child, j1.pose_in_child))
+
     def test_kinematics_dynamics(self):
         scene = sapien.Scene()
         loader = scene.create_urdf_loader()
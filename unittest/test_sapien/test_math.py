@@ -134,6 +134,46 @@ class TestFunctions(unittest.TestCase):
         )
 
 
+class TestBatch(unittest.TestCase):
+    def test_transform_points(self):
+        pose = rand_pose()
+        points = np.random.uniform(-1, 1, (5, 7, 3)).astype(np.float32)
+        scale = [0.5, 2, 1.5]
+        result = sapien.math.transform_points(pose, points, scale)
+        self.assertEqual(result.shape, (5, 7, 3))
+        mat = pose.to_transformation_matrix()
+        expected = (points * scale) @ mat[:3, :3].T + mat[:3, 3]
+        self.assertTrue(np.allclose(result, expected, atol=1e-5))
+
+    def test_poses(self):
+        poses = [rand_pose() for _ in range(10)]
+        array = np.array([np.concatenate([p.p, p.q]) for p in poses], dtype=np.float32)
+
+        matrices = sapien.math.poses_to_matrices(array)
+        self.assertEqual(matrices.shape, (10, 4, 4))
+        for m, p in zip(matrices, poses):
+            self.assertTrue(np.allclose(m, p.to_transformation_matrix(), atol=1e-5))
+        back = sapien.math.matrices_to_poses(matrices)
+        for b, p in zip(back, poses):
+            self.assertTrue(pose_equal(sapien.Pose(b[:3], b[3:]), p, atol=1e-5))
+
+        composed = sapien.math.compose_poses(array[:1], array)
+        for c, p in zip(composed, poses):
+            expected = poses[0] * p
+            self.assertTrue(pose_equal(sapien.Pose(c[:3], c[3:]), expected, atol=1e-5))
+        inverted = sapien.math.invert_poses(array)
+        for i, p in zip(inverted, poses):
+            self.assertTrue(pose_equal(sapien.Pose(i[:3], i[3:]), p.inv(), atol=1e-5))
+
+        rpy = sapien.math.quats_to_rpy(array[:, 3:])
+        quats = sapien.math.rpy_to_quats(rpy)
+        for q, p in zip(quats, poses):
+            self.assertTrue(pose_equal(sapien.Pose(q=q), sapien.Pose(q=p.q), atol=1e-5))
+
+        with self.assertRaises(RuntimeError):
+            sapien.math.invert_poses(np.zeros((3, 4)))
+
+
 class TestMatrix(unittest.TestCase):
     def test_matrix(self):
         self.assertTrue(np.allclose(sapien.math.pose_gl_to_ros.p, [0, 0, 0]))
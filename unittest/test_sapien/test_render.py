@@ -1,8 +1,26 @@
+import os
+import struct
+import tempfile
 import unittest
+import zlib
 import sapien
 import numpy as np
 
 
+def write_png(filename, rgba):
+    def chunk(kind, body):
+        crc = zlib.crc32(kind + body)
+        return struct.pack(">I", len(body)) + kind + body + struct.pack(">I", crc)
+
+    height, width, _ = rgba.shape
+    raw = b"".join(b"\x00" + row.tobytes() for row in rgba)
+    with open(filename, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">2I5B", width, height, 8, 6, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(raw)))
+        f.write(chunk(b"IEND", b""))
+
+
 class TestScene(unittest.TestCase):
     def test_empty(self):
         scene = sapien.Scene()
@@ -16,6 +34,337 @@ class TestScene(unittest.TestCase):
         cam.take_picture()
         color = cam.get_picture("Color")
 
+    def test_picture_zero_copy(self):
+        scene = sapien.Scene()
+        scene.add_directional_light([0, 1, -1], [0.5, 0.5, 0.5])
+        builder = scene.create_actor_builder()
+        builder.add_box_visual(half_size=[0.5, 0.5, 0.5])
+        box = builder.build_kinematic()
+        cam = scene.add_camera("", 64, 64, 1, 0.01, 10)
+        cam.entity.set_pose(sapien.Pose([-3, 0, 0]))
+
+        scene.update_render()
+        cam.take_picture()
+        first = cam.get_picture("Color")
+        saved = first.copy()
+        self.assertIsNotNone(first.base)
+
+        # pictures held by python are not overwritten by later pictures
+        box.set_pose(sapien.Pose([0, 10, 0]))
+        scene.update_render()
+        cam.take_picture()
+        second = cam.get_picture("Color")
+        self.assertTrue(np.array_equal(first, saved))
+        self.assertFalse(np.array_equal(first, second))
+
+        self.assertEqual(np.from_dlpack(second).shape, second.shape)
+
+    def test_picture_async(self):
+        scene = sapien.Scene()
+        scene.add_directional_light([0, 1, -1], [0.5, 0.5, 0.5])
+        builder = scene.create_actor_builder()
+        builder.add_box_visual(half_size=[0.5, 0.5, 0.5])
+        box = builder.build_kinematic()
+        cam = scene.add_camera("", 64, 64, 1, 0.01, 10)
+        cam.entity.set_pose(sapien.Pose([-3, 0, 0]))
+        cam.async_readback_targets = ["Color"]
+
+        self.assertEqual(cam.get_async_frame(), 0)
+        scene.update_render()
+        cam.take_picture()
+        frame = cam.get_async_frame(wait=True)
+        self.assertEqual(frame, 1)
+        first = cam.get_picture_async("Color", frame)
+        self.assertTrue(np.array_equal(first, cam.get_picture("Color")))
+
+        box.set_pose(sapien.Pose([0, 10, 0]))
+        scene.update_render()
+        cam.take_picture()
+        second = cam.get_picture_async("Color", cam.get_async_frame(wait=True))
+        self.assertFalse(np.array_equal(first, second))
+
+        # the previous picture stays readable while the next one renders
+        self.assertTrue(np.array_equal(cam.get_picture_async("Color", 1), first))
+        with self.assertRaises(RuntimeError):
+            cam.get_picture_async("Position", 2)
+
+    def test_host_camera_group(self):
+        cams = []
+        for x in [0, 10]:
+            scene = sapien.Scene()
+            scene.add_directional_light([0, 1, -1], [0.5, 0.5, 0.5])
+            builder = scene.create_actor_builder()
+            builder.add_box_visual(half_size=[0.5, 0.5, 0.5])
+            builder.build_kinematic().set_pose(sapien.Pose([0, x, 0]))
+            cam = scene.add_camera("", 64, 48, 1, 0.01, 10)
+            cam.entity.set_pose(sapien.Pose([-3, 0, 0]))
+            scene.update_render()
+            cams.append(cam)
+
+        group = sapien.render.RenderHostCameraGroup(cams, ["Color"])
+        group.take_picture()
+        pictures = group.get_picture("Color")
+        self.assertEqual(pictures.shape, (2, 48, 64, 4))
+        for picture, cam in zip(pictures, cams):
+            cam.take_picture()
+            self.assertTrue(np.allclose(picture, cam.get_picture("Color")))
+        self.assertFalse(np.array_equal(pictures[0], pictures[1]))
+
+    def test_frustum_culling(self):
+        scene = sapien.Scene()
+        scene.add_directional_light([0, 1, -1], [0.5, 0.5, 0.5])
+        builder = scene.create_actor_builder()
+        builder.add_box_visual(half_size=[0.5, 0.5, 0.5])
+        builder.build_kinematic().set_pose(sapien.Pose([2, 0, 0]))
+        builder.build_kinematic().set_pose(sapien.Pose([-2, 0, 0]))
+        cam = scene.add_camera("", 64, 64, 1, 0.01, 10)
+        scene.update_render()
+
+        cam.take_picture()
+        reference = cam.get_picture("Color")
+        self.assertEqual(cam.culled_object_count, 0)
+
+        cam.frustum_culling = True
+        cam.take_picture()
+        self.assertEqual(cam.culled_object_count, 1)
+        self.assertTrue(np.allclose(cam.get_picture("Color"), reference))
+
+    def test_mesh_lod(self):
+        n = 40
+        y, z = np.meshgrid(np.linspace(-0.5, 0.5, n + 1), np.linspace(-0.5, 0.5, n + 1))
+        vertices = np.stack([np.zeros_like(y), y, z], -1).reshape(-1, 3)
+        index = np.arange((n + 1) * (n + 1)).reshape(n + 1, n + 1)[:-1, :-1].reshape(-1)
+        triangles = np.concatenate(
+            [
+                np.stack([index, index + n + 1, index + 1], -1),
+                np.stack([index + 1, index + n + 1, index + n + 2], -1),
+            ]
+        )
+        shape = sapien.render.RenderShapeTriangleMesh(
+            vertices.astype(np.float32),
+            triangles.astype(np.uint32),
+            np.tile(np.array([-1, 0, 0], dtype=np.float32), (len(vertices), 1)),
+            np.zeros((len(vertices), 2), dtype=np.float32),
+            sapien.render.RenderMaterial(),
+        )
+        shape.generate_lods(2)
+        self.assertEqual(shape.lod_count, 2)
+
+        scene = sapien.Scene()
+        entity = sapien.Entity()
+        body = sapien.render.RenderBodyComponent()
+        body.attach(shape)
+        entity.add_component(body)
+        entity.set_pose(sapien.Pose([8, 0, 0]))
+        scene.add_entity(entity)
+        cam = scene.add_camera("", 64, 64, 1, 0.01, 10)
+        scene.update_render()
+
+        cam.take_picture()
+        self.assertEqual(cam.lod_object_count, 1)
+        scene.render_system.lod_bias = -10
+        cam.take_picture()
+        self.assertEqual(cam.lod_object_count, 0)
+        scene.render_system.lod_bias = 0
+        cam.take_picture()
+        cam.take_picture()
+        self.assertEqual(cam.lod_object_count, 1)
+
+    def test_mesh_lod_cache(self):
+        n = 20
+        lines = [f"v 0 {i / n} {j / n}" for i in range(n + 1) for j in range(n + 1)]
+        for i in range(n):
+            for j in range(n):
+                a = i * (n + 1) + j + 1
+                lines.append(f"f {a} {a + n + 1} {a + 1}")
+                lines.append(f"f {a + 1} {a + n + 1} {a + n + 2}")
+
+        cache_dir = sapien.render.get_mesh_lod_cache_dir()
+        with tempfile.TemporaryDirectory() as d:
+            filename = os.path.join(d, "assets", "grid.obj")
+            os.mkdir(os.path.dirname(filename))
+            with open(filename, "w") as f:
+                f.write("\n".join(lines) + "\n")
+
+            sapien.render.set_mesh_lod_cache_dir(os.path.join(d, "cache"))
+            try:
+                shape = sapien.render.RenderShapeTriangleMesh(filename)
+                shape.generate_lods(1)
+                again = sapien.render.RenderShapeTriangleMesh(filename)
+                again.generate_lods(1)
+            finally:
+                sapien.render.set_mesh_lod_cache_dir(cache_dir)
+
+            # the cache is written to the cache directory, never next to the asset
+            self.assertEqual(os.listdir(os.path.dirname(filename)), ["grid.obj"])
+            self.assertEqual(len(os.listdir(os.path.join(d, "cache"))), 1)
+            self.assertEqual(shape.lod_count, 1)
+            self.assertEqual(again.lod_count, 1)
+
+    def test_resource_cache(self):
+        with tempfile.TemporaryDirectory() as d:
+            files = [os.path.join(d, "a.obj"), os.path.join(d, "b.obj")]
+            for f in files:
+                with open(f, "w") as out:
+                    out.write("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n")
+
+            sapien.render.clear_unused_resources()
+            before = sapien.render.get_resource_cache_stats()
+            a = sapien.render.RenderShapeTriangleMesh(files[0])
+            b = sapien.render.RenderShapeTriangleMesh(files[1])
+            stats = sapien.render.get_resource_cache_stats()
+            self.assertEqual(stats.misses - before.misses, 1)
+            self.assertEqual(stats.hits - before.hits, 1)
+            self.assertEqual(stats.model_count - before.model_count, 1)
+
+            del a, b
+            sapien.render.clear_unused_resources()
+            self.assertEqual(sapien.render.get_resource_cache_stats().model_count, 0)
+
+    def test_resource_cache_materials(self):
+        # identical OBJ files are not shared when their material libraries differ
+        shapes = []
+        with tempfile.TemporaryDirectory() as d:
+            for name, color in [("red", "1 0 0"), ("green", "0 1 0")]:
+                os.mkdir(os.path.join(d, name))
+                with open(os.path.join(d, name, "mesh.obj"), "w") as out:
+                    out.write("mtllib mesh.mtl\nusemtl m\n")
+                    out.write("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n")
+                with open(os.path.join(d, name, "mesh.mtl"), "w") as out:
+                    out.write(f"newmtl m\nKd {color}\n")
+                shapes.append(
+                    sapien.render.RenderShapeTriangleMesh(
+                        os.path.join(d, name, "mesh.obj")
+                    )
+                )
+            red, green = [s.parts[0].material.base_color for s in shapes]
+
+        self.assertTrue(np.allclose(red[:3], [1, 0, 0]))
+        self.assertTrue(np.allclose(green[:3], [0, 1, 0]))
+
+    def test_texture_prefetch(self):
+        # 2x2 R8G8B8A8_UNORM KTX2 file with one level
+        data = bytes(range(16))
+        header = b"\xabKTX 20\xbb\r\n\x1a\n"
+        header += struct.pack("<9I4I2Q", 37, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0)
+        header += struct.pack("<3Q", 104, len(data), len(data))
+        with tempfile.TemporaryDirectory() as d:
+            filename = os.path.join(d, "texture.ktx2")
+            with open(filename, "wb") as f:
+                f.write(header + data)
+
+            sapien.render.RenderTexture2D.prefetch([filename], srgb=False)
+            before = sapien.render.get_resource_cache_stats()
+            texture = sapien.render.RenderTexture2D(filename, srgb=False)
+            stats = sapien.render.get_resource_cache_stats()
+            self.assertEqual(stats.hits, before.hits + 1)
+            self.assertEqual((texture.width, texture.height), (2, 2))
+
+    def test_texture_prefetch_bc1(self):
+        # 8x8 BC1_RGBA_UNORM KTX2 file, 2x2 blocks of 8 bytes
+        data = bytes(range(32))
+        header = b"\xabKTX 20\xbb\r\n\x1a\n"
+        header += struct.pack("<9I4I2Q", 133, 1, 8, 8, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0)
+        header += struct.pack("<3Q", 104, len(data), len(data))
+        with tempfile.TemporaryDirectory() as d:
+            filename = os.path.join(d, "texture.ktx2")
+            with open(filename, "wb") as f:
+                f.write(header + data)
+            truncated = os.path.join(d, "truncated.ktx2")
+            with open(truncated, "wb") as f:
+                f.write(header[:-24] + struct.pack("<3Q", 104, 16, 16) + data[:16])
+
+            sapien.render.RenderTexture2D.prefetch([filename], srgb=False)
+            texture = sapien.render.RenderTexture2D(filename, srgb=False)
+            self.assertEqual((texture.width, texture.height), (8, 8))
+            self.assertEqual(texture.mipmap_levels, 1)
+            with self.assertRaises(RuntimeError):
+                sapien.render.RenderTexture2D.prefetch([truncated])
+
+    def test_texture_prefetch_decode(self):
+        with tempfile.TemporaryDirectory() as d:
+            files = []
+            for i in range(6):
+                files.append(os.path.join(d, f"{i}.png"))
+                write_png(files[-1], np.full((4, 8, 4), i * 40, dtype=np.uint8))
+
+            # prefetched textures stay cached over the budget until requested
+            budget = sapien.render.get_resource_memory_budget()
+            sapien.render.set_resource_memory_budget(1)
+            try:
+                sapien.render.RenderTexture2D.prefetch(files, thread_count=3)
+                before = sapien.render.get_resource_cache_stats()
+                textures = [sapien.render.RenderTexture2D(f) for f in files]
+                stats = sapien.render.get_resource_cache_stats()
+            finally:
+                sapien.render.set_resource_memory_budget(budget)
+
+            self.assertEqual(stats.hits - before.hits, len(files))
+            for i, texture in enumerate(textures):
+                self.assertEqual((texture.width, texture.height), (8, 4))
+                self.assertTrue(np.all(texture.download()[..., 0] == i * 40))
+
+            with self.assertRaises(RuntimeError):
+                sapien.render.RenderTexture2D.prefetch([os.path.join(d, "missing.png")])
+
+    def test_frame_recorder(self):
+        depth = np.arange(12, dtype=np.float32).reshape(3, 4)
+        with tempfile.TemporaryDirectory() as d:
+            recorder = sapien.render.FrameRecorder(d, "npy", max_queued_frames=1)
+            for frame in range(4):
+                recorder.add_image("depth", frame, (depth + frame)[:, ::2])
+            recorder.flush()
+            self.assertEqual(recorder.written_frame_count, 4)
+            loaded = np.load(os.path.join(d, "depth", "000003.npy"))
+            self.assertTrue(np.array_equal(loaded, depth[:, ::2] + 3))
+
+    def test_point_cloud(self):
+        scene = sapien.Scene()
+        scene.add_directional_light([0, 1, -1], [0.5, 0.5, 0.5])
+        builder = scene.create_actor_builder()
+        builder.add_box_visual(half_size=[0.5, 0.5, 0.5])
+        box = builder.build_kinematic()
+        builder.build_kinematic().set_pose(sapien.Pose([1, 1.2, 0]))
+        cam = scene.add_camera("", 64, 48, 1, 0.01, 10)
+        cam.entity.set_pose(sapien.Pose([-3, 0, 0]))
+        scene.update_render()
+        cam.take_picture()
+
+        position = cam.get_picture("Position")
+        seg = cam.get_picture("Segmentation")
+        mask = (position[..., 3] < 1) & (seg[..., 1] == box.per_scene_id)
+        model = cam.get_model_matrix()
+        expected = position[..., :3][mask] @ model[:3, :3].T + model[:3, 3]
+
+        pc = cam.get_point_cloud(
+            segmentation=True, segmentation_ids=[box.per_scene_id], thread_count=2
+        )
+        self.assertGreater(len(expected), 0)
+        self.assertTrue(np.allclose(pc["points"], expected, atol=1e-5))
+        self.assertTrue(np.all(pc["segmentation"][:, 1] == box.per_scene_id))
+        self.assertNotIn("colors", pc)
+
+        pc = cam.get_point_cloud("camera", color=True, max_depth=3.5)
+        self.assertEqual(pc["colors"].shape, (len(pc["points"]), 4))
+        self.assertTrue(np.all(-pc["points"][:, 2] <= 3.5))
+        self.assertLess(len(pc["points"]), np.count_nonzero(position[..., 3] < 1))
+
+    def test_update_unchanged(self):
+        scene = sapien.Scene()
+        builder = scene.create_actor_builder()
+        builder.add_box_visual(half_size=[0.5, 0.5, 0.5])
+        a = builder.build_kinematic()
+        b = builder.build_kinematic()
+        scene.update_render()
+
+        version = a.pose_version
+        a.set_pose(sapien.Pose([1, 0, 0]))
+        self.assertEqual(a.pose_version, version + 1)
+        scene.update_render()
+        self.assertEqual(scene.render_system.updated_node_count, 1)
+        scene.update_render()
+        self.assertEqual(scene.render_system.updated_node_count, 0)
+
     # def test_empty(self):
     #     scene = sapien.Scene()
     #     scene.add_ground(altitude=0)  # Add a ground
@@ -187,3 +187,45 @@ class TestScene(unittest.TestCase):
         )
 
         # TODO: check details of the built shapes
+
+    def test_scene_bvh(self):
+        scene = sapien.Scene()
+        builder = scene.create_actor_builder()
+        builder.add_box_collision(half_size=[0.1, 0.1, 0.1])
+        entities = []
+        for i in range(10):
+            builder.set_initial_pose(sapien.Pose([i, 0, 0]))
+            entities.append(builder.build_kinematic())
+
+        bvh = sapien.pysapien.SceneBVH(scene)
+        self.assertEqual(len(bvh.components), 10)
+
+        found = bvh.query_box([2.5, -1, -1], [4.5, 1, 1], return_components=True)
+        self.assertEqual(set(c.entity for c in found), set(entities[3:5]))
+
+        nearest = bvh.query_nearest([6.2, 0, 0], 2, return_components=True)
+        self.assertEqual([c.entity for c in nearest], [entities[6], entities[7]])
+
+        # 90 degree frustum looking along +x, clipped to 2.5 <= x <= 4.5
+        planes = [
+            [1, -1, 0, 0],
+            [1, 1, 0, 0],
+            [1, 0, -1, 0],
+            [1, 0, 1, 0],
+            [1, 0, 0, -2.5],
+            [-1, 0, 0, 4.5],
+        ]
+        found = bvh.query_frustum(planes, return_components=True)
+        self.assertEqual(set(c.entity for c in found), set(entities[3:5]))
+        indices = bvh.query_frustum(np.array(planes[:5], dtype=np.float32))
+        self.assertEqual(len(indices), 7)
+
+        # boxes are refit after the next step
+        entities[0].pose = sapien.Pose([20, 0, 0])
+        scene.step()
+        found = bvh.query_sphere([20, 0, 0], 0.5, return_components=True)
+        self.assertEqual([c.entity for c in found], [entities[0]])
+
+        scene.remove_entity(entities[1])
+        bvh.update()
+        self.assertEqual(len(bvh.components), 9)